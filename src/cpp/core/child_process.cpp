@@ -0,0 +1,200 @@
+#include "child_process.h"
+#include <csignal>
+
+namespace Nexus {
+
+ChildProcess::ChildProcess(OutputCallback on_output, ExitCallback on_exit)
+    : on_output_(std::move(on_output)), on_exit_(std::move(on_exit)) {}
+
+int ChildProcess::spawn(uv_loop_t* loop, const Options& options, OutputCallback on_output, ExitCallback on_exit,
+                        ChildProcess** started) {
+    if (options.argv.empty()) {
+        return UV_EINVAL;
+    }
+
+    auto* child = new ChildProcess(std::move(on_output), std::move(on_exit));
+    child->process_.data = child;
+    child->timer_.data = child;
+    child->stdout_pipe_.handle.data = child;
+    child->stderr_pipe_.handle.data = child;
+
+    uv_timer_init(loop, &child->timer_);
+    uv_pipe_init(loop, &child->stdout_pipe_.handle, 0);
+    uv_pipe_init(loop, &child->stderr_pipe_.handle, 0);
+    child->open_handles_ = 3;
+
+    uv_stdio_container_t stdio[3];
+    stdio[0].flags = UV_IGNORE;
+    stdio[1].flags = static_cast<uv_stdio_flags>(UV_CREATE_PIPE | UV_WRITABLE_PIPE);
+    stdio[1].data.stream = reinterpret_cast<uv_stream_t*>(&child->stdout_pipe_.handle);
+    stdio[2].flags = static_cast<uv_stdio_flags>(UV_CREATE_PIPE | UV_WRITABLE_PIPE);
+    stdio[2].data.stream = reinterpret_cast<uv_stream_t*>(&child->stderr_pipe_.handle);
+
+    std::vector<char*> args;
+    args.reserve(options.argv.size() + 1);
+    for (const auto& arg : options.argv) {
+        args.push_back(const_cast<char*>(arg.c_str()));
+    }
+    args.push_back(nullptr);
+
+    std::vector<char*> env;
+    if (!options.env.empty()) {
+        env.reserve(options.env.size() + 1);
+        for (const auto& entry : options.env) {
+            env.push_back(const_cast<char*>(entry.c_str()));
+        }
+        env.push_back(nullptr);
+    }
+
+    uv_process_options_t process_options{};
+    process_options.exit_cb = on_process_exit;
+    process_options.file = args[0];
+    process_options.args = args.data();
+    process_options.env = env.empty() ? nullptr : env.data();
+    process_options.cwd = options.cwd.empty() ? nullptr : options.cwd.c_str();
+    process_options.stdio_count = 3;
+    process_options.stdio = stdio;
+    if (options.process_group) {
+        process_options.flags = UV_PROCESS_DETACHED;    // setsid(): the child leads its own group
+    }
+
+    int status = uv_spawn(loop, &child->process_, &process_options);
+    // Even a failed spawn leaves an initialized process handle to close
+    ++child->open_handles_;
+    if (status != 0) {
+        child->on_output_ = nullptr;
+        child->on_exit_ = nullptr;
+        child->close_all();
+        return status;
+    }
+
+    for (Pipe* pipe : {&child->stdout_pipe_, &child->stderr_pipe_}) {
+        pipe->open = uv_read_start(reinterpret_cast<uv_stream_t*>(&pipe->handle), on_alloc, on_read) == 0;
+    }
+    child->kill_grace_ms_ = options.kill_grace_ms;
+    child->process_group_ = options.process_group;
+    if (options.timeout_ms > 0) {
+        uv_timer_start(&child->timer_, on_timeout, options.timeout_ms, 0);
+    }
+    if (started) {
+        *started = child;
+    }
+    return 0;
+}
+
+void ChildProcess::terminate() {
+    uv_timer_stop(&timer_);
+    on_timeout(&timer_);
+}
+
+// The group outlives the child while any descendant is in it; fall back to
+// the child alone if it never had one
+void ChildProcess::signal(int signum) {
+    if (process_group_ && uv_kill(-process_.pid, signum) == 0) {
+        return;
+    }
+    if (!exited_) {
+        uv_process_kill(&process_, signum);
+    }
+}
+
+ChildProcess::Pipe& ChildProcess::pipe_for(uv_handle_t* handle) {
+    return handle == reinterpret_cast<uv_handle_t*>(&stdout_pipe_.handle) ? stdout_pipe_ : stderr_pipe_;
+}
+
+void ChildProcess::stop_reading(Pipe& pipe) {
+    if (pipe.open) {
+        uv_read_stop(reinterpret_cast<uv_stream_t*>(&pipe.handle));
+        pipe.open = false;
+    }
+}
+
+void ChildProcess::maybe_finish() {
+    if (!exited_ || stdout_pipe_.open || stderr_pipe_.open) {
+        return;
+    }
+
+    uv_timer_stop(&timer_);
+    ExitCallback on_exit = std::move(on_exit_);
+    on_output_ = nullptr;
+    if (on_exit) {
+        on_exit(result_);
+    }
+    close_all();
+}
+
+void ChildProcess::close_all() {
+    for (uv_handle_t* handle : {reinterpret_cast<uv_handle_t*>(&process_),
+                                reinterpret_cast<uv_handle_t*>(&timer_),
+                                reinterpret_cast<uv_handle_t*>(&stdout_pipe_.handle),
+                                reinterpret_cast<uv_handle_t*>(&stderr_pipe_.handle)}) {
+        if (!uv_is_closing(handle)) {
+            uv_close(handle, on_close);
+        }
+    }
+}
+
+// Each pipe reads into its own fixed buffer; libuv's size hint is not needed
+void ChildProcess::on_alloc(uv_handle_t* handle, size_t, uv_buf_t* buf) {
+    Pipe& pipe = static_cast<ChildProcess*>(handle->data)->pipe_for(handle);
+    *buf = uv_buf_init(pipe.buffer, sizeof(pipe.buffer));
+}
+
+void ChildProcess::on_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+    auto* child = static_cast<ChildProcess*>(stream->data);
+    auto* handle = reinterpret_cast<uv_handle_t*>(stream);
+
+    if (nread > 0) {
+        if (child->on_output_) {
+            Stream which = handle == reinterpret_cast<uv_handle_t*>(&child->stdout_pipe_.handle)
+                ? Stream::Stdout : Stream::Stderr;
+            child->on_output_(which, buf->base, static_cast<size_t>(nread));
+        }
+        return;
+    }
+    if (nread < 0) {
+        // EOF or read error: this stream is done
+        child->stop_reading(child->pipe_for(handle));
+        child->maybe_finish();
+    }
+}
+
+void ChildProcess::on_process_exit(uv_process_t* process, int64_t exit_status, int term_signal) {
+    auto* child = static_cast<ChildProcess*>(process->data);
+    child->result_.exit_status = exit_status;
+    child->result_.term_signal = term_signal;
+    child->exited_ = true;
+    child->maybe_finish();
+}
+
+void ChildProcess::on_timeout(uv_timer_t* timer) {
+    auto* child = static_cast<ChildProcess*>(timer->data);
+
+    if (child->exited_) {
+        // A background grandchild is holding the pipes open; stop waiting
+        if (child->process_group_) {
+            child->signal(SIGKILL);
+        }
+        child->stop_reading(child->stdout_pipe_);
+        child->stop_reading(child->stderr_pipe_);
+        child->maybe_finish();
+        return;
+    }
+
+    if (!child->result_.timed_out) {
+        child->result_.timed_out = true;
+        child->signal(SIGTERM);
+        uv_timer_start(&child->timer_, on_timeout, child->kill_grace_ms_, 0);
+    } else {
+        child->signal(SIGKILL);
+    }
+}
+
+void ChildProcess::on_close(uv_handle_t* handle) {
+    auto* child = static_cast<ChildProcess*>(handle->data);
+    if (--child->open_handles_ == 0) {
+        delete child;
+    }
+}
+
+} // namespace Nexus
@@ -0,0 +1,182 @@
+#include "code_cache.h"
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <unistd.h>
+
+namespace Nexus {
+
+CodeCache::CodeCache(const std::string& cache_directory, size_t max_memory_entries)
+    : cache_directory_(cache_directory), max_memory_entries_(max_memory_entries) {
+    if (!cache_directory_.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(cache_directory_, ec);
+        persistent_ = !ec;
+    }
+}
+
+CodeCache::~CodeCache() = default;
+
+CodeCache::Entry CodeCache::lookup(uint64_t source_hash) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(source_hash);
+        if (it != entries_.end()) {
+            hits_.fetch_add(1);
+            recency_.splice(recency_.begin(), recency_, it->second.position);
+            return it->second.entry;
+        }
+    }
+
+    Entry entry = load_from_disk(source_hash);
+    if (!entry) {
+        misses_.fetch_add(1);
+        return nullptr;
+    }
+
+    hits_.fetch_add(1);
+    std::lock_guard<std::mutex> lock(mutex_);
+    insert_locked(source_hash, entry);
+    return entry;
+}
+
+void CodeCache::store(uint64_t source_hash, std::vector<uint8_t> data) {
+    if (data.empty()) {
+        return;
+    }
+
+    auto entry = std::make_shared<const std::vector<uint8_t>>(std::move(data));
+    write_to_disk(source_hash, *entry);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    insert_locked(source_hash, std::move(entry));
+}
+
+void CodeCache::insert_locked(uint64_t source_hash, Entry entry) {
+    auto it = entries_.find(source_hash);
+    if (it != entries_.end()) {
+        it->second.entry = std::move(entry);
+        recency_.splice(recency_.begin(), recency_, it->second.position);
+        return;
+    }
+    if (max_memory_entries_ == 0) {
+        return;
+    }
+    if (entries_.size() >= max_memory_entries_) {
+        entries_.erase(recency_.back());
+        recency_.pop_back();
+    }
+    recency_.push_front(source_hash);
+    entries_.emplace(source_hash, Slot{std::move(entry), recency_.begin()});
+}
+
+void CodeCache::invalidate(uint64_t source_hash) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(source_hash);
+        if (it != entries_.end()) {
+            recency_.erase(it->second.position);
+            entries_.erase(it);
+        }
+    }
+
+    if (persistent_) {
+        std::error_code ec;
+        std::filesystem::remove(entry_path(source_hash), ec);
+    }
+}
+
+void CodeCache::clear() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+        recency_.clear();
+    }
+
+    if (persistent_) {
+        std::error_code ec;
+        for (const auto& file : std::filesystem::directory_iterator(cache_directory_, ec)) {
+            if (file.path().extension() == ".v8cache") {
+                std::filesystem::remove(file.path(), ec);
+            }
+        }
+    }
+}
+
+uint64_t CodeCache::hash_source(std::string_view source) {
+    // FNV-1a; V8 re-validates the source length and its own version/flags
+    // when consuming, so a stale or mismatched entry is rejected, not run
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : source) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash ^ source.size();
+}
+
+std::string CodeCache::default_cache_directory() {
+    if (const char* xdg_cache = std::getenv("XDG_CACHE_HOME"); xdg_cache && *xdg_cache) {
+        return std::string(xdg_cache) + "/nexus/code-cache";
+    }
+    if (const char* home = std::getenv("HOME"); home && *home) {
+        return std::string(home) + "/.cache/nexus/code-cache";
+    }
+    return "";
+}
+
+std::string CodeCache::entry_path(uint64_t source_hash) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.v8cache", static_cast<unsigned long long>(source_hash));
+    return cache_directory_ + "/" + name;
+}
+
+CodeCache::Entry CodeCache::load_from_disk(uint64_t source_hash) {
+    if (!persistent_) {
+        return nullptr;
+    }
+
+    std::ifstream file(entry_path(source_hash), std::ios::binary);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)),
+                              std::istreambuf_iterator<char>());
+    if (data.empty()) {
+        return nullptr;
+    }
+    return std::make_shared<const std::vector<uint8_t>>(std::move(data));
+}
+
+void CodeCache::write_to_disk(uint64_t source_hash, const std::vector<uint8_t>& data) {
+    if (!persistent_) {
+        return;
+    }
+
+    // Write to a private temp file and rename so concurrent shells never read
+    // a partially written entry
+    std::string path = entry_path(source_hash);
+    std::string temp_path = path + ".tmp." + std::to_string(getpid());
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file.good()) {
+            file.close();
+            std::remove(temp_path.c_str());
+            return;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+    }
+}
+
+} // namespace Nexus
@@ -0,0 +1,284 @@
+#include "command_metrics.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace Nexus {
+
+namespace {
+
+std::atomic<uint64_t> next_instance{1};
+
+// Shards this thread records into, by registry instance. Entries of
+// destroyed registries are never matched again: instances are not reused
+thread_local std::vector<std::pair<uint64_t, void*>> t_shards;
+
+void increment(std::atomic<uint64_t>& counter, uint64_t amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+} // namespace
+
+size_t LatencyHistogram::bucket_index(uint64_t value) {
+    if (value < kSubBuckets) {
+        return static_cast<size_t>(value);
+    }
+    unsigned msb = static_cast<unsigned>(std::bit_width(value)) - 1;
+    if (msb >= kMaxValueBits) {
+        return kBuckets - 1;
+    }
+    unsigned shift = msb - (kSubBucketBits - 1);
+    return kSubBuckets + (msb - kSubBucketBits) * (kSubBuckets / 2) +
+           static_cast<size_t>((value >> shift) - kSubBuckets / 2);
+}
+
+uint64_t LatencyHistogram::bucket_upper(size_t index) {
+    if (index < kSubBuckets) {
+        return index;
+    }
+    size_t offset = index - kSubBuckets;
+    unsigned msb = kSubBucketBits + static_cast<unsigned>(offset / (kSubBuckets / 2));
+    uint64_t sub_bucket = kSubBuckets / 2 + offset % (kSubBuckets / 2);
+    unsigned shift = msb - (kSubBucketBits - 1);
+    return ((sub_bucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    increment(counts_[bucket_index(value)], 1);
+    increment(count_, 1);
+    increment(sum_, value);
+    if (value > max_.load(std::memory_order_relaxed)) {
+        max_.store(value, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::add_to(Snapshot& snapshot) const {
+    if (snapshot.counts.empty()) {
+        snapshot.counts.resize(kBuckets);
+    }
+    for (size_t i = 0; i < kBuckets; ++i) {
+        snapshot.counts[i] += counts_[i].load(std::memory_order_relaxed);
+    }
+    snapshot.count += count_.load(std::memory_order_relaxed);
+    snapshot.sum += sum_.load(std::memory_order_relaxed);
+    snapshot.max = std::max(snapshot.max, max_.load(std::memory_order_relaxed));
+}
+
+void LatencyHistogram::Snapshot::merge(const Snapshot& other) {
+    if (other.counts.empty()) {
+        return;
+    }
+    if (counts.empty()) {
+        counts.resize(kBuckets);
+    }
+    for (size_t i = 0; i < kBuckets; ++i) {
+        counts[i] += other.counts[i];
+    }
+    count += other.count;
+    sum += other.sum;
+    max = std::max(max, other.max);
+}
+
+void LatencyHistogram::Snapshot::subtract(const Snapshot& baseline) {
+    if (baseline.counts.empty() || counts.empty()) {
+        return;
+    }
+    size_t highest = 0;
+    bool any = false;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        counts[i] -= std::min(counts[i], baseline.counts[i]);
+        if (counts[i]) {
+            highest = i;
+            any = true;
+        }
+    }
+    count -= std::min(count, baseline.count);
+    sum -= std::min(sum, baseline.sum);
+    // The exact maximum may predate the baseline; bound it by the buckets
+    max = any ? std::min(max, bucket_upper(highest)) : 0;
+}
+
+uint64_t LatencyHistogram::Snapshot::percentile(double quantile) const {
+    if (count == 0 || counts.empty()) {
+        return 0;
+    }
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(count))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::min(bucket_upper(i), max);
+        }
+    }
+    return max;
+}
+
+LatencySummary LatencyHistogram::Snapshot::summary() const {
+    LatencySummary result;
+    result.count = count;
+    if (count) {
+        result.mean_us = static_cast<double>(sum) / static_cast<double>(count);
+        result.p50_us = percentile(0.50);
+        result.p99_us = percentile(0.99);
+        result.max_us = max;
+    }
+    return result;
+}
+
+const char* command_phase_name(CommandPhase phase) {
+    switch (phase) {
+        case CommandPhase::Parse: return "parse";
+        case CommandPhase::Security: return "security";
+        case CommandPhase::Execute: return "execute";
+        case CommandPhase::Convert: return "convert";
+        case CommandPhase::Total: return "total";
+    }
+    return "unknown";
+}
+
+CommandMetrics::Shard::~Shard() {
+    for (std::atomic<Histograms*>& histograms : commands) {
+        delete histograms.load(std::memory_order_relaxed);
+    }
+}
+
+CommandMetrics::CommandMetrics() : instance_(next_instance.fetch_add(1, std::memory_order_relaxed)) {}
+
+CommandMetrics::~CommandMetrics() {
+    Shard* shard = shards_.load(std::memory_order_acquire);
+    while (shard) {
+        Shard* next = shard->next;
+        delete shard;
+        shard = next;
+    }
+}
+
+CommandMetrics::Shard& CommandMetrics::local_shard() {
+    for (const auto& [instance, shard] : t_shards) {
+        if (instance == instance_) {
+            return *static_cast<Shard*>(shard);
+        }
+    }
+
+    auto* shard = new Shard;
+    Shard* head = shards_.load(std::memory_order_relaxed);
+    do {
+        shard->next = head;
+    } while (!shards_.compare_exchange_weak(head, shard, std::memory_order_release, std::memory_order_relaxed));
+    t_shards.emplace_back(instance_, shard);
+    return *shard;
+}
+
+uint32_t CommandMetrics::name_id(Shard& shard, std::string_view command) {
+    auto cached = shard.names.find(command);
+    if (cached != shard.names.end()) {
+        return cached->second;
+    }
+
+    uint32_t id;
+    {
+        std::lock_guard<std::mutex> lock(names_mutex_);
+        auto known = name_ids_.find(command);
+        if (known != name_ids_.end()) {
+            id = known->second;
+        } else if (names_.size() < kMaxCommands) {
+            id = static_cast<uint32_t>(names_.size());
+            names_.emplace_back(command);
+            name_ids_.emplace(names_.back(), id);
+        } else {
+            id = kMaxCommands;
+        }
+    }
+    // Overflow names are cached too, up to a bound, so a stream of distinct
+    // commands cannot grow the cache without limit
+    if (id < kMaxCommands || shard.names.size() < 4 * kMaxCommands) {
+        shard.names.emplace(std::string(command), id);
+    }
+    return id;
+}
+
+void CommandMetrics::record(const Sample& sample) {
+    Shard& shard = local_shard();
+    uint32_t id = name_id(shard, sample.command);
+
+    Histograms* histograms = shard.commands[id].load(std::memory_order_relaxed);
+    if (!histograms) {
+        histograms = new Histograms;
+        shard.commands[id].store(histograms, std::memory_order_release);
+    }
+    for (size_t phase = 0; phase < kCommandPhases; ++phase) {
+        if (sample.timed & (1u << phase)) {
+            histograms->phases[phase].record(sample.phase_us[phase]);
+        }
+    }
+    if (sample.failed) {
+        increment(shard.failed, 1);
+    }
+}
+
+CommandMetrics::Totals CommandMetrics::totals() const {
+    Totals totals;
+    totals.commands.resize(kMaxCommands + 1);
+    for (Shard* shard = shards_.load(std::memory_order_acquire); shard; shard = shard->next) {
+        totals.failed += shard->failed.load(std::memory_order_relaxed);
+        for (size_t id = 0; id <= kMaxCommands; ++id) {
+            const Histograms* histograms = shard->commands[id].load(std::memory_order_acquire);
+            if (!histograms) {
+                continue;
+            }
+            for (size_t phase = 0; phase < kCommandPhases; ++phase) {
+                histograms->phases[phase].add_to(totals.commands[id][phase]);
+            }
+        }
+    }
+    return totals;
+}
+
+void CommandMetrics::collect(PerformanceMetrics& metrics) const {
+    std::lock_guard<std::mutex> lock(baseline_mutex_);
+    Totals totals = this->totals();
+    totals.failed -= std::min(totals.failed, baseline_.failed);
+
+    std::vector<std::string> names;
+    {
+        std::lock_guard<std::mutex> names_lock(names_mutex_);
+        names = names_;
+    }
+    names.resize(kMaxCommands);
+    names.emplace_back("other");
+
+    constexpr size_t kTotal = static_cast<size_t>(CommandPhase::Total);
+    LatencyHistogram::Snapshot all;
+    metrics.commands_executed = 0;
+    metrics.total_execution_time_us = 0;
+    metrics.command_latency.clear();
+    for (size_t id = 0; id <= kMaxCommands; ++id) {
+        auto& phases = totals.commands[id];
+        if (!baseline_.commands.empty()) {
+            for (size_t phase = 0; phase < kCommandPhases; ++phase) {
+                phases[phase].subtract(baseline_.commands[id][phase]);
+            }
+        }
+        if (phases[kTotal].count == 0) {
+            continue;
+        }
+        metrics.commands_executed += phases[kTotal].count;
+        metrics.total_execution_time_us += phases[kTotal].sum;
+        all.merge(phases[kTotal]);
+        for (size_t phase = 0; phase < kCommandPhases; ++phase) {
+            if (phases[phase].count) {
+                metrics.command_latency.push_back({names[id], command_phase_name(static_cast<CommandPhase>(phase)),
+                                                   phases[phase].summary()});
+            }
+        }
+    }
+    metrics.commands_failed = totals.failed;
+    metrics.latency = all.summary();
+}
+
+void CommandMetrics::reset() {
+    std::lock_guard<std::mutex> lock(baseline_mutex_);
+    baseline_ = totals();
+}
+
+} // namespace Nexus
@@ -0,0 +1,103 @@
+#include "command_table.h"
+#include <algorithm>
+#include <utility>
+
+namespace Nexus {
+
+namespace {
+
+std::atomic<uint64_t> next_table_id{1};
+
+struct CommandReaderCache {
+    uint64_t table_id = 0;
+    uint64_t generation = 0;
+    std::shared_ptr<const CommandTable::Snapshot> snapshot;
+};
+
+thread_local CommandReaderCache command_reader_cache;
+
+} // namespace
+
+CommandTable::CommandTable()
+    : table_id_(next_table_id.fetch_add(1, std::memory_order_relaxed)),
+      snapshot_(std::make_shared<const Snapshot>()) {}
+
+void CommandTable::set(const std::string& name, CommandHandler handler) {
+    auto shared = std::make_shared<const CommandHandler>(std::move(handler));
+    Handler replaced;                   // Released after the lock
+    std::lock_guard<std::mutex> lock(mutex_);
+    replaced = std::exchange(handlers_[name], std::move(shared));
+    publish_locked();
+}
+
+bool CommandTable::add(const std::string& name, CommandHandler handler) {
+    auto shared = std::make_shared<const CommandHandler>(std::move(handler));
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!handlers_.emplace(name, std::move(shared)).second) {
+        return false;
+    }
+    publish_locked();
+    return true;
+}
+
+bool CommandTable::remove(const std::string& name) {
+    Handler removed;                    // Released after the lock
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = handlers_.find(name);
+    if (it == handlers_.end()) {
+        return false;
+    }
+    removed = std::move(it->second);
+    handlers_.erase(it);
+    publish_locked();
+    return true;
+}
+
+// Copy-on-write: registrations are rare and the table is small
+void CommandTable::publish_locked() {
+    auto next = std::make_shared<Snapshot>();
+    next->reserve(handlers_.size());
+    for (const auto& [name, handler] : handlers_) {
+        next->emplace(name, handler);
+    }
+    snapshot_ = std::move(next);
+    generation_.fetch_add(1, std::memory_order_release);
+}
+
+const CommandTable::Snapshot& CommandTable::current() const {
+    CommandReaderCache& cache = command_reader_cache;
+    if (cache.table_id != table_id_ || cache.generation != generation_.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cache.table_id = table_id_;
+        cache.generation = generation_.load(std::memory_order_relaxed);
+        cache.snapshot = snapshot_;
+    }
+    return *cache.snapshot;
+}
+
+CommandTable::Handler CommandTable::find(const std::string& name) const {
+    const Snapshot& snapshot = current();
+    auto it = snapshot.find(name);
+    return it == snapshot.end() ? nullptr : it->second.lock();
+}
+
+bool CommandTable::contains(const std::string& name) const {
+    const Snapshot& snapshot = current();
+    auto it = snapshot.find(name);
+    return it != snapshot.end() && !it->second.expired();
+}
+
+std::vector<std::string> CommandTable::names() const {
+    std::vector<std::string> names;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        names.reserve(handlers_.size());
+        for (const auto& [name, handler] : handlers_) {
+            names.push_back(name);
+        }
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+} // namespace Nexus
@@ -0,0 +1,254 @@
+#include "daemon_protocol.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace Nexus {
+
+namespace {
+
+struct Header {
+    uint32_t magic;
+    uint32_t payload_length;
+};
+
+bool send_all(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t sent = ::send(fd, data, length, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += sent;
+        length -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool receive_all(int fd, char* data, size_t length) {
+    while (length > 0) {
+        ssize_t received = ::recv(fd, data, length, 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            return false;
+        }
+        data += received;
+        length -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+void put_u32(std::string& out, uint32_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void put_string(std::string& out, const std::string& value) {
+    put_u32(out, static_cast<uint32_t>(value.size()));
+    out += value;
+}
+
+void put_strings(std::string& out, const std::vector<std::string>& values) {
+    put_u32(out, static_cast<uint32_t>(values.size()));
+    for (const std::string& value : values) {
+        put_string(out, value);
+    }
+}
+
+// Bounds-checked reader over a received payload
+class Reader {
+public:
+    Reader(const char* data, size_t size) : data_(data), end_(data + size) {}
+
+    bool u32(uint32_t& value) {
+        if (static_cast<size_t>(end_ - data_) < sizeof(value)) {
+            return false;
+        }
+        std::memcpy(&value, data_, sizeof(value));
+        data_ += sizeof(value);
+        return true;
+    }
+
+    bool string(std::string& value) {
+        uint32_t length;
+        if (!u32(length) || static_cast<size_t>(end_ - data_) < length) {
+            return false;
+        }
+        value.assign(data_, length);
+        data_ += length;
+        return true;
+    }
+
+    bool strings(std::vector<std::string>& values) {
+        uint32_t count;
+        // Every string needs at least its length prefix
+        if (!u32(count) || count > static_cast<size_t>(end_ - data_) / sizeof(uint32_t)) {
+            return false;
+        }
+        values.resize(count);
+        for (std::string& value : values) {
+            if (!string(value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool done() const { return data_ == end_; }
+
+private:
+    const char* data_;
+    const char* end_;
+};
+
+} // namespace
+
+std::string default_daemon_socket() {
+    if (const char* path = std::getenv("NEXUS_DAEMON_SOCKET"); path && *path) {
+        return path;
+    }
+    if (const char* runtime = std::getenv("XDG_RUNTIME_DIR"); runtime && *runtime) {
+        return std::string(runtime) + "/nexus/daemon.sock";
+    }
+    return "/tmp/nexus-" + std::to_string(::geteuid()) + "/daemon.sock";
+}
+
+bool send_daemon_request(int socket, const DaemonRequest& request, std::string& error) {
+    std::string payload;
+    put_strings(payload, request.argv);
+    put_string(payload, request.cwd);
+    put_strings(payload, request.environment);
+    if (payload.size() > kDaemonMaxPayload) {
+        error = "Request too large (arguments and environment exceed " + std::to_string(kDaemonMaxPayload >> 20) +
+                " MB)";
+        return false;
+    }
+
+    Header header{kDaemonMagic, static_cast<uint32_t>(payload.size())};
+    struct iovec iov{&header, sizeof(header)};
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(request.fds))] = {};
+    struct msghdr message{};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(request.fds));
+    std::memcpy(CMSG_DATA(cmsg), request.fds, sizeof(request.fds));
+
+    ssize_t sent;
+    do {
+        sent = ::sendmsg(socket, &message, MSG_NOSIGNAL);
+    } while (sent < 0 && errno == EINTR);
+    if (sent < 0) {
+        error = std::string("Cannot send request: ") + std::strerror(errno);
+        return false;
+    }
+    // The descriptors went with the first byte; the rest is plain data
+    if (!send_all(socket, reinterpret_cast<const char*>(&header) + sent, sizeof(header) - sent) ||
+        !send_all(socket, payload.data(), payload.size())) {
+        error = std::string("Cannot send request: ") + std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool receive_daemon_request(int socket, DaemonRequest& request, std::string& error) {
+    Header header{};
+    struct iovec iov{&header, sizeof(header)};
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(request.fds))] = {};
+    struct msghdr message{};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    ssize_t received;
+    do {
+        received = ::recvmsg(socket, &message, MSG_CMSG_CLOEXEC);
+    } while (received < 0 && errno == EINTR);
+    if (received <= 0) {
+        error = received < 0 ? std::string("Cannot read request: ") + std::strerror(errno) : "Client disconnected";
+        return false;
+    }
+
+    // Take ownership of whatever arrived before validating anything else:
+    // the first three descriptors are the client's stdio, any others are
+    // closed (the kernel already closed those that did not fit in control)
+    size_t received_fds = 0;
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+            continue;
+        }
+        size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        const unsigned char* data = CMSG_DATA(cmsg);
+        for (size_t i = 0; i < count; ++i) {
+            int fd;
+            std::memcpy(&fd, data + i * sizeof(int), sizeof(int));
+            if (received_fds < 3) {
+                request.fds[received_fds] = fd;
+            } else {
+                ::close(fd);
+            }
+            ++received_fds;
+        }
+    }
+    if ((message.msg_flags & MSG_CTRUNC) || received_fds != 3) {
+        error = "Request did not carry exactly stdin, stdout and stderr";
+        close_request_fds(request);
+        return false;
+    }
+
+    if (!receive_all(socket, reinterpret_cast<char*>(&header) + received, sizeof(header) - received)) {
+        error = "Truncated request header";
+        close_request_fds(request);
+        return false;
+    }
+    if (header.magic != kDaemonMagic || header.payload_length > kDaemonMaxPayload) {
+        error = "Not a nexus daemon request";
+        close_request_fds(request);
+        return false;
+    }
+
+    std::string payload(header.payload_length, '\0');
+    if (!receive_all(socket, payload.data(), payload.size())) {
+        error = "Truncated request";
+        close_request_fds(request);
+        return false;
+    }
+    Reader reader(payload.data(), payload.size());
+    if (!reader.strings(request.argv) || !reader.string(request.cwd) || !reader.strings(request.environment) ||
+        !reader.done()) {
+        error = "Malformed request";
+        close_request_fds(request);
+        return false;
+    }
+    return true;
+}
+
+void close_request_fds(DaemonRequest& request) {
+    for (int& fd : request.fds) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+}
+
+bool send_daemon_status(int socket, int32_t status) {
+    return send_all(socket, reinterpret_cast<const char*>(&status), sizeof(status));
+}
+
+bool receive_daemon_status(int socket, int32_t& status) {
+    return receive_all(socket, reinterpret_cast<char*>(&status), sizeof(status));
+}
+
+} // namespace Nexus
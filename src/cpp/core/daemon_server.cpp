@@ -0,0 +1,276 @@
+#include "daemon_server.h"
+#include "nexus_kernel.h"
+#include "result_format.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace Nexus {
+
+namespace {
+
+constexpr int kRequestTimeoutSeconds = 5;
+
+void write_all(int fd, const std::string& data) {
+    size_t offset = 0;
+    while (offset < data.size()) {
+        ssize_t written = ::write(fd, data.data() + offset, data.size() - offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;                         // The client's reader went away
+        }
+        offset += static_cast<size_t>(written);
+    }
+}
+
+// The parser has no escapes, so a word is quoted with whichever quote it lacks
+std::string command_line(const std::vector<std::string>& argv) {
+    std::string line;
+    for (const std::string& arg : argv) {
+        if (!line.empty()) {
+            line += ' ';
+        }
+        bool plain = !arg.empty() && arg.find_first_of(" \t\n'\"|") == std::string::npos;
+        if (plain) {
+            line += arg;
+        } else {
+            char quote = arg.find('\'') == std::string::npos ? '\'' : '"';
+            line += quote;
+            line += arg;
+            line += quote;
+        }
+    }
+    return line;
+}
+
+// The socket's directory must be ours alone: in /tmp anyone could create it
+bool prepare_directory(const std::string& path, std::string& error) {
+    size_t slash = path.rfind('/');
+    if (slash == std::string::npos || slash == 0) {
+        return true;
+    }
+    std::string directory = path.substr(0, slash);
+    if (::mkdir(directory.c_str(), 0700) != 0 && errno != EEXIST) {
+        error = "Cannot create " + directory + ": " + std::strerror(errno);
+        return false;
+    }
+    struct stat st;
+    if (::lstat(directory.c_str(), &st) != 0 || !S_ISDIR(st.st_mode) || st.st_uid != ::geteuid() ||
+        (st.st_mode & 0077) != 0) {
+        error = "Refusing to use " + directory + ": it must be a directory owned by this user with mode 0700";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+DaemonServer::DaemonServer(NexusKernel* kernel) : kernel_(kernel) {}
+
+DaemonServer::~DaemonServer() {
+    for (int fd : {listen_fd_, wake_fd_[0], wake_fd_[1], epoll_fd_, home_fd_}) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+    if (!path_.empty()) {
+        ::unlink(path_.c_str());
+    }
+}
+
+bool DaemonServer::start(const std::string& path, std::string& error) {
+    struct sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        error = "Invalid daemon socket path: " + path;
+        return false;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    if (!prepare_directory(path, error)) {
+        return false;
+    }
+
+    listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        error = std::string("Cannot create daemon socket: ") + std::strerror(errno);
+        return false;
+    }
+
+    // A socket left behind by a daemon that died is replaced; a live one is not
+    struct stat st;
+    if (::lstat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) {
+        int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        bool live = probe >= 0 &&
+                    ::connect(probe, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) == 0;
+        if (probe >= 0) {
+            ::close(probe);
+        }
+        if (live) {
+            error = "A daemon is already listening on " + path;
+            return false;
+        }
+        ::unlink(path.c_str());
+    }
+
+    if (::bind(listen_fd_, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0) {
+        error = "Cannot listen on " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    path_ = path;
+    ::chmod(path.c_str(), 0600);
+    if (::listen(listen_fd_, SOMAXCONN) != 0) {
+        error = "Cannot listen on " + path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    home_fd_ = ::open(".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (epoll_fd_ < 0 || home_fd_ < 0 || ::pipe2(wake_fd_, O_CLOEXEC | O_NONBLOCK) != 0) {
+        error = std::string("Cannot set up daemon: ") + std::strerror(errno);
+        return false;
+    }
+    for (int fd : {listen_fd_, wake_fd_[0]}) {
+        struct epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+            error = std::string("Cannot set up daemon: ") + std::strerror(errno);
+            return false;
+        }
+    }
+    return true;
+}
+
+void DaemonServer::run() {
+    while (!stopping_.load() && kernel_->is_running()) {
+        // Requests cancel their own async work; anything started at startup keeps running
+        kernel_->wait_for_input(epoll_fd_);
+        while (!stopping_.load()) {
+            int client = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            serve(client);
+        }
+    }
+}
+
+void DaemonServer::stop() {
+    stopping_.store(true);
+    if (wake_fd_[1] >= 0) {
+        char wake = 0;
+        [[maybe_unused]] ssize_t written = ::write(wake_fd_[1], &wake, 1);
+    }
+}
+
+void DaemonServer::serve(int client) {
+    struct ucred peer{};
+    socklen_t length = sizeof(peer);
+    if (::getsockopt(client, SOL_SOCKET, SO_PEERCRED, &peer, &length) != 0 || peer.uid != ::geteuid()) {
+        ::close(client);
+        return;
+    }
+    // A client sends its whole request at once; a stalled one must not block the rest
+    struct timeval timeout{kRequestTimeoutSeconds, 0};
+    ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    DaemonRequest request;
+    std::string error;
+    if (!receive_daemon_request(client, request, error)) {
+        std::cerr << "nexus daemon: " << error << "\n";
+        close_request_fds(request);
+        ::close(client);
+        return;
+    }
+
+    int status = execute(request);
+    // Drop our copies of the client's stdio before it learns the status
+    close_request_fds(request);
+    send_daemon_status(client, status);
+    ::close(client);
+    requests_.fetch_add(1, std::memory_order_relaxed);
+}
+
+int DaemonServer::execute(const DaemonRequest& request) {
+    std::string command;
+    if (!request.argv.empty() && request.argv[0] == "-c") {
+        command = request.argv.size() == 2 ? request.argv[1] : std::string();
+    } else {
+        command = command_line(request.argv);
+    }
+    if (command.empty()) {
+        write_all(request.fds[2], "Usage: nexus_client <command> [args...] | nexus_client -c <command line>\n");
+        return 2;
+    }
+
+    // Everything the command writes, including JS output, goes to the client
+    std::cout.flush();
+    std::cerr.flush();
+    int saved[3];
+    for (int fd = 0; fd < 3; ++fd) {
+        saved[fd] = ::fcntl(fd, F_DUPFD_CLOEXEC, 3);
+        ::dup2(request.fds[fd], fd);
+    }
+
+    int status;
+    if (::chdir(request.cwd.c_str()) != 0) {
+        write_all(STDERR_FILENO, "nexus: cannot enter " + request.cwd + ": " + std::strerror(errno) + "\n");
+        status = 1;
+    } else {
+        CommandContext context;
+        context.working_directory = request.cwd;
+        context.security_context = kernel_->security_context();
+        context.object_bridge = nullptr;    // StellarObjectBridge is not an ObjectBridge
+        for (const std::string& variable : request.environment) {
+            size_t equals = variable.find('=');
+            if (equals != std::string::npos) {
+                context.environment.emplace(variable.substr(0, equals), variable.substr(equals + 1));
+            }
+        }
+
+        kernel_->begin_request(request.environment);
+        NexusObject result = kernel_->execute_command(command, context);
+        std::string text;
+        if (is_error_result(result)) {
+            text = "nexus: ";
+            format_result(result, text);
+            std::cout.flush();
+            write_all(STDERR_FILENO, text);
+        } else {
+            format_result(result, text);
+            std::cout.flush();
+            write_all(STDOUT_FILENO, text);
+        }
+        status = result_exit_status(result);
+        // Timers and callbacks left behind would write to the next client
+        kernel_->end_request();
+    }
+
+    std::cout.flush();
+    std::cerr.flush();
+    for (int fd = 0; fd < 3; ++fd) {
+        if (saved[fd] >= 0) {
+            ::dup2(saved[fd], fd);
+            ::close(saved[fd]);
+        } else {
+            ::close(fd);
+        }
+    }
+    if (::fchdir(home_fd_) != 0) {
+        std::cerr << "nexus daemon: cannot return to its working directory: " << std::strerror(errno) << "\n";
+    }
+    return status;
+}
+
+} // namespace Nexus
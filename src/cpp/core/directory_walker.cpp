@@ -0,0 +1,178 @@
+#include "directory_walker.h"
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Nexus {
+
+namespace {
+
+uint32_t type_from_dirent(unsigned char d_type) {
+    switch (d_type) {
+        case DT_REG: return DirectoryWalker::kFile;
+        case DT_DIR: return DirectoryWalker::kDirectory;
+        case DT_LNK: return DirectoryWalker::kSymlink;
+        case DT_UNKNOWN: return 0;      // Filesystem without d_type: stat
+        default: return DirectoryWalker::kOther;
+    }
+}
+
+uint32_t type_from_mode(mode_t mode) {
+    if (S_ISREG(mode)) return DirectoryWalker::kFile;
+    if (S_ISDIR(mode)) return DirectoryWalker::kDirectory;
+    if (S_ISLNK(mode)) return DirectoryWalker::kSymlink;
+    return DirectoryWalker::kOther;
+}
+
+const char* type_name(uint32_t type) {
+    switch (type) {
+        case DirectoryWalker::kFile: return "file";
+        case DirectoryWalker::kDirectory: return "directory";
+        case DirectoryWalker::kSymlink: return "symlink";
+        default: return "other";
+    }
+}
+
+bool matches_names(const DirectoryWalker::Spec& spec, const char* name) {
+    for (const std::string& pattern : spec.names) {
+        if (::fnmatch(pattern.c_str(), name, 0) != 0) {
+            return false;
+        }
+    }
+    for (const std::string& pattern : spec.inames) {
+        if (::fnmatch(pattern.c_str(), name, FNM_CASEFOLD) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+void DirectoryWalker::Range::at_least(double value, bool inclusive) {
+    if (value > min || (value == min && !inclusive)) {
+        min = value;
+        min_inclusive = inclusive;
+    }
+}
+
+void DirectoryWalker::Range::at_most(double value, bool inclusive) {
+    if (value < max || (value == max && !inclusive)) {
+        max = value;
+        max_inclusive = inclusive;
+    }
+}
+
+bool DirectoryWalker::Range::contains(double value) const {
+    return (min_inclusive ? value >= min : value > min) &&
+           (max_inclusive ? value <= max : value < max);
+}
+
+uint32_t DirectoryWalker::type_bit(std::string_view name) {
+    if (name == "file") return kFile;
+    if (name == "directory") return kDirectory;
+    if (name == "symlink") return kSymlink;
+    if (name == "other") return kOther;
+    return 0;
+}
+
+std::shared_ptr<NexusTable> DirectoryWalker::walk(const std::string& root, const Spec& spec, std::string& error) {
+    NexusTable::Strings paths, names, types;
+    NexusTable::Numbers sizes, modes, mtimes, depths;
+
+    struct Pending {
+        std::string path;
+        uint32_t depth;                 // Of the directory itself; the root is 0
+    };
+    std::vector<Pending> pending{{root, 0}};
+    bool full = false;
+
+    while (!pending.empty() && !full) {
+        Pending dir = std::move(pending.back());
+        pending.pop_back();
+
+        int fd = ::open(dir.path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) {
+            if (dir.depth == 0) {
+                error = "Cannot walk directory: " + root + ": " + std::strerror(errno);
+                return nullptr;
+            }
+            continue;
+        }
+        DIR* handle = ::fdopendir(fd);
+        if (!handle) {
+            ::close(fd);
+            continue;
+        }
+
+        uint32_t depth = dir.depth + 1;
+        std::string prefix = dir.path;
+        if (prefix.empty() || prefix.back() != '/') {
+            prefix += '/';
+        }
+
+        while (struct dirent* entry = ::readdir(handle)) {
+            const char* name = entry->d_name;
+            if (std::strcmp(name, ".") == 0 || std::strcmp(name, "..") == 0) {
+                continue;
+            }
+
+            struct stat st;
+            bool have_stat = false;
+            uint32_t type = type_from_dirent(entry->d_type);
+            if (type == 0) {
+                if (::fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+                    continue;
+                }
+                have_stat = true;
+                type = type_from_mode(st.st_mode);
+            }
+            if (type == kDirectory && depth < spec.max_depth) {
+                pending.push_back({prefix + name, depth});
+            }
+
+            // Cheap predicates first: only candidates are stat'ed
+            if (depth < spec.min_depth || (spec.filter_type && !(spec.type_mask & type)) ||
+                !matches_names(spec, name)) {
+                continue;
+            }
+            if (!have_stat && ::fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+                continue;
+            }
+            double mtime = static_cast<double>(st.st_mtim.tv_sec) * 1000.0 +
+                           static_cast<double>(st.st_mtim.tv_nsec) / 1e6;
+            if (!spec.size.contains(static_cast<double>(st.st_size)) || !spec.mtime.contains(mtime)) {
+                continue;
+            }
+
+            paths.push_back(prefix + name);
+            names.emplace_back(name);
+            types.emplace_back(type_name(type));
+            sizes.push_back(static_cast<double>(st.st_size));
+            modes.push_back(st.st_mode);
+            mtimes.push_back(mtime);
+            depths.push_back(depth);
+            if (spec.limit && paths.size() >= spec.limit) {
+                full = true;
+                break;
+            }
+        }
+        ::closedir(handle);
+    }
+
+    auto table = std::make_shared<NexusTable>(paths.size());
+    table->add_string_column("path") = std::move(paths);
+    table->add_string_column("name") = std::move(names);
+    table->add_string_column("type") = std::move(types);
+    table->add_number_column("size") = std::move(sizes);
+    table->add_number_column("mode") = std::move(modes);
+    table->add_number_column("mtime") = std::move(mtimes);
+    table->add_number_column("depth") = std::move(depths);
+    return table;
+}
+
+} // namespace Nexus
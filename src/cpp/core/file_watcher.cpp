@@ -0,0 +1,452 @@
+#include "file_watcher.h"
+#include <algorithm>
+#include <cerrno>
+#include <dirent.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Nexus {
+
+namespace {
+
+constexpr uint32_t kWatchMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB |
+                                IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF |
+                                IN_MOVE_SELF | IN_EXCL_UNLINK;
+
+// Upper bound on how long a continuous burst can postpone delivery
+constexpr uint64_t kMaxDebounceFactor = 4;
+
+std::string join_path(const std::string& dir, const char* name) {
+    if (!dir.empty() && dir.back() == '/') {
+        return dir + name;
+    }
+    return dir + "/" + name;
+}
+
+bool is_directory(const std::string& path, unsigned char d_type) {
+    if (d_type != DT_UNKNOWN) {
+        return d_type == DT_DIR;
+    }
+    struct stat st;
+    return ::lstat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+} // namespace
+
+FileWatcher::FileWatcher(uv_loop_t* loop) : loop_(loop) {}
+
+FileWatcher::~FileWatcher() {
+    shutdown();
+}
+
+bool FileWatcher::initialize() {
+    inotify_fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ < 0) {
+        return false;
+    }
+
+    poll_handle_ = new uv_poll_t;
+    if (uv_poll_init(loop_, poll_handle_, inotify_fd_) != 0) {
+        delete poll_handle_;
+        poll_handle_ = nullptr;
+        ::close(inotify_fd_);
+        inotify_fd_ = -1;
+        return false;
+    }
+    poll_handle_->data = this;
+
+    debounce_timer_ = new uv_timer_t;
+    uv_timer_init(loop_, debounce_timer_);
+    debounce_timer_->data = this;
+    return true;
+}
+
+void FileWatcher::shutdown() {
+    subscriptions_.clear();
+    watches_.clear();
+    watch_by_path_.clear();
+
+    // Handles may outlive the watcher until the loop processes the close
+    if (poll_handle_) {
+        uv_close(reinterpret_cast<uv_handle_t*>(poll_handle_), [](uv_handle_t* handle) {
+            delete reinterpret_cast<uv_poll_t*>(handle);
+        });
+        poll_handle_ = nullptr;
+    }
+    if (debounce_timer_) {
+        uv_close(reinterpret_cast<uv_handle_t*>(debounce_timer_), [](uv_handle_t* handle) {
+            delete reinterpret_cast<uv_timer_t*>(handle);
+        });
+        debounce_timer_ = nullptr;
+    }
+    polling_ = false;
+
+    // Closing the descriptor drops every kernel watch at once
+    if (inotify_fd_ >= 0) {
+        ::close(inotify_fd_);
+        inotify_fd_ = -1;
+    }
+}
+
+FileWatcher::SubscriptionId FileWatcher::subscribe(const std::string& path, const Options& options, Callback callback) {
+    if (inotify_fd_ < 0 || !callback) {
+        return 0;
+    }
+
+    SubscriptionId id = next_subscription_id_++;
+    Subscription& subscription = subscriptions_[id];
+    subscription.root = path;
+    subscription.options = options;
+    subscription.callback = std::move(callback);
+
+    if (add_watch(path, id) < 0) {
+        subscriptions_.erase(id);
+        return 0;
+    }
+    if (options.recursive && is_directory(path, DT_UNKNOWN)) {
+        add_tree(path, id, false);
+    }
+
+    update_polling();
+    return id;
+}
+
+void FileWatcher::unsubscribe(SubscriptionId id) {
+    auto it = subscriptions_.find(id);
+    if (it == subscriptions_.end()) {
+        return;
+    }
+
+    std::vector<int> watch_descriptors = std::move(it->second.watch_descriptors);
+    subscriptions_.erase(it);
+    for (int wd : watch_descriptors) {
+        release_watch(wd, id);
+    }
+
+    update_polling();
+    schedule_flush();
+}
+
+int FileWatcher::add_watch(const std::string& path, SubscriptionId id) {
+    // The kernel hands back the existing descriptor for an already watched inode
+    int wd = ::inotify_add_watch(inotify_fd_, path.c_str(), kWatchMask);
+    if (wd < 0) {
+        return -1;
+    }
+
+    // A descriptor seen under another path means the directory was renamed
+    Watch& watch = watches_[wd];
+    if (watch.path != path) {
+        auto by_path = watch_by_path_.find(watch.path);
+        if (by_path != watch_by_path_.end() && by_path->second == wd) {
+            watch_by_path_.erase(by_path);
+        }
+        watch.path = path;
+        watch_by_path_[path] = wd;
+    }
+    if (std::find(watch.subscribers.begin(), watch.subscribers.end(), id) == watch.subscribers.end()) {
+        watch.subscribers.push_back(id);
+        subscriptions_[id].watch_descriptors.push_back(wd);
+    }
+    return wd;
+}
+
+void FileWatcher::add_tree(const std::string& root, SubscriptionId id, bool report_entries) {
+    std::vector<std::string> pending_dirs{root};
+
+    while (!pending_dirs.empty()) {
+        std::string dir_path = std::move(pending_dirs.back());
+        pending_dirs.pop_back();
+
+        DIR* dir = ::opendir(dir_path.c_str());
+        if (!dir) {
+            continue;
+        }
+
+        while (struct dirent* entry = ::readdir(dir)) {
+            const char* name = entry->d_name;
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+                continue;
+            }
+
+            std::string entry_path = join_path(dir_path, name);
+            // Entries created before the new directory's watch existed
+            if (report_entries) {
+                queue_event(id, entry_path, FileEventType::Created);
+            }
+            // Symlinks are not followed (DT_LNK is never a directory here)
+            if (is_directory(entry_path, entry->d_type) && add_watch(entry_path, id) >= 0) {
+                pending_dirs.push_back(std::move(entry_path));
+            }
+        }
+        ::closedir(dir);
+    }
+}
+
+// Watches a subscription holds on root and below. A directory moved away
+// keeps its descriptors; left alone they would report under stale paths
+void FileWatcher::release_tree(const std::string& root, SubscriptionId id) {
+    auto sub_it = subscriptions_.find(id);
+    if (sub_it == subscriptions_.end()) {
+        return;
+    }
+    std::vector<int>& watch_descriptors = sub_it->second.watch_descriptors;
+    std::vector<int> released;
+    for (int wd : watch_descriptors) {
+        auto watch_it = watches_.find(wd);
+        if (watch_it == watches_.end()) {
+            continue;
+        }
+        const std::string& path = watch_it->second.path;
+        if (path.compare(0, root.size(), root) == 0 &&
+            (path.size() == root.size() || path[root.size()] == '/')) {
+            released.push_back(wd);
+        }
+    }
+    for (int wd : released) {
+        watch_descriptors.erase(std::remove(watch_descriptors.begin(), watch_descriptors.end(), wd),
+                                watch_descriptors.end());
+        release_watch(wd, id);
+    }
+}
+
+void FileWatcher::release_watch(int wd, SubscriptionId id) {
+    auto it = watches_.find(wd);
+    if (it == watches_.end()) {
+        return;
+    }
+
+    auto& subscribers = it->second.subscribers;
+    subscribers.erase(std::remove(subscribers.begin(), subscribers.end(), id), subscribers.end());
+    if (subscribers.empty()) {
+        ::inotify_rm_watch(inotify_fd_, wd);
+        forget_watch(wd);
+    }
+}
+
+void FileWatcher::forget_watch(int wd) {
+    auto it = watches_.find(wd);
+    if (it == watches_.end()) {
+        return;
+    }
+    auto by_path = watch_by_path_.find(it->second.path);
+    if (by_path != watch_by_path_.end() && by_path->second == wd) {
+        watch_by_path_.erase(by_path);
+    }
+    watches_.erase(it);
+}
+
+void FileWatcher::update_polling() {
+    // An idle watcher keeps no active handle, so it never holds the loop open
+    if (!poll_handle_) {
+        return;
+    }
+    if (!subscriptions_.empty() && !polling_) {
+        uv_poll_start(poll_handle_, UV_READABLE, on_readable);
+        polling_ = true;
+    } else if (subscriptions_.empty() && polling_) {
+        uv_poll_stop(poll_handle_);
+        polling_ = false;
+    }
+}
+
+void FileWatcher::read_events() {
+    alignas(struct inotify_event) char buffer[64 * 1024];
+
+    for (;;) {
+        ssize_t length = ::read(inotify_fd_, buffer, sizeof(buffer));
+        if (length < 0 && errno == EINTR) {
+            continue;
+        }
+        if (length <= 0) {
+            break;
+        }
+
+        for (char* cursor = buffer; cursor < buffer + length;) {
+            auto* event = reinterpret_cast<struct inotify_event*>(cursor);
+            cursor += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                for (auto& [id, subscription] : subscriptions_) {
+                    queue_event(id, subscription.root, FileEventType::Overflow);
+                }
+                continue;
+            }
+
+            auto watch_it = watches_.find(event->wd);
+            if (watch_it == watches_.end()) {
+                continue;
+            }
+
+            // Copies: adding watches below may rehash the table
+            std::string watch_path = watch_it->second.path;
+            std::vector<SubscriptionId> subscribers = watch_it->second.subscribers;
+
+            if (event->mask & IN_IGNORED) {
+                for (SubscriptionId id : subscribers) {
+                    auto sub_it = subscriptions_.find(id);
+                    if (sub_it != subscriptions_.end()) {
+                        auto& wds = sub_it->second.watch_descriptors;
+                        wds.erase(std::remove(wds.begin(), wds.end(), event->wd), wds.end());
+                    }
+                }
+                forget_watch(event->wd);
+                continue;
+            }
+
+            std::string path = event->len > 0 ? join_path(watch_path, event->name) : watch_path;
+
+            FileEventType type;
+            if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                type = FileEventType::Created;
+            } else if (event->mask & (IN_DELETE | IN_MOVED_FROM | IN_DELETE_SELF | IN_MOVE_SELF)) {
+                type = FileEventType::Deleted;
+            } else {
+                type = FileEventType::Modified;
+            }
+
+            // A directory moved within the tree is picked up again by its
+            // IN_MOVED_TO, with fresh descriptors under the new path
+            bool new_directory = type == FileEventType::Created && (event->mask & IN_ISDIR);
+            bool moved_directory = (event->mask & IN_MOVED_FROM) && (event->mask & IN_ISDIR);
+            for (SubscriptionId id : subscribers) {
+                auto sub_it = subscriptions_.find(id);
+                if (sub_it == subscriptions_.end()) {
+                    continue;
+                }
+                queue_event(id, path, type);
+                if (!sub_it->second.options.recursive) {
+                    continue;
+                }
+                if (new_directory && add_watch(path, id) >= 0) {
+                    add_tree(path, id, true);
+                } else if (moved_directory && path != sub_it->second.root) {
+                    release_tree(path, id);
+                }
+            }
+        }
+    }
+
+    schedule_flush();
+}
+
+void FileWatcher::queue_event(SubscriptionId id, const std::string& path, FileEventType type) {
+    auto sub_it = subscriptions_.find(id);
+    if (sub_it == subscriptions_.end()) {
+        return;
+    }
+    Subscription& subscription = sub_it->second;
+
+    uint64_t now = uv_now(loop_);
+    if (subscription.pending.empty()) {
+        subscription.first_event_ms = now;
+    }
+    uint64_t debounce = subscription.options.debounce_ms;
+    subscription.deadline_ms = std::min(now + debounce, subscription.first_event_ms + debounce * kMaxDebounceFactor);
+
+    auto [it, inserted] = subscription.pending.try_emplace(path, PendingEvent{type, type == FileEventType::Created});
+    if (inserted) {
+        subscription.pending_order.push_back(path);
+        return;
+    }
+
+    // Coalesce with what is already pending for this path
+    PendingEvent& pending = it->second;
+    switch (type) {
+        case FileEventType::Created:
+            pending.type = pending.type == FileEventType::Deleted ? FileEventType::Modified : FileEventType::Created;
+            break;
+        case FileEventType::Modified:
+            if (pending.type != FileEventType::Created && pending.type != FileEventType::Overflow) {
+                pending.type = FileEventType::Modified;
+            }
+            break;
+        case FileEventType::Deleted:
+            if (pending.created_in_window) {
+                // Transient file: created and removed within one window
+                subscription.pending.erase(it);
+            } else {
+                pending.type = FileEventType::Deleted;
+            }
+            break;
+        case FileEventType::Overflow:
+            pending.type = FileEventType::Overflow;
+            break;
+    }
+}
+
+void FileWatcher::schedule_flush() {
+    if (!debounce_timer_) {
+        return;
+    }
+
+    uint64_t earliest = UINT64_MAX;
+    for (const auto& [id, subscription] : subscriptions_) {
+        if (!subscription.pending_order.empty()) {
+            earliest = std::min(earliest, subscription.deadline_ms);
+        }
+    }
+
+    if (earliest == UINT64_MAX) {
+        uv_timer_stop(debounce_timer_);
+        return;
+    }
+
+    uint64_t now = uv_now(loop_);
+    uv_timer_start(debounce_timer_, on_debounce_timer, earliest > now ? earliest - now : 0, 0);
+}
+
+void FileWatcher::flush_due() {
+    uint64_t now = uv_now(loop_);
+    std::vector<std::pair<SubscriptionId, std::vector<FileEvent>>> deliveries;
+
+    for (auto& [id, subscription] : subscriptions_) {
+        if (subscription.pending_order.empty() || subscription.deadline_ms > now) {
+            continue;
+        }
+
+        std::vector<FileEvent> events;
+        events.reserve(subscription.pending.size());
+        for (std::string& path : subscription.pending_order) {
+            auto it = subscription.pending.find(path);
+            if (it == subscription.pending.end()) {
+                continue;
+            }
+            events.push_back({it->second.type, std::move(path)});
+            subscription.pending.erase(it);
+        }
+        subscription.pending.clear();
+        subscription.pending_order.clear();
+
+        if (!events.empty()) {
+            deliveries.emplace_back(id, std::move(events));
+        }
+    }
+
+    // Callbacks may subscribe or unsubscribe, so look each one up again
+    for (auto& [id, events] : deliveries) {
+        auto it = subscriptions_.find(id);
+        if (it == subscriptions_.end()) {
+            continue;
+        }
+        Callback callback = it->second.callback;
+        callback(events);
+    }
+
+    schedule_flush();
+}
+
+void FileWatcher::on_readable(uv_poll_t* handle, int status, int events) {
+    auto* watcher = static_cast<FileWatcher*>(handle->data);
+    if (status < 0 || !(events & UV_READABLE)) {
+        return;
+    }
+    watcher->read_events();
+}
+
+void FileWatcher::on_debounce_timer(uv_timer_t* handle) {
+    static_cast<FileWatcher*>(handle->data)->flush_due();
+}
+
+} // namespace Nexus
@@ -0,0 +1,432 @@
+#include "fs_transaction.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <linux/fs.h>
+#include <map>
+#include <mutex>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Nexus {
+
+namespace {
+
+// Inodes shared between live files and hard-linked snapshots, counted per
+// transaction holding them
+std::mutex g_links_mutex;
+std::map<std::pair<dev_t, ino_t>, size_t> g_snapshot_links;
+
+std::string normalize(std::string path) {
+    while (path.size() > 1 && path.back() == '/') {
+        path.pop_back();
+    }
+    return path;
+}
+
+bool reflink_unsupported(int error) {
+    return error == EOPNOTSUPP || error == ENOTTY || error == EXDEV || error == EINVAL || error == ENOSYS;
+}
+
+std::string describe(const char* action, const std::string& path) {
+    return std::string(action) + " " + path + ": " + std::strerror(errno);
+}
+
+void copy_metadata(int fd, const struct stat& st) {
+    // Ownership only carries over for root; the mode and times always do
+    if (::fchown(fd, st.st_uid, st.st_gid) != 0) {
+        errno = 0;
+    }
+    ::fchmod(fd, st.st_mode & 07777);
+    struct timespec times[2] = {st.st_atim, st.st_mtim};
+    ::futimens(fd, times);
+}
+
+// copy_file_range() from the current offsets, then read/write for whatever
+// the filesystem would not copy in the kernel
+bool copy_contents(int in, int out) {
+    for (;;) {
+        ssize_t count = ::copy_file_range(in, nullptr, out, nullptr, 1 << 30, 0);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count == 0) {
+            return true;
+        }
+        if (count < 0) {
+            if (errno != ENOSYS && errno != EXDEV && errno != EINVAL && errno != EOPNOTSUPP) {
+                return false;
+            }
+            break;
+        }
+    }
+
+    char buffer[64 * 1024];
+    for (;;) {
+        ssize_t count = ::read(in, buffer, sizeof(buffer));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return count == 0;
+        }
+        for (ssize_t done = 0; done < count;) {
+            ssize_t written = ::write(out, buffer + done, static_cast<size_t>(count - done));
+            if (written < 0 && errno != EINTR) {
+                return false;
+            }
+            done += written > 0 ? written : 0;
+        }
+    }
+}
+
+int remove_entry(const char* path, const struct stat*, int type, struct FTW*) {
+    return type == FTW_DP ? ::rmdir(path) : ::unlink(path);
+}
+
+} // namespace
+
+FsTransaction::FsTransaction(uint64_t id, bool hardlink_snapshots)
+    : id_(id), hardlink_snapshots_(hardlink_snapshots) {
+}
+
+FsTransaction::~FsTransaction() {
+    if (state_ == State::Open) {
+        commit();
+    }
+    collect_garbage();
+    release_links();
+}
+
+bool FsTransaction::protect(const std::string& raw_path, std::string& error) {
+    if (state_ != State::Open) {
+        error = "Transaction is no longer open";
+        return false;
+    }
+    std::string path = normalize(raw_path);
+    size_t slash = path.rfind('/');
+    if (path.empty() || path == "/" || path == "." || path == ".." ||
+        path.compare(slash == std::string::npos ? 0 : slash + 1, std::string::npos, "..") == 0) {
+        error = "Cannot protect " + raw_path + ": name a file or directory by its path";
+        return false;
+    }
+    if (covered(path)) {
+        return true;
+    }
+
+    struct stat st;
+    if (::lstat(path.c_str(), &st) != 0) {
+        if (errno != ENOENT) {
+            error = describe("Cannot protect", path);
+            return false;
+        }
+        entries_.push_back({path, {}});
+        stats_.paths++;
+        return true;
+    }
+
+    std::string snapshot = sibling(path, "");
+    if (!capture(AT_FDCWD, path.c_str(), AT_FDCWD, snapshot.c_str(), st, error)) {
+        garbage_.push_back(std::move(snapshot));
+        collect_garbage();
+        return false;
+    }
+    entries_.push_back({path, std::move(snapshot)});
+    stats_.paths++;
+    return true;
+}
+
+bool FsTransaction::rollback(std::string& error) {
+    if (state_ != State::Open) {
+        error = "Transaction is no longer open";
+        return false;
+    }
+    state_ = State::RolledBack;
+
+    bool ok = true;
+    auto fail = [&](const char* action, const std::string& path) {
+        if (ok) {
+            error = describe(action, path);
+        }
+        ok = false;
+    };
+
+    for (auto it = entries_.rbegin(); it != entries_.rend(); ++it) {
+        struct stat st;
+        bool exists = ::lstat(it->path.c_str(), &st) == 0;
+
+        if (it->snapshot.empty()) {
+            // Created by the transaction: move it aside
+            if (exists) {
+                std::string trash = sibling(it->path, ".trash");
+                if (::rename(it->path.c_str(), trash.c_str()) == 0) {
+                    garbage_.push_back(std::move(trash));
+                } else {
+                    fail("Cannot remove", it->path);
+                }
+            }
+            continue;
+        }
+
+        if (!exists) {
+            if (::rename(it->snapshot.c_str(), it->path.c_str()) != 0) {
+                fail("Cannot restore", it->path);
+            }
+            continue;
+        }
+        // One atomic swap: the snapshot's name now holds the discarded state
+        if (::renameat2(AT_FDCWD, it->snapshot.c_str(), AT_FDCWD, it->path.c_str(), RENAME_EXCHANGE) == 0) {
+            garbage_.push_back(it->snapshot);
+            continue;
+        }
+        if (errno != EINVAL && errno != ENOSYS) {
+            fail("Cannot restore", it->path);
+            continue;
+        }
+        // Filesystem without RENAME_EXCHANGE: two renames, briefly absent
+        std::string trash = sibling(it->path, ".trash");
+        if (::rename(it->path.c_str(), trash.c_str()) != 0) {
+            fail("Cannot restore", it->path);
+            continue;
+        }
+        garbage_.push_back(std::move(trash));
+        if (::rename(it->snapshot.c_str(), it->path.c_str()) != 0) {
+            fail("Cannot restore", it->path);
+        }
+    }
+    entries_.clear();
+    return ok;
+}
+
+void FsTransaction::commit() {
+    if (state_ != State::Open) {
+        return;
+    }
+    state_ = State::Committed;
+    for (Entry& entry : entries_) {
+        if (!entry.snapshot.empty()) {
+            garbage_.push_back(std::move(entry.snapshot));
+        }
+    }
+    entries_.clear();
+}
+
+void FsTransaction::collect_garbage() {
+    for (const std::string& path : garbage_) {
+        ::nftw(path.c_str(), remove_entry, 64, FTW_DEPTH | FTW_PHYS);
+    }
+    garbage_.clear();
+    if (state_ != State::Open) {
+        release_links();
+    }
+}
+
+bool FsTransaction::break_snapshot_link(const std::string& path, mode_t& mode) {
+    struct stat st;
+    if (::lstat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode) || st.st_nlink < 2) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_links_mutex);
+        if (g_snapshot_links.find({st.st_dev, st.st_ino}) == g_snapshot_links.end()) {
+            return false;
+        }
+    }
+    if (::unlink(path.c_str()) != 0) {
+        return false;
+    }
+    mode = st.st_mode & 07777;
+    return true;
+}
+
+// Already inside a protected tree (or protected itself)
+bool FsTransaction::covered(const std::string& path) const {
+    for (const Entry& entry : entries_) {
+        if (path == entry.path ||
+            (path.size() > entry.path.size() && path.compare(0, entry.path.size(), entry.path) == 0 &&
+             path[entry.path.size()] == '/')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Hidden sibling in the same directory, so it is on the same filesystem;
+// the pid keeps concurrent shells apart
+std::string FsTransaction::sibling(const std::string& path, const char* suffix) const {
+    size_t slash = path.rfind('/');
+    std::string directory = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    return directory + "." + name + ".nexus-tx-" + std::to_string(::getpid()) + "-" +
+           std::to_string(id_) + "-" +
+           std::to_string(entries_.size()) + suffix;
+}
+
+bool FsTransaction::capture(int src_dir, const char* src_name, int dst_dir, const char* dst_name,
+                            const struct stat& st, std::string& error) {
+    if (S_ISREG(st.st_mode)) {
+        return capture_file(src_dir, src_name, dst_dir, dst_name, st, error);
+    }
+
+    if (S_ISLNK(st.st_mode)) {
+        std::string target(static_cast<size_t>(st.st_size) + 1, '\0');
+        ssize_t length = ::readlinkat(src_dir, src_name, target.data(), target.size());
+        if (length < 0) {
+            error = describe("Cannot read link", src_name);
+            return false;
+        }
+        target.resize(static_cast<size_t>(length));
+        if (::symlinkat(target.c_str(), dst_dir, dst_name) != 0) {
+            error = describe("Cannot snapshot link", src_name);
+            return false;
+        }
+        stats_.symlinks++;
+        return true;
+    }
+
+    if (S_ISFIFO(st.st_mode)) {
+        if (::mkfifoat(dst_dir, dst_name, st.st_mode & 07777) != 0) {
+            error = describe("Cannot snapshot", src_name);
+            return false;
+        }
+        return true;
+    }
+
+    if (!S_ISDIR(st.st_mode)) {
+        stats_.skipped++;
+        return true;
+    }
+
+    if (::mkdirat(dst_dir, dst_name, 0700) != 0) {
+        error = describe("Cannot create snapshot of", src_name);
+        return false;
+    }
+    int src_fd = ::openat(src_dir, src_name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    if (src_fd < 0) {
+        error = describe("Cannot open directory", src_name);
+        return false;
+    }
+    int dst_fd = ::openat(dst_dir, dst_name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    DIR* handle = dst_fd < 0 ? nullptr : ::fdopendir(src_fd);
+    if (!handle) {
+        error = describe("Cannot read directory", src_name);
+        ::close(src_fd);
+        if (dst_fd >= 0) {
+            ::close(dst_fd);
+        }
+        return false;
+    }
+
+    bool ok = true;
+    while (struct dirent* entry = ::readdir(handle)) {
+        const char* name = entry->d_name;
+        if (std::strcmp(name, ".") == 0 || std::strcmp(name, "..") == 0) {
+            continue;
+        }
+        struct stat child;
+        if (::fstatat(src_fd, name, &child, AT_SYMLINK_NOFOLLOW) != 0) {
+            continue;       // Vanished while we were reading
+        }
+        if (!capture(src_fd, name, dst_fd, name, child, error)) {
+            ok = false;
+            break;
+        }
+    }
+    ::closedir(handle);
+
+    // After the children, so creating them does not reset the times
+    copy_metadata(dst_fd, st);
+    ::close(dst_fd);
+    stats_.directories++;
+    return ok;
+}
+
+bool FsTransaction::capture_file(int src_dir, const char* src_name, int dst_dir, const char* dst_name,
+                                 const struct stat& st, std::string& error) {
+    bool try_reflink = true;
+    for (dev_t device : no_reflink_devices_) {
+        try_reflink = try_reflink && device != st.st_dev;
+    }
+
+    if (try_reflink) {
+        int in = ::openat(src_dir, src_name, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+        if (in < 0) {
+            error = describe("Cannot open", src_name);
+            return false;
+        }
+        int out = ::openat(dst_dir, dst_name, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        if (out < 0) {
+            error = describe("Cannot create snapshot of", src_name);
+            ::close(in);
+            return false;
+        }
+        if (::ioctl(out, FICLONE, in) == 0) {
+            copy_metadata(out, st);
+            ::close(in);
+            ::close(out);
+            stats_.reflinked++;
+            return true;
+        }
+        int clone_error = errno;
+        ::close(in);
+        ::close(out);
+        ::unlinkat(dst_dir, dst_name, 0);
+        if (!reflink_unsupported(clone_error)) {
+            errno = clone_error;
+            error = describe("Cannot clone", src_name);
+            return false;
+        }
+        // Do not ask again for every file of a large tree
+        no_reflink_devices_.push_back(st.st_dev);
+    }
+
+    // Shares the inode, so in-place writes would reach the snapshot: opt-in
+    if (hardlink_snapshots_ && ::linkat(src_dir, src_name, dst_dir, dst_name, 0) == 0) {
+        {
+            std::lock_guard<std::mutex> lock(g_links_mutex);
+            g_snapshot_links[{st.st_dev, st.st_ino}]++;
+        }
+        linked_.emplace_back(st.st_dev, st.st_ino);
+        stats_.hardlinked++;
+        return true;
+    }
+
+    // Copy, letting the kernel do it and share extents where it can; also
+    // where links are refused (fs.protected_hardlinks, foreign files)
+    int in = ::openat(src_dir, src_name, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    int out = in < 0 ? -1 : ::openat(dst_dir, dst_name, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    bool ok = out >= 0 && copy_contents(in, out);
+    if (ok) {
+        copy_metadata(out, st);
+        stats_.copied++;
+    } else {
+        error = describe("Cannot snapshot", src_name);
+    }
+    if (in >= 0) {
+        ::close(in);
+    }
+    if (out >= 0) {
+        ::close(out);
+    }
+    return ok;
+}
+
+void FsTransaction::release_links() {
+    if (linked_.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_links_mutex);
+    for (const auto& key : linked_) {
+        auto it = g_snapshot_links.find(key);
+        if (it != g_snapshot_links.end() && --it->second == 0) {
+            g_snapshot_links.erase(it);
+        }
+    }
+    linked_.clear();
+}
+
+} // namespace Nexus
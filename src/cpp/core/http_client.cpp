@@ -0,0 +1,933 @@
+#include "http_client.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Nexus {
+
+namespace {
+
+constexpr size_t kMaxHeadSize = 64 * 1024;
+constexpr size_t kMaxLineSize = 8 * 1024;
+constexpr int kMaxAttempts = 2;
+
+// Safe to pipeline behind other requests
+bool is_pipelinable(const std::string& method) {
+    return method == "GET" || method == "HEAD";
+}
+
+// Safe to resend when a reused connection was already closed
+bool is_idempotent(const std::string& method) {
+    return is_pipelinable(method) || method == "PUT" || method == "DELETE" || method == "OPTIONS";
+}
+
+std::string to_lower(std::string text) {
+    for (char& c : text) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+    return text;
+}
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+bool contains_line_break(const std::string& text) {
+    return text.find_first_of("\r\n") != std::string::npos;
+}
+
+// Spaces and control characters would end the request line early
+bool valid_target(const std::string& target) {
+    return !target.empty() && std::none_of(target.begin(), target.end(), [](char c) {
+        return static_cast<unsigned char>(c) <= 0x20 || c == 0x7f;
+    });
+}
+
+// Digits only; anything else leaves the body length unknown
+bool parse_content_length(const std::string& text, uint64_t& length) {
+    if (text.empty() || text.size() > 19) {
+        return false;
+    }
+    length = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        length = length * 10 + static_cast<uint64_t>(c - '0');
+    }
+    return true;
+}
+
+} // namespace
+
+enum class BodyMode { None, Length, Chunked, UntilClose };
+enum class ParseState { Head, Body, ChunkSize, ChunkData, ChunkDataEnd, Trailers };
+
+struct RequestTimer {
+    uv_timer_t handle;
+    HttpClient* client;
+    HttpClient::RequestId id;
+};
+
+struct HttpClient::Exchange {
+    RequestId id = 0;
+    Request request;
+    HostPool* pool = nullptr;
+    Connection* connection = nullptr;
+    RequestTimer* timer = nullptr;
+    std::string wire;               // Serialized request, kept for retries
+    int attempts = 0;
+    bool needs_fresh_connection = false;    // Set when retrying after a dropped connection
+    bool head_delivered = false;
+    bool finished = false;
+};
+
+struct HttpClient::HostPool {
+    HttpClient* client = nullptr;   // Cleared on shutdown while a lookup is pending
+    std::string key;
+    std::string host;
+    uint16_t port = 80;
+    std::vector<Connection*> connections;
+    std::deque<std::shared_ptr<Exchange>> queue;
+    bool resolving = false;
+    bool resolved = false;
+    sockaddr_storage address{};
+};
+
+struct HttpClient::Connection {
+    HttpClient* client = nullptr;
+    HostPool* pool = nullptr;
+    uv_tcp_t tcp;
+    uv_connect_t connect_req;
+    uv_timer_t idle_timer;
+    int open_handles = 0;
+    bool connected = false;
+    bool closing = false;
+    bool paused = false;
+    bool reusable = true;
+    uint64_t completed_responses = 0;
+    std::deque<std::shared_ptr<Exchange>> in_flight;    // Front owns the response being parsed
+
+    // Response parser state
+    ParseState state = ParseState::Head;
+    BodyMode mode = BodyMode::None;
+    uint64_t remaining = 0;
+    std::string line;               // Head or chunk-size line being accumulated
+    HttpResponseHead head;
+
+    char read_buffer[64 * 1024];
+};
+
+struct WriteRequest {
+    uv_write_t req;
+    std::shared_ptr<void> keep_alive;   // Exchange owning the written bytes
+};
+
+struct ResolveRequest {
+    uv_getaddrinfo_t req;
+    std::shared_ptr<void> pool;
+};
+
+bool HttpUrl::parse(const std::string& url, HttpUrl& out, std::string& error) {
+    // Parts of the URL are copied into the request line and Host header
+    if (!valid_target(url)) {
+        error = "Invalid URL (whitespace or control characters): " + url;
+        return false;
+    }
+    size_t scheme_end = url.find("://");
+    if (scheme_end == std::string::npos) {
+        error = "Invalid URL: " + url;
+        return false;
+    }
+    out.scheme = to_lower(url.substr(0, scheme_end));
+    if (out.scheme == "https") {
+        error = "https:// URLs are not supported (no TLS backend)";
+        return false;
+    }
+    if (out.scheme != "http") {
+        error = "Unsupported URL scheme: " + out.scheme;
+        return false;
+    }
+
+    size_t authority_begin = scheme_end + 3;
+    size_t authority_end = url.find_first_of("/?#", authority_begin);
+    std::string authority = url.substr(authority_begin, authority_end == std::string::npos
+                                                            ? std::string::npos
+                                                            : authority_end - authority_begin);
+    size_t at = authority.rfind('@');
+    if (at != std::string::npos) {
+        authority.erase(0, at + 1);
+    }
+
+    std::string port;
+    if (!authority.empty() && authority[0] == '[') {
+        size_t close = authority.find(']');
+        if (close == std::string::npos) {
+            error = "Invalid URL: " + url;
+            return false;
+        }
+        out.host = authority.substr(1, close - 1);
+        if (close + 1 < authority.size() && authority[close + 1] == ':') {
+            port = authority.substr(close + 2);
+        }
+    } else {
+        size_t colon = authority.rfind(':');
+        out.host = authority.substr(0, colon);
+        if (colon != std::string::npos) {
+            port = authority.substr(colon + 1);
+        }
+    }
+    if (out.host.empty()) {
+        error = "Invalid URL: " + url;
+        return false;
+    }
+
+    out.port = 80;
+    if (!port.empty()) {
+        unsigned long value = 0;
+        for (char c : port) {
+            if (c < '0' || c > '9' || (value = value * 10 + static_cast<unsigned long>(c - '0')) > 65535) {
+                error = "Invalid port in URL: " + url;
+                return false;
+            }
+        }
+        out.port = static_cast<uint16_t>(value);
+    }
+
+    if (authority_end == std::string::npos) {
+        out.target = "/";
+    } else {
+        size_t fragment = url.find('#', authority_end);
+        out.target = url.substr(authority_end, fragment == std::string::npos ? std::string::npos
+                                                                            : fragment - authority_end);
+        if (out.target.empty() || out.target[0] != '/') {
+            out.target.insert(0, "/");
+        }
+    }
+    return true;
+}
+
+std::string HttpUrl::origin() const {
+    bool ipv6 = host.find(':') != std::string::npos;
+    std::string authority = ipv6 ? "[" + host + "]" : host;
+    return port == 80 ? authority : authority + ":" + std::to_string(port);
+}
+
+const std::string* HttpResponseHead::header(const std::string& lowercase_name) const {
+    for (const auto& [name, value] : headers) {
+        if (name == lowercase_name) {
+            return &value;
+        }
+    }
+    return nullptr;
+}
+
+HttpClient::HttpClient(uv_loop_t* loop) : HttpClient(loop, Options{}) {}
+
+HttpClient::HttpClient(uv_loop_t* loop, const Options& options) : loop_(loop), options_(options) {
+    options_.max_connections_per_host = std::max<size_t>(1, options_.max_connections_per_host);
+    options_.max_pipeline_depth = std::max<size_t>(1, options_.max_pipeline_depth);
+}
+
+HttpClient::~HttpClient() {
+    shutdown();
+}
+
+// RFC 9110 token characters
+bool HttpClient::valid_method(const std::string& method) {
+    return !method.empty() && std::all_of(method.begin(), method.end(), [](char c) {
+        return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+               std::strchr("!#$%&'*+-.^_`|~", c) != nullptr;
+    });
+}
+
+HttpClient::RequestId HttpClient::send(Request request) {
+    // Anything else could smuggle headers or a second request onto a
+    // shared, pipelined connection
+    if (shut_down_ || !valid_method(request.method) || !valid_target(request.url.target) ||
+        contains_line_break(request.url.host)) {
+        return 0;
+    }
+
+    auto exchange = std::make_shared<Exchange>();
+    exchange->id = next_request_id_++;
+
+    // Serialize once; headers with embedded line breaks are dropped
+    std::string& wire = exchange->wire;
+    wire.reserve(256 + request.body.size());
+    wire += request.method + " " + request.url.target + " HTTP/1.1\r\n";
+    bool has_host = false, has_length = false, has_agent = false;
+    for (const auto& [name, value] : request.headers) {
+        if (contains_line_break(name) || contains_line_break(value)) {
+            continue;
+        }
+        std::string lower = to_lower(name);
+        has_host |= lower == "host";
+        has_length |= lower == "content-length" || lower == "transfer-encoding";
+        has_agent |= lower == "user-agent";
+        wire += name + ": " + value + "\r\n";
+    }
+    if (!has_host) {
+        wire += "Host: " + request.url.origin() + "\r\n";
+    }
+    if (!has_agent) {
+        wire += "User-Agent: NexusShell\r\n";
+    }
+    if (!has_length && (!request.body.empty() || request.method == "POST" || request.method == "PUT" ||
+                        request.method == "PATCH")) {
+        wire += "Content-Length: " + std::to_string(request.body.size()) + "\r\n";
+    }
+    wire += "\r\n";
+    wire += request.body;
+
+    std::string key = request.url.host + ":" + std::to_string(request.url.port);
+    std::shared_ptr<HostPool>& pool = pools_[key];
+    if (!pool) {
+        pool = std::make_shared<HostPool>();
+        pool->client = this;
+        pool->key = key;
+        pool->host = request.url.host;
+        pool->port = request.url.port;
+    }
+    exchange->pool = pool.get();
+
+    if (request.timeout_ms > 0) {
+        auto* timer = new RequestTimer{{}, this, exchange->id};
+        uv_timer_init(loop_, &timer->handle);
+        timer->handle.data = timer;
+        uv_timer_start(&timer->handle, on_request_timeout, request.timeout_ms, 0);
+        exchange->timer = timer;
+    }
+
+    exchange->request = std::move(request);
+    exchanges_[exchange->id] = exchange;
+    pool->queue.push_back(exchange);
+    dispatch(*pool);
+    return exchange->id;
+}
+
+void HttpClient::cancel(RequestId id) {
+    auto it = exchanges_.find(id);
+    if (it != exchanges_.end()) {
+        std::shared_ptr<Exchange> exchange = it->second;
+        abort(exchange, "Request cancelled");
+    }
+}
+
+void HttpClient::pause(RequestId id) {
+    auto it = exchanges_.find(id);
+    if (it == exchanges_.end() || !it->second->connection) {
+        return;
+    }
+    Connection& connection = *it->second->connection;
+    if (connection.connected && !connection.closing && !connection.paused) {
+        uv_read_stop(reinterpret_cast<uv_stream_t*>(&connection.tcp));
+        connection.paused = true;
+    }
+}
+
+void HttpClient::resume(RequestId id) {
+    auto it = exchanges_.find(id);
+    if (it == exchanges_.end() || !it->second->connection) {
+        return;
+    }
+    Connection& connection = *it->second->connection;
+    if (connection.paused && !connection.closing) {
+        uv_read_start(reinterpret_cast<uv_stream_t*>(&connection.tcp), on_alloc, on_read);
+        connection.paused = false;
+    }
+}
+
+void HttpClient::shutdown() {
+    shut_down_ = true;
+
+    for (auto& [id, exchange] : exchanges_) {
+        exchange->finished = true;
+        exchange->request.on_head = nullptr;
+        exchange->request.on_body = nullptr;
+        exchange->request.on_complete = nullptr;
+        if (exchange->timer) {
+            uv_close(reinterpret_cast<uv_handle_t*>(&exchange->timer->handle), [](uv_handle_t* handle) {
+                delete static_cast<RequestTimer*>(handle->data);
+            });
+            exchange->timer = nullptr;
+        }
+    }
+    exchanges_.clear();
+
+    for (auto& [key, pool] : pools_) {
+        pool->client = nullptr;
+        pool->queue.clear();
+        std::vector<Connection*> connections = pool->connections;
+        for (Connection* connection : connections) {
+            connection->in_flight.clear();
+            close_connection(*connection);
+        }
+    }
+    pools_.clear();
+}
+
+void HttpClient::dispatch(HostPool& pool) {
+    while (!pool.queue.empty()) {
+        const std::shared_ptr<Exchange>& next = pool.queue.front();
+        Connection* target = nullptr;
+
+        // Prefer an idle keep-alive connection
+        for (Connection* connection : pool.connections) {
+            if (next->needs_fresh_connection) {
+                break;
+            }
+            if (connection->connected && !connection->closing && connection->in_flight.empty()) {
+                target = connection;
+                break;
+            }
+        }
+
+        // Otherwise pipeline behind other safe requests
+        if (!target && !next->needs_fresh_connection && is_pipelinable(next->request.method)) {
+            for (Connection* connection : pool.connections) {
+                if (!connection->connected || connection->closing || !connection->reusable ||
+                    connection->in_flight.size() >= options_.max_pipeline_depth) {
+                    continue;
+                }
+                bool all_pipelinable = std::all_of(connection->in_flight.begin(), connection->in_flight.end(),
+                    [](const std::shared_ptr<Exchange>& queued) { return is_pipelinable(queued->request.method); });
+                if (all_pipelinable && (!target || connection->in_flight.size() < target->in_flight.size())) {
+                    target = connection;
+                }
+            }
+        }
+
+        if (!target && pool.connections.size() < options_.max_connections_per_host) {
+            if (!pool.resolved) {
+                resolve(pools_.at(pool.key));
+                return;
+            }
+            target = open_connection(pool);
+            if (!target) {
+                pool.resolved = false;
+                fail_pool(pool, "Cannot connect to " + pool.host);
+                return;
+            }
+        }
+
+        if (!target) {
+            return;
+        }
+
+        std::shared_ptr<Exchange> exchange = next;
+        pool.queue.pop_front();
+        exchange->connection = target;
+        ++exchange->attempts;
+        target->in_flight.push_back(exchange);
+
+        uv_timer_stop(&target->idle_timer);
+        uv_ref(reinterpret_cast<uv_handle_t*>(&target->tcp));
+        // A connecting socket sends its request once connected
+        if (target->connected) {
+            write_request(*target, exchange);
+        }
+    }
+}
+
+void HttpClient::resolve(const std::shared_ptr<HostPool>& pool) {
+    if (pool->resolving) {
+        return;
+    }
+    pool->resolving = true;
+
+    auto* request = new ResolveRequest{{}, pool};
+    request->req.data = request;
+
+    struct addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    std::string port = std::to_string(pool->port);
+
+    int status = uv_getaddrinfo(loop_, &request->req, on_resolved, pool->host.c_str(), port.c_str(), &hints);
+    if (status != 0) {
+        pool->resolving = false;
+        delete request;
+        fail_pool(*pool, "Cannot resolve " + pool->host + ": " + uv_strerror(status));
+    }
+}
+
+HttpClient::Connection* HttpClient::open_connection(HostPool& pool) {
+    auto* connection = new Connection;
+    connection->client = this;
+    connection->pool = &pool;
+    connection->tcp.data = connection;
+    connection->idle_timer.data = connection;
+    connection->connect_req.data = connection;
+
+    uv_tcp_init(loop_, &connection->tcp);
+    uv_timer_init(loop_, &connection->idle_timer);
+    connection->open_handles = 2;
+    uv_tcp_nodelay(&connection->tcp, 1);
+
+    int status = uv_tcp_connect(&connection->connect_req, &connection->tcp,
+                                reinterpret_cast<const sockaddr*>(&pool.address), on_connect);
+    pool.connections.push_back(connection);
+    if (status != 0) {
+        close_connection(*connection);
+        return nullptr;
+    }
+    ++connections_opened_;
+    return connection;
+}
+
+void HttpClient::write_request(Connection& connection, const std::shared_ptr<Exchange>& exchange) {
+    auto* write = new WriteRequest{{}, exchange};
+    write->req.data = write;
+    uv_buf_t buffer = uv_buf_init(exchange->wire.data(), static_cast<unsigned int>(exchange->wire.size()));
+
+    ++requests_sent_;
+    if (connection.completed_responses > 0 || connection.in_flight.size() > 1) {
+        ++connections_reused_;
+    }
+
+    int status = uv_write(&write->req, reinterpret_cast<uv_stream_t*>(&connection.tcp), &buffer, 1, on_write);
+    if (status != 0) {
+        delete write;
+        connection_failed(connection, std::string("Write failed: ") + uv_strerror(status));
+    }
+}
+
+void HttpClient::consume(Connection& connection, const char* data, size_t length) {
+    while (length > 0 && !connection.closing) {
+        if (connection.in_flight.empty()) {
+            connection_failed(connection, "Unexpected data from server");
+            return;
+        }
+        const std::shared_ptr<Exchange> exchange = connection.in_flight.front();
+
+        switch (connection.state) {
+            case ParseState::Head: {
+                size_t search_from = connection.line.size() > 3 ? connection.line.size() - 3 : 0;
+                connection.line.append(data, length);
+                size_t end = connection.line.find("\r\n\r\n", search_from);
+                if (end == std::string::npos) {
+                    if (connection.line.size() > kMaxHeadSize) {
+                        connection_failed(connection, "Response head too large");
+                    }
+                    return;
+                }
+
+                // Bytes past the head belong to the body (or the next response)
+                size_t excess = connection.line.size() - (end + 4);
+                data += length - excess;
+                length = excess;
+                connection.line.resize(end + 2);
+
+                if (!parse_head(connection)) {
+                    connection_failed(connection, "Malformed HTTP response");
+                    return;
+                }
+                connection.line.clear();
+
+                int status = connection.head.status;
+                if (status >= 100 && status < 200) {
+                    connection.head = HttpResponseHead{};
+                    break;
+                }
+
+                exchange->head_delivered = true;
+                if (exchange->request.on_head) {
+                    exchange->request.on_head(connection.head);
+                }
+                if (connection.closing || exchange->finished) {
+                    return;
+                }
+                switch (connection.mode) {
+                    case BodyMode::None:
+                        complete_front(connection);
+                        break;
+                    case BodyMode::Chunked:
+                        connection.state = ParseState::ChunkSize;
+                        break;
+                    default:
+                        connection.state = ParseState::Body;
+                        break;
+                }
+                break;
+            }
+
+            case ParseState::Body:
+            case ParseState::ChunkData: {
+                bool bounded = connection.state == ParseState::ChunkData || connection.mode == BodyMode::Length;
+                size_t count = bounded ? static_cast<size_t>(std::min<uint64_t>(connection.remaining, length)) : length;
+                if (count > 0 && exchange->request.on_body) {
+                    exchange->request.on_body(data, count);
+                }
+                data += count;
+                length -= count;
+                if (connection.closing || exchange->finished) {
+                    return;
+                }
+                if (bounded && (connection.remaining -= count) == 0) {
+                    if (connection.state == ParseState::ChunkData) {
+                        connection.state = ParseState::ChunkDataEnd;
+                    } else {
+                        complete_front(connection);
+                    }
+                }
+                break;
+            }
+
+            case ParseState::ChunkSize:
+            case ParseState::ChunkDataEnd:
+            case ParseState::Trailers: {
+                const char* newline = static_cast<const char*>(std::memchr(data, '\n', length));
+                size_t count = newline ? static_cast<size_t>(newline - data) + 1 : length;
+                connection.line.append(data, count);
+                data += count;
+                length -= count;
+                if (!newline) {
+                    if (connection.line.size() > kMaxLineSize) {
+                        connection_failed(connection, "Malformed chunked encoding");
+                    }
+                    break;
+                }
+
+                std::string line = trim(connection.line.substr(0, connection.line.size() - 1));
+                connection.line.clear();
+
+                if (connection.state == ParseState::ChunkDataEnd) {
+                    connection.state = ParseState::ChunkSize;
+                } else if (connection.state == ParseState::Trailers) {
+                    if (line.empty()) {
+                        complete_front(connection);
+                    }
+                } else {
+                    char* parse_end = nullptr;
+                    unsigned long long size = std::strtoull(line.c_str(), &parse_end, 16);
+                    if (parse_end == line.c_str()) {
+                        connection_failed(connection, "Malformed chunked encoding");
+                        return;
+                    }
+                    if (size == 0) {
+                        connection.state = ParseState::Trailers;
+                    } else {
+                        connection.remaining = size;
+                        connection.state = ParseState::ChunkData;
+                    }
+                }
+                break;
+            }
+        }
+    }
+}
+
+bool HttpClient::parse_head(Connection& connection) {
+    HttpResponseHead& head = connection.head;
+    head = HttpResponseHead{};
+    const std::string& text = connection.line;
+
+    size_t line_end = text.find("\r\n");
+    std::string status_line = text.substr(0, line_end);
+    if (status_line.compare(0, 7, "HTTP/1.") != 0 || status_line.size() < 12) {
+        return false;
+    }
+    head.version_minor = status_line[7] - '0';
+    head.status = std::atoi(status_line.c_str() + 9);
+    if (head.status < 100 || head.status > 999) {
+        return false;
+    }
+    head.reason = status_line.size() > 13 ? status_line.substr(13) : "";
+
+    for (size_t begin = line_end + 2; begin < text.size();) {
+        size_t end = text.find("\r\n", begin);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        size_t colon = text.find(':', begin);
+        if (colon != std::string::npos && colon < end) {
+            head.headers.emplace_back(to_lower(text.substr(begin, colon - begin)),
+                                      trim(text.substr(colon + 1, end - colon - 1)));
+        }
+        begin = end + 2;
+    }
+
+    const std::string* connection_header = head.header("connection");
+    std::string connection_value = connection_header ? to_lower(*connection_header) : "";
+    connection.reusable = head.version_minor >= 1
+        ? connection_value.find("close") == std::string::npos
+        : connection_value.find("keep-alive") != std::string::npos;
+
+    const std::string& method = connection.in_flight.front()->request.method;
+    const std::string* transfer_encoding = head.header("transfer-encoding");
+    const std::string* content_length = head.header("content-length");
+    connection.remaining = 0;
+
+    if (method == "HEAD" || head.status < 200 || head.status == 204 || head.status == 304) {
+        connection.mode = BodyMode::None;
+    } else if (transfer_encoding && to_lower(*transfer_encoding).find("chunked") != std::string::npos) {
+        connection.mode = BodyMode::Chunked;
+    } else if (content_length) {
+        if (!parse_content_length(*content_length, connection.remaining)) {
+            return false;
+        }
+        connection.mode = connection.remaining > 0 ? BodyMode::Length : BodyMode::None;
+    } else {
+        connection.mode = BodyMode::UntilClose;
+        connection.reusable = false;
+    }
+    return true;
+}
+
+void HttpClient::complete_front(Connection& connection) {
+    std::shared_ptr<Exchange> exchange = connection.in_flight.front();
+    connection.in_flight.pop_front();
+    exchange->connection = nullptr;
+    ++connection.completed_responses;
+
+    connection.state = ParseState::Head;
+    connection.mode = BodyMode::None;
+    connection.line.clear();
+
+    // A pause only applies to the response that requested it
+    if (connection.paused) {
+        uv_read_start(reinterpret_cast<uv_stream_t*>(&connection.tcp), on_alloc, on_read);
+        connection.paused = false;
+    }
+
+    HostPool& pool = *connection.pool;
+    if (!connection.reusable) {
+        connection_failed(connection, "Connection closed by server");
+    }
+
+    finish(exchange, "");
+    if (connection.closing) {
+        dispatch(pool);
+        return;
+    }
+    if (connection.in_flight.empty()) {
+        make_idle(connection);
+    }
+    dispatch(pool);
+}
+
+void HttpClient::connection_failed(Connection& connection, const std::string& error) {
+    std::deque<std::shared_ptr<Exchange>> exchanges = std::move(connection.in_flight);
+    connection.in_flight.clear();
+    HostPool& pool = *connection.pool;
+    close_connection(connection);
+
+    // Requests the server never answered are resent once on a fresh connection
+    std::vector<std::shared_ptr<Exchange>> failed;
+    for (auto it = exchanges.rbegin(); it != exchanges.rend(); ++it) {
+        const std::shared_ptr<Exchange>& exchange = *it;
+        exchange->connection = nullptr;
+        if (exchange->finished) {
+            continue;
+        }
+        if (!exchange->head_delivered && exchange->attempts < kMaxAttempts &&
+            is_idempotent(exchange->request.method)) {
+            exchange->needs_fresh_connection = true;
+            pool.queue.push_front(exchange);
+        } else {
+            failed.push_back(exchange);
+        }
+    }
+
+    for (auto it = failed.rbegin(); it != failed.rend(); ++it) {
+        finish(*it, error);
+    }
+    if (!shut_down_) {
+        dispatch(pool);
+    }
+}
+
+void HttpClient::close_connection(Connection& connection) {
+    if (connection.closing) {
+        return;
+    }
+    connection.closing = true;
+
+    auto& connections = connection.pool->connections;
+    connections.erase(std::remove(connections.begin(), connections.end(), &connection), connections.end());
+
+    auto on_close = [](uv_handle_t* handle) {
+        auto* closed = static_cast<Connection*>(handle->data);
+        if (--closed->open_handles == 0) {
+            delete closed;
+        }
+    };
+    uv_close(reinterpret_cast<uv_handle_t*>(&connection.tcp), on_close);
+    uv_close(reinterpret_cast<uv_handle_t*>(&connection.idle_timer), on_close);
+}
+
+void HttpClient::make_idle(Connection& connection) {
+    // Idle pooled sockets must not keep the event loop alive
+    uv_timer_start(&connection.idle_timer, on_idle_timeout, options_.idle_timeout_ms, 0);
+    uv_unref(reinterpret_cast<uv_handle_t*>(&connection.idle_timer));
+    uv_unref(reinterpret_cast<uv_handle_t*>(&connection.tcp));
+}
+
+void HttpClient::finish(const std::shared_ptr<Exchange>& exchange, const std::string& error) {
+    if (exchange->finished) {
+        return;
+    }
+    exchange->finished = true;
+    exchanges_.erase(exchange->id);
+
+    if (exchange->timer) {
+        uv_close(reinterpret_cast<uv_handle_t*>(&exchange->timer->handle), [](uv_handle_t* handle) {
+            delete static_cast<RequestTimer*>(handle->data);
+        });
+        exchange->timer = nullptr;
+    }
+
+    auto on_complete = std::move(exchange->request.on_complete);
+    exchange->request.on_head = nullptr;
+    exchange->request.on_body = nullptr;
+    exchange->request.on_complete = nullptr;
+    if (on_complete) {
+        on_complete(error);
+    }
+}
+
+void HttpClient::abort(const std::shared_ptr<Exchange>& exchange, const std::string& error) {
+    if (exchange->finished) {
+        return;
+    }
+
+    if (Connection* connection = exchange->connection) {
+        // The response stream cannot be skipped mid-pipeline: drop the socket
+        auto& in_flight = connection->in_flight;
+        in_flight.erase(std::remove(in_flight.begin(), in_flight.end(), exchange), in_flight.end());
+        exchange->connection = nullptr;
+        finish(exchange, error);
+        connection_failed(*connection, error);
+        return;
+    }
+
+    auto& queue = exchange->pool->queue;
+    queue.erase(std::remove(queue.begin(), queue.end(), exchange), queue.end());
+    finish(exchange, error);
+}
+
+void HttpClient::fail_pool(HostPool& pool, const std::string& error) {
+    std::deque<std::shared_ptr<Exchange>> queue = std::move(pool.queue);
+    pool.queue.clear();
+    for (const auto& exchange : queue) {
+        finish(exchange, error);
+    }
+}
+
+void HttpClient::on_resolved(uv_getaddrinfo_t* req, int status, struct addrinfo* result) {
+    auto* request = static_cast<ResolveRequest*>(req->data);
+    auto pool = std::static_pointer_cast<HostPool>(request->pool);
+    delete request;
+
+    pool->resolving = false;
+    HttpClient* client = pool->client;
+    if (!client) {
+        uv_freeaddrinfo(result);
+        return;
+    }
+
+    if (status != 0 || !result) {
+        uv_freeaddrinfo(result);
+        client->fail_pool(*pool, "Cannot resolve " + pool->host + ": " + uv_strerror(status));
+        return;
+    }
+
+    std::memcpy(&pool->address, result->ai_addr, result->ai_addrlen);
+    pool->resolved = true;
+    uv_freeaddrinfo(result);
+    client->dispatch(*pool);
+}
+
+void HttpClient::on_connect(uv_connect_t* req, int status) {
+    auto* connection = static_cast<Connection*>(req->data);
+    if (connection->closing) {
+        return;
+    }
+    HttpClient* client = connection->client;
+
+    if (status != 0) {
+        connection->pool->resolved = false;
+        client->connection_failed(*connection, "Cannot connect to " + connection->pool->host + ": " +
+                                               uv_strerror(status));
+        return;
+    }
+
+    connection->connected = true;
+    uv_read_start(reinterpret_cast<uv_stream_t*>(&connection->tcp), on_alloc, on_read);
+    std::deque<std::shared_ptr<Exchange>> pending = connection->in_flight;
+    for (const auto& exchange : pending) {
+        if (connection->closing) {
+            break;
+        }
+        client->write_request(*connection, exchange);
+    }
+    if (!connection->closing) {
+        client->dispatch(*connection->pool);
+    }
+}
+
+// Each connection reads into its own fixed buffer; libuv's size hint is not needed
+void HttpClient::on_alloc(uv_handle_t* handle, size_t, uv_buf_t* buf) {
+    auto* connection = static_cast<Connection*>(handle->data);
+    *buf = uv_buf_init(connection->read_buffer, sizeof(connection->read_buffer));
+}
+
+void HttpClient::on_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+    auto* connection = static_cast<Connection*>(stream->data);
+    if (connection->closing) {
+        return;
+    }
+    HttpClient* client = connection->client;
+
+    if (nread > 0) {
+        client->consume(*connection, buf->base, static_cast<size_t>(nread));
+        return;
+    }
+    if (nread < 0) {
+        // A close-delimited body ends with the connection
+        if (connection->state == ParseState::Body && connection->mode == BodyMode::UntilClose &&
+            !connection->in_flight.empty()) {
+            client->complete_front(*connection);
+        }
+        if (!connection->closing) {
+            client->connection_failed(*connection, nread == UV_EOF ? "Connection closed by server"
+                                                                   : std::string("Read failed: ") + uv_strerror(nread));
+        }
+    }
+}
+
+void HttpClient::on_write(uv_write_t* req, int status) {
+    auto* write = static_cast<WriteRequest*>(req->data);
+    auto* connection = static_cast<Connection*>(req->handle->data);
+    delete write;
+
+    if (status != 0 && !connection->closing) {
+        connection->client->connection_failed(*connection, std::string("Write failed: ") + uv_strerror(status));
+    }
+}
+
+void HttpClient::on_idle_timeout(uv_timer_t* timer) {
+    auto* connection = static_cast<Connection*>(timer->data);
+    if (connection->in_flight.empty()) {
+        connection->client->close_connection(*connection);
+    }
+}
+
+void HttpClient::on_request_timeout(uv_timer_t* timer) {
+    auto* request_timer = static_cast<RequestTimer*>(timer->data);
+    HttpClient* client = request_timer->client;
+    auto it = client->exchanges_.find(request_timer->id);
+    if (it != client->exchanges_.end()) {
+        std::shared_ptr<Exchange> exchange = it->second;
+        client->abort(exchange, "Request timed out");
+    }
+}
+
+} // namespace Nexus
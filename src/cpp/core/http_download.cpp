@@ -0,0 +1,407 @@
+#include "http_download.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Nexus {
+
+namespace {
+
+constexpr int kMaxRedirects = 5;
+
+bool is_redirect(int status) {
+    return status == 301 || status == 302 || status == 303 || status == 307 || status == 308;
+}
+
+// Parses "bytes <first>-<last>/<total>"; total is 0 when given as "*"
+bool parse_content_range(const std::string& value, uint64_t& first, uint64_t& total) {
+    if (value.compare(0, 6, "bytes ") != 0) {
+        return false;
+    }
+    char* end = nullptr;
+    first = std::strtoull(value.c_str() + 6, &end, 10);
+    if (end == value.c_str() + 6 || *end != '-') {
+        return false;
+    }
+    const char* slash = std::strchr(end, '/');
+    if (!slash) {
+        return false;
+    }
+    total = slash[1] == '*' ? 0 : std::strtoull(slash + 1, nullptr, 10);
+    return true;
+}
+
+// Absolute http URL, or a path on the same origin
+bool resolve_location(const HttpUrl& base, const std::string& location, HttpUrl& out, std::string& error) {
+    if (location.find("://") != std::string::npos) {
+        return HttpUrl::parse(location, out, error);
+    }
+    if (location.compare(0, 2, "//") == 0) {
+        return HttpUrl::parse(base.scheme + ":" + location, out, error);
+    }
+    std::string target = location;
+    if (location.empty() || location[0] != '/') {
+        std::string path = base.target.substr(0, base.target.find_first_of("?#"));
+        target = path.substr(0, path.rfind('/') + 1) + location;
+    }
+    // Parsed like any URL, so the target is checked before it is sent
+    return HttpUrl::parse(base.scheme + "://" + base.origin() + target, out, error);
+}
+
+} // namespace
+
+HttpDownload::HttpDownload(uv_loop_t* loop, HttpClient* client, Options options,
+                           ProgressCallback on_progress, CompleteCallback on_complete)
+    : loop_(loop), client_(client), options_(std::move(options)),
+      on_progress_(std::move(on_progress)), on_complete_(std::move(on_complete)) {
+    part_path_ = options_.path + ".part";
+}
+
+HttpDownload::~HttpDownload() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+int HttpDownload::start(uv_loop_t* loop, HttpClient* client, Options options,
+                        ProgressCallback on_progress, CompleteCallback on_complete) {
+    std::shared_ptr<HttpDownload> download(new HttpDownload(loop, client, std::move(options),
+                                                            std::move(on_progress), std::move(on_complete)));
+
+    int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (download->options_.resume ? 0 : O_TRUNC);
+    download->fd_ = ::open(download->part_path_.c_str(), flags, 0644);
+    if (download->fd_ < 0) {
+        return uv_translate_sys_error(errno);
+    }
+
+    struct stat st;
+    if (download->options_.resume && ::fstat(download->fd_, &st) == 0) {
+        download->resume_offset_ = static_cast<uint64_t>(st.st_size);
+    }
+
+    download->started_ms_ = uv_now(loop);
+    download->send_request();
+    return 0;
+}
+
+void HttpDownload::send_request() {
+    HttpClient::Request request;
+    request.url = options_.url;
+    request.headers = options_.headers;
+    request.timeout_ms = options_.timeout_ms;
+    // Byte offsets must refer to the stored representation
+    request.headers.emplace_back("Accept-Encoding", "identity");
+    if (resume_offset_ > 0) {
+        request.headers.emplace_back("Range", "bytes=" + std::to_string(resume_offset_) + "-");
+    }
+
+    std::shared_ptr<HttpDownload> self = shared_from_this();
+    request.on_head = [self](const HttpResponseHead& head) { self->handle_head(head); };
+    request.on_body = [self](const char* data, size_t length) { self->handle_body(data, length); };
+    request.on_complete = [self](const std::string& error) {
+        self->request_id_ = 0;
+        self->response_done_ = true;
+        self->accepting_body_ = false;
+        if (!error.empty() && self->error_.empty()) {
+            self->error_ = error;
+        }
+        if (self->filling_) {
+            Buffer* buffer = self->filling_;
+            self->filling_ = nullptr;
+            // Bytes received before a dropped connection are still a valid prefix
+            if (buffer->length > 0) {
+                self->submit(buffer);
+            } else {
+                buffer->length = 0;
+                self->free_buffers_.push_back(buffer);
+            }
+        }
+        self->maybe_finish();
+    };
+
+    response_done_ = false;
+    request_id_ = client_->send(std::move(request));
+    if (request_id_ == 0) {
+        response_done_ = true;
+        error_ = "Network client is shut down";
+        maybe_finish();
+    }
+}
+
+void HttpDownload::handle_head(const HttpResponseHead& head) {
+    result_.status = head.status;
+
+    const std::string* location = head.header("location");
+    if (is_redirect(head.status) && location) {
+        if (++redirects_ > kMaxRedirects) {
+            fail("Too many redirects");
+        } else {
+            redirect_ = *location;
+        }
+        return;
+    }
+
+    // The stored prefix is no longer valid for this resource: start over
+    if (head.status == 416 && resume_offset_ > 0) {
+        restart_ = true;
+        return;
+    }
+
+    if (head.status < 200 || head.status >= 300) {
+        fail("HTTP " + std::to_string(head.status) + (head.reason.empty() ? "" : " " + head.reason));
+        return;
+    }
+
+    const std::string* content_length = head.header("content-length");
+    uint64_t length = content_length ? std::strtoull(content_length->c_str(), nullptr, 10) : 0;
+
+    if (head.status == 206) {
+        uint64_t first = 0, total = 0;
+        const std::string* range = head.header("content-range");
+        if (!range || !parse_content_range(*range, first, total) || first != resume_offset_) {
+            fail("Server returned an unexpected byte range");
+            return;
+        }
+        result_.resumed = true;
+        total_ = total ? total : (length ? resume_offset_ + length : 0);
+    } else {
+        // Full body: the server ignored the Range header
+        if (resume_offset_ > 0 && ::ftruncate(fd_, 0) != 0) {
+            fail(std::string("Cannot truncate ") + part_path_ + ": " + std::strerror(errno));
+            return;
+        }
+        resume_offset_ = 0;
+        total_ = length;
+    }
+
+    write_offset_ = resume_offset_;
+    accepting_body_ = true;
+    report_progress(true);
+}
+
+void HttpDownload::handle_body(const char* data, size_t length) {
+    if (!accepting_body_) {
+        return;
+    }
+
+    while (length > 0) {
+        if (!filling_) {
+            if (free_buffers_.empty()) {
+                buffers_.push_back(std::make_unique<Buffer>());
+                free_buffers_.push_back(buffers_.back().get());
+            }
+            filling_ = free_buffers_.back();
+            free_buffers_.pop_back();
+        }
+
+        size_t count = std::min(length, kBufferSize - filling_->length);
+        std::memcpy(filling_->data.get() + filling_->length, data, count);
+        filling_->length += count;
+        data += count;
+        length -= count;
+
+        if (filling_->length == kBufferSize) {
+            Buffer* full = filling_;
+            filling_ = nullptr;
+            submit(full);
+        }
+    }
+
+    // Every buffer is queued for the disk: stop reading the socket
+    if (!paused_ && free_buffers_.empty() && buffers_.size() >= kBufferCount && request_id_ != 0) {
+        client_->pause(request_id_);
+        paused_ = true;
+    }
+}
+
+void HttpDownload::submit(Buffer* buffer) {
+    auto* write = new WriteRequest{{}, shared_from_this(), buffer, 0, write_offset_};
+    write->req.data = write;
+    write_offset_ += buffer->length;
+    ++pending_writes_;
+
+    uv_buf_t data = uv_buf_init(buffer->data.get(), static_cast<unsigned int>(buffer->length));
+    int status = uv_fs_write(loop_, &write->req, fd_, &data, 1, static_cast<int64_t>(write->offset), on_write);
+    if (status < 0) {
+        write_done(write, status);
+    }
+}
+
+void HttpDownload::write_done(WriteRequest* write, ssize_t result) {
+    Buffer* buffer = write->buffer;
+
+    if (result < 0) {
+        fail(std::string("Cannot write ") + part_path_ + ": " + uv_strerror(static_cast<int>(result)));
+    } else {
+        write->written += static_cast<size_t>(result);
+        if (write->written < buffer->length && result > 0) {
+            // Short write: submit the rest of the buffer
+            uv_buf_t rest = uv_buf_init(buffer->data.get() + write->written,
+                                        static_cast<unsigned int>(buffer->length - write->written));
+            int status = uv_fs_write(loop_, &write->req, fd_, &rest, 1,
+                                     static_cast<int64_t>(write->offset + write->written), on_write);
+            if (status >= 0) {
+                return;
+            }
+            fail(std::string("Cannot write ") + part_path_ + ": " + uv_strerror(status));
+        } else {
+            written_ += buffer->length;
+        }
+    }
+
+    buffer->length = 0;
+    free_buffers_.push_back(buffer);
+    --pending_writes_;
+    std::shared_ptr<HttpDownload> self = std::move(write->download);
+    delete write;
+
+    if (paused_ && error_.empty()) {
+        paused_ = false;
+        client_->resume(request_id_);
+    }
+    report_progress(false);
+    maybe_finish();
+}
+
+void HttpDownload::report_progress(bool force) {
+    if (!on_progress_) {
+        return;
+    }
+    uint64_t now = uv_now(loop_);
+    if (!force && now - last_progress_ms_ < options_.progress_interval_ms) {
+        return;
+    }
+    last_progress_ms_ = now;
+
+    Progress progress;
+    progress.bytes = resume_offset_ + written_;
+    progress.total = total_;
+    uint64_t elapsed_ms = now - started_ms_;
+    progress.bytes_per_second = elapsed_ms > 0 ? static_cast<double>(written_) * 1000.0 / elapsed_ms : 0;
+    on_progress_(progress);
+}
+
+void HttpDownload::fail(const std::string& error) {
+    if (error_.empty()) {
+        error_ = error;
+    }
+    accepting_body_ = false;
+    if (request_id_ != 0) {
+        client_->cancel(request_id_);
+    }
+}
+
+void HttpDownload::maybe_finish() {
+    if (!response_done_ || pending_writes_ > 0 || finishing_) {
+        return;
+    }
+
+    if (error_.empty() && (restart_ || !redirect_.empty())) {
+        if (!redirect_.empty()) {
+            HttpUrl next;
+            std::string error;
+            if (!resolve_location(options_.url, redirect_, next, error)) {
+                complete(error);
+                return;
+            }
+            options_.url = next;
+            redirect_.clear();
+        } else {
+            restart_ = false;
+            if (::ftruncate(fd_, 0) != 0) {
+                complete(std::string("Cannot truncate ") + part_path_ + ": " + std::strerror(errno));
+                return;
+            }
+            resume_offset_ = 0;
+        }
+        write_offset_ = resume_offset_;
+        written_ = 0;
+        send_request();
+        return;
+    }
+
+    if (!error_.empty()) {
+        // A non-empty .part file stays behind so the next attempt can resume
+        if (resume_offset_ + written_ == 0) {
+            ::unlink(part_path_.c_str());
+        }
+        complete(error_);
+        return;
+    }
+
+    finishing_ = true;
+    report_progress(true);
+    auto* sync = new FsRequest{{}, shared_from_this()};
+    sync->req.data = sync;
+    int status = uv_fs_fdatasync(loop_, &sync->req, fd_, on_synced);
+    if (status < 0) {
+        delete sync;
+        complete(std::string("Cannot sync ") + part_path_ + ": " + uv_strerror(status));
+    }
+}
+
+void HttpDownload::complete(const std::string& error) {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    result_.bytes = resume_offset_ + written_;
+
+    CompleteCallback on_complete = std::move(on_complete_);
+    on_complete_ = nullptr;
+    on_progress_ = nullptr;
+    if (on_complete) {
+        on_complete(error, result_);
+    }
+}
+
+void HttpDownload::on_write(uv_fs_t* req) {
+    auto* write = static_cast<WriteRequest*>(req->data);
+    ssize_t result = req->result;
+    uv_fs_req_cleanup(req);
+    write->download->write_done(write, result);
+}
+
+void HttpDownload::on_synced(uv_fs_t* req) {
+    auto* sync = static_cast<FsRequest*>(req->data);
+    std::shared_ptr<HttpDownload> download = std::move(sync->download);
+    ssize_t result = req->result;
+    uv_fs_req_cleanup(req);
+    delete sync;
+
+    if (result < 0) {
+        download->complete(std::string("Cannot sync ") + download->part_path_ + ": " +
+                           uv_strerror(static_cast<int>(result)));
+        return;
+    }
+
+    ::close(download->fd_);
+    download->fd_ = -1;
+
+    // rename() replaces the destination atomically
+    auto* rename = new FsRequest{{}, download};
+    rename->req.data = rename;
+    int status = uv_fs_rename(download->loop_, &rename->req, download->part_path_.c_str(),
+                              download->options_.path.c_str(), on_renamed);
+    if (status < 0) {
+        delete rename;
+        download->complete(std::string("Cannot rename ") + download->part_path_ + ": " + uv_strerror(status));
+    }
+}
+
+void HttpDownload::on_renamed(uv_fs_t* req) {
+    auto* rename = static_cast<FsRequest*>(req->data);
+    std::shared_ptr<HttpDownload> download = std::move(rename->download);
+    ssize_t result = req->result;
+    uv_fs_req_cleanup(req);
+    delete rename;
+
+    download->complete(result < 0 ? std::string("Cannot rename ") + download->part_path_ + ": " +
+                                        uv_strerror(static_cast<int>(result))
+                                  : std::string());
+}
+
+} // namespace Nexus
@@ -0,0 +1,90 @@
+#include "isolate_limits.h"
+#include <algorithm>
+
+namespace Nexus {
+
+namespace {
+
+// Extra heap granted to a terminated script so it can unwind
+constexpr size_t kMinimumHeadroom = 16 * 1024 * 1024;
+
+} // namespace
+
+void IsolateLimits::apply(v8::ResourceConstraints& constraints) const {
+    if (heap_limit != 0) {
+        constraints.ConfigureDefaultsFromHeapSize(0, heap_limit);
+    }
+    if (young_generation_size != 0) {
+        constraints.set_max_young_generation_size_in_bytes(young_generation_size);
+        if (heap_limit > young_generation_size) {
+            constraints.set_max_old_generation_size_in_bytes(heap_limit - young_generation_size);
+        }
+    }
+}
+
+ManagedArrayBufferAllocator::ManagedArrayBufferAllocator(MemoryManager* memory_manager)
+    : memory_manager_(memory_manager), storage_(v8::ArrayBuffer::Allocator::NewDefaultAllocator()) {
+}
+
+void* ManagedArrayBufferAllocator::Allocate(size_t length) {
+    if (!memory_manager_->try_reserve(length)) {
+        return nullptr;
+    }
+    void* data = storage_->Allocate(length);
+    if (!data) {
+        memory_manager_->release(length);
+    }
+    return data;
+}
+
+void* ManagedArrayBufferAllocator::AllocateUninitialized(size_t length) {
+    if (!memory_manager_->try_reserve(length)) {
+        return nullptr;
+    }
+    void* data = storage_->AllocateUninitialized(length);
+    if (!data) {
+        memory_manager_->release(length);
+    }
+    return data;
+}
+
+void ManagedArrayBufferAllocator::Free(void* data, size_t length) {
+    storage_->Free(data, length);
+    memory_manager_->release(length);
+}
+
+void HeapLimitGuard::attach(v8::Isolate* isolate) {
+    isolate_ = isolate;
+    isolate_->AddNearHeapLimitCallback(&HeapLimitGuard::near_heap_limit, this);
+}
+
+void HeapLimitGuard::detach() {
+    if (isolate_) {
+        isolate_->RemoveNearHeapLimitCallback(&HeapLimitGuard::near_heap_limit, 0);
+        isolate_ = nullptr;
+    }
+}
+
+// Runs inside a GC: may not call into JS, only request termination
+size_t HeapLimitGuard::near_heap_limit(void* data, size_t current_heap_limit, size_t initial_heap_limit) {
+    auto* guard = static_cast<HeapLimitGuard*>(data);
+    guard->heap_limit_ = initial_heap_limit;
+    guard->reached_.store(true, std::memory_order_release);
+    guard->isolate_->TerminateExecution();
+    return current_heap_limit + std::max(initial_heap_limit / 4, kMinimumHeadroom);
+}
+
+bool HeapLimitGuard::recover() {
+    if (!reached_.exchange(false, std::memory_order_acq_rel)) {
+        return false;
+    }
+    isolate_->CancelTerminateExecution();
+    isolate_->LowMemoryNotification();
+
+    // Removing the callback is the only way to lower the limit again
+    isolate_->RemoveNearHeapLimitCallback(&HeapLimitGuard::near_heap_limit, heap_limit_);
+    isolate_->AddNearHeapLimitCallback(&HeapLimitGuard::near_heap_limit, this);
+    return true;
+}
+
+} // namespace Nexus
@@ -0,0 +1,363 @@
+#include "isolate_pool.h"
+#include <iostream>
+#include <stdexcept>
+
+namespace Nexus {
+
+namespace {
+
+std::string describe_exception(v8::Isolate* isolate, const v8::TryCatch& try_catch) {
+    if (try_catch.HasTerminated()) {
+        return "heap limit reached; execution cancelled";
+    }
+    if (!try_catch.HasCaught()) {
+        return "unknown error";
+    }
+    v8::String::Utf8Value error(isolate, try_catch.Exception());
+    return *error ? std::string(*error, error.length()) : "unknown error";
+}
+
+} // namespace
+
+TransferBuffer TransferBuffer::serialize(v8::Local<v8::Context> context, v8::Local<v8::Value> value) {
+    v8::ValueSerializer serializer(context->GetIsolate());
+    serializer.WriteHeader();
+    if (serializer.WriteValue(context, value).IsNothing()) {
+        return {};
+    }
+
+    auto [data, size] = serializer.Release();
+    TransferBuffer buffer;
+    buffer.data.reset(data);
+    buffer.size = size;
+    return buffer;
+}
+
+v8::MaybeLocal<v8::Value> TransferBuffer::deserialize(v8::Local<v8::Context> context) const {
+    v8::ValueDeserializer deserializer(context->GetIsolate(), data.get(), size);
+    if (!deserializer.ReadHeader(context).FromMaybe(false)) {
+        return {};
+    }
+    return deserializer.ReadValue(context);
+}
+
+IsolatePool::IsolatePool(ThreadPool* thread_pool, SecurityContext* security_context, size_t pool_size,
+                         MemoryManager* memory_manager, const IsolateLimits& limits)
+    : thread_pool_(thread_pool), security_context_(security_context), pool_size_(pool_size),
+      memory_manager_(memory_manager), limits_(limits) {
+}
+
+IsolatePool::~IsolatePool() {
+    shutdown();
+}
+
+bool IsolatePool::initialize(const v8::StartupData* snapshot, const std::string& runtime_path) {
+    for (size_t i = 0; i < pool_size_; ++i) {
+        auto worker = std::make_unique<Worker>();
+        if (!setup_worker(*worker, snapshot, runtime_path)) {
+            teardown_worker(*worker);
+            return false;
+        }
+        idle_workers_.push_back(worker.get());
+        workers_.push_back(std::move(worker));
+    }
+    return true;
+}
+
+void IsolatePool::shutdown() {
+    // Queued tasks fail; running ones return their worker
+    std::deque<Job> abandoned;
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        shutting_down_ = true;
+        abandoned.swap(queued_jobs_);
+    }
+    for (const Job& job : abandoned) {
+        job(nullptr);
+    }
+    {
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+        idle_condition_.wait(lock, [this] { return idle_workers_.size() == workers_.size(); });
+        idle_workers_.clear();
+    }
+    for (auto& worker : workers_) {
+        teardown_worker(*worker);
+    }
+    workers_.clear();
+}
+
+// The bridge and context die under the isolate's lock, before the isolate
+void IsolatePool::teardown_worker(Worker& worker) {
+    if (!worker.isolate) {
+        return;
+    }
+    {
+        v8::Locker locker(worker.isolate);
+        v8::Isolate::Scope isolate_scope(worker.isolate);
+        worker.bridge.reset();
+        worker.context.Reset();
+        worker.heap_guard.detach();
+    }
+    worker.isolate->Dispose();
+    worker.isolate = nullptr;
+}
+
+bool IsolatePool::setup_worker(Worker& worker, const v8::StartupData* snapshot, const std::string& runtime_path) {
+    worker.allocator = std::make_unique<ManagedArrayBufferAllocator>(memory_manager_);
+
+    v8::Isolate::CreateParams create_params;
+    create_params.array_buffer_allocator = worker.allocator.get();
+    create_params.external_references = StellarObjectBridge::external_references();
+    create_params.snapshot_blob = snapshot;
+    limits_.apply(create_params.constraints);
+    worker.isolate = v8::Isolate::New(create_params);
+    if (!worker.isolate) {
+        return false;
+    }
+    worker.heap_guard.attach(worker.isolate);
+
+    v8::Locker locker(worker.isolate);
+    v8::Isolate::Scope isolate_scope(worker.isolate);
+    v8::HandleScope handle_scope(worker.isolate);
+    v8::Local<v8::Context> context = v8::Context::New(worker.isolate);
+    worker.context.Reset(worker.isolate, context);
+
+    worker.bridge = std::make_unique<StellarObjectBridge>(worker.isolate, security_context_);
+    if (!worker.bridge->initialize()) {
+        return false;
+    }
+    worker.bridge->set_code_cache(code_cache_);
+
+    // Same global setup as the kernel's main context
+    if (!snapshot) {
+        v8::Context::Scope context_scope(context);
+        worker.bridge->install_globals(context);
+        worker.bridge->run_script_file(context, runtime_path);
+    }
+    return true;
+}
+
+bool IsolatePool::dispatch(Job job) {
+    Worker* worker;
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        if (shutting_down_) {
+            return false;
+        }
+        if (idle_workers_.empty()) {
+            queued_jobs_.push_back(std::move(job));
+            return true;
+        }
+        worker = idle_workers_.back();
+        idle_workers_.pop_back();
+    }
+    run(worker, std::move(job));
+    return true;
+}
+
+void IsolatePool::run(Worker* worker, Job job) {
+    try {
+        thread_pool_->submit([this, worker, job]() {
+            job(worker);
+            finish(worker);
+        });
+    } catch (const std::exception&) {
+        // The ThreadPool is shut down: nothing can run the job
+        job(nullptr);
+        finish(worker);
+    }
+}
+
+void IsolatePool::finish(Worker* worker) {
+    // A task cancelled at the heap limit leaves the isolate terminating
+    if (worker->heap_guard.limit_reached()) {
+        v8::Locker locker(worker->isolate);
+        v8::Isolate::Scope isolate_scope(worker->isolate);
+        worker->heap_guard.recover();
+    }
+    Job next;
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        if (!queued_jobs_.empty()) {
+            next = std::move(queued_jobs_.front());
+            queued_jobs_.pop_front();
+        } else {
+            idle_workers_.push_back(worker);
+        }
+    }
+    if (next) {
+        // Resubmitted rather than run here, so other ThreadPool tasks get a turn
+        run(worker, std::move(next));
+        return;
+    }
+    // shutdown() waits on this
+    idle_condition_.notify_all();
+}
+
+NexusObject IsolatePool::run_script(Worker& worker, const std::string& js_code) {
+    v8::Locker locker(worker.isolate);
+    v8::Isolate::Scope isolate_scope(worker.isolate);
+    v8::HandleScope handle_scope(worker.isolate);
+    v8::Local<v8::Context> context = worker.context.Get(worker.isolate);
+    v8::Context::Scope context_scope(context);
+    v8::TryCatch try_catch(worker.isolate);
+
+    NexusObject result;
+    v8::Local<v8::String> source;
+    v8::Local<v8::Script> script;
+    v8::Local<v8::Value> value;
+    uint64_t source_hash = CodeCache::hash_source(js_code);
+    bool produce_cache = false;
+    if (v8::String::NewFromUtf8(worker.isolate, js_code.data(), v8::NewStringType::kNormal,
+                                static_cast<int>(js_code.size())).ToLocal(&source) &&
+        worker.bridge->compile_script(context, source, source_hash, produce_cache).ToLocal(&script) &&
+        script->Run(context).ToLocal(&value)) {
+        if (produce_cache) {
+            worker.bridge->update_code_cache(script, source_hash);
+        }
+        result = worker.bridge->js_to_nexus(value);
+    } else {
+        result.metadata.type_id = TypeIds::JsError;
+        result.value = std::string("JavaScript execution failed: ") + describe_exception(worker.isolate, try_catch);
+    }
+    return result;
+}
+
+std::future<NexusObject> IsolatePool::execute_async(const std::string& js_code) {
+    auto promise = std::make_shared<std::promise<NexusObject>>();
+    std::future<NexusObject> future = promise->get_future();
+    auto refuse = [promise] {
+        NexusObject result;
+        result.metadata.type_id = TypeIds::JsError;
+        result.value = std::string("JavaScript execution failed: isolate pool is shutting down");
+        promise->set_value(std::move(result));
+    };
+    bool accepted = dispatch([this, js_code, promise, refuse](Worker* worker) {
+        if (!worker) {
+            refuse();
+            return;
+        }
+        promise->set_value(run_script(*worker, js_code));
+    });
+    if (!accepted) {
+        refuse();
+    }
+    return future;
+}
+
+std::vector<TransferBuffer> IsolatePool::map_partitions(const std::string& function_source,
+                                                        std::vector<TransferBuffer> partitions,
+                                                        const std::vector<uint32_t>& partition_offsets) {
+    std::vector<std::future<TransferBuffer>> pending;
+    pending.reserve(partitions.size());
+
+    bool refused = false;
+    for (size_t i = 0; i < partitions.size(); ++i) {
+        auto partition = std::make_shared<TransferBuffer>(std::move(partitions[i]));
+        uint32_t offset = partition_offsets[i];
+        auto promise = std::make_shared<std::promise<TransferBuffer>>();
+        std::future<TransferBuffer> future = promise->get_future();
+        bool accepted = dispatch([this, &function_source, partition, offset, promise](Worker* worker) {
+            if (!worker) {
+                promise->set_exception(std::make_exception_ptr(
+                    std::runtime_error("parallel.map: isolate pool is shutting down")));
+                return;
+            }
+            try {
+                promise->set_value(map_partition(*worker, function_source, *partition, offset));
+            } catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        });
+        if (!accepted) {
+            refused = true;
+            break;
+        }
+        pending.push_back(std::move(future));
+    }
+
+    // Wait for every partition before reporting a failure, since the tasks
+    // reference function_source
+    std::vector<TransferBuffer> results;
+    results.reserve(pending.size());
+    std::exception_ptr failure;
+    for (auto& future : pending) {
+        try {
+            results.push_back(future.get());
+        } catch (...) {
+            if (!failure) {
+                failure = std::current_exception();
+            }
+        }
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    if (refused) {
+        throw std::runtime_error("parallel.map: isolate pool is shutting down");
+    }
+    return results;
+}
+
+TransferBuffer IsolatePool::map_partition(Worker& worker, const std::string& function_source,
+                                          const TransferBuffer& partition, uint32_t offset) {
+    v8::Isolate* isolate = worker.isolate;
+    v8::Locker locker(isolate);
+    v8::Isolate::Scope isolate_scope(isolate);
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = worker.context.Get(isolate);
+    v8::Context::Scope context_scope(context);
+    v8::TryCatch try_catch(isolate);
+
+    // Closures cannot cross isolates, so the function is recompiled from its
+    // source here; it must not rely on captured variables
+    std::string wrapped_source = "(" + function_source + ")";
+    v8::Local<v8::String> source;
+    v8::Local<v8::Script> script;
+    v8::Local<v8::Value> function_value;
+    if (!v8::String::NewFromUtf8(isolate, wrapped_source.data(), v8::NewStringType::kNormal,
+                                 static_cast<int>(wrapped_source.size())).ToLocal(&source) ||
+        !v8::Script::Compile(context, source).ToLocal(&script) ||
+        !script->Run(context).ToLocal(&function_value) ||
+        !function_value->IsFunction()) {
+        throw std::runtime_error("parallel.map: cannot compile mapping function: " +
+            describe_exception(isolate, try_catch));
+    }
+    v8::Local<v8::Function> function = function_value.As<v8::Function>();
+
+    v8::Local<v8::Value> items_value;
+    if (!partition.deserialize(context).ToLocal(&items_value) || !items_value->IsArray()) {
+        throw std::runtime_error("parallel.map: cannot read partition: " +
+            describe_exception(isolate, try_catch));
+    }
+    v8::Local<v8::Array> items = items_value.As<v8::Array>();
+
+    const uint32_t length = items->Length();
+    std::vector<v8::Local<v8::Value>> mapped;
+    mapped.reserve(length);
+    for (uint32_t i = 0; i < length; ++i) {
+        v8::Local<v8::Value> item;
+        if (!items->Get(context, i).ToLocal(&item)) {
+            throw std::runtime_error("parallel.map: " + describe_exception(isolate, try_catch));
+        }
+
+        // Same (item, index) arguments as Array.prototype.map
+        v8::Local<v8::Value> call_args[] = {item, v8::Integer::NewFromUnsigned(isolate, offset + i)};
+        v8::Local<v8::Value> result;
+        if (!function->Call(context, v8::Undefined(isolate), 2, call_args).ToLocal(&result)) {
+            throw std::runtime_error("parallel.map: " + describe_exception(isolate, try_catch));
+        }
+        mapped.push_back(result);
+    }
+
+    TransferBuffer output = TransferBuffer::serialize(
+        context, v8::Array::New(isolate, mapped.data(), mapped.size())
+    );
+    if (!output.data) {
+        throw std::runtime_error("parallel.map: result cannot be transferred: " +
+            describe_exception(isolate, try_catch));
+    }
+    return output;
+}
+
+} // namespace Nexus
@@ -0,0 +1,379 @@
+#include "metrics_exporter.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace Nexus {
+
+namespace {
+
+constexpr size_t kMaxRequestBytes = 8192;
+constexpr int kClientTimeoutSeconds = 2;
+
+bool is_loopback(const struct sockaddr* address) {
+    if (address->sa_family == AF_INET) {
+        auto* in = reinterpret_cast<const struct sockaddr_in*>(address);
+        return (ntohl(in->sin_addr.s_addr) >> 24) == 127;
+    }
+    if (address->sa_family == AF_INET6) {
+        auto* in6 = reinterpret_cast<const struct sockaddr_in6*>(address);
+        return IN6_IS_ADDR_LOOPBACK(&in6->sin6_addr);
+    }
+    return false;
+}
+
+bool send_all(int fd, std::string_view data) {
+    while (!data.empty()) {
+        ssize_t sent = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data.remove_prefix(static_cast<size_t>(sent));
+    }
+    return true;
+}
+
+void respond(int fd, const char* status, std::string_view content_type, std::string_view body, bool head) {
+    std::string response = std::string("HTTP/1.1 ") + status + "\r\nContent-Type: " + std::string(content_type) +
+                           "\r\nContent-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n";
+    if (!head) {
+        response += body;
+    }
+    send_all(fd, response);
+}
+
+} // namespace
+
+void OpenMetricsWriter::begin(std::string_view name, const char* type, std::string_view help, std::string_view unit) {
+    out_ += "# TYPE ";
+    out_ += name;
+    out_ += ' ';
+    out_ += type;
+    out_ += '\n';
+    if (!unit.empty()) {
+        out_ += "# UNIT ";
+        out_ += name;
+        out_ += ' ';
+        out_ += unit;
+        out_ += '\n';
+    }
+    out_ += "# HELP ";
+    out_ += name;
+    out_ += ' ';
+    append_escaped(help);
+    out_ += '\n';
+}
+
+void OpenMetricsWriter::sample(std::string_view name, std::string_view suffix, Labels labels, double value) {
+    out_ += name;
+    out_ += suffix;
+    if (labels.size()) {
+        out_ += '{';
+        bool first = true;
+        for (const auto& [label, label_value] : labels) {
+            if (!first) {
+                out_ += ',';
+            }
+            first = false;
+            out_ += label;
+            out_ += "=\"";
+            append_escaped(label_value);
+            out_ += '"';
+        }
+        out_ += '}';
+    }
+    out_ += ' ';
+    append_number(value);
+    out_ += '\n';
+}
+
+void OpenMetricsWriter::counter(std::string_view name, std::string_view help, double value) {
+    begin(name, "counter", help);
+    sample(name, "_total", {}, value);
+}
+
+void OpenMetricsWriter::gauge(std::string_view name, std::string_view help, double value, std::string_view unit) {
+    begin(name, "gauge", help, unit);
+    sample(name, "", {}, value);
+}
+
+void OpenMetricsWriter::latency(std::string_view name, Labels labels, const LatencySummary& summary) {
+    // Quantile samples carry one more label than the family's own
+    auto quantile = [&](std::string_view q, uint64_t us) {
+        out_ += name;
+        out_ += '{';
+        for (const auto& [label, label_value] : labels) {
+            out_ += label;
+            out_ += "=\"";
+            append_escaped(label_value);
+            out_ += "\",";
+        }
+        out_ += "quantile=\"";
+        out_ += q;
+        out_ += "\"} ";
+        append_number(static_cast<double>(us) / 1e6);
+        out_ += '\n';
+    };
+    quantile("0.5", summary.p50_us);
+    quantile("0.99", summary.p99_us);
+    sample(name, "_sum", labels, summary.mean_us * static_cast<double>(summary.count) / 1e6);
+    sample(name, "_count", labels, static_cast<double>(summary.count));
+}
+
+std::string OpenMetricsWriter::finish() {
+    out_ += "# EOF\n";
+    return std::move(out_);
+}
+
+void OpenMetricsWriter::append_number(double value) {
+    if (std::isnan(value)) {
+        out_ += "NaN";
+        return;
+    }
+    if (std::isinf(value)) {
+        out_ += value > 0 ? "+Inf" : "-Inf";
+        return;
+    }
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out_.append(buffer, result.ptr);
+}
+
+void OpenMetricsWriter::append_escaped(std::string_view text) {
+    for (char c : text) {
+        switch (c) {
+            case '\\': out_ += "\\\\"; break;
+            case '"': out_ += "\\\""; break;
+            case '\n': out_ += "\\n"; break;
+            default: out_ += c;
+        }
+    }
+}
+
+MetricsExporter::MetricsExporter(Collector collector) : collector_(std::move(collector)) {}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::start(const std::string& listen, std::string& error) {
+    if (running()) {
+        error = "Metrics exporter already listening on " + address_;
+        return false;
+    }
+
+    bool listening;
+    if (listen.rfind("unix:", 0) == 0) {
+        listening = listen_unix(listen.substr(5), error);
+    } else if (!listen.empty() && listen[0] == '/') {
+        listening = listen_unix(listen, error);
+    } else {
+        size_t colon = listen.rfind(':');
+        std::string host = colon == std::string::npos ? "127.0.0.1" : listen.substr(0, colon);
+        std::string port = colon == std::string::npos ? listen : listen.substr(colon + 1);
+        if (host.size() >= 2 && host.front() == '[' && host.back() == ']') {
+            host = host.substr(1, host.size() - 2);
+        }
+        listening = listen_tcp(host, port, error);
+    }
+    if (!listening) {
+        return false;
+    }
+
+    if (::pipe2(wake_fd_, O_CLOEXEC) != 0) {
+        error = std::string("Cannot create metrics exporter pipe: ") + std::strerror(errno);
+        stop();
+        return false;
+    }
+    thread_ = std::thread(&MetricsExporter::run, this);
+    return true;
+}
+
+void MetricsExporter::stop() {
+    if (thread_.joinable()) {
+        char wake = 0;
+        ssize_t written;
+        do {
+            written = ::write(wake_fd_[1], &wake, 1);
+        } while (written < 0 && errno == EINTR);
+        thread_.join();
+    }
+    for (int& fd : wake_fd_) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+    }
+    if (!socket_path_.empty()) {
+        ::unlink(socket_path_.c_str());
+        socket_path_.clear();
+    }
+}
+
+bool MetricsExporter::listen_unix(const std::string& path, std::string& error) {
+    struct sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        error = "Invalid metrics socket path: " + path;
+        return false;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        error = std::string("Cannot create metrics socket: ") + std::strerror(errno);
+        return false;
+    }
+
+    // A socket left behind by a process that died is replaced; a live one is not
+    struct stat st;
+    if (::lstat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) {
+        int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        bool live = probe >= 0 &&
+                    ::connect(probe, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) == 0;
+        if (probe >= 0) {
+            ::close(probe);
+        }
+        if (live) {
+            ::close(fd);
+            error = "Metrics socket is in use: " + path;
+            return false;
+        }
+        ::unlink(path.c_str());
+    }
+
+    if (::bind(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(fd, 16) != 0) {
+        error = "Cannot listen on " + path + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    listen_fd_ = fd;
+    socket_path_ = path;
+    address_ = "unix:" + path;
+    return true;
+}
+
+bool MetricsExporter::listen_tcp(const std::string& host, const std::string& port, std::string& error) {
+    struct addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_NUMERICSERV;
+    struct addrinfo* addresses = nullptr;
+    int status = ::getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses);
+    if (status != 0) {
+        error = "Invalid metrics address " + host + ":" + port + ": " + ::gai_strerror(status);
+        return false;
+    }
+
+    // Metrics are not authenticated: only loopback addresses are accepted
+    error = "Metrics exporter only listens on loopback addresses, not " + host;
+    for (struct addrinfo* candidate = addresses; candidate; candidate = candidate->ai_next) {
+        if (!is_loopback(candidate->ai_addr)) {
+            continue;
+        }
+        int fd = ::socket(candidate->ai_family, candidate->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                          candidate->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        int reuse = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (::bind(fd, candidate->ai_addr, candidate->ai_addrlen) != 0 || ::listen(fd, 16) != 0) {
+            error = "Cannot listen on " + host + ":" + port + ": " + std::strerror(errno);
+            ::close(fd);
+            continue;
+        }
+        listen_fd_ = fd;
+        address_ = (candidate->ai_family == AF_INET6 ? "[" + host + "]" : host) + ":" + port;
+        break;
+    }
+    ::freeaddrinfo(addresses);
+    return listen_fd_ >= 0;
+}
+
+void MetricsExporter::run() {
+    struct pollfd fds[2] = {{listen_fd_, POLLIN, 0}, {wake_fd_[0], POLLIN, 0}};
+    while (true) {
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        if (fds[1].revents) {
+            return;
+        }
+        if (fds[0].revents & POLLIN) {
+            int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd >= 0) {
+                serve(fd);
+                ::close(fd);
+            }
+        }
+    }
+}
+
+// One request per connection; a client that stalls is dropped after the timeout
+void MetricsExporter::serve(int fd) {
+    struct timeval timeout{kClientTimeoutSeconds, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.find("\n\n") == std::string::npos) {
+        if (request.size() >= kMaxRequestBytes) {
+            respond(fd, "431 Request Header Fields Too Large", "text/plain", "", false);
+            return;
+        }
+        ssize_t count = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return;
+        }
+        request.append(buffer, static_cast<size_t>(count));
+    }
+
+    std::string_view line(request.data(), request.find_first_of("\r\n"));
+    size_t method_end = line.find(' ');
+    std::string_view method = line.substr(0, method_end);
+    std::string_view target = method_end == std::string_view::npos ? std::string_view() : line.substr(method_end + 1);
+    target = target.substr(0, target.find_first_of(" ?"));
+
+    bool head = method == "HEAD";
+    if (method != "GET" && !head) {
+        respond(fd, "405 Method Not Allowed", "text/plain", "Only GET is supported\n", false);
+        return;
+    }
+    if (target != "/metrics" && target != "/") {
+        respond(fd, "404 Not Found", "text/plain", "Metrics are served at /metrics\n", head);
+        return;
+    }
+
+    OpenMetricsWriter writer;
+    collector_(writer);
+    scrapes_.fetch_add(1, std::memory_order_relaxed);
+    respond(fd, "200 OK", "application/openmetrics-text; version=1.0.0; charset=utf-8", writer.finish(), head);
+}
+
+} // namespace Nexus
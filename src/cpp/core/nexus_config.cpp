@@ -0,0 +1,436 @@
+#include "nexus_config.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <simdjson.h>
+
+namespace Nexus {
+
+namespace {
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+bool iequals(std::string_view a, std::string_view b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+        return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+    });
+}
+
+// "<number><unit>" with optional spaces between; the number may have a fraction
+bool split_quantity(std::string_view text, double& number, std::string_view& unit) {
+    text = trim(text);
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), number);
+    if (ec != std::errc() || !std::isfinite(number) || number < 0) {
+        return false;
+    }
+    unit = trim(text.substr(static_cast<size_t>(end - text.data())));
+    return true;
+}
+
+bool parse_count(std::string_view text, size_t& value) {
+    text = trim(text);
+    size_t parsed = 0;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), parsed);
+    if (ec != std::errc() || end != text.data() + text.size() || text.empty()) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+template <size_t NexusConfig::*Field>
+bool apply_size(NexusConfig& config, std::string_view text) {
+    return NexusConfig::parse_size(text, config.*Field);
+}
+
+template <size_t NexusConfig::*Field>
+bool apply_count(NexusConfig& config, std::string_view text) {
+    return parse_count(text, config.*Field);
+}
+
+template <bool NexusConfig::*Field>
+bool apply_bool(NexusConfig& config, std::string_view text) {
+    return NexusConfig::parse_bool(text, config.*Field);
+}
+
+template <std::string NexusConfig::*Field>
+bool apply_string(NexusConfig& config, std::string_view text) {
+    config.*Field = std::string(text);
+    return true;
+}
+
+bool apply_pool_size(NexusConfig& config, std::string_view text) {
+    size_t size;
+    if (!parse_count(text, size)) {
+        return false;
+    }
+    config.js_isolate_pool_size = size;
+    return true;
+}
+
+// "false" disables the snapshot, as the flat key always allowed
+bool apply_snapshot_path(NexusConfig& config, std::string_view text) {
+    if (text == "false") {
+        config.startup_snapshot = false;
+    } else {
+        config.snapshot_path = std::string(text);
+    }
+    return true;
+}
+
+template <std::vector<std::string> NexusConfig::*Field>
+bool apply_list(NexusConfig& config, std::string_view text) {
+    std::vector<std::string> items;
+    while (!text.empty()) {
+        size_t comma = text.find(',');
+        std::string_view item = trim(text.substr(0, comma));
+        if (!item.empty()) {
+            items.emplace_back(item);
+        }
+        text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+    }
+    config.*Field = std::move(items);
+    return true;
+}
+
+bool apply_latency_warning(NexusConfig& config, std::string_view text) {
+    return NexusConfig::parse_duration_ms(text, config.latency_warning_ms);
+}
+
+struct Setting {
+    const char* key;        // Flat name
+    const char* path;       // Section path in the README layout
+    bool (*apply)(NexusConfig&, std::string_view);
+};
+
+constexpr Setting kSettings[] = {
+    {"max_memory", "shell.maxMemory", apply_size<&NexusConfig::max_memory>},
+    {"thread_pool_size", "shell.threadPoolSize", apply_count<&NexusConfig::thread_pool_size>},
+    {"enable_jit", "shell.enableJIT", apply_bool<&NexusConfig::enable_jit>},
+    {"enable_sandbox", "shell.enableSandbox", apply_bool<&NexusConfig::enable_sandbox>},
+    {"enable_debug", "shell.enableDebug", apply_bool<&NexusConfig::enable_debug>},
+    {"startup_trace", "shell.startupTrace", apply_bool<&NexusConfig::startup_trace>},
+    {"quiet", "shell.quiet", apply_bool<&NexusConfig::quiet>},
+    {"plugins", "shell.plugins", apply_list<&NexusConfig::plugins>},
+    {"js_heap_limit", "js.heapLimit", apply_size<&NexusConfig::js_heap_limit>},
+    {"js_young_generation_size", "js.youngGenerationSize", apply_size<&NexusConfig::js_young_generation_size>},
+    {"js_isolate_pool_size", "js.isolatePoolSize", apply_pool_size},
+    {"js_runtime_path", "js.runtimePath", apply_string<&NexusConfig::js_runtime_path>},
+    {"code_cache", "js.codeCache", apply_bool<&NexusConfig::code_cache>},
+    {"code_cache_dir", "js.codeCacheDir", apply_string<&NexusConfig::code_cache_dir>},
+    {"startup_snapshot", "js.startupSnapshot", apply_bool<&NexusConfig::startup_snapshot>},
+    {"snapshot_path", "js.snapshotPath", apply_snapshot_path},
+    {"default_policy", "security.defaultPolicy", apply_string<&NexusConfig::default_policy>},
+    {"audit_logging", "security.auditLogging", apply_bool<&NexusConfig::audit_logging>},
+    {"capabilities", "security.capabilities", apply_list<&NexusConfig::capabilities>},
+    {"monitoring", "performance.monitoring", apply_bool<&NexusConfig::monitoring>},
+    {"memory_warning", "performance.thresholds.memoryWarning", apply_size<&NexusConfig::memory_warning>},
+    {"latency_warning", "performance.thresholds.latencyWarning", apply_latency_warning},
+    {"metrics_listen", "performance.metricsListen", apply_string<&NexusConfig::metrics_listen>},
+};
+
+const Setting* find_setting(std::string_view key) {
+    for (const Setting& setting : kSettings) {
+        if (key == setting.key || key == setting.path) {
+            return &setting;
+        }
+    }
+    return nullptr;
+}
+
+std::string join_key(const std::string& prefix, std::string_view key) {
+    return prefix.empty() ? std::string(key) : prefix + "." + std::string(key);
+}
+
+// Scalar JSON value as the text set() takes; arrays are comma-joined
+simdjson::error_code value_text(simdjson::ondemand::value value, simdjson::ondemand::json_type type,
+                                std::string& text) {
+    using simdjson::ondemand::json_type;
+    switch (type) {
+        case json_type::string: {
+            std::string_view string;
+            if (auto error = value.get_string().get(string)) {
+                return error;
+            }
+            text = std::string(string);
+            return simdjson::SUCCESS;
+        }
+        case json_type::number:
+            text = std::string(trim(value.raw_json_token()));
+            return simdjson::SUCCESS;
+        case json_type::boolean: {
+            bool flag;
+            if (auto error = value.get_bool().get(flag)) {
+                return error;
+            }
+            text = flag ? "true" : "false";
+            return simdjson::SUCCESS;
+        }
+        case json_type::array: {
+            simdjson::ondemand::array array;
+            if (auto error = value.get_array().get(array)) {
+                return error;
+            }
+            text.clear();
+            for (auto element : array) {
+                simdjson::ondemand::value item;
+                simdjson::ondemand::json_type item_type;
+                std::string item_text;
+                if (auto error = element.get(item)) {
+                    return error;
+                }
+                if (auto error = item.type().get(item_type)) {
+                    return error;
+                }
+                if (item_type == json_type::array || item_type == json_type::object) {
+                    return simdjson::INCORRECT_TYPE;
+                }
+                if (auto error = value_text(item, item_type, item_text)) {
+                    return error;
+                }
+                text += text.empty() ? item_text : "," + item_text;
+            }
+            return simdjson::SUCCESS;
+        }
+        default:
+            return simdjson::INCORRECT_TYPE;
+    }
+}
+
+bool parse_object(simdjson::ondemand::object object, const std::string& prefix, NexusConfig& config,
+                  std::string& error) {
+    for (auto field : object) {
+        std::string_view name;
+        simdjson::ondemand::value value;
+        simdjson::ondemand::json_type type;
+        if (field.unescaped_key().get(name) || field.value().get(value) || value.type().get(type)) {
+            error = "malformed JSON";
+            return false;
+        }
+        std::string key = join_key(prefix, name);
+
+        if (type == simdjson::ondemand::json_type::null) {
+            continue;       // Keep the default
+        }
+        if (type == simdjson::ondemand::json_type::object) {
+            simdjson::ondemand::object child;
+            if (value.get_object().get(child)) {
+                error = "malformed JSON";
+                return false;
+            }
+            if (!parse_object(child, key, config, error)) {
+                return false;
+            }
+            continue;
+        }
+
+        std::string text;
+        if (auto code = value_text(value, type, text)) {
+            error = key + ": " + simdjson::error_message(code);
+            return false;
+        }
+        if (!config.set(key, text, error)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool NexusConfig::set(const std::string& key, std::string_view value, std::string& error) {
+    const Setting* setting = find_setting(key);
+    if (!setting) {
+        values[key] = std::string(value);
+        return true;
+    }
+    if (!setting->apply(*this, value)) {
+        error = "invalid value for " + key + ": '" + std::string(value) + "'";
+        return false;
+    }
+    values[setting->key] = std::string(value);
+    values[setting->path] = std::string(value);
+    return true;
+}
+
+std::string NexusConfig::canonical_key(const std::string& key) {
+    const Setting* setting = find_setting(key);
+    return setting ? setting->key : key;
+}
+
+bool NexusConfig::parse(std::string_view json, std::string& error) {
+    simdjson::ondemand::parser parser;
+    simdjson::padded_string padded(json);
+    simdjson::ondemand::document document;
+    simdjson::ondemand::object root;
+    if (auto code = parser.iterate(padded).get(document)) {
+        error = simdjson::error_message(code);
+        return false;
+    }
+    if (document.get_object().get(root)) {
+        error = "configuration must be a JSON object";
+        return false;
+    }
+    if (!parse_object(root, "", *this, error)) {
+        return false;
+    }
+    // On-Demand validates lazily: reject trailing content after the object
+    if (!document.at_end()) {
+        error = "trailing content after the configuration object";
+        return false;
+    }
+    return true;
+}
+
+bool NexusConfig::load(const std::string& path, std::string& error) {
+    simdjson::padded_string json;
+    if (auto code = simdjson::padded_string::load(path).get(json)) {
+        error = path + ": " + simdjson::error_message(code);
+        return false;
+    }
+    if (!parse(json, error)) {
+        error = path + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+void NexusConfig::apply_environment() {
+    std::string error;
+    if (const char* max_memory = std::getenv("NEXUS_MAX_MEMORY")) {
+        set("max_memory", max_memory, error);
+    }
+    if (const char* debug = std::getenv("NEXUS_DEBUG")) {
+        set("enable_debug", debug, error);
+    }
+}
+
+bool NexusConfig::parse_size(std::string_view text, size_t& bytes) {
+    double number;
+    std::string_view unit;
+    if (!split_quantity(text, number, unit)) {
+        return false;
+    }
+
+    static const std::pair<std::string_view, double> kUnits[] = {
+        {"", 1}, {"b", 1},
+        {"k", 0x1p10}, {"kb", 0x1p10}, {"kib", 0x1p10},
+        {"m", 0x1p20}, {"mb", 0x1p20}, {"mib", 0x1p20},
+        {"g", 0x1p30}, {"gb", 0x1p30}, {"gib", 0x1p30},
+        {"t", 0x1p40}, {"tb", 0x1p40}, {"tib", 0x1p40},
+    };
+    for (const auto& [name, multiplier] : kUnits) {
+        if (iequals(unit, name)) {
+            double value = std::round(number * multiplier);
+            if (value >= static_cast<double>(std::numeric_limits<size_t>::max())) {
+                return false;
+            }
+            bytes = static_cast<size_t>(value);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool NexusConfig::parse_duration_ms(std::string_view text, uint64_t& ms) {
+    double number;
+    std::string_view unit;
+    if (!split_quantity(text, number, unit)) {
+        return false;
+    }
+
+    static const std::pair<std::string_view, double> kUnits[] = {
+        {"", 1}, {"ms", 1}, {"s", 1000}, {"m", 60000}, {"min", 60000}, {"h", 3600000},
+    };
+    for (const auto& [name, multiplier] : kUnits) {
+        if (iequals(unit, name)) {
+            double value = std::round(number * multiplier);
+            if (value >= static_cast<double>(std::numeric_limits<uint64_t>::max())) {
+                return false;
+            }
+            ms = static_cast<uint64_t>(value);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool NexusConfig::parse_bool(std::string_view text, bool& value) {
+    text = trim(text);
+    for (std::string_view yes : {"true", "yes", "on", "1"}) {
+        if (iequals(text, yes)) {
+            value = true;
+            return true;
+        }
+    }
+    for (std::string_view no : {"false", "no", "off", "0"}) {
+        if (iequals(text, no)) {
+            value = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+namespace {
+
+std::atomic<uint64_t> next_store_id{1};
+
+struct ConfigReaderCache {
+    uint64_t store_id = 0;
+    uint64_t generation = 0;
+    std::shared_ptr<const NexusConfig> snapshot;
+};
+
+thread_local ConfigReaderCache config_reader_cache;
+
+} // namespace
+
+ConfigStore::ConfigStore(NexusConfig initial)
+    : store_id_(next_store_id.fetch_add(1, std::memory_order_relaxed)),
+      current_(std::make_shared<const NexusConfig>(std::move(initial))) {}
+
+std::shared_ptr<const NexusConfig> ConfigStore::current() const {
+    ConfigReaderCache& cache = config_reader_cache;
+    if (cache.store_id != store_id_ || cache.generation != generation_.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cache.store_id = store_id_;
+        cache.generation = generation_.load(std::memory_order_relaxed);
+        cache.snapshot = current_;
+    }
+    return cache.snapshot;
+}
+
+void ConfigStore::publish(NexusConfig next) {
+    auto snapshot = std::make_shared<const NexusConfig>(std::move(next));
+    std::lock_guard<std::mutex> lock(mutex_);
+    publish_locked(std::move(snapshot));
+}
+
+bool ConfigStore::update(const std::string& key, std::string_view value, std::string& error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    NexusConfig next = *current_;
+    if (!next.set(key, value, error)) {
+        return false;
+    }
+    publish_locked(std::make_shared<const NexusConfig>(std::move(next)));
+    return true;
+}
+
+void ConfigStore::publish_locked(std::shared_ptr<const NexusConfig> next) {
+    current_.swap(next);
+    generation_.fetch_add(1, std::memory_order_release);
+}
+
+} // namespace Nexus
@@ -3,31 +3,26 @@
 #include <iostream>
 #include <fstream>
 #include <chrono>
-#include <simdjson.h>
+#include <cstdlib>
+#include <filesystem>
+#include <libplatform/libplatform.h>
+
+#ifndef NEXUS_DATA_DIR
+#define NEXUS_DATA_DIR "/usr/local/share/nexus"
+#endif
 
 namespace Nexus {
 
-NexusKernel::NexusKernel(const std::string& config_path) {
+NexusKernel::NexusKernel(const std::string& config_path) : config_path_(config_path) {
     // Load configuration
-    if (!config_path.empty()) {
-        std::ifstream config_file(config_path);
-        if (config_file.is_open()) {
-            simdjson::dom::parser parser;
-            simdjson::dom::element config = parser.load(config_file);
-            
-            for (auto [key, value] : config.get_object()) {
-                config_[std::string(key)] = std::string(value.get_string());
-            }
-        }
-    }
-
-    // Set default configuration
-    if (config_.find("max_memory") == config_.end()) {
-        config_["max_memory"] = "52428800"; // 50MB
-    }
-    if (config_.find("thread_pool_size") == config_.end()) {
-        config_["thread_pool_size"] = "8";
+    NexusConfig config;
+    std::string error;
+    if (!read_config(config, error)) {
+        std::cerr << "Ignoring configuration: " << error << "\n";
+        config = {};
+        config.apply_environment();
     }
+    config_.publish(std::move(config));
 }
 
 NexusKernel::~NexusKernel() {
@@ -39,37 +34,175 @@ bool NexusKernel::initialize() {
         return true;
     }
 
+    startup_trace_ = std::make_unique<StartupTrace>();
+    StartupTrace& trace = *startup_trace_;
+    std::shared_ptr<const NexusConfig> config = this->config();
+
     try {
         // Initialize memory manager first
-        memory_manager_ = std::make_unique<MemoryManager>(
-            std::stoull(config_["max_memory"])
-        );
+        {
+            StartupTrace::Phase phase(trace, "memory manager");
+            memory_manager_ = std::make_unique<MemoryManager>(config->max_memory);
+        }
 
         // Initialize thread pool
-        thread_pool_ = std::make_unique<ThreadPool>(
-            std::stoi(config_["thread_pool_size"])
-        );
+        {
+            StartupTrace::Phase phase(trace, "thread pool");
+            thread_pool_ = std::make_unique<ThreadPool>(config->thread_pool_size);
+        }
 
-        // Initialize security context
+        // Independent subsystems come up on the pool while this thread
+        // prepares the plain-shell path. V8's process-wide setup keeps
+        // running in the background; the isolate and everything behind the
+        // nexus.* APIs are created by the first JS command
         security_context_ = std::make_unique<SecurityContext>();
-        if (!security_context_->initialize()) {
-            std::cerr << "Failed to initialize security context\n";
+        security_ready_ = thread_pool_->submit([this, &trace] {
+            StartupTrace::Phase phase(trace, "security context");
+            return security_context_->initialize();
+        });
+
+        v8_platform_ready_ = thread_pool_->submit([this, &trace] {
+            StartupTrace::Phase phase(trace, "v8 platform");
+            return initialize_v8_platform();
+        });
+
+        // Initialize compiled script cache
+        if (config->code_cache) {
+            std::string cache_dir = config->code_cache_dir;
+            code_cache_ready_ = thread_pool_->submit([this, &trace, cache_dir] {
+                StartupTrace::Phase phase(trace, "code cache");
+                code_cache_ = std::make_unique<CodeCache>(
+                    cache_dir.empty() ? CodeCache::default_cache_directory() : cache_dir
+                );
+            });
+        }
+
+        // Initialize libuv event loop
+        bool loop_ready;
+        {
+            StartupTrace::Phase phase(trace, "event loop");
+            loop_ready = initialize_libuv();
+        }
+
+        // Initialize filesystem watcher (nexus.fs.watch, configuration
+        // reloads); optional when inotify is unavailable or its instance
+        // limit is exhausted
+        {
+            StartupTrace::Phase phase(trace, "file watcher");
+            file_watcher_ = std::make_unique<FileWatcher>(event_loop_);
+            if (!file_watcher_->initialize()) {
+                std::cerr << "Warning: file watching unavailable\n";
+                file_watcher_.reset();
+            }
+            watch_config_file();
+        }
+
+        // Process snapshots shared by ps, nexus.proc.list and monitors
+        {
+            StartupTrace::Phase phase(trace, "process snapshots");
+            process_snapshots_ = std::make_unique<ProcessSnapshotEngine>(thread_pool_.get());
+        }
+
+        // Initialize parser and execution engine
+        {
+            StartupTrace::Phase phase(trace, "parser and engine");
+            parser_ = std::make_unique<QuantumParser>();
+            execution_engine_ = std::make_unique<OrionExecutionEngine>(
+                this, thread_pool_.get()
+            );
+            plugins_ = std::make_unique<PluginManager>(execution_engine_->commands());
+            execution_engine_->register_native_command("plugin", [this](const CommandContext& context) {
+                return plugins_->command(context);
+            });
+        }
+
+        if (!config->plugins.empty()) {
+            StartupTrace::Phase phase(trace, "plugins");
+            for (const std::string& plugin : config->plugins) {
+                load_plugin(plugin);
+            }
+        }
+
+        // Every command is permission-checked: the shell is not ready before this
+        bool security_ok;
+        {
+            StartupTrace::Phase phase(trace, "wait: security context");
+            security_ok = security_ready_.get();
+        }
+        if (!security_ok || !loop_ready) {
+            std::cerr << (security_ok ? "Failed to initialize libuv\n" : "Failed to initialize security context\n");
+            release_components();
             return false;
         }
 
-        // Initialize V8 JavaScript engine
-        if (!initialize_v8()) {
+        startup_time_us_ = trace.elapsed_us();
+        running_.store(true);
+
+        if (!config->metrics_listen.empty()) {
+            StartupTrace::Phase phase(trace, "metrics exporter");
+            start_metrics_exporter(config->metrics_listen);
+        }
+
+        if (config->startup_trace) {
+            trace.report(std::cerr, "startup trace: shell");
+        }
+        if (!config->quiet) {
+            std::cout << "🚀 NexusShell kernel initialized successfully\n";
+        }
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Kernel initialization failed: " << e.what() << "\n";
+        release_components();
+        return false;
+    }
+}
+
+bool NexusKernel::ensure_js_runtime() {
+    if (js_runtime_ready_) {
+        return true;
+    }
+    if (js_runtime_failed_) {
+        return false;
+    }
+
+    uint64_t start_us = startup_trace_->elapsed_us();
+    js_runtime_ready_ = initialize_js_runtime();
+    js_runtime_failed_ = !js_runtime_ready_;
+    js_runtime_startup_us_ = startup_trace_->elapsed_us() - start_us;
+
+    if (config()->startup_trace) {
+        startup_trace_->report(std::cerr, "startup trace: JS runtime");
+    }
+    return js_runtime_ready_;
+}
+
+bool NexusKernel::initialize_js_runtime() {
+    StartupTrace& trace = *startup_trace_;
+
+    {
+        StartupTrace::Phase phase(trace, "wait: v8 platform");
+        if (!v8_platform_ready_.get()) {
             std::cerr << "Failed to initialize V8 engine\n";
             return false;
         }
+    }
+    if (code_cache_ready_.valid()) {
+        StartupTrace::Phase phase(trace, "wait: code cache");
+        code_cache_ready_.get();
+    }
 
-        // Initialize libuv event loop
-        if (!initialize_libuv()) {
-            std::cerr << "Failed to initialize libuv\n";
+    {
+        StartupTrace::Phase phase(trace, "v8 isolate");
+        if (!create_main_isolate()) {
+            std::cerr << "Failed to initialize V8 engine\n";
             return false;
         }
+    }
 
-        // Initialize object bridge
+    // Initialize object bridge
+    {
+        StartupTrace::Phase phase(trace, "object bridge");
         object_bridge_ = std::make_unique<StellarObjectBridge>(
             isolate_, security_context_.get()
         );
@@ -77,26 +210,171 @@ bool NexusKernel::initialize() {
             std::cerr << "Failed to initialize object bridge\n";
             return false;
         }
+        object_bridge_->set_event_loop(event_loop_);
+        object_bridge_->set_process_snapshots(process_snapshots_.get());
+        object_bridge_->set_code_cache(code_cache_.get());
+    }
 
-        // Initialize parser
-        parser_ = std::make_unique<QuantumParser>();
+    if (file_watcher_) {
+        object_bridge_->set_file_watcher(file_watcher_.get());
+    }
 
-        // Initialize execution engine
-        execution_engine_ = std::make_unique<OrionExecutionEngine>(
-            this, thread_pool_.get()
-        );
+    // Pooled keep-alive HTTP client behind nexus.net
+    {
+        StartupTrace::Phase phase(trace, "http client");
+        http_client_ = std::make_unique<HttpClient>(event_loop_);
+        object_bridge_->set_http_client(http_client_.get());
+    }
 
-        // Setup JavaScript global objects
+    // Initialize isolates for parallel JS execution
+    {
+        StartupTrace::Phase phase(trace, "isolate pool");
+        if (!initialize_isolate_pool()) {
+            std::cerr << "Failed to initialize isolate pool\n";
+            return false;
+        }
+    }
+
+    // Setup JavaScript global objects, unless the context was
+    // deserialized from a startup snapshot that already contains them
+    if (!globals_from_snapshot_) {
+        StartupTrace::Phase phase(trace, "js globals");
         setup_js_globals();
+    }
+    return true;
+}
 
-        running_.store(true);
-        
-        std::cout << "🚀 NexusShell kernel initialized successfully\n";
-        return true;
+// Scrapes are answered on the exporter thread from sampled values; the
+// exporter is not fatal to startup
+void NexusKernel::start_metrics_exporter(const std::string& listen) {
+    metrics_timer_ = new uv_timer_t;
+    uv_timer_init(event_loop_, metrics_timer_);
+    metrics_timer_->data = this;
+    uv_timer_start(metrics_timer_, [](uv_timer_t* timer) {
+        static_cast<NexusKernel*>(timer->data)->sample_runtime_metrics();
+    }, 0, 1000);
+    uv_unref(reinterpret_cast<uv_handle_t*>(metrics_timer_));
 
-    } catch (const std::exception& e) {
-        std::cerr << "Kernel initialization failed: " << e.what() << "\n";
-        return false;
+    metrics_exporter_ = std::make_unique<MetricsExporter>([this](OpenMetricsWriter& out) { write_metrics(out); });
+    std::string error;
+    if (!metrics_exporter_->start(listen, error)) {
+        std::cerr << "nexus: " << error << "\n";
+        stop_metrics_exporter();
+        return;
+    }
+    if (!config()->quiet) {
+        std::cout << "📊 Metrics at " << metrics_exporter_->address() << "\n";
+    }
+}
+
+void NexusKernel::stop_metrics_exporter() {
+    metrics_exporter_.reset();
+    if (metrics_timer_) {
+        uv_close(reinterpret_cast<uv_handle_t*>(metrics_timer_), [](uv_handle_t* handle) {
+            delete reinterpret_cast<uv_timer_t*>(handle);
+        });
+        metrics_timer_ = nullptr;
+    }
+}
+
+// Main thread: the isolate, the bridge and the code cache (until its
+// background load finishes) are not safe to read from the exporter
+void NexusKernel::sample_runtime_metrics() {
+    RuntimeSample sample;
+    sample.js_runtime_ready = js_runtime_ready_;
+    sample.js_runtime_startup_us = js_runtime_startup_us_;
+
+    bool code_cache_loaded = !code_cache_ready_.valid() ||
+        code_cache_ready_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    if (code_cache_loaded && code_cache_) {
+        sample.code_cache_hits = code_cache_->get_hits();
+        sample.code_cache_misses = code_cache_->get_misses();
+    }
+    if (js_runtime_ready_ && isolate_) {
+        v8::Isolate::Scope isolate_scope(isolate_);
+        v8::HeapStatistics heap;
+        isolate_->GetHeapStatistics(&heap);
+        sample.js_heap_used = heap.used_heap_size();
+        sample.js_heap_total = heap.total_heap_size();
+        sample.js_heap_limit = heap.heap_size_limit();
+        sample.js_external_memory = heap.external_memory();
+        sample.native_objects = object_bridge_->object_registry().get_stats().live_objects;
+    }
+
+    std::lock_guard<std::mutex> lock(runtime_sample_mutex_);
+    runtime_sample_ = sample;
+}
+
+// Exporter thread
+void NexusKernel::write_metrics(OpenMetricsWriter& out) const {
+    PerformanceMetrics commands{};
+    command_metrics_.collect(commands);
+    RuntimeSample runtime;
+    {
+        std::lock_guard<std::mutex> lock(runtime_sample_mutex_);
+        runtime = runtime_sample_;
+    }
+
+    out.gauge("nexus_startup_seconds", "Time until the shell accepted commands",
+              static_cast<double>(startup_time_us_) / 1e6, "seconds");
+    out.counter("nexus_commands", "Commands executed", static_cast<double>(commands.commands_executed));
+    out.counter("nexus_command_failures", "Commands that failed or returned an error",
+                static_cast<double>(commands.commands_failed));
+
+    out.begin("nexus_command_latency_seconds", "summary", "Command latency by command and phase", "seconds");
+    for (const CommandLatency& entry : commands.command_latency) {
+        out.latency("nexus_command_latency_seconds", {{"command", entry.command}, {"phase", entry.phase}},
+                    entry.latency);
+    }
+    out.begin("nexus_command_latency_max_seconds", "gauge", "Slowest command by command and phase", "seconds");
+    for (const CommandLatency& entry : commands.command_latency) {
+        out.sample("nexus_command_latency_max_seconds", "", {{"command", entry.command}, {"phase", entry.phase}},
+                   static_cast<double>(entry.latency.max_us) / 1e6);
+    }
+
+    if (thread_pool_) {
+        out.gauge("nexus_thread_pool_threads", "Worker threads", static_cast<double>(thread_pool_->get_thread_count()));
+        out.gauge("nexus_thread_pool_queued_tasks", "Tasks waiting for a worker",
+                  static_cast<double>(thread_pool_->get_queue_size()));
+        out.gauge("nexus_thread_pool_active_tasks", "Tasks running", static_cast<double>(thread_pool_->get_active_tasks()));
+    }
+    if (memory_manager_) {
+        out.gauge("nexus_memory_used_bytes", "Memory reserved through the memory manager",
+                  static_cast<double>(memory_manager_->get_used_memory()), "bytes");
+        out.gauge("nexus_memory_limit_bytes", "Memory manager limit",
+                  static_cast<double>(memory_manager_->get_total_memory()), "bytes");
+    }
+
+    out.counter("nexus_code_cache_hits", "Scripts compiled from the code cache",
+                static_cast<double>(runtime.code_cache_hits));
+    out.counter("nexus_code_cache_misses", "Scripts compiled without a cached entry",
+                static_cast<double>(runtime.code_cache_misses));
+
+    out.gauge("nexus_js_runtime_ready", "Whether the lazily created JS runtime exists",
+              runtime.js_runtime_ready ? 1 : 0);
+    out.gauge("nexus_js_runtime_startup_seconds", "Time the first JS command spent creating the runtime",
+              static_cast<double>(runtime.js_runtime_startup_us) / 1e6, "seconds");
+    out.gauge("nexus_js_heap_used_bytes", "V8 heap in use", static_cast<double>(runtime.js_heap_used), "bytes");
+    out.gauge("nexus_js_heap_total_bytes", "V8 heap reserved", static_cast<double>(runtime.js_heap_total), "bytes");
+    out.gauge("nexus_js_heap_limit_bytes", "V8 heap limit", static_cast<double>(runtime.js_heap_limit), "bytes");
+    out.gauge("nexus_js_external_memory_bytes", "Memory held outside the V8 heap by JS objects",
+              static_cast<double>(runtime.js_external_memory), "bytes");
+    out.counter("nexus_js_heap_limit_cancellations", "JS commands stopped at the heap limit",
+                static_cast<double>(heap_limit_cancellations_.load(std::memory_order_relaxed)));
+    out.gauge("nexus_native_objects", "Native objects owned by JS handles",
+              static_cast<double>(runtime.native_objects));
+}
+
+// Background initialization tasks reference the kernel: never leave one running
+void NexusKernel::wait_for_background_init() {
+    if (security_ready_.valid()) {
+        security_ready_.wait();
+    }
+    if (v8_platform_ready_.valid()) {
+        v8_platform_ready_.wait();
+    }
+    if (code_cache_ready_.valid()) {
+        code_cache_ready_.wait();
     }
 }
 
@@ -106,63 +384,124 @@ void NexusKernel::shutdown() {
     }
 
     running_.store(false);
+    stop_metrics_exporter();
+    release_components();
+
+    if (!config()->quiet) {
+        std::cout << "🛑 NexusShell kernel shutdown complete\n";
+    }
+}
+
+// Also undoes a failed initialize(), so every step tolerates components
+// that were never created
+void NexusKernel::release_components() {
+    wait_for_background_init();
 
     // Shutdown components in reverse order
+    plugins_.reset();
     execution_engine_.reset();
     parser_.reset();
+    isolate_pool_.reset();
+    if (file_watcher_ && config_subscription_) {
+        file_watcher_->unsubscribe(config_subscription_);
+        config_subscription_ = 0;
+    }
+    if (object_bridge_) {
+        object_bridge_->set_file_watcher(nullptr);  // Watch handles outlive the watcher
+    }
+    file_watcher_.reset();  // Holds JS callbacks; release before the isolate
+    http_client_.reset();
     object_bridge_.reset();
+    process_snapshots_.reset();
     
     cleanup_v8();
     cleanup_libuv();
+    code_cache_.reset();
     
     security_context_.reset();
     thread_pool_.reset();
     memory_manager_.reset();
-
-    std::cout << "🛑 NexusShell kernel shutdown complete\n";
 }
 
 NexusObject NexusKernel::execute_command(const std::string& input, const CommandContext& context) {
-    auto start_time = std::chrono::high_resolution_clock::now();
-    
+    using Clock = std::chrono::steady_clock;
+    auto start_time = Clock::now();
+    auto phase_start = start_time;
+    auto elapsed_us = [](Clock::time_point from, Clock::time_point to) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(to - from).count());
+    };
+
+    CommandMetrics::Sample sample;
+    auto end_phase = [&](CommandPhase phase) {
+        auto now = Clock::now();
+        sample.set(phase, elapsed_us(phase_start, now));
+        phase_start = now;
+    };
+
+    // Named after the first word until the input is parsed
+    std::string command_name = input.substr(0, input.find_first_of(" \t|"));
+    NexusObject result;
     try {
         // Security check
         if (!security_context_->check_permission("command:execute", input)) {
             throw std::runtime_error("Permission denied: " + input);
         }
+        end_phase(CommandPhase::Security);
 
         // Parse command
         auto parsed = parser_->parse(input);
+        end_phase(CommandPhase::Parse);
         
         // Execute based on type
-        NexusObject result;
+        uint64_t convert_us = 0;
         if (parsed.is_js_pipeline) {
-            result = execute_js_pipeline(parsed.js_code, context);
+            command_name = "js";
+            result = run_js_pipeline(parsed.js_code, context, &convert_us);
         } else if (parsed.is_pipeline) {
+            command_name = "pipeline";
             result = execute_pipeline(parsed.commands, context);
         } else {
+            command_name = parsed.commands[0].command;
             result = execution_engine_->execute_single_command(parsed.commands[0], context);
         }
-
-        // Update performance metrics
-        auto end_time = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
-        
-        {
-            std::lock_guard<std::mutex> lock(metrics_mutex_);
-            metrics_.commands_executed++;
-            metrics_.total_execution_time_us += duration.count();
-            metrics_.memory_usage_bytes = memory_manager_->get_used_memory();
+        auto now = Clock::now();
+        uint64_t execute_us = elapsed_us(phase_start, now);
+        if (parsed.is_js_pipeline) {
+            sample.set(CommandPhase::Convert, convert_us);
+            execute_us -= std::min(execute_us, convert_us);
         }
-
-        return result;
+        sample.set(CommandPhase::Execute, execute_us);
+        sample.failed = result.metadata.type_id == TypeIds::Error || result.metadata.type_id == TypeIds::JsError;
 
     } catch (const std::exception& e) {
-        NexusObject error_obj;
-        error_obj.metadata.type = "error";
-        error_obj.value = std::string("Command execution failed: ") + e.what();
-        return error_obj;
+        result = NexusObject();
+        result.metadata.type_id = TypeIds::Error;
+        result.value = std::string("Command execution failed: ") + e.what();
+        sample.failed = true;
     }
+
+    // Recorded for failures too; the shard is this thread's, so no lock
+    uint64_t total_us = elapsed_us(start_time, Clock::now());
+    sample.command = command_name;
+    sample.set(CommandPhase::Total, total_us);
+    command_metrics_.record(sample);
+
+    // Thresholds are read from the published snapshot: no lock per command
+    std::shared_ptr<const NexusConfig> config = this->config();
+    if (config->monitoring) {
+        uint64_t elapsed_ms = total_us / 1000;
+        if (config->latency_warning_ms && elapsed_ms > config->latency_warning_ms) {
+            std::cerr << "⚠️  Command took " << elapsed_ms << " ms (latency warning at "
+                      << config->latency_warning_ms << " ms)\n";
+        }
+        size_t used = memory_manager_->get_used_memory();
+        if (config->memory_warning && used > config->memory_warning) {
+            std::cerr << "⚠️  Memory in use: " << (used >> 20) << " MB (warning at "
+                      << (config->memory_warning >> 20) << " MB)\n";
+        }
+    }
+
+    return result;
 }
 
 NexusObject NexusKernel::execute_pipeline(const std::vector<std::string>& commands, const CommandContext& context) {
@@ -170,31 +509,216 @@ NexusObject NexusKernel::execute_pipeline(const std::vector<std::string>& comman
 }
 
 NexusObject NexusKernel::execute_js_pipeline(const std::string& js_code, const CommandContext& context) {
+    return run_js_pipeline(js_code, context, nullptr);
+}
+
+// convert_us, if given, receives the time spent converting the result
+NexusObject NexusKernel::run_js_pipeline(const std::string& js_code, const CommandContext& context,
+                                         uint64_t* convert_us) {
+    if (!ensure_js_runtime()) {
+        NexusObject error_obj;
+        error_obj.metadata.type_id = TypeIds::JsError;
+        error_obj.value = std::string("JavaScript runtime unavailable");
+        return error_obj;
+    }
+
     v8::Isolate::Scope isolate_scope(isolate_);
     v8::HandleScope handle_scope(isolate_);
     v8::Local<v8::Context> local_context = global_context_.Get(isolate_);
     v8::Context::Scope context_scope(local_context);
+    v8::TryCatch try_catch(isolate_);
 
-    try {
-        // Compile JavaScript code
-        v8::Local<v8::String> source = v8::String::NewFromUtf8(
-            isolate_, js_code.c_str(), v8::NewStringType::kNormal
-        ).ToLocalChecked();
+    // Top-level await: retry code that only parses inside an async function,
+    // first as an expression so its value is still the result
+    std::vector<std::string> candidates{js_code};
+    if (js_code.find("await") != std::string::npos) {
+        candidates.push_back("(async () => (\n" + js_code + "\n))()");
+        candidates.push_back("(async () => {\n" + js_code + "\n})()");
+    }
 
-        v8::Local<v8::Script> script = v8::Script::Compile(local_context, source).ToLocalChecked();
-        
-        // Execute JavaScript
-        v8::Local<v8::Value> result = script->Run(local_context).ToLocalChecked();
-        
-        // Convert result back to NexusObject
-        return object_bridge_->js_to_nexus(result);
+    v8::Local<v8::Script> script;
+    uint64_t source_hash = 0;
+    bool produce_cache = false;
+    for (const std::string& candidate : candidates) {
+        try_catch.Reset();
+        v8::Local<v8::String> source;
+        if (!v8::String::NewFromUtf8(isolate_, candidate.data(), v8::NewStringType::kNormal,
+                                     static_cast<int>(candidate.size())).ToLocal(&source)) {
+            break;
+        }
+        source_hash = CodeCache::hash_source(candidate);
+        if (object_bridge_->compile_script(local_context, source, source_hash, produce_cache).ToLocal(&script)) {
+            break;
+        }
+    }
+    if (script.IsEmpty()) {
+        return js_exception_to_nexus(local_context, try_catch.Exception());
+    }
 
-    } catch (const std::exception& e) {
-        NexusObject error_obj;
-        error_obj.metadata.type = "js_error";
-        error_obj.value = std::string("JavaScript execution failed: ") + e.what();
-        return error_obj;
+    v8::Local<v8::Value> result;
+    if (!script->Run(local_context).ToLocal(&result)) {
+        if (recover_from_heap_limit()) {
+            return heap_limit_error();
+        }
+        isolate_->PerformMicrotaskCheckpoint();
+        return js_exception_to_nexus(local_context, try_catch.Exception());
+    }
+
+    // Serialize after running so functions compiled lazily during the
+    // first execution are part of the cache as well
+    if (produce_cache) {
+        object_bridge_->update_code_cache(script, source_hash);
+    }
+    isolate_->PerformMicrotaskCheckpoint();
+
+    if (result->IsPromise()) {
+        v8::Local<v8::Promise> promise = result.As<v8::Promise>();
+        bool settled = await_promise(promise);
+        if (recover_from_heap_limit()) {
+            return heap_limit_error();
+        }
+        if (!settled) {
+            NexusObject error_obj;
+            error_obj.metadata.type_id = TypeIds::JsError;
+            error_obj.value = std::string("JavaScript execution failed: promise can never settle");
+            return error_obj;
+        }
+        if (promise->State() == v8::Promise::kRejected) {
+            promise->MarkAsHandled();
+            return js_exception_to_nexus(local_context, promise->Result());
+        }
+        result = promise->Result();
+    }
+
+    // Convert result back to NexusObject
+    auto convert_start = std::chrono::steady_clock::now();
+    NexusObject converted = object_bridge_->js_to_nexus(result);
+    if (convert_us) {
+        *convert_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - convert_start).count());
+    }
+    return converted;
+}
+
+// Runs the event loop until the promise settles. False if it is still
+// pending once nothing is left that could settle it
+bool NexusKernel::await_promise(v8::Local<v8::Promise> promise) {
+    while (promise->State() == v8::Promise::kPending && !heap_guard_.limit_reached()) {
+        bool alive = uv_run(event_loop_, UV_RUN_ONCE) != 0;
+        pump_v8_tasks();
+        if (!alive && promise->State() == v8::Promise::kPending && !uv_loop_alive(event_loop_)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+NexusObject NexusKernel::heap_limit_error() const {
+    NexusObject error_obj;
+    error_obj.metadata.type_id = TypeIds::JsError;
+    error_obj.value = "JavaScript heap limit reached (" + std::to_string(heap_guard_.heap_limit() >> 20) +
+                      " MB); pipeline cancelled";
+    return error_obj;
+}
+
+// Foreground tasks posted by V8 (e.g. finalizers) and pending microtasks
+void NexusKernel::pump_v8_tasks() {
+    if (!isolate_) {
+        return;
     }
+    v8::Isolate::Scope isolate_scope(isolate_);
+    v8::HandleScope handle_scope(isolate_);
+    while (v8::platform::PumpMessageLoop(platform_.get(), isolate_)) {
+    }
+    isolate_->PerformMicrotaskCheckpoint();
+}
+
+NexusObject NexusKernel::js_exception_to_nexus(v8::Local<v8::Context> context, v8::Local<v8::Value> exception) {
+    std::string message = "unknown error";
+    if (!exception.IsEmpty()) {
+        v8::Local<v8::Value> stack;
+        if (exception->IsObject() &&
+            exception.As<v8::Object>()->Get(context, v8::String::NewFromUtf8Literal(isolate_, "stack")).ToLocal(&stack) &&
+            stack->IsString()) {
+            message = *v8::String::Utf8Value(isolate_, stack);
+        } else {
+            v8::String::Utf8Value text(isolate_, exception);
+            if (*text) {
+                message = *text;
+            }
+        }
+    }
+    NexusObject error_obj;
+    error_obj.metadata.type_id = TypeIds::JsError;
+    error_obj.value = "JavaScript execution failed: " + message;
+    return error_obj;
+}
+
+void NexusKernel::run_pending_events() {
+    uv_run(event_loop_, UV_RUN_NOWAIT);
+    pump_v8_tasks();
+    report_idle_heap_limit();
+}
+
+// A timer or watcher callback exhausted the heap while no pipeline ran
+void NexusKernel::report_idle_heap_limit() {
+    if (!isolate_) {
+        return;
+    }
+    v8::Isolate::Scope isolate_scope(isolate_);
+    if (recover_from_heap_limit()) {
+        std::cerr << "nexus: " << std::get<std::string>(heap_limit_error().value) << "\n";
+    }
+}
+
+void NexusKernel::wait_for_input(int fd) {
+    // Regular files and /dev/null cannot be polled: they are always readable
+    uv_poll_t* poll = new uv_poll_t;
+    if (uv_poll_init(event_loop_, poll, fd) != 0) {
+        delete poll;
+        run_pending_events();
+        return;
+    }
+    bool readable = false;
+    poll->data = &readable;
+    uv_poll_start(poll, UV_READABLE | UV_DISCONNECT, [](uv_poll_t* handle, int, int) {
+        *static_cast<bool*>(handle->data) = true;
+        uv_poll_stop(handle);
+    });
+    while (!readable && running_.load()) {
+        uv_run(event_loop_, UV_RUN_ONCE);
+        pump_v8_tasks();
+        report_idle_heap_limit();
+    }
+    uv_close(reinterpret_cast<uv_handle_t*>(poll), [](uv_handle_t* handle) {
+        delete reinterpret_cast<uv_poll_t*>(handle);
+    });
+}
+
+void NexusKernel::begin_request(std::vector<std::string> environment) {
+    // Without the JS runtime nothing could start async work
+    if (js_runtime_ready_ && object_bridge_) {
+        object_bridge_->begin_request(std::move(environment));
+    }
+}
+
+void NexusKernel::end_request() {
+    if (!js_runtime_ready_ || !object_bridge_) {
+        return;
+    }
+    v8::Isolate::Scope isolate_scope(isolate_);
+    v8::HandleScope handle_scope(isolate_);
+    object_bridge_->end_request();
+}
+
+std::future<NexusObject> NexusKernel::execute_js_pipeline_async(const std::string& js_code, const CommandContext& context) {
+    ensure_js_runtime();
+    if (!isolate_pool_ || isolate_pool_->size() == 0) {
+        std::promise<NexusObject> promise;
+        promise.set_value(execute_js_pipeline(js_code, context));
+        return promise.get_future();
+    }
+    return isolate_pool_->execute_async(js_code);
 }
 
 ObjectId NexusKernel::begin_transaction() {
@@ -204,14 +728,26 @@ ObjectId NexusKernel::begin_transaction() {
 
     TransactionState state;
     state.transaction_id = transaction_id;
+    state.files = std::make_shared<FsTransaction>(transaction_id);
     
     transactions_[transaction_id] = std::move(state);
     return transaction_id;
 }
 
+bool NexusKernel::protect_path(ObjectId transaction_id, const std::string& path, std::string& error) {
+    auto it = transactions_.find(transaction_id);
+    if (it == transactions_.end()) {
+        error = "No such transaction";
+        return false;
+    }
+    return it->second.files->protect(path, error);
+}
+
 void NexusKernel::commit_transaction(ObjectId transaction_id) {
     auto it = transactions_.find(transaction_id);
     if (it != transactions_.end()) {
+        it->second.files->commit();
+        collect_transaction_garbage(std::move(it->second.files));
         transactions_.erase(it);
     }
 }
@@ -219,42 +755,96 @@ void NexusKernel::commit_transaction(ObjectId transaction_id) {
 void NexusKernel::rollback_transaction(ObjectId transaction_id) {
     auto it = transactions_.find(transaction_id);
     if (it != transactions_.end()) {
+        // Protected paths first, so the handler sees them as they were,
+        // like NexusTransaction in the JS runtime
+        std::string error;
+        if (!it->second.files->rollback(error)) {
+            std::cerr << "Transaction rollback incomplete: " << error << std::endl;
+        }
         if (it->second.rollback_handler) {
             it->second.rollback_handler();
         }
+        collect_transaction_garbage(std::move(it->second.files));
         transactions_.erase(it);
     }
 }
 
+// Dropped snapshots and displaced trees can be large; delete them off the
+// command path
+void NexusKernel::collect_transaction_garbage(std::shared_ptr<FsTransaction> files) {
+    if (thread_pool_) {
+        thread_pool_->submit([files] { files->collect_garbage(); });
+    } else {
+        files->collect_garbage();
+    }
+}
+
 PerformanceMetrics NexusKernel::get_performance_metrics() const {
-    std::lock_guard<std::mutex> lock(metrics_mutex_);
-    return metrics_;
+    PerformanceMetrics metrics{};
+    command_metrics_.collect(metrics);
+    metrics.memory_usage_bytes = memory_manager_ ? memory_manager_->get_used_memory() : 0;
+    metrics.heap_limit_cancellations = heap_limit_cancellations_.load(std::memory_order_relaxed);
+    metrics.startup_time_us = startup_time_us_;
+    metrics.js_runtime_startup_us = js_runtime_startup_us_;
+    metrics.startup_snapshot_used = js_runtime_ready_ && globals_from_snapshot_;
+    // The pool task may still be creating the code cache
+    bool code_cache_loaded = !code_cache_ready_.valid() ||
+        code_cache_ready_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    if (code_cache_loaded && code_cache_) {
+        metrics.cache_hits = code_cache_->get_hits();
+        metrics.cache_misses = code_cache_->get_misses();
+    }
+    if (object_bridge_) {
+        ObjectRegistry::Stats registry = object_bridge_->object_registry().get_stats();
+        metrics.native_objects = registry.live_objects;
+        metrics.native_object_lookups = registry.lookups;
+        metrics.native_object_lookup_ns = registry.avg_lookup_ns;
+    }
+    return metrics;
 }
 
 void NexusKernel::reset_performance_metrics() {
-    std::lock_guard<std::mutex> lock(metrics_mutex_);
-    metrics_ = {};
+    command_metrics_.reset();
+    heap_limit_cancellations_.store(0, std::memory_order_relaxed);
 }
 
-bool NexusKernel::initialize_v8() {
-    // Initialize V8
+// Process-wide V8 setup; needs no isolate, so it runs on the pool while
+// the shell comes up
+bool NexusKernel::initialize_v8_platform() {
     v8::V8::InitializeICUDefaultLocation("");
     v8::V8::InitializeExternalStartupData("");
-    
-    std::unique_ptr<v8::Platform> platform = v8::platform::NewDefaultPlatform();
-    v8::V8::InitializePlatform(platform.get());
+
+    platform_ = v8::platform::NewDefaultPlatform();
+    v8::V8::InitializePlatform(platform_.get());
     v8::V8::Initialize();
 
-    // Create isolate
+    globals_from_snapshot_ = load_startup_snapshot();
+    return true;
+}
+
+bool NexusKernel::create_main_isolate() {
+    // ArrayBuffers are charged to the MemoryManager budget, the heap is
+    // capped by js_heap_limit (max_memory unless configured)
+    array_buffer_allocator_ = std::make_unique<ManagedArrayBufferAllocator>(memory_manager_.get());
     v8::Isolate::CreateParams create_params;
-    create_params.array_buffer_allocator = v8::ArrayBuffer::Allocator::NewDefaultAllocator();
+    create_params.array_buffer_allocator = array_buffer_allocator_.get();
+    create_params.external_references = StellarObjectBridge::external_references();
+    isolate_limits().apply(create_params.constraints);
+    if (globals_from_snapshot_) {
+        create_params.snapshot_blob = &startup_data_;
+    }
     isolate_ = v8::Isolate::New(create_params);
 
     if (!isolate_) {
         return false;
     }
+    heap_guard_.attach(isolate_);
+
+    // Microtasks run at defined points (after a script, after each loop
+    // callback) rather than whenever the call depth drops to zero
+    isolate_->SetMicrotasksPolicy(v8::MicrotasksPolicy::kExplicit);
 
-    // Create global context
+    // Create global context (deserialized from the snapshot when present)
     v8::Isolate::Scope isolate_scope(isolate_);
     v8::HandleScope handle_scope(isolate_);
     v8::Local<v8::Context> context = v8::Context::New(isolate_);
@@ -263,6 +853,36 @@ bool NexusKernel::initialize_v8() {
     return true;
 }
 
+bool NexusKernel::load_startup_snapshot() {
+    std::shared_ptr<const NexusConfig> config = this->config();
+    if (!config->startup_snapshot) {
+        return false;
+    }
+    std::string snapshot_path = config->snapshot_path;
+    if (snapshot_path.empty()) {
+        snapshot_path = NEXUS_DATA_DIR "/nexus_snapshot.blob";
+    }
+
+    std::ifstream snapshot_file(snapshot_path, std::ios::binary);
+    if (!snapshot_file.is_open()) {
+        return false;
+    }
+
+    snapshot_blob_.assign((std::istreambuf_iterator<char>(snapshot_file)),
+                          std::istreambuf_iterator<char>());
+    startup_data_.data = snapshot_blob_.data();
+    startup_data_.raw_size = static_cast<int>(snapshot_blob_.size());
+
+    // A blob produced by a different V8 build cannot be deserialized
+    if (snapshot_blob_.empty() || !startup_data_.IsValid()) {
+        std::cerr << "Ignoring incompatible startup snapshot: " << snapshot_path << "\n";
+        snapshot_blob_.clear();
+        startup_data_ = {nullptr, 0};
+        return false;
+    }
+    return true;
+}
+
 bool NexusKernel::initialize_libuv() {
     event_loop_ = uv_default_loop();
     return event_loop_ != nullptr;
@@ -274,70 +894,166 @@ void NexusKernel::setup_js_globals() {
     v8::Local<v8::Context> context = global_context_.Get(isolate_);
     v8::Context::Scope context_scope(context);
 
-    // Setup global nexus object
-    v8::Local<v8::Object> nexus_global = v8::Object::New(isolate_);
-    
-    // Add filesystem API
-    v8::Local<v8::Object> fs_api = object_bridge_->create_filesystem_api();
-    nexus_global->Set(context, 
-        v8::String::NewFromUtf8(isolate_, "fs").ToLocalChecked(), 
-        fs_api
-    ).Check();
-
-    // Add process API
-    v8::Local<v8::Object> proc_api = object_bridge_->create_process_api();
-    nexus_global->Set(context,
-        v8::String::NewFromUtf8(isolate_, "proc").ToLocalChecked(),
-        proc_api
-    ).Check();
-
-    // Add network API
-    v8::Local<v8::Object> net_api = object_bridge_->create_network_api();
-    nexus_global->Set(context,
-        v8::String::NewFromUtf8(isolate_, "net").ToLocalChecked(),
-        net_api
-    ).Check();
-
-    // Set global nexus object
-    context->Global()->Set(context,
-        v8::String::NewFromUtf8(isolate_, "nexus").ToLocalChecked(),
-        nexus_global
-    ).Check();
+    object_bridge_->install_globals(context);
+
+    // Load the high-level JavaScript runtime on top of the native APIs
+    std::string runtime_path = js_runtime_path();
+    if (!object_bridge_->run_script_file(context, runtime_path)) {
+        std::cerr << "Warning: JavaScript runtime not loaded from " << runtime_path << "\n";
+    }
+}
+
+std::string NexusKernel::js_runtime_path() const {
+    std::string runtime_path = config()->js_runtime_path;
+    if (runtime_path.empty()) {
+        const char* js_path = std::getenv("NEXUS_JS_PATH");
+        runtime_path = std::string(js_path ? js_path : NEXUS_DATA_DIR "/js") + "/nexus-runtime.js";
+    }
+    return runtime_path;
+}
+
+IsolateLimits NexusKernel::isolate_limits() const {
+    std::shared_ptr<const NexusConfig> config = this->config();
+    IsolateLimits limits;
+    limits.heap_limit = config->js_heap_limit ? config->js_heap_limit : config->max_memory;
+    limits.young_generation_size = config->js_young_generation_size;
+    return limits;
+}
+
+bool NexusKernel::recover_from_heap_limit() {
+    if (!heap_guard_.recover()) {
+        return false;
+    }
+    heap_limit_cancellations_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool NexusKernel::initialize_isolate_pool() {
+    size_t pool_size = std::min<size_t>(4, std::max(1u, std::thread::hardware_concurrency()));
+    pool_size = config()->js_isolate_pool_size.value_or(pool_size);
+    if (pool_size == 0) {
+        return true;
+    }
+
+    isolate_pool_ = std::make_unique<IsolatePool>(thread_pool_.get(), security_context_.get(), pool_size,
+                                                  memory_manager_.get(), isolate_limits());
+    isolate_pool_->set_code_cache(code_cache_.get());
+    if (!isolate_pool_->initialize(globals_from_snapshot_ ? &startup_data_ : nullptr, js_runtime_path())) {
+        return false;
+    }
+    object_bridge_->set_isolate_pool(isolate_pool_.get());
+    return true;
 }
 
 void NexusKernel::cleanup_v8() {
     if (isolate_) {
         global_context_.Reset();
+        heap_guard_.detach();
         isolate_->Dispose();
         isolate_ = nullptr;
     }
-    v8::V8::Dispose();
-    v8::V8::ShutdownPlatform();
+    array_buffer_allocator_.reset();
+    if (platform_) {
+        v8::V8::Dispose();
+        v8::V8::DisposePlatform();
+        platform_.reset();
+    }
+    snapshot_blob_.clear();
+    startup_data_ = {nullptr, 0};
 }
 
 void NexusKernel::cleanup_libuv() {
     if (event_loop_) {
+        // Let handles closed by the components above run their close callbacks
+        uv_run(event_loop_, UV_RUN_NOWAIT);
         uv_loop_close(event_loop_);
         event_loop_ = nullptr;
     }
 }
 
 bool NexusKernel::load_plugin(const std::string& plugin_path) {
-    // Plugin loading implementation
+    std::string name, error;
+    if (!plugins_ || !plugins_->load(plugin_path, name, error)) {
+        std::cerr << "nexus: " << (plugins_ ? error : "kernel not initialized") << "\n";
+        return false;
+    }
     return true;
 }
 
 void NexusKernel::unload_plugin(const std::string& plugin_name) {
-    // Plugin unloading implementation
+    std::string error;
+    if (plugins_ && !plugins_->unload(plugin_name, error)) {
+        std::cerr << "nexus: " << error << "\n";
+    }
 }
 
-void NexusKernel::set_config(const std::string& key, const std::string& value) {
-    config_[key] = value;
+bool NexusKernel::set_config(const std::string& key, const std::string& value) {
+    std::string error;
+    if (!config_.update(key, value, error)) {
+        std::cerr << "nexus: " << error << "\n";
+        return false;
+    }
+    // Survives reloads of the configuration file; a later value for the
+    // same setting replaces the earlier one
+    config_overrides_[NexusConfig::canonical_key(key)] = value;
+    return true;
 }
 
 std::string NexusKernel::get_config(const std::string& key) const {
-    auto it = config_.find(key);
-    return it != config_.end() ? it->second : "";
+    std::shared_ptr<const NexusConfig> config = this->config();
+    auto it = config->values.find(key);
+    return it != config->values.end() ? it->second : "";
+}
+
+// The file (if any), then the environment, then set_config() overrides
+bool NexusKernel::read_config(NexusConfig& config, std::string& error) const {
+    NexusConfig next;
+    if (!config_path_.empty() && !next.load(config_path_, error)) {
+        return false;
+    }
+    next.apply_environment();
+    for (const auto& [key, value] : config_overrides_) {
+        next.set(key, value, error);
+    }
+    config = std::move(next);
+    return true;
+}
+
+bool NexusKernel::reload_config() {
+    NexusConfig next;
+    std::string error;
+    if (!read_config(next, error)) {
+        std::cerr << "nexus: configuration not reloaded: " << error << "\n";
+        return false;
+    }
+    config_.publish(std::move(next));
+    std::cerr << "nexus: configuration reloaded from " << config_path_ << "\n";
+    return true;
+}
+
+// Editors replace the file instead of writing it in place, which ends a
+// watch on the file itself: watch its directory and match the name
+void NexusKernel::watch_config_file() {
+    if (config_path_.empty() || !file_watcher_) {
+        return;
+    }
+    std::error_code ec;
+    std::filesystem::path path = std::filesystem::absolute(config_path_, ec);
+    if (ec) {
+        return;
+    }
+    std::string name = path.filename().string();
+    config_subscription_ = file_watcher_->subscribe(path.parent_path().string(), {},
+        [this, name](const std::vector<FileEvent>& events) {
+            for (const FileEvent& event : events) {
+                if (event.type == FileEventType::Overflow ||
+                    (event.type != FileEventType::Deleted &&
+                     std::filesystem::path(event.path).filename() == name)) {
+                    reload_config();
+                    return;
+                }
+            }
+        });
 }
 
 } // namespace Nexus
\ No newline at end of file
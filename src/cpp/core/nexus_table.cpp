@@ -0,0 +1,191 @@
+#include "nexus_table.h"
+#include <algorithm>
+#include <cmath>
+#include <fnmatch.h>
+#include <numeric>
+
+namespace Nexus {
+
+namespace {
+
+// Branch-free selection: every index is written, only matches advance the
+// cursor, so the loop has no data-dependent jumps for the compiler to miss
+template <typename Predicate>
+std::vector<uint32_t> select_rows(size_t rows, Predicate predicate) {
+    std::vector<uint32_t> indices(rows);
+    size_t count = 0;
+    for (size_t i = 0; i < rows; ++i) {
+        indices[count] = static_cast<uint32_t>(i);
+        count += predicate(i) ? 1 : 0;
+    }
+    indices.resize(count);
+    return indices;
+}
+
+} // namespace
+
+NexusTable::Numbers& NexusTable::add_number_column(std::string name) {
+    auto data = std::make_shared<Numbers>(rows_);
+    Numbers& values = *data;
+    columns_.push_back({std::move(name), ColumnKind::Number, std::move(data), nullptr});
+    return values;
+}
+
+NexusTable::Strings& NexusTable::add_string_column(std::string name) {
+    auto data = std::make_shared<Strings>(rows_);
+    Strings& values = *data;
+    columns_.push_back({std::move(name), ColumnKind::String, nullptr, std::move(data)});
+    return values;
+}
+
+const NexusTable::Column* NexusTable::column(std::string_view name) const {
+    for (const Column& entry : columns_) {
+        if (entry.name == name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool NexusTable::parse_op(std::string_view text, Op& op) {
+    static const std::pair<std::string_view, Op> kOps[] = {
+        {"==", Op::Eq}, {"!=", Op::Ne}, {"<", Op::Lt}, {"<=", Op::Le}, {">", Op::Gt}, {">=", Op::Ge},
+        {"contains", Op::Contains}, {"startsWith", Op::StartsWith}, {"endsWith", Op::EndsWith},
+        {"glob", Op::Glob},
+    };
+    for (const auto& [name, value] : kOps) {
+        if (name == text) {
+            op = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::shared_ptr<NexusTable> NexusTable::filter(std::string_view name, Op op, double value) const {
+    const Column* source = column(name);
+    if (!source || source->kind != ColumnKind::Number) {
+        return nullptr;
+    }
+    const double* v = source->numbers->data();
+
+    // One specialized loop per operator keeps the comparison out of the loop
+    switch (op) {
+        case Op::Eq: return gather(select_rows(rows_, [&](size_t i) { return v[i] == value; }));
+        case Op::Ne: return gather(select_rows(rows_, [&](size_t i) { return v[i] != value; }));
+        case Op::Lt: return gather(select_rows(rows_, [&](size_t i) { return v[i] < value; }));
+        case Op::Le: return gather(select_rows(rows_, [&](size_t i) { return v[i] <= value; }));
+        case Op::Gt: return gather(select_rows(rows_, [&](size_t i) { return v[i] > value; }));
+        case Op::Ge: return gather(select_rows(rows_, [&](size_t i) { return v[i] >= value; }));
+        default: return nullptr;
+    }
+}
+
+std::shared_ptr<NexusTable> NexusTable::filter(std::string_view name, Op op, std::string_view value) const {
+    const Column* source = column(name);
+    if (!source || source->kind != ColumnKind::String) {
+        return nullptr;
+    }
+    const Strings& v = *source->strings;
+
+    switch (op) {
+        case Op::Eq: return gather(select_rows(rows_, [&](size_t i) { return v[i] == value; }));
+        case Op::Ne: return gather(select_rows(rows_, [&](size_t i) { return v[i] != value; }));
+        case Op::Lt: return gather(select_rows(rows_, [&](size_t i) { return v[i] < value; }));
+        case Op::Le: return gather(select_rows(rows_, [&](size_t i) { return v[i] <= value; }));
+        case Op::Gt: return gather(select_rows(rows_, [&](size_t i) { return v[i] > value; }));
+        case Op::Ge: return gather(select_rows(rows_, [&](size_t i) { return v[i] >= value; }));
+        case Op::Contains:
+            return gather(select_rows(rows_, [&](size_t i) {
+                return std::string_view(v[i]).find(value) != std::string_view::npos;
+            }));
+        case Op::StartsWith:
+            return gather(select_rows(rows_, [&](size_t i) { return std::string_view(v[i]).starts_with(value); }));
+        case Op::EndsWith:
+            return gather(select_rows(rows_, [&](size_t i) { return std::string_view(v[i]).ends_with(value); }));
+        case Op::Glob: {
+            std::string pattern(value);
+            return gather(select_rows(rows_, [&](size_t i) { return ::fnmatch(pattern.c_str(), v[i].c_str(), 0) == 0; }));
+        }
+    }
+    return nullptr;
+}
+
+std::shared_ptr<NexusTable> NexusTable::sort_by(std::string_view name, bool descending) const {
+    const Column* source = column(name);
+    if (!source) {
+        return nullptr;
+    }
+
+    std::vector<uint32_t> indices(rows_);
+    std::iota(indices.begin(), indices.end(), 0u);
+
+    if (source->kind == ColumnKind::Number) {
+        const double* v = source->numbers->data();
+        std::stable_sort(indices.begin(), indices.end(), [v, descending](uint32_t a, uint32_t b) {
+            double x = v[a], y = v[b];
+            if (std::isnan(x) || std::isnan(y)) {
+                return !std::isnan(x) && std::isnan(y);
+            }
+            return descending ? x > y : x < y;
+        });
+    } else {
+        const Strings& v = *source->strings;
+        std::stable_sort(indices.begin(), indices.end(), [&v, descending](uint32_t a, uint32_t b) {
+            return descending ? v[a] > v[b] : v[a] < v[b];
+        });
+    }
+    return gather(indices);
+}
+
+std::shared_ptr<NexusTable> NexusTable::select(const std::vector<std::string>& names) const {
+    auto result = std::make_shared<NexusTable>(rows_);
+    for (const std::string& name : names) {
+        const Column* source = column(name);
+        if (!source) {
+            return nullptr;
+        }
+        result->columns_.push_back(*source);
+    }
+    return result;
+}
+
+std::shared_ptr<NexusTable> NexusTable::take(const std::vector<uint32_t>& indices) const {
+    for (uint32_t index : indices) {
+        if (index >= rows_) {
+            return nullptr;
+        }
+    }
+    return gather(indices);
+}
+
+std::shared_ptr<NexusTable> NexusTable::gather(const std::vector<uint32_t>& indices) const {
+    auto result = std::make_shared<NexusTable>(indices.size());
+    bool identity = indices.size() == rows_ &&
+        std::adjacent_find(indices.begin(), indices.end(), [](uint32_t a, uint32_t b) { return a >= b; }) == indices.end();
+    if (identity) {
+        // Every row in order (an all-pass filter): share the columns
+        result->columns_ = columns_;
+        return result;
+    }
+
+    size_t count = indices.size();
+    for (const Column& source : columns_) {
+        if (source.kind == ColumnKind::Number) {
+            const double* in = source.numbers->data();
+            Numbers& out = result->add_number_column(source.name);
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = in[indices[i]];
+            }
+        } else {
+            const Strings& in = *source.strings;
+            Strings& out = result->add_string_column(source.name);
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = in[indices[i]];
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace Nexus
@@ -0,0 +1,56 @@
+#include "nexus_types.h"
+#include <mutex>
+#include <shared_mutex>
+
+namespace Nexus {
+
+namespace {
+
+struct TypeTable {
+    std::shared_mutex mutex;
+    std::unordered_map<std::string, TypeId> ids;
+    std::vector<std::unique_ptr<std::string>> names;    // Indexed by id; entries never move
+
+    TypeTable() {
+        // Order matches the TypeIds constants
+        for (const char* name : {"unknown", "null", "boolean", "number", "string", "buffer", "array",
+                                 "object", "circular", "error", "js_error", "exit"}) {
+            ids.emplace(name, static_cast<TypeId>(names.size()));
+            names.push_back(std::make_unique<std::string>(name));
+        }
+    }
+};
+
+TypeTable& type_table() {
+    static TypeTable table;
+    return table;
+}
+
+} // namespace
+
+TypeId intern_type(std::string_view name) {
+    TypeTable& table = type_table();
+    std::string key(name);
+    {
+        std::shared_lock lock(table.mutex);
+        auto it = table.ids.find(key);
+        if (it != table.ids.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock lock(table.mutex);
+    auto [it, inserted] = table.ids.emplace(key, static_cast<TypeId>(table.names.size()));
+    if (inserted) {
+        table.names.push_back(std::make_unique<std::string>(std::move(key)));
+    }
+    return it->second;
+}
+
+const std::string& type_name(TypeId id) {
+    TypeTable& table = type_table();
+    std::shared_lock lock(table.mutex);
+    return id < table.names.size() ? *table.names[id] : *table.names[TypeIds::Unknown];
+}
+
+} // namespace Nexus
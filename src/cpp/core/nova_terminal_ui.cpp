@@ -1,6 +1,6 @@
 #include "nova_terminal_ui.h"
+#include "result_format.h"
 #include <iostream>
-#include <sstream>
 #include <algorithm>
 #include <termios.h>
 #include <unistd.h>
@@ -32,6 +32,11 @@ void NovaTerminalUI::run_interactive_shell() {
     while (running_ && kernel_->is_running()) {
         try {
             print_prompt();
+            // Keep the event loop running until a line arrives, unless
+            // std::cin already buffered one (pasted multi-line input)
+            if (std::cin.rdbuf()->in_avail() <= 0) {
+                kernel_->wait_for_input(STDIN_FILENO);
+            }
             std::string input = read_line_with_completion();
             
             if (input.empty()) {
@@ -67,7 +72,7 @@ void NovaTerminalUI::run_interactive_shell() {
             auto result = kernel_->execute_command(input, context);
             
             // Handle special result types
-            if (result.metadata.type == "exit") {
+            if (result.metadata.type_id == TypeIds::Exit) {
                 running_ = false;
                 break;
             }
@@ -107,28 +112,14 @@ std::vector<std::string> NovaTerminalUI::get_completions(const std::string& part
 }
 
 void NovaTerminalUI::print_result(const NexusObject& result) {
-    if (result.metadata.type == "error") {
+    if (result.metadata.type_id == TypeIds::Error) {
         print_error(std::get<std::string>(result.value));
         return;
     }
     
-    std::visit([this](const auto& value) {
-        using T = std::decay_t<decltype(value)>;
-        
-        if constexpr (std::is_same_v<T, std::nullptr_t>) {
-            // Don't print anything for null results
-        } else if constexpr (std::is_same_v<T, bool>) {
-            std::cout << (value ? "true" : "false") << std::endl;
-        } else if constexpr (std::is_same_v<T, int64_t>) {
-            std::cout << value << std::endl;
-        } else if constexpr (std::is_same_v<T, double>) {
-            std::cout << value << std::endl;
-        } else if constexpr (std::is_same_v<T, std::string>) {
-            std::cout << value << std::endl;
-        } else if constexpr (std::is_same_v<T, std::vector<uint8_t>>) {
-            std::cout << "[Binary data: " << value.size() << " bytes]" << std::endl;
-        }
-    }, result.value);
+    std::string text;
+    format_result(result, text);
+    std::cout << text << std::flush;
 }
 
 void NovaTerminalUI::print_error(const std::string& error) {
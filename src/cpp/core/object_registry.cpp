@@ -0,0 +1,119 @@
+#include "object_registry.h"
+#include <chrono>
+#include <mutex>
+
+namespace Nexus {
+
+ObjectId ObjectRegistry::insert(std::shared_ptr<void> object) {
+    // Round-robin spreads concurrent writers over the shard locks
+    size_t shard_index = next_shard_.fetch_add(1, std::memory_order_relaxed) % kShardCount;
+    Shard& shard = shards_[shard_index];
+    std::unique_lock lock(shard.mutex);
+
+    uint32_t slot_index;
+    if (shard.free_head != kNoFreeSlot) {
+        slot_index = shard.free_head;
+        shard.free_head = shard.slots[slot_index].next_free;
+    } else {
+        if (shard.slots.size() > kSlotMask) {
+            return 0;
+        }
+        slot_index = static_cast<uint32_t>(shard.slots.size());
+        shard.slots.emplace_back();
+    }
+
+    Slot& slot = shard.slots[slot_index];
+    slot.object = std::move(object);
+    slot.next_free = kNoFreeSlot;
+    ++shard.live;
+    return encode(slot.generation, shard_index, slot_index);
+}
+
+std::shared_ptr<void> ObjectRegistry::find(const Shard& shard, uint32_t slot_index, uint32_t generation) const {
+    std::shared_lock lock(shard.mutex);
+    if (slot_index >= shard.slots.size()) {
+        return nullptr;
+    }
+    const Slot& slot = shard.slots[slot_index];
+    return slot.generation == generation ? slot.object : nullptr;
+}
+
+std::shared_ptr<void> ObjectRegistry::get(ObjectId handle) const {
+    const Shard& shard = shards_[(handle >> kSlotBits) & (kShardCount - 1)];
+    uint32_t slot_index = static_cast<uint32_t>(handle) & kSlotMask;
+    uint32_t generation = static_cast<uint32_t>(handle >> 32);
+
+    uint64_t count = shard.lookups.fetch_add(1, std::memory_order_relaxed);
+    std::shared_ptr<void> object;
+    if ((count & kLookupSampleMask) == 0) {
+        auto start = std::chrono::steady_clock::now();
+        object = find(shard, slot_index, generation);
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        shard.sampled_lookups.fetch_add(1, std::memory_order_relaxed);
+        shard.sampled_ns.fetch_add(static_cast<uint64_t>(elapsed), std::memory_order_relaxed);
+    } else {
+        object = find(shard, slot_index, generation);
+    }
+
+    if (!object) {
+        shard.misses.fetch_add(1, std::memory_order_relaxed);
+    }
+    return object;
+}
+
+bool ObjectRegistry::erase(ObjectId handle) {
+    Shard& shard = shards_[(handle >> kSlotBits) & (kShardCount - 1)];
+    uint32_t slot_index = static_cast<uint32_t>(handle) & kSlotMask;
+    uint32_t generation = static_cast<uint32_t>(handle >> 32);
+
+    std::shared_ptr<void> released;
+    {
+        std::unique_lock lock(shard.mutex);
+        if (slot_index >= shard.slots.size()) {
+            return false;
+        }
+        Slot& slot = shard.slots[slot_index];
+        if (slot.generation != generation || !slot.object) {
+            return false;
+        }
+        released = std::move(slot.object);
+        slot.object.reset();
+        // Generation 0 is skipped so a handle is never 0
+        slot.generation = slot.generation == UINT32_MAX ? 1 : slot.generation + 1;
+        slot.next_free = shard.free_head;
+        shard.free_head = slot_index;
+        --shard.live;
+    }
+    // The object's destructor runs outside the shard lock
+    return true;
+}
+
+size_t ObjectRegistry::size() const {
+    size_t total = 0;
+    for (const Shard& shard : shards_) {
+        std::shared_lock lock(shard.mutex);
+        total += shard.live;
+    }
+    return total;
+}
+
+ObjectRegistry::Stats ObjectRegistry::get_stats() const {
+    Stats stats;
+    uint64_t sampled = 0, sampled_ns = 0;
+    for (const Shard& shard : shards_) {
+        {
+            std::shared_lock lock(shard.mutex);
+            stats.live_objects += shard.live;
+            stats.slot_capacity += shard.slots.size();
+        }
+        stats.lookups += shard.lookups.load(std::memory_order_relaxed);
+        stats.lookup_misses += shard.misses.load(std::memory_order_relaxed);
+        sampled += shard.sampled_lookups.load(std::memory_order_relaxed);
+        sampled_ns += shard.sampled_ns.load(std::memory_order_relaxed);
+    }
+    stats.avg_lookup_ns = sampled ? static_cast<double>(sampled_ns) / sampled : 0;
+    return stats;
+}
+
+} // namespace Nexus
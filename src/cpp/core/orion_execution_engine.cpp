@@ -4,6 +4,8 @@
 #include <filesystem>
 #include <fstream>
 #include <algorithm>
+#include <charconv>
+#include <cstdio>
 
 namespace Nexus {
 
@@ -16,27 +18,38 @@ OrionExecutionEngine::~OrionExecutionEngine() = default;
 
 NexusObject OrionExecutionEngine::execute_single_command(const ParsedCommand& command, const CommandContext& context) {
     try {
+        CommandContext command_context = with_arguments(command, context);
+
         // Check if it's a native command
-        auto it = native_commands_.find(command.command);
-        if (it != native_commands_.end()) {
-            return it->second(context);
+        // The handler stays alive until it returns, even if unregistered meanwhile
+        if (CommandTable::Handler handler = native_commands_.find(command.command)) {
+            return (*handler)(command_context);
         }
         
         // Fall back to system command
-        return execute_system_command(command.command, context);
+        return execute_system_command(command.command, command_context);
         
     } catch (const std::exception& e) {
         NexusObject error_obj;
-        error_obj.metadata.type = "error";
+        error_obj.metadata.type_id = TypeIds::Error;
         error_obj.value = std::string("Command execution failed: ") + e.what();
         return error_obj;
     }
 }
 
+CommandContext OrionExecutionEngine::with_arguments(const ParsedCommand& command, const CommandContext& context) {
+    CommandContext command_context = context;
+    command_context.args = command.args;
+    for (const auto& [name, value] : command.flags) {
+        command_context.flags[name] = value;
+    }
+    return command_context;
+}
+
 NexusObject OrionExecutionEngine::execute_pipeline(const std::vector<std::string>& commands, const CommandContext& context) {
     if (commands.empty()) {
         NexusObject empty_obj;
-        empty_obj.metadata.type = "null";
+        empty_obj.metadata.type_id = TypeIds::Null;
         empty_obj.value = nullptr;
         return empty_obj;
     }
@@ -63,7 +76,7 @@ std::future<NexusObject> OrionExecutionEngine::execute_async(const std::string&
         }
         
         NexusObject empty_obj;
-        empty_obj.metadata.type = "null";
+        empty_obj.metadata.type_id = TypeIds::Null;
         empty_obj.value = nullptr;
         return empty_obj;
     });
@@ -76,18 +89,18 @@ std::future<NexusObject> OrionExecutionEngine::execute_pipeline_async(const std:
 }
 
 void OrionExecutionEngine::register_native_command(const std::string& name, CommandHandler handler) {
-    native_commands_[name] = handler;
+    native_commands_.set(name, std::move(handler));
 }
 
 void OrionExecutionEngine::unregister_command(const std::string& name) {
-    native_commands_.erase(name);
+    native_commands_.remove(name);
 }
 
 NexusObject OrionExecutionEngine::execute_system_command(const std::string& command, const CommandContext& context) {
     // This would execute system commands using subprocess
     // For now, return a placeholder
     NexusObject result;
-    result.metadata.type = "string";
+    result.metadata.type_id = TypeIds::String;
     result.value = std::string("System command executed: ") + command;
     return result;
 }
@@ -101,7 +114,7 @@ void OrionExecutionEngine::register_builtin_commands() {
     register_native_command("cp", cmd_cp);
     register_native_command("mv", cmd_mv);
     register_native_command("cat", cmd_cat);
-    register_native_command("ps", cmd_ps);
+    register_native_command("ps", [this](const CommandContext& context) { return cmd_ps(context); });
     register_native_command("kill", cmd_kill);
     register_native_command("help", cmd_help);
     register_native_command("exit", cmd_exit);
@@ -110,7 +123,7 @@ void OrionExecutionEngine::register_builtin_commands() {
 // Built-in command implementations
 NexusObject OrionExecutionEngine::cmd_ls(const CommandContext& context) {
     NexusObject result;
-    result.metadata.type = "string";
+    result.metadata.type_id = TypeIds::String;
     
     std::string path = context.args.empty() ? "." : context.args[0];
     std::string output;
@@ -121,7 +134,7 @@ NexusObject OrionExecutionEngine::cmd_ls(const CommandContext& context) {
         }
         result.value = output;
     } catch (const std::exception& e) {
-        result.metadata.type = "error";
+        result.metadata.type_id = TypeIds::Error;
         result.value = std::string("ls failed: ") + e.what();
     }
     
@@ -130,7 +143,7 @@ NexusObject OrionExecutionEngine::cmd_ls(const CommandContext& context) {
 
 NexusObject OrionExecutionEngine::cmd_cd(const CommandContext& context) {
     NexusObject result;
-    result.metadata.type = "string";
+    result.metadata.type_id = TypeIds::String;
     
     std::string path = context.args.empty() ? std::getenv("HOME") : context.args[0];
     
@@ -138,7 +151,7 @@ NexusObject OrionExecutionEngine::cmd_cd(const CommandContext& context) {
         std::filesystem::current_path(path);
         result.value = std::string("Changed directory to: ") + std::filesystem::current_path().string();
     } catch (const std::exception& e) {
-        result.metadata.type = "error";
+        result.metadata.type_id = TypeIds::Error;
         result.value = std::string("cd failed: ") + e.what();
     }
     
@@ -147,17 +160,17 @@ NexusObject OrionExecutionEngine::cmd_cd(const CommandContext& context) {
 
 NexusObject OrionExecutionEngine::cmd_pwd(const CommandContext& context) {
     NexusObject result;
-    result.metadata.type = "string";
+    result.metadata.type_id = TypeIds::String;
     result.value = std::filesystem::current_path().string();
     return result;
 }
 
 NexusObject OrionExecutionEngine::cmd_mkdir(const CommandContext& context) {
     NexusObject result;
-    result.metadata.type = "string";
+    result.metadata.type_id = TypeIds::String;
     
     if (context.args.empty()) {
-        result.metadata.type = "error";
+        result.metadata.type_id = TypeIds::Error;
         result.value = "mkdir: missing directory name";
         return result;
     }
@@ -166,7 +179,7 @@ NexusObject OrionExecutionEngine::cmd_mkdir(const CommandContext& context) {
         std::filesystem::create_directories(context.args[0]);
         result.value = std::string("Directory created: ") + context.args[0];
     } catch (const std::exception& e) {
-        result.metadata.type = "error";
+        result.metadata.type_id = TypeIds::Error;
         result.value = std::string("mkdir failed: ") + e.what();
     }
     
@@ -175,10 +188,10 @@ NexusObject OrionExecutionEngine::cmd_mkdir(const CommandContext& context) {
 
 NexusObject OrionExecutionEngine::cmd_rm(const CommandContext& context) {
     NexusObject result;
-    result.metadata.type = "string";
+    result.metadata.type_id = TypeIds::String;
     
     if (context.args.empty()) {
-        result.metadata.type = "error";
+        result.metadata.type_id = TypeIds::Error;
         result.value = "rm: missing file name";
         return result;
     }
@@ -189,7 +202,7 @@ NexusObject OrionExecutionEngine::cmd_rm(const CommandContext& context) {
         }
         result.value = "Files removed successfully";
     } catch (const std::exception& e) {
-        result.metadata.type = "error";
+        result.metadata.type_id = TypeIds::Error;
         result.value = std::string("rm failed: ") + e.what();
     }
     
@@ -198,10 +211,10 @@ NexusObject OrionExecutionEngine::cmd_rm(const CommandContext& context) {
 
 NexusObject OrionExecutionEngine::cmd_cp(const CommandContext& context) {
     NexusObject result;
-    result.metadata.type = "string";
+    result.metadata.type_id = TypeIds::String;
     
     if (context.args.size() < 2) {
-        result.metadata.type = "error";
+        result.metadata.type_id = TypeIds::Error;
         result.value = "cp: missing source or destination";
         return result;
     }
@@ -210,7 +223,7 @@ NexusObject OrionExecutionEngine::cmd_cp(const CommandContext& context) {
         std::filesystem::copy(context.args[0], context.args[1]);
         result.value = std::string("Copied ") + context.args[0] + " to " + context.args[1];
     } catch (const std::exception& e) {
-        result.metadata.type = "error";
+        result.metadata.type_id = TypeIds::Error;
         result.value = std::string("cp failed: ") + e.what();
     }
     
@@ -219,10 +232,10 @@ NexusObject OrionExecutionEngine::cmd_cp(const CommandContext& context) {
 
 NexusObject OrionExecutionEngine::cmd_mv(const CommandContext& context) {
     NexusObject result;
-    result.metadata.type = "string";
+    result.metadata.type_id = TypeIds::String;
     
     if (context.args.size() < 2) {
-        result.metadata.type = "error";
+        result.metadata.type_id = TypeIds::Error;
         result.value = "mv: missing source or destination";
         return result;
     }
@@ -231,7 +244,7 @@ NexusObject OrionExecutionEngine::cmd_mv(const CommandContext& context) {
         std::filesystem::rename(context.args[0], context.args[1]);
         result.value = std::string("Moved ") + context.args[0] + " to " + context.args[1];
     } catch (const std::exception& e) {
-        result.metadata.type = "error";
+        result.metadata.type_id = TypeIds::Error;
         result.value = std::string("mv failed: ") + e.what();
     }
     
@@ -240,10 +253,10 @@ NexusObject OrionExecutionEngine::cmd_mv(const CommandContext& context) {
 
 NexusObject OrionExecutionEngine::cmd_cat(const CommandContext& context) {
     NexusObject result;
-    result.metadata.type = "string";
+    result.metadata.type_id = TypeIds::String;
     
     if (context.args.empty()) {
-        result.metadata.type = "error";
+        result.metadata.type_id = TypeIds::Error;
         result.value = "cat: missing file name";
         return result;
     }
@@ -260,7 +273,7 @@ NexusObject OrionExecutionEngine::cmd_cat(const CommandContext& context) {
         }
         result.value = content;
     } catch (const std::exception& e) {
-        result.metadata.type = "error";
+        result.metadata.type_id = TypeIds::Error;
         result.value = std::string("cat failed: ") + e.what();
     }
     
@@ -269,21 +282,45 @@ NexusObject OrionExecutionEngine::cmd_cat(const CommandContext& context) {
 
 NexusObject OrionExecutionEngine::cmd_ps(const CommandContext& context) {
     NexusObject result;
-    result.metadata.type = "string";
+    result.metadata.type_id = TypeIds::String;
+    
+    ProcessSnapshotEngine* engine = kernel_ ? kernel_->process_snapshots() : nullptr;
+    if (!engine) {
+        result.metadata.type_id = TypeIds::Error;
+        result.value = "ps: process snapshots unavailable";
+        return result;
+    }
     
-    // Simplified process listing
-    result.value = "PID    COMMAND\n";
-    result.value += std::to_string(getpid()) + "    nexus\n";
+    try {
+        auto snapshot = engine->scan();
+        std::string output;
+        output.reserve(64 + snapshot->size() * 96);
+        output += "    PID    PPID S  %CPU      RSS COMMAND\n";
+        
+        char line[64];
+        for (size_t i = 0; i < snapshot->size(); ++i) {
+            int length = std::snprintf(line, sizeof(line), "%7d %7d %c %5.1f %8llu ",
+                snapshot->pid[i], snapshot->ppid[i], snapshot->state[i], snapshot->cpu_percent[i],
+                static_cast<unsigned long long>(snapshot->rss_bytes[i] / 1024));
+            output.append(line, static_cast<size_t>(std::max(0, std::min<int>(length, sizeof(line) - 1))));
+            output += snapshot->command[i];
+            output += '\n';
+        }
+        result.value = std::move(output);
+    } catch (const std::exception& e) {
+        result.metadata.type_id = TypeIds::Error;
+        result.value = std::string("ps failed: ") + e.what();
+    }
     
     return result;
 }
 
 NexusObject OrionExecutionEngine::cmd_kill(const CommandContext& context) {
     NexusObject result;
-    result.metadata.type = "string";
+    result.metadata.type_id = TypeIds::String;
     
     if (context.args.empty()) {
-        result.metadata.type = "error";
+        result.metadata.type_id = TypeIds::Error;
         result.value = "kill: missing process ID";
         return result;
     }
@@ -293,7 +330,7 @@ NexusObject OrionExecutionEngine::cmd_kill(const CommandContext& context) {
         // In a real implementation, this would send signals to processes
         result.value = std::string("Signal sent to process ") + std::to_string(pid);
     } catch (const std::exception& e) {
-        result.metadata.type = "error";
+        result.metadata.type_id = TypeIds::Error;
         result.value = std::string("kill failed: ") + e.what();
     }
     
@@ -302,7 +339,7 @@ NexusObject OrionExecutionEngine::cmd_kill(const CommandContext& context) {
 
 NexusObject OrionExecutionEngine::cmd_help(const CommandContext& context) {
     NexusObject result;
-    result.metadata.type = "string";
+    result.metadata.type_id = TypeIds::String;
     
     result.value = "NexusShell - Available Commands:\n";
     result.value += "  ls [path]           - List directory contents\n";
@@ -316,7 +353,7 @@ NexusObject OrionExecutionEngine::cmd_help(const CommandContext& context) {
     result.value += "  ps                  - List processes\n";
     result.value += "  kill <pid>          - Terminate process\n";
     result.value += "  help                - Show this help\n";
-    result.value += "  exit                - Exit shell\n";
+    result.value += "  exit [status]       - Exit shell\n";
     result.value += "\nJavaScript Pipeline Mode:\n";
     result.value += "  nexus.fs.readFile('/path/to/file')\n";
     result.value += "  nexus.proc.list().filter(p => p.cpu > 5)\n";
@@ -325,10 +362,21 @@ NexusObject OrionExecutionEngine::cmd_help(const CommandContext& context) {
     return result;
 }
 
+// The value is the exit status, so scripts can `exit 3`
 NexusObject OrionExecutionEngine::cmd_exit(const CommandContext& context) {
     NexusObject result;
-    result.metadata.type = "exit";
-    result.value = std::string("Goodbye!");
+    result.metadata.type_id = TypeIds::Exit;
+    int64_t status = 0;
+    if (!context.args.empty()) {
+        const std::string& text = context.args[0];
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), status);
+        if (error != std::errc() || end != text.data() + text.size()) {
+            result.metadata.type_id = TypeIds::Error;
+            result.value = "exit: numeric argument required: " + text;
+            return result;
+        }
+    }
+    result.value = status & 0xff;
     return result;
 }
 
@@ -0,0 +1,311 @@
+#include "plugin_manager.h"
+#include "nexus_plugin.h"
+#include <cstdlib>
+#include <dlfcn.h>
+#include <iostream>
+#include <string_view>
+#include <sys/stat.h>
+
+// The host's side of the opaque result handed to plugin commands
+struct nexus_result {
+    Nexus::NexusObject object;
+};
+
+namespace Nexus {
+
+namespace {
+
+constexpr const char* kDefaultPluginPath = "/usr/local/lib/nexus/plugins";
+
+void set_result(nexus_result* result, TypeId type, NexusValue value) {
+    result->object.metadata.type_id = type;
+    result->object.value = std::move(value);
+}
+
+void host_set_null(nexus_result* result) {
+    set_result(result, TypeIds::Null, nullptr);
+}
+
+void host_set_bool(nexus_result* result, int value) {
+    set_result(result, TypeIds::Boolean, value != 0);
+}
+
+void host_set_int(nexus_result* result, int64_t value) {
+    set_result(result, TypeIds::Number, value);
+}
+
+void host_set_double(nexus_result* result, double value) {
+    set_result(result, TypeIds::Number, value);
+}
+
+void host_set_string(nexus_result* result, const char* data, size_t length) {
+    set_result(result, TypeIds::String, std::string(data, length));
+}
+
+void host_set_bytes(nexus_result* result, const void* data, size_t length) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    set_result(result, TypeIds::Buffer, std::vector<uint8_t>(bytes, bytes + length));
+}
+
+void host_set_error(nexus_result* result, const char* message) {
+    set_result(result, TypeIds::Error, std::string(message ? message : "Plugin command failed"));
+}
+
+NexusObject text_result(std::string text, TypeId type = TypeIds::String) {
+    NexusObject result;
+    result.metadata.type_id = type;
+    result.value = std::move(text);
+    return result;
+}
+
+bool is_file(const std::string& path) {
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode);
+}
+
+} // namespace
+
+struct PluginManager::Loaded {
+    struct Command {
+        std::string name;
+        nexus_command_fn fn;
+        void* user_data;
+    };
+
+    std::string name;
+    std::string version;
+    std::string path;
+    void* handle = nullptr;
+    const nexus_plugin_info* info = nullptr;
+    nexus_host_api api{};
+    void* state = nullptr;
+    bool initialized = false;
+    bool registering = false;               // register_command is only valid during initialize
+    const CommandTable* table = nullptr;
+    std::vector<Command> commands;
+
+    // Runs when the manager and every running command have let go
+    ~Loaded() {
+        if (initialized && info->shutdown) {
+            info->shutdown(state);
+        }
+        if (handle) {
+            ::dlclose(handle);
+        }
+    }
+
+    static int register_command(void* host, const char* name, nexus_command_fn fn, void* user_data) {
+        auto* plugin = static_cast<Loaded*>(host);
+        if (!plugin->registering || !name || !*name || !fn || plugin->table->contains(name)) {
+            return 1;
+        }
+        for (const Command& command : plugin->commands) {
+            if (command.name == name) {
+                return 1;
+            }
+        }
+        plugin->commands.push_back({name, fn, user_data});
+        return 0;
+    }
+
+    static void log(void* host, const char* message) {
+        std::cerr << "[" << static_cast<Loaded*>(host)->name << "] " << (message ? message : "") << "\n";
+    }
+
+    // The handler owns a reference: a running command keeps the code it is
+    // executing mapped
+    static CommandHandler handler(std::shared_ptr<Loaded> plugin, const Command& command) {
+        return [plugin = std::move(plugin), fn = command.fn, user_data = command.user_data,
+                name = command.name](const CommandContext& context) {
+            // argv, then flag names, then flag values, in one allocation
+            std::vector<const char*> strings;
+            strings.reserve(context.args.size() + 2 * context.flags.size());
+            for (const std::string& arg : context.args) {
+                strings.push_back(arg.c_str());
+            }
+            for (const auto& flag : context.flags) {
+                strings.push_back(flag.first.c_str());
+            }
+            for (const auto& flag : context.flags) {
+                strings.push_back(flag.second.c_str());
+            }
+
+            size_t argc = context.args.size();
+            size_t flag_count = context.flags.size();
+            nexus_command_args args{argc, strings.data(), flag_count, strings.data() + argc,
+                                    strings.data() + argc + flag_count, context.working_directory.c_str()};
+            nexus_result result;
+            result.object.metadata.type_id = TypeIds::Null;
+            if (fn(user_data, &args, &result) != 0 && result.object.metadata.type_id != TypeIds::Error) {
+                host_set_error(&result, (name + ": plugin command failed").c_str());
+            }
+            return std::move(result.object);
+        };
+    }
+};
+
+PluginManager::PluginManager(CommandTable& commands) : commands_(commands) {}
+
+PluginManager::~PluginManager() {
+    unload_all();
+}
+
+std::string PluginManager::resolve(const std::string& path) {
+    if (path.find('/') != std::string::npos) {
+        return path;
+    }
+    const char* env = std::getenv("NEXUS_PLUGIN_PATH");
+    std::string_view directories = env && *env ? env : kDefaultPluginPath;
+    while (!directories.empty()) {
+        size_t colon = directories.find(':');
+        std::string directory(directories.substr(0, colon));
+        directories = colon == std::string_view::npos ? std::string_view() : directories.substr(colon + 1);
+        if (directory.empty()) {
+            continue;
+        }
+        for (const std::string& candidate : {directory + "/" + path, directory + "/" + path + ".so",
+                                             directory + "/lib" + path + ".so"}) {
+            if (is_file(candidate)) {
+                return candidate;
+            }
+        }
+    }
+    return path;                            // Left to dlopen's library search
+}
+
+bool PluginManager::load(const std::string& path, std::string& name, std::string& error) {
+    auto plugin = std::make_shared<Loaded>();
+    plugin->path = resolve(path);
+    plugin->table = &commands_;
+    plugin->handle = ::dlopen(plugin->path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!plugin->handle) {
+        const char* reason = ::dlerror();
+        error = "Cannot load plugin " + path + ": " + (reason ? reason : "unknown error");
+        return false;
+    }
+
+    auto entry = reinterpret_cast<nexus_plugin_entry_fn>(::dlsym(plugin->handle, NEXUS_PLUGIN_ENTRY));
+    const nexus_plugin_info* info = entry ? entry() : nullptr;
+    if (!info) {
+        error = "Not a nexus plugin: " + plugin->path;
+        return false;
+    }
+    if (info->abi_version != NEXUS_PLUGIN_ABI_VERSION) {
+        error = "Plugin " + plugin->path + " uses plugin ABI " + std::to_string(info->abi_version) +
+                "; this shell provides " + std::to_string(NEXUS_PLUGIN_ABI_VERSION);
+        return false;
+    }
+    if (info->size < sizeof(nexus_plugin_info) || !info->name || !*info->name || !info->initialize) {
+        error = "Malformed plugin description in " + plugin->path;
+        return false;
+    }
+    plugin->info = info;
+    plugin->name = info->name;
+    plugin->version = info->version ? info->version : "";
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (plugins_.count(plugin->name)) {
+        error = "Plugin already loaded: " + plugin->name;
+        return false;
+    }
+
+    plugin->api = {NEXUS_PLUGIN_ABI_VERSION, sizeof(nexus_host_api), plugin.get(),
+                   &Loaded::register_command, &Loaded::log,
+                   host_set_null, host_set_bool, host_set_int, host_set_double,
+                   host_set_string, host_set_bytes, host_set_error};
+    plugin->registering = true;
+    int status = info->initialize(&plugin->api, &plugin->state);
+    plugin->registering = false;
+    if (status != 0) {
+        error = "Plugin " + plugin->name + " failed to initialize";
+        return false;
+    }
+    plugin->initialized = true;
+
+    for (size_t i = 0; i < plugin->commands.size(); ++i) {
+        const Loaded::Command& command = plugin->commands[i];
+        if (!commands_.add(command.name, Loaded::handler(plugin, command))) {
+            for (size_t j = 0; j < i; ++j) {
+                commands_.remove(plugin->commands[j].name);
+            }
+            error = "Plugin " + plugin->name + ": command already exists: " + command.name;
+            return false;
+        }
+    }
+
+    name = plugin->name;
+    plugins_.emplace(name, std::move(plugin));
+    return true;
+}
+
+bool PluginManager::unload(const std::string& name, std::string& error) {
+    std::shared_ptr<Loaded> plugin;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = plugins_.find(name);
+    if (it == plugins_.end()) {
+        error = "Plugin not loaded: " + name;
+        return false;
+    }
+    plugin = std::move(it->second);
+    plugins_.erase(it);
+    for (const Loaded::Command& command : plugin->commands) {
+        commands_.remove(command.name);
+    }
+    return true;
+}
+
+void PluginManager::unload_all() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [name, plugin] : plugins_) {
+        for (const Loaded::Command& command : plugin->commands) {
+            commands_.remove(command.name);
+        }
+    }
+    plugins_.clear();
+}
+
+std::vector<PluginManager::PluginInfo> PluginManager::list() const {
+    std::vector<PluginInfo> result;
+    std::lock_guard<std::mutex> lock(mutex_);
+    result.reserve(plugins_.size());
+    for (const auto& [name, plugin] : plugins_) {
+        PluginInfo info{plugin->name, plugin->version, plugin->path, {}};
+        for (const Loaded::Command& command : plugin->commands) {
+            info.commands.push_back(command.name);
+        }
+        result.push_back(std::move(info));
+    }
+    return result;
+}
+
+NexusObject PluginManager::command(const CommandContext& context) {
+    const std::string action = context.args.empty() ? "list" : context.args[0];
+    std::string name, error;
+
+    if (action == "list") {
+        std::string output;
+        for (const PluginInfo& info : list()) {
+            output += info.name + " " + info.version + "  " + info.path + "\n  commands:";
+            for (const std::string& command : info.commands) {
+                output += " " + command;
+            }
+            output += "\n";
+        }
+        return text_result(output.empty() ? "No plugins loaded\n" : output);
+    }
+    if (action == "load" && context.args.size() == 2) {
+        if (!load(context.args[1], name, error)) {
+            return text_result(error, TypeIds::Error);
+        }
+        return text_result("Loaded plugin " + name + "\n");
+    }
+    if (action == "unload" && context.args.size() == 2) {
+        if (!unload(context.args[1], error)) {
+            return text_result(error, TypeIds::Error);
+        }
+        return text_result("Unloaded plugin " + context.args[1] + "\n");
+    }
+    return text_result("Usage: plugin [list] | plugin load <path> | plugin unload <name>", TypeIds::Error);
+}
+
+} // namespace Nexus
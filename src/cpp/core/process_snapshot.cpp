@@ -0,0 +1,470 @@
+#include "process_snapshot.h"
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Nexus {
+
+namespace {
+
+struct LinuxDirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+uint64_t monotonic_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000 + static_cast<uint64_t>(ts.tv_nsec) / 1000000;
+}
+
+// "<pid>/<leaf>" relative to the /proc descriptor
+void format_proc_path(char* out, int32_t pid, const char* leaf) {
+    char digits[16];
+    int length = 0;
+    do {
+        digits[length++] = static_cast<char>('0' + pid % 10);
+        pid /= 10;
+    } while (pid > 0);
+    while (length > 0) {
+        *out++ = digits[--length];
+    }
+    *out++ = '/';
+    while (*leaf) {
+        *out++ = *leaf++;
+    }
+    *out = '\0';
+}
+
+// Reads from offset 0, so an open /proc file can be read again on every scan
+ssize_t read_open_file(int fd, char* buffer, size_t capacity) {
+    size_t total = 0;
+    while (total < capacity) {
+        ssize_t n = ::pread(fd, buffer + total, capacity - total, static_cast<off_t>(total));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            return -1;
+        }
+        if (n == 0) {
+            break;
+        }
+        total += static_cast<size_t>(n);
+    }
+    return static_cast<ssize_t>(total);
+}
+
+ssize_t read_proc_file(int dir_fd, const char* path, char* buffer, size_t capacity) {
+    int fd = ::openat(dir_fd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    ssize_t length = read_open_file(fd, buffer, capacity);
+    ::close(fd);
+    return length;
+}
+
+bool parse_int(const char*& cursor, const char* end, int64_t& value) {
+    while (cursor < end && *cursor == ' ') {
+        ++cursor;
+    }
+    bool negative = cursor < end && *cursor == '-';
+    if (negative) {
+        ++cursor;
+    }
+    if (cursor >= end || *cursor < '0' || *cursor > '9') {
+        return false;
+    }
+    int64_t result = 0;
+    while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+        result = result * 10 + (*cursor++ - '0');
+    }
+    value = negative ? -result : result;
+    return true;
+}
+
+// Fields of /proc/<pid>/stat after "pid (comm) state", numbered as in proc(5)
+enum StatField {
+    kPpid = 4,
+    kUtime = 14,
+    kStime = 15,
+    kNumThreads = 20,
+    kStartTime = 22,
+    kVsize = 23,
+    kRss = 24,
+    kLastStatField = kRss
+};
+
+} // namespace
+
+void ProcessSnapshot::resize(size_t rows) {
+    pid.resize(rows);
+    ppid.resize(rows);
+    uid.resize(rows);
+    state.resize(rows);
+    threads.resize(rows);
+    rss_bytes.resize(rows);
+    vsize_bytes.resize(rows);
+    cpu_ticks.resize(rows);
+    start_ticks.resize(rows);
+    cpu_percent.resize(rows);
+    name.resize(rows);
+    command.resize(rows);
+}
+
+ProcessSnapshotEngine::ProcessSnapshotEngine(ThreadPool* thread_pool, std::string proc_root)
+    : thread_pool_(thread_pool),
+      proc_root_(std::move(proc_root)),
+      ticks_per_second_(std::max(1L, ::sysconf(_SC_CLK_TCK))),
+      page_size_(static_cast<uint64_t>(::sysconf(_SC_PAGESIZE))) {
+    // Raise the soft descriptor limit to the hard one, as Node and Go do at
+    // startup, and keep up to half of it for stat files
+    struct rlimit limit;
+    if (::getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        if (limit.rlim_cur < limit.rlim_max) {
+            rlim_t soft = limit.rlim_cur;
+            limit.rlim_cur = limit.rlim_max;
+            if (::setrlimit(RLIMIT_NOFILE, &limit) != 0) {
+                limit.rlim_cur = soft;
+            }
+        }
+        if (limit.rlim_cur != RLIM_INFINITY) {
+            max_stat_fds_ = static_cast<size_t>(limit.rlim_cur / 2);
+        }
+    }
+}
+
+ProcessSnapshotEngine::~ProcessSnapshotEngine() {
+    for (int fd : stat_fds_) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+std::shared_ptr<const ProcessSnapshot> ProcessSnapshotEngine::latest() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return latest_;
+}
+
+std::shared_ptr<const ProcessSnapshot> ProcessSnapshotEngine::scan(uint64_t max_age_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    uint64_t now = monotonic_ms();
+    if (latest_ && max_age_ms > 0 && now - latest_->timestamp_ms < max_age_ms) {
+        return latest_;
+    }
+
+    int proc_fd = ::open(proc_root_.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (proc_fd < 0) {
+        throw std::runtime_error("Cannot open " + proc_root_ + ": " + std::strerror(errno));
+    }
+
+    auto snapshot = std::make_shared<ProcessSnapshot>();
+    std::vector<int32_t> pids = list_pids(proc_fd);
+    std::sort(pids.begin(), pids.end());
+    size_t rows = pids.size();
+    snapshot->resize(rows);
+    snapshot->pid = std::move(pids);
+
+    const ProcessSnapshot* previous = latest_.get();
+    std::vector<uint8_t> valid(rows, 0);
+    next_stat_fds_.assign(rows, -1);
+    size_t chunks = (rows + kRowsPerTask - 1) / kRowsPerTask;
+
+    if (!thread_pool_ || chunks < 2) {
+        read_rows(proc_fd, *snapshot, previous, 0, rows, valid);
+    } else {
+        // Chunks are claimed from a shared counter and the calling thread
+        // works too, so the scan finishes even if every pool thread is busy.
+        // Helpers that start late find nothing left and only touch `work`.
+        struct ScanWork {
+            std::atomic<size_t> next_chunk{0};
+            size_t chunk_count = 0;
+            size_t completed = 0;
+            std::mutex mutex;
+            std::condition_variable done;
+            std::function<void(size_t)> run_chunk;
+        };
+        auto work = std::make_shared<ScanWork>();
+        work->chunk_count = chunks;
+        work->run_chunk = [&](size_t chunk) {
+            size_t begin = chunk * kRowsPerTask;
+            read_rows(proc_fd, *snapshot, previous, begin, std::min(rows, begin + kRowsPerTask), valid);
+        };
+
+        auto drain = [](const std::shared_ptr<ScanWork>& work) {
+            for (;;) {
+                size_t chunk = work->next_chunk.fetch_add(1);
+                if (chunk >= work->chunk_count) {
+                    return;
+                }
+                work->run_chunk(chunk);
+                std::lock_guard<std::mutex> lock(work->mutex);
+                if (++work->completed == work->chunk_count) {
+                    work->done.notify_one();
+                }
+            }
+        };
+
+        size_t helpers = std::min(thread_pool_->get_thread_count(), chunks - 1);
+        for (size_t i = 0; i < helpers; ++i) {
+            thread_pool_->submit([work, drain]() { drain(work); });
+        }
+        drain(work);
+
+        std::unique_lock<std::mutex> lock(work->mutex);
+        work->done.wait(lock, [&]() { return work->completed == work->chunk_count; });
+    }
+
+    // Descriptors read_rows did not take belong to processes that exited
+    for (int fd : stat_fds_) {
+        if (fd >= 0) {
+            ::close(fd);
+            --open_stat_fds_;
+        }
+    }
+
+    // Drop processes that exited between listing and reading
+    size_t kept = 0;
+    for (size_t i = 0; i < rows; ++i) {
+        if (!valid[i]) {
+            if (next_stat_fds_[i] >= 0) {
+                ::close(next_stat_fds_[i]);
+                --open_stat_fds_;
+            }
+            continue;
+        }
+        if (kept != i) {
+            next_stat_fds_[kept] = next_stat_fds_[i];
+            snapshot->pid[kept] = snapshot->pid[i];
+            snapshot->ppid[kept] = snapshot->ppid[i];
+            snapshot->uid[kept] = snapshot->uid[i];
+            snapshot->state[kept] = snapshot->state[i];
+            snapshot->threads[kept] = snapshot->threads[i];
+            snapshot->rss_bytes[kept] = snapshot->rss_bytes[i];
+            snapshot->vsize_bytes[kept] = snapshot->vsize_bytes[i];
+            snapshot->cpu_ticks[kept] = snapshot->cpu_ticks[i];
+            snapshot->start_ticks[kept] = snapshot->start_ticks[i];
+            snapshot->name[kept] = std::move(snapshot->name[i]);
+            snapshot->command[kept] = std::move(snapshot->command[i]);
+        }
+        ++kept;
+    }
+    snapshot->resize(kept);
+    next_stat_fds_.resize(kept);
+    stat_fds_.swap(next_stat_fds_);
+
+    snapshot->timestamp_ms = monotonic_ms();
+    compute_cpu_percent(*snapshot, previous, proc_fd);
+    ::close(proc_fd);
+
+    latest_ = std::move(snapshot);
+    ++scan_count_;
+    return latest_;
+}
+
+std::vector<int32_t> ProcessSnapshotEngine::list_pids(int proc_fd) const {
+    std::vector<int32_t> pids;
+    alignas(LinuxDirent64) char buffer[32 * 1024];
+
+    for (;;) {
+        long length = ::syscall(SYS_getdents64, proc_fd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break;
+        }
+        for (long offset = 0; offset < length;) {
+            auto* entry = reinterpret_cast<LinuxDirent64*>(buffer + offset);
+            offset += entry->d_reclen;
+
+            const char* name = entry->d_name;
+            if (*name < '1' || *name > '9') {
+                continue;
+            }
+            int32_t pid = 0;
+            while (*name >= '0' && *name <= '9') {
+                pid = pid * 10 + (*name++ - '0');
+            }
+            if (*name == '\0') {
+                pids.push_back(pid);
+            }
+        }
+    }
+    return pids;
+}
+
+void ProcessSnapshotEngine::read_rows(int proc_fd, ProcessSnapshot& snapshot, const ProcessSnapshot* previous,
+                                      size_t begin, size_t end, std::vector<uint8_t>& valid) {
+    char path[64];
+    char stat_buffer[1024];
+    char text_buffer[4096];
+
+    for (size_t row = begin; row < end; ++row) {
+        int32_t pid = snapshot.pid[row];
+
+        size_t prev_row = kNoRow;
+        if (previous) {
+            auto it = std::lower_bound(previous->pid.begin(), previous->pid.end(), pid);
+            if (it != previous->pid.end() && *it == pid) {
+                prev_row = static_cast<size_t>(it - previous->pid.begin());
+            }
+        }
+
+        // A descriptor kept from the last scan skips the path walk and the
+        // open; once its process exits, reads fail and the pid is reopened
+        ssize_t length = -1;
+        int fd = prev_row != kNoRow ? stat_fds_[prev_row] : -1;
+        if (fd >= 0) {
+            stat_fds_[prev_row] = -1;
+            length = read_open_file(fd, stat_buffer, sizeof(stat_buffer));
+            if (length <= 0) {
+                ::close(fd);
+                --open_stat_fds_;
+                fd = -1;
+            }
+        }
+        if (fd < 0) {
+            format_proc_path(path, pid, "stat");
+            fd = ::openat(proc_fd, path, O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                continue;
+            }
+            length = read_open_file(fd, stat_buffer, sizeof(stat_buffer));
+            if (length <= 0 || open_stat_fds_.fetch_add(1) >= max_stat_fds_) {
+                if (length > 0) {
+                    --open_stat_fds_;
+                }
+                ::close(fd);
+                fd = -1;
+            }
+        }
+        next_stat_fds_[row] = fd;
+        if (length <= 0) {
+            continue;
+        }
+        const char* stat_end = stat_buffer + length;
+
+        // comm may itself contain ')' or spaces, so split on the last ')'
+        const char* open_paren = static_cast<const char*>(std::memchr(stat_buffer, '(', length));
+        const char* close_paren = static_cast<const char*>(::memrchr(stat_buffer, ')', length));
+        if (!open_paren || !close_paren || close_paren < open_paren || close_paren + 2 >= stat_end) {
+            continue;
+        }
+
+        const char* cursor = close_paren + 2;
+        char state = *cursor++;
+        int64_t fields[kLastStatField + 1] = {};
+        bool parsed = true;
+        for (int field = kPpid; field <= kLastStatField && parsed; ++field) {
+            parsed = parse_int(cursor, stat_end, fields[field]);
+        }
+        if (!parsed) {
+            continue;
+        }
+
+        snapshot.name[row].assign(open_paren + 1, close_paren);
+        snapshot.state[row] = state;
+        snapshot.ppid[row] = static_cast<int32_t>(fields[kPpid]);
+        snapshot.threads[row] = static_cast<int32_t>(fields[kNumThreads]);
+        snapshot.cpu_ticks[row] = static_cast<uint64_t>(fields[kUtime] + fields[kStime]);
+        snapshot.start_ticks[row] = static_cast<uint64_t>(fields[kStartTime]);
+        snapshot.vsize_bytes[row] = static_cast<uint64_t>(fields[kVsize]);
+        snapshot.rss_bytes[row] = static_cast<uint64_t>(std::max<int64_t>(0, fields[kRss])) * page_size_;
+        valid[row] = 1;
+
+        // Same pid and start time as last scan: reuse the static fields
+        if (prev_row != kNoRow && previous->start_ticks[prev_row] == snapshot.start_ticks[row]) {
+            snapshot.uid[row] = previous->uid[prev_row];
+            snapshot.command[row] = previous->command[prev_row];
+            continue;
+        }
+
+        format_proc_path(path, pid, "status");
+        length = read_proc_file(proc_fd, path, text_buffer, sizeof(text_buffer));
+        if (length > 0) {
+            const char* status_end = text_buffer + length;
+            const char* uid_line = static_cast<const char*>(
+                ::memmem(text_buffer, static_cast<size_t>(length), "\nUid:", 5));
+            int64_t uid = 0;
+            if (uid_line) {
+                const char* uid_cursor = uid_line + 5;
+                while (uid_cursor < status_end && *uid_cursor == '\t') {
+                    ++uid_cursor;
+                }
+                if (parse_int(uid_cursor, status_end, uid)) {
+                    snapshot.uid[row] = static_cast<uint32_t>(uid);
+                }
+            }
+        }
+
+        format_proc_path(path, pid, "cmdline");
+        length = read_proc_file(proc_fd, path, text_buffer, sizeof(text_buffer));
+        while (length > 0 && text_buffer[length - 1] == '\0') {
+            --length;
+        }
+        if (length > 0) {
+            std::replace(text_buffer, text_buffer + length, '\0', ' ');
+            snapshot.command[row].assign(text_buffer, static_cast<size_t>(length));
+        } else {
+            // Kernel threads have no command line
+            snapshot.command[row] = "[" + snapshot.name[row] + "]";
+        }
+    }
+}
+
+void ProcessSnapshotEngine::compute_cpu_percent(ProcessSnapshot& snapshot, const ProcessSnapshot* previous,
+                                                int proc_fd) const {
+    double ticks_per_second = static_cast<double>(ticks_per_second_);
+
+    // Processes not in the previous snapshot get their lifetime average
+    double uptime_ticks = 0.0;
+    char uptime_buffer[64];
+    ssize_t length = read_proc_file(proc_fd, "uptime", uptime_buffer, sizeof(uptime_buffer) - 1);
+    if (length > 0) {
+        uptime_buffer[length] = '\0';
+        uptime_ticks = std::strtod(uptime_buffer, nullptr) * ticks_per_second;
+    }
+
+    double interval_ticks = 0.0;
+    if (previous && snapshot.timestamp_ms > previous->timestamp_ms) {
+        snapshot.interval_s = static_cast<double>(snapshot.timestamp_ms - previous->timestamp_ms) / 1000.0;
+        interval_ticks = snapshot.interval_s * ticks_per_second;
+    }
+
+    // Both pid columns are sorted: a single merge pass matches rows
+    size_t prev_row = 0;
+    size_t prev_rows = previous ? previous->size() : 0;
+    for (size_t row = 0; row < snapshot.size(); ++row) {
+        int32_t pid = snapshot.pid[row];
+        while (prev_row < prev_rows && previous->pid[prev_row] < pid) {
+            ++prev_row;
+        }
+
+        double percent = 0.0;
+        if (interval_ticks > 0.0 && prev_row < prev_rows && previous->pid[prev_row] == pid &&
+            previous->start_ticks[prev_row] == snapshot.start_ticks[row]) {
+            uint64_t before = previous->cpu_ticks[prev_row];
+            uint64_t after = snapshot.cpu_ticks[row];
+            percent = after > before ? static_cast<double>(after - before) * 100.0 / interval_ticks : 0.0;
+        } else {
+            double lifetime = uptime_ticks - static_cast<double>(snapshot.start_ticks[row]);
+            if (lifetime > 0.0) {
+                percent = static_cast<double>(snapshot.cpu_ticks[row]) * 100.0 / lifetime;
+            }
+        }
+        snapshot.cpu_percent[row] = percent;
+    }
+}
+
+} // namespace Nexus
@@ -0,0 +1,89 @@
+#include "result_format.h"
+#include <sstream>
+
+namespace Nexus {
+
+void append_value(std::string& out, const NexusValue& value) {
+    std::visit([&out](const auto& v) {
+        using T = std::decay_t<decltype(v)>;
+
+        if constexpr (std::is_same_v<T, std::nullptr_t>) {
+            out += "null";
+        } else if constexpr (std::is_same_v<T, bool>) {
+            out += v ? "true" : "false";
+        } else if constexpr (std::is_same_v<T, int64_t>) {
+            out += std::to_string(v);
+        } else if constexpr (std::is_same_v<T, double>) {
+            std::ostringstream oss;
+            oss << v;
+            out += oss.str();
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            out += '"';
+            out += v;
+            out += '"';
+        } else if constexpr (std::is_same_v<T, std::vector<uint8_t>>) {
+            out += "[Binary data: " + std::to_string(v.size()) + " bytes]";
+        } else if constexpr (std::is_same_v<T, std::vector<int64_t>> ||
+                             std::is_same_v<T, std::vector<double>>) {
+            out += '[';
+            for (size_t i = 0; i < v.size(); ++i) {
+                if (i > 0) out += ", ";
+                append_value(out, v[i]);
+            }
+            out += ']';
+        } else if constexpr (std::is_same_v<T, std::shared_ptr<NexusList>>) {
+            out += '[';
+            if (v) {
+                for (size_t i = 0; i < v->size(); ++i) {
+                    if (i > 0) out += ", ";
+                    append_value(out, (*v)[i].value);
+                }
+            }
+            out += ']';
+        } else if constexpr (std::is_same_v<T, std::shared_ptr<NexusMap>>) {
+            out += '{';
+            if (v) {
+                for (size_t i = 0; i < v->size(); ++i) {
+                    if (i > 0) out += ", ";
+                    out += (*v)[i].first + ": ";
+                    append_value(out, (*v)[i].second.value);
+                }
+            }
+            out += '}';
+        }
+    }, value);
+}
+
+void format_result(const NexusObject& result, std::string& out) {
+    if (result.metadata.type_id == TypeIds::Exit) {
+        return;
+    }
+    size_t start = out.size();
+    std::visit([&out, &result](const auto& value) {
+        using T = std::decay_t<decltype(value)>;
+
+        if constexpr (std::is_same_v<T, std::nullptr_t>) {
+            // Nothing is printed for null results
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            out += value;                   // Unquoted, unlike inside a structure
+        } else if constexpr (std::is_same_v<T, std::vector<uint8_t>>) {
+            out += "[Binary data: " + std::to_string(value.size()) + " bytes]";
+        } else {
+            append_value(out, result.value);
+        }
+    }, result.value);
+    // Command output that already ends a line is not given an empty one
+    if (out.size() > start && out.back() != '\n') {
+        out += '\n';
+    }
+}
+
+int result_exit_status(const NexusObject& result) {
+    if (result.metadata.type_id == TypeIds::Exit) {
+        const int64_t* status = std::get_if<int64_t>(&result.value);
+        return status ? static_cast<int>(*status & 0xff) : 0;
+    }
+    return is_error_result(result) ? 1 : 0;
+}
+
+} // namespace Nexus
@@ -0,0 +1,152 @@
+#include "script_runner.h"
+#include "nexus_kernel.h"
+#include "result_format.h"
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace Nexus {
+
+namespace {
+
+void write_all(int fd, std::string_view data) {
+    while (!data.empty()) {
+        ssize_t written = ::write(fd, data.data(), data.size());
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;                         // EPIPE: the reader went away
+        }
+        data.remove_prefix(static_cast<size_t>(written));
+    }
+}
+
+} // namespace
+
+ScriptRunner::ScriptRunner(NexusKernel* kernel)
+    : kernel_(kernel), flush_each_(::isatty(STDOUT_FILENO)) {
+    context_.security_context = kernel_->security_context();
+    context_.object_bridge = nullptr;
+    for (char** variable = environ; *variable; ++variable) {
+        const char* equals = std::strchr(*variable, '=');
+        if (equals) {
+            context_.environment.emplace(std::string(*variable, equals - *variable), std::string(equals + 1));
+        }
+    }
+    out_.reserve(kFlushSize);
+}
+
+ScriptRunner::~ScriptRunner() {
+    flush();
+}
+
+int ScriptRunner::run_command(const std::string& line) {
+    execute(line, "-c", 0);
+    flush();
+    return status_;
+}
+
+int ScriptRunner::run_file(const std::string& path) {
+    if (path == "-") {
+        return run_fd(STDIN_FILENO, "<stdin>");
+    }
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "nexus: cannot open " << path << ": " << std::strerror(errno) << "\n";
+        status_ = 127;
+        return status_;
+    }
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    run_fd(fd, path);
+    ::close(fd);
+    return status_;
+}
+
+int ScriptRunner::run_fd(int fd, const std::string& name) {
+    std::string buffer;
+    size_t line_number = 0;
+    size_t start = 0;                       // First unconsumed byte of buffer
+    bool eof = false;
+    while (!exited_ && !eof) {
+        // Keep the partial last line, drop everything before it
+        buffer.erase(0, start);
+        start = 0;
+        size_t used = buffer.size();
+        buffer.resize(used + kReadSize);
+        ssize_t n = ::read(fd, buffer.data() + used, kReadSize);
+        if (n < 0 && errno == EINTR) {
+            buffer.resize(used);
+            continue;
+        }
+        if (n < 0) {
+            std::cerr << "nexus: read error on " << name << ": " << std::strerror(errno) << "\n";
+            buffer.resize(used);
+            status_ = 1;
+            break;
+        }
+        buffer.resize(used + static_cast<size_t>(n));
+        eof = n == 0;
+        if (eof && !buffer.empty() && buffer.back() != '\n') {
+            buffer += '\n';                 // Unterminated last line
+        }
+
+        size_t newline;
+        while (!exited_ && (newline = buffer.find('\n', start)) != std::string::npos) {
+            execute(std::string_view(buffer).substr(start, newline - start), name, ++line_number);
+            start = newline + 1;
+        }
+    }
+    flush();
+    return status_;
+}
+
+void ScriptRunner::execute(std::string_view line, const std::string& source, size_t line_number) {
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    size_t first = line.find_first_not_of(" \t");
+    if (first == std::string_view::npos || line[first] == '#') {
+        return;
+    }
+
+    char cwd[PATH_MAX];
+    if (::getcwd(cwd, sizeof(cwd))) {
+        context_.working_directory = cwd;  // cd may have moved it
+    }
+    NexusObject result = kernel_->execute_command(std::string(line.substr(first)), context_);
+    status_ = result_exit_status(result);
+
+    if (result.metadata.type_id == TypeIds::Exit) {
+        exited_ = true;
+    } else if (is_error_result(result)) {
+        // Earlier output first, so 2>&1 keeps the order
+        flush();
+        std::string text = "nexus: ";
+        if (line_number) {
+            text += source + ":" + std::to_string(line_number) + ": ";
+        }
+        format_result(result, text);
+        write_all(STDERR_FILENO, text);
+    } else {
+        format_result(result, out_);
+        if (flush_each_ || out_.size() >= kFlushSize) {
+            flush();
+        }
+    }
+}
+
+void ScriptRunner::flush() {
+    if (!out_.empty()) {
+        std::cout.flush();
+        write_all(STDOUT_FILENO, out_);
+        out_.clear();
+    }
+}
+
+} // namespace Nexus
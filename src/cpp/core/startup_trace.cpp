@@ -0,0 +1,46 @@
+#include "startup_trace.h"
+#include <algorithm>
+#include <iomanip>
+
+namespace Nexus {
+
+namespace {
+
+uint64_t micros(StartupTrace::Clock::duration duration) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+}
+
+} // namespace
+
+StartupTrace::StartupTrace() : origin_(Clock::now()), main_thread_(std::this_thread::get_id()) {
+}
+
+void StartupTrace::record(std::string name, Clock::time_point start, Clock::time_point end) {
+    Entry entry{std::move(name), micros(start - origin_), micros(end - start),
+                std::this_thread::get_id() == main_thread_};
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.push_back(std::move(entry));
+}
+
+uint64_t StartupTrace::elapsed_us() const {
+    return micros(Clock::now() - origin_);
+}
+
+void StartupTrace::report(std::ostream& out, const char* title) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto first = entries_.begin() + static_cast<std::ptrdiff_t>(reported_);
+    std::stable_sort(first, entries_.end(), [](const Entry& a, const Entry& b) {
+        return a.start_us < b.start_us;
+    });
+
+    out << title << " (µs since kernel start)\n";
+    out << "   start  duration  thread  phase\n";
+    for (auto it = first; it != entries_.end(); ++it) {
+        out << std::setw(8) << it->start_us << std::setw(10) << it->duration_us
+            << (it->main_thread ? "  main    " : "  pool    ") << it->name << "\n";
+    }
+    out << "   ready " << std::setw(9) << micros(Clock::now() - origin_) << "\n";
+    reported_ = entries_.size();
+}
+
+} // namespace Nexus
@@ -1,28 +1,371 @@
 #include "stellar_object_bridge.h"
+#include "isolate_pool.h"
 #include <iostream>
 #include <filesystem>
 #include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <climits>
+#include <atomic>
+#include <limits>
+#include <csignal>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+extern char** environ;
 
 namespace Nexus {
 
+namespace {
+
+// Array::Iterate callbacks may only inspect elements: no V8 allocation and
+// no escaping Locals. They therefore cover primitives only and stop at the
+// first element that needs the generic Get()-based path.
+struct NumericArrayScan {
+    std::vector<int64_t> ints;
+    std::vector<double> doubles;
+    bool all_ints = true;
+    uint32_t scanned = 0;
+};
+
+v8::Array::CallbackResult scan_numeric_element(uint32_t index, v8::Local<v8::Value> element, void* data) {
+    auto* scan = static_cast<NumericArrayScan*>(data);
+    if (!element->IsNumber()) {
+        return v8::Array::CallbackResult::kBreak;
+    }
+    if (scan->all_ints && element->IsInt32()) {
+        scan->ints.push_back(element.As<v8::Int32>()->Value());
+    } else {
+        if (scan->all_ints) {
+            scan->all_ints = false;
+            scan->doubles.reserve(scan->ints.capacity());
+            scan->doubles.assign(scan->ints.begin(), scan->ints.end());
+            scan->ints = {};
+        }
+        scan->doubles.push_back(element.As<v8::Number>()->Value());
+    }
+    scan->scanned = index + 1;
+    return v8::Array::CallbackResult::kContinue;
+}
+
+struct PrimitiveArrayScan {
+    std::vector<NexusObject>* objects;
+    uint32_t scanned = 0;
+};
+
+// Null, boolean and number values; false for anything needing the isolate
+bool convert_primitive(v8::Local<v8::Value> value, NexusObject& obj) {
+    if (value->IsNull() || value->IsUndefined()) {
+        obj.metadata.type_id = TypeIds::Null;
+        obj.value = nullptr;
+    } else if (value->IsBoolean()) {
+        obj.metadata.type_id = TypeIds::Boolean;
+        obj.value = value->IsTrue();
+    } else if (value->IsNumber()) {
+        obj.metadata.type_id = TypeIds::Number;
+        if (value->IsInt32()) {
+            obj.value = static_cast<int64_t>(value.As<v8::Int32>()->Value());
+        } else {
+            obj.value = value.As<v8::Number>()->Value();
+        }
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Every object handed out by js_to_nexus carries an id and timestamps
+void stamp_metadata(NexusObject& obj) {
+    obj.metadata.id = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::high_resolution_clock::now().time_since_epoch()
+    ).count();
+    obj.metadata.created_at = obj.metadata.id;
+    obj.metadata.modified_at = obj.metadata.id;
+}
+
+v8::Array::CallbackResult scan_primitive_element(uint32_t index, v8::Local<v8::Value> element, void* data) {
+    auto* scan = static_cast<PrimitiveArrayScan*>(data);
+    NexusObject obj;
+    if (!convert_primitive(element, obj)) {
+        return v8::Array::CallbackResult::kBreak;
+    }
+    stamp_metadata(obj);
+    scan->objects->push_back(std::move(obj));
+    scan->scanned = index + 1;
+    return v8::Array::CallbackResult::kContinue;
+}
+
+// Fast API strings are not NUL-terminated
+bool copy_path(const char* data, size_t length, char (&path)[PATH_MAX]) {
+    if (length == 0 || length >= PATH_MAX) {
+        return false;
+    }
+    std::memcpy(path, data, length);
+    path[length] = '\0';
+    return true;
+}
+
+uint32_t fnv1a_hash(const uint8_t* data, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+int32_t read_file_prefix(const char* path, uint8_t* buffer, size_t capacity) {
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    size_t total = 0;
+    while (total < capacity) {
+        ssize_t n = ::read(fd, buffer + total, capacity - total);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        total += static_cast<size_t>(n);
+    }
+    ::close(fd);
+    return static_cast<int32_t>(total);
+}
+
+const char* file_event_type_name(FileEventType type) {
+    switch (type) {
+        case FileEventType::Created: return "created";
+        case FileEventType::Modified: return "modified";
+        case FileEventType::Deleted: return "deleted";
+        case FileEventType::Overflow: return "overflow";
+    }
+    return "unknown";
+}
+
+// Reads {recursive, debounce} from an optional JS options object
+FileWatcher::Options watch_options_from_js(v8::Isolate* isolate, v8::Local<v8::Value> value) {
+    FileWatcher::Options options;
+    if (!value->IsObject()) {
+        return options;
+    }
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::Object> object = value.As<v8::Object>();
+    v8::Local<v8::Value> field;
+    if (object->Get(context, v8::String::NewFromUtf8Literal(isolate, "recursive")).ToLocal(&field)) {
+        options.recursive = field->BooleanValue(isolate);
+    }
+    if (object->Get(context, v8::String::NewFromUtf8Literal(isolate, "debounce")).ToLocal(&field) &&
+        field->IsNumber()) {
+        options.debounce_ms = static_cast<uint32_t>(std::max(0.0, field.As<v8::Number>()->Value()));
+    }
+    return options;
+}
+
+// Native-initiated JS calls (loop callbacks) have no caller to rethrow to
+void report_callback_exception(v8::Isolate* isolate, const v8::TryCatch& try_catch, const char* origin) {
+    if (!try_catch.HasCaught()) {
+        return;
+    }
+    v8::String::Utf8Value error(isolate, try_catch.Exception());
+    std::cerr << origin << ": " << (*error ? *error : "unknown error") << "\n";
+}
+
+// Length of the prefix made of complete UTF-8 sequences, so a multi-byte
+// character split across pipe reads is decoded once both halves arrive
+size_t utf8_complete_length(const char* data, size_t length) {
+    size_t lead = length;
+    size_t lookback = std::min<size_t>(length, 3);
+    for (size_t i = 1; i <= lookback; ++i) {
+        unsigned char byte = static_cast<unsigned char>(data[length - i]);
+        if ((byte & 0xC0) != 0x80) {
+            lead = length - i;
+            break;
+        }
+    }
+    if (lead == length) {
+        return length;
+    }
+    unsigned char byte = static_cast<unsigned char>(data[lead]);
+    size_t needed = byte >= 0xF0 ? 4 : byte >= 0xE0 ? 3 : byte >= 0xC0 ? 2 : 1;
+    return length - lead >= needed ? length : lead;
+}
+
+const char* signal_name(int signal) {
+    switch (signal) {
+        case SIGHUP: return "SIGHUP";
+        case SIGINT: return "SIGINT";
+        case SIGQUIT: return "SIGQUIT";
+        case SIGABRT: return "SIGABRT";
+        case SIGKILL: return "SIGKILL";
+        case SIGSEGV: return "SIGSEGV";
+        case SIGPIPE: return "SIGPIPE";
+        case SIGTERM: return "SIGTERM";
+        default: return "SIGNAL";
+    }
+}
+
+// Numeric columns are copied into Float64Arrays in one memcpy: the column
+// is shared between tables and must stay immutable, and sandboxed V8 only
+// accepts buffers from the isolate allocator. String columns are converted
+// in one pass
+v8::Local<v8::Value> table_column_to_js(v8::Isolate* isolate, size_t rows, const NexusTable::Column& column) {
+    if (column.kind == NexusTable::ColumnKind::Number) {
+        v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate, rows * sizeof(double));
+        if (rows > 0) {
+            std::memcpy(buffer->Data(), column.numbers->data(), rows * sizeof(double));
+        }
+        return v8::Float64Array::New(buffer, 0, rows);
+    }
+
+    std::vector<v8::Local<v8::Value>> values;
+    values.reserve(rows);
+    for (const std::string& text : *column.strings) {
+        values.push_back(v8::String::NewFromUtf8(isolate, text.data(), v8::NewStringType::kNormal,
+                                                 static_cast<int>(text.size())).ToLocalChecked());
+    }
+    return v8::Array::New(isolate, values.data(), values.size());
+}
+
+v8::Local<v8::Value> table_cell_to_js(v8::Isolate* isolate, const NexusTable::Column& column, size_t row) {
+    if (column.kind == NexusTable::ColumnKind::Number) {
+        return v8::Number::New(isolate, (*column.numbers)[row]);
+    }
+    const std::string& text = (*column.strings)[row];
+    return v8::String::NewFromUtf8(isolate, text.data(), v8::NewStringType::kNormal,
+                                   static_cast<int>(text.size())).ToLocalChecked();
+}
+
+const char* file_type_name(mode_t mode) {
+    if (S_ISREG(mode)) return "file";
+    if (S_ISDIR(mode)) return "directory";
+    if (S_ISLNK(mode)) return "symlink";
+    return "other";
+}
+
+double timespec_to_ms(const struct timespec& ts) {
+    return static_cast<double>(ts.tv_sec) * 1000.0 + static_cast<double>(ts.tv_nsec) / 1e6;
+}
+
+// {status, statusText, headers, ok}; repeated headers are joined with ", "
+v8::Local<v8::Object> http_head_to_js(v8::Isolate* isolate, v8::Local<v8::Context> context,
+                                      const HttpResponseHead& head) {
+    auto to_js_string = [isolate](const std::string& text) {
+        return v8::String::NewFromUtf8(isolate, text.data(), v8::NewStringType::kNormal,
+                                       static_cast<int>(text.size())).ToLocalChecked();
+    };
+
+    std::vector<std::pair<std::string, std::string>> merged;
+    for (const auto& [name, value] : head.headers) {
+        auto it = std::find_if(merged.begin(), merged.end(), [&](const auto& entry) { return entry.first == name; });
+        if (it == merged.end()) {
+            merged.emplace_back(name, value);
+        } else {
+            it->second += ", " + value;
+        }
+    }
+    v8::Local<v8::Object> headers = v8::Object::New(isolate);
+    for (const auto& [name, value] : merged) {
+        headers->CreateDataProperty(context, to_js_string(name), to_js_string(value)).Check();
+    }
+
+    v8::Local<v8::Object> result = v8::Object::New(isolate);
+    auto set = [&](const char* key, v8::Local<v8::Value> value) {
+        result->CreateDataProperty(context, v8::String::NewFromUtf8(isolate, key).ToLocalChecked(), value).Check();
+    };
+    set("status", v8::Integer::New(isolate, head.status));
+    set("statusText", to_js_string(head.reason));
+    set("headers", headers);
+    set("ok", v8::Boolean::New(isolate, head.status >= 200 && head.status < 300));
+    return result;
+}
+
+} // namespace
+
 StellarObjectBridge::StellarObjectBridge(v8::Isolate* isolate, SecurityContext* security_context)
     : isolate_(isolate), security_context_(security_context) {
 }
 
-StellarObjectBridge::~StellarObjectBridge() = default;
+StellarObjectBridge::~StellarObjectBridge() {
+    // Close callbacks run after the isolate is gone: drop JS references now
+    std::vector<uint32_t> ids;
+    for (const auto& [id, timer] : timers_) {
+        ids.push_back(id);
+    }
+    for (uint32_t id : ids) {
+        close_timer(id);
+    }
+    request_work_.clear();
+}
 
 bool StellarObjectBridge::initialize() {
+    isolate_->SetData(kIsolateDataSlot, this);
     setup_default_type_converters();
     return true;
 }
 
+StellarObjectBridge* StellarObjectBridge::from_isolate(v8::Isolate* isolate) {
+    return static_cast<StellarObjectBridge*>(isolate->GetData(kIsolateDataSlot));
+}
+
+void StellarObjectBridge::begin_request(std::vector<std::string> environment) {
+    end_request();
+    in_request_ = true;
+    request_environment_ = std::move(environment);
+}
+
+void StellarObjectBridge::end_request() {
+    if (!in_request_) {
+        return;
+    }
+    in_request_ = false;
+    request_environment_.clear();
+
+    std::vector<uint32_t> owned;
+    for (const auto& [id, timer] : timers_) {
+        if (timer->request_owned) {
+            owned.push_back(id);
+        }
+    }
+    for (uint32_t id : owned) {
+        close_timer(id);
+    }
+
+    std::vector<std::function<void()>> work;
+    work.swap(request_work_);
+    for (const auto& cancel : work) {
+        cancel();
+    }
+}
+
+void StellarObjectBridge::track_request_work(std::function<void()> cancel) {
+    if (in_request_) {
+        request_work_.push_back(std::move(cancel));
+    }
+}
+
+std::vector<std::string> StellarObjectBridge::environment() const {
+    if (in_request_) {
+        return request_environment_;
+    }
+    std::vector<std::string> entries;
+    for (char** entry = environ; entry && *entry; ++entry) {
+        entries.emplace_back(*entry);
+    }
+    return entries;
+}
+
 v8::Local<v8::Value> StellarObjectBridge::nexus_to_js(const NexusObject& obj) {
     v8::EscapableHandleScope handle_scope(isolate_);
     
     // Check for custom type converter
-    auto it = type_converters_.find(obj.metadata.type);
-    if (it != type_converters_.end()) {
-        return handle_scope.Escape(it->second.first(obj));
+    TypeId type_id = obj.metadata.type_id;
+    if (type_id < type_converters_.size() && type_converters_[type_id].to_js) {
+        return handle_scope.Escape(type_converters_[type_id].to_js(obj));
     }
     
     // Default conversion based on variant type
@@ -43,6 +386,32 @@ v8::Local<v8::Value> StellarObjectBridge::nexus_to_js(const NexusObject& obj) {
             auto buffer = v8::ArrayBuffer::New(isolate_, value.size());
             std::memcpy(buffer->GetBackingStore()->Data(), value.data(), value.size());
             return handle_scope.Escape(buffer);
+        } else if constexpr (std::is_same_v<T, std::vector<int64_t>> ||
+                             std::is_same_v<T, std::vector<double>>) {
+            std::vector<v8::Local<v8::Value>> elements;
+            elements.reserve(value.size());
+            for (auto element : value) {
+                elements.push_back(v8::Number::New(isolate_, static_cast<double>(element)));
+            }
+            return handle_scope.Escape(v8::Array::New(isolate_, elements.data(), elements.size()));
+        } else if constexpr (std::is_same_v<T, std::shared_ptr<NexusList>>) {
+            if (!value) {
+                return handle_scope.Escape(v8::Array::New(isolate_));
+            }
+            return handle_scope.Escape(nexus_array_to_js(*value));
+        } else if constexpr (std::is_same_v<T, std::shared_ptr<NexusMap>>) {
+            v8::Local<v8::Context> context = isolate_->GetCurrentContext();
+            v8::Local<v8::Object> js_object = v8::Object::New(isolate_);
+            if (value) {
+                for (const auto& [key, entry] : *value) {
+                    js_object->CreateDataProperty(context,
+                        v8::String::NewFromUtf8(isolate_, key.data(), v8::NewStringType::kNormal,
+                                                static_cast<int>(key.size())).ToLocalChecked(),
+                        nexus_to_js(entry)
+                    ).Check();
+                }
+            }
+            return handle_scope.Escape(js_object);
         } else {
             return handle_scope.Escape(v8::Undefined(isolate_));
         }
@@ -50,63 +419,312 @@ v8::Local<v8::Value> StellarObjectBridge::nexus_to_js(const NexusObject& obj) {
 }
 
 NexusObject StellarObjectBridge::js_to_nexus(v8::Local<v8::Value> js_value) {
+    v8::HandleScope handle_scope(isolate_);
+
+    ConversionState state;
+    state.context = isolate_->GetCurrentContext();
+    state.remaining = conversion_budget_;
+
+    NexusObject obj;
+    try {
+        obj = convert_js_value(js_value, state);
+    } catch (const std::exception& e) {
+        obj = create_error_object(std::string("Conversion failed: ") + e.what());
+    }
+
+    stamp_metadata(obj);
+    return obj;
+}
+
+NexusObject StellarObjectBridge::convert_js_value(v8::Local<v8::Value> js_value, ConversionState& state) {
+    consume_conversion_budget(state, 1);
+
     NexusObject obj;
-    obj.metadata.id = std::chrono::duration_cast<std::chrono::nanoseconds>(
-        std::chrono::high_resolution_clock::now().time_since_epoch()
-    ).count();
-    obj.metadata.created_at = obj.metadata.id;
-    obj.metadata.modified_at = obj.metadata.id;
     
-    if (js_value->IsNull() || js_value->IsUndefined()) {
-        obj.metadata.type = "null";
-        obj.value = nullptr;
-    } else if (js_value->IsBoolean()) {
-        obj.metadata.type = "boolean";
-        obj.value = js_value->BooleanValue(isolate_);
-    } else if (js_value->IsNumber()) {
-        obj.metadata.type = "number";
-        if (js_value->IsInt32()) {
-            obj.value = static_cast<int64_t>(js_value->Int32Value(isolate_->GetCurrentContext()).FromJust());
-        } else {
-            obj.value = js_value->NumberValue(isolate_->GetCurrentContext()).FromJust();
-        }
+    if (convert_primitive(js_value, obj)) {
+        // Same conversion as the js_array_to_nexus fast path
     } else if (js_value->IsString()) {
-        obj.metadata.type = "string";
+        obj.metadata.type_id = TypeIds::String;
         v8::String::Utf8Value utf8_value(isolate_, js_value);
         obj.value = std::string(*utf8_value, utf8_value.length());
     } else if (js_value->IsArrayBuffer()) {
-        obj.metadata.type = "buffer";
+        obj.metadata.type_id = TypeIds::Buffer;
         auto buffer = v8::Local<v8::ArrayBuffer>::Cast(js_value);
         auto backing_store = buffer->GetBackingStore();
         std::vector<uint8_t> data(static_cast<uint8_t*>(backing_store->Data()),
                                   static_cast<uint8_t*>(backing_store->Data()) + backing_store->ByteLength());
         obj.value = std::move(data);
+    } else if (js_value->IsTypedArray()) {
+        obj = convert_js_typed_array(js_value.As<v8::TypedArray>());
+        consume_conversion_budget(state, obj.metadata.size);
+    } else if (js_value->IsObject() && !js_value->IsFunction()) {
+        auto js_object = js_value.As<v8::Object>();
+
+        // Cycles are cut like console.log does instead of recursing forever
+        for (const auto& ancestor : state.ancestors) {
+            if (ancestor == js_object) {
+                obj.metadata.type_id = TypeIds::Circular;
+                obj.value = std::string("[Circular]");
+                return obj;
+            }
+        }
+        if (state.ancestors.size() >= kMaxConversionDepth) {
+            throw std::runtime_error("maximum nesting depth exceeded");
+        }
+
+        state.ancestors.push_back(js_object);
+        if (js_value->IsArray()) {
+            obj = convert_js_array(js_value.As<v8::Array>(), state);
+        } else {
+            obj = convert_js_object(js_object, state);
+        }
+        state.ancestors.pop_back();
     } else {
-        obj.metadata.type = "object";
+        obj.metadata.type_id = TypeIds::Object;
         obj.value = std::string("[Object]");
     }
     
     return obj;
 }
 
+NexusObject StellarObjectBridge::convert_js_array(v8::Local<v8::Array> js_array, ConversionState& state) {
+    NexusObject obj;
+    obj.metadata.type_id = TypeIds::Array;
+
+    const uint32_t length = js_array->Length();
+    obj.metadata.size = length;
+
+    // Every element costs at least one value, so an over-budget length fails
+    // before anything is reserved. Holes count too: `new Array(2 ** 31)`
+    // would otherwise reserve gigabytes
+    if (length > state.remaining) {
+        consume_conversion_budget(state, length);
+    }
+    const size_t reserve = std::min<size_t>(length, kMaxArrayReserve);
+
+    // Fast path: packed SMI / double arrays are copied straight into typed
+    // vectors. We speculate on integers, widen to doubles, and only fall back
+    // to the generic conversion once a non-number shows up.
+    NumericArrayScan scan;
+    scan.ints.reserve(reserve);
+    if (js_array->Iterate(state.context, scan_numeric_element, &scan).IsNothing()) {
+        throw std::runtime_error("failed to read array elements");
+    }
+
+    if (scan.scanned == length) {
+        consume_conversion_budget(state, length);
+        if (scan.all_ints) {
+            obj.value = std::move(scan.ints);
+        } else {
+            obj.value = std::move(scan.doubles);
+        }
+        return obj;
+    }
+
+    // Generic path: heterogeneous or nested elements
+    auto list = std::make_shared<NexusList>();
+    list->reserve(reserve);
+
+    // Keep the numeric prefix that was already scanned
+    consume_conversion_budget(state, scan.scanned);
+    for (uint32_t j = 0; j < scan.scanned; ++j) {
+        NexusObject element;
+        element.metadata.type_id = TypeIds::Number;
+        if (scan.all_ints) {
+            element.value = scan.ints[j];
+        } else {
+            element.value = scan.doubles[j];
+        }
+        list->push_back(std::move(element));
+    }
+
+    for (uint32_t j = scan.scanned; j < length; ++j) {
+        v8::HandleScope element_scope(isolate_);
+        v8::Local<v8::Value> element;
+        if (!js_array->Get(state.context, j).ToLocal(&element)) {
+            throw std::runtime_error("failed to read array element");
+        }
+        list->push_back(convert_js_value(element, state));
+    }
+    obj.value = std::move(list);
+    return obj;
+}
+
+NexusObject StellarObjectBridge::convert_js_typed_array(v8::Local<v8::TypedArray> typed_array) {
+    NexusObject obj;
+    obj.metadata.type_id = TypeIds::Array;
+
+    const size_t length = typed_array->Length();
+    obj.metadata.size = length;
+
+    auto backing_store = typed_array->Buffer()->GetBackingStore();
+    const uint8_t* data = static_cast<const uint8_t*>(backing_store->Data()) + typed_array->ByteOffset();
+
+    auto copy_as = [&](auto tag, auto& out) {
+        using Element = decltype(tag);
+        const Element* elements = reinterpret_cast<const Element*>(data);
+        out.assign(elements, elements + length);
+    };
+
+    if (typed_array->IsFloat64Array()) {
+        std::vector<double> values;
+        copy_as(double{}, values);
+        obj.value = std::move(values);
+    } else if (typed_array->IsFloat32Array()) {
+        std::vector<double> values;
+        copy_as(float{}, values);
+        obj.value = std::move(values);
+    } else if (typed_array->IsInt32Array()) {
+        std::vector<int64_t> values;
+        copy_as(int32_t{}, values);
+        obj.value = std::move(values);
+    } else if (typed_array->IsUint32Array()) {
+        std::vector<int64_t> values;
+        copy_as(uint32_t{}, values);
+        obj.value = std::move(values);
+    } else if (typed_array->IsInt16Array()) {
+        std::vector<int64_t> values;
+        copy_as(int16_t{}, values);
+        obj.value = std::move(values);
+    } else if (typed_array->IsUint16Array()) {
+        std::vector<int64_t> values;
+        copy_as(uint16_t{}, values);
+        obj.value = std::move(values);
+    } else if (typed_array->IsInt8Array()) {
+        std::vector<int64_t> values;
+        copy_as(int8_t{}, values);
+        obj.value = std::move(values);
+    } else if (typed_array->IsBigInt64Array()) {
+        std::vector<int64_t> values;
+        copy_as(int64_t{}, values);
+        obj.value = std::move(values);
+    } else {
+        // Uint8Array, Uint8ClampedArray and BigUint64Array travel as raw bytes
+        obj.metadata.type_id = TypeIds::Buffer;
+        obj.metadata.size = typed_array->ByteLength();
+        obj.value = std::vector<uint8_t>(data, data + typed_array->ByteLength());
+    }
+
+    return obj;
+}
+
+NexusObject StellarObjectBridge::convert_js_object(v8::Local<v8::Object> js_object, ConversionState& state) {
+    NexusObject obj;
+    obj.metadata.type_id = TypeIds::Object;
+
+    v8::Local<v8::Array> names;
+    if (!js_object->GetOwnPropertyNames(state.context,
+            static_cast<v8::PropertyFilter>(v8::ONLY_ENUMERABLE | v8::SKIP_SYMBOLS),
+            v8::KeyConversionMode::kConvertToString).ToLocal(&names)) {
+        throw std::runtime_error("failed to enumerate object properties");
+    }
+
+    const uint32_t count = names->Length();
+    obj.metadata.size = count;
+
+    std::vector<v8::Local<v8::Value>> keys;
+    keys.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        keys.push_back(names->Get(state.context, i).ToLocalChecked());
+    }
+
+    // Fast path for objects sharing a recently seen shape (rows of a result
+    // set): reuse the already-decoded key strings instead of converting each
+    // property name again.
+    std::shared_ptr<const std::vector<std::string>> key_names;
+    for (const auto& shape : state.shapes) {
+        if (shape.keys.size() != count) {
+            continue;
+        }
+        uint32_t i = 0;
+        while (i < count && shape.keys[i] == keys[i]) {
+            ++i;
+        }
+        if (i == count) {
+            key_names = shape.names;
+            break;
+        }
+    }
+
+    if (!key_names) {
+        auto decoded = std::make_shared<std::vector<std::string>>();
+        decoded->reserve(count);
+        for (const auto& key : keys) {
+            v8::String::Utf8Value utf8_key(isolate_, key);
+            decoded->emplace_back(*utf8_key, utf8_key.length());
+        }
+        key_names = decoded;
+
+        if (state.shapes.size() < kMaxCachedShapes) {
+            state.shapes.emplace_back();
+        }
+        ObjectShape& slot = state.shapes[state.next_shape_slot++ % state.shapes.size()];
+        slot.keys.clear();
+        slot.keys.reserve(count);
+        for (const auto& key : keys) {
+            slot.keys.emplace_back(isolate_, key);
+        }
+        slot.names = key_names;
+    }
+
+    auto map = std::make_shared<NexusMap>();
+    map->reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        v8::HandleScope property_scope(isolate_);
+        v8::Local<v8::Value> property;
+        if (!js_object->Get(state.context, keys[i]).ToLocal(&property)) {
+            throw std::runtime_error("failed to read object property");
+        }
+        if (property->IsFunction()) {
+            continue;
+        }
+        map->emplace_back((*key_names)[i], convert_js_value(property, state));
+    }
+
+    obj.value = std::move(map);
+    return obj;
+}
+
+void StellarObjectBridge::consume_conversion_budget(ConversionState& state, size_t count) {
+    if (count > state.remaining) {
+        throw std::runtime_error("conversion budget of " +
+            std::to_string(conversion_budget_) + " values exceeded");
+    }
+    state.remaining -= count;
+}
+
 v8::Local<v8::Array> StellarObjectBridge::nexus_array_to_js(const std::vector<NexusObject>& objects) {
     v8::EscapableHandleScope handle_scope(isolate_);
-    v8::Local<v8::Array> js_array = v8::Array::New(isolate_, objects.size());
-    v8::Local<v8::Context> context = isolate_->GetCurrentContext();
-    
-    for (size_t i = 0; i < objects.size(); ++i) {
-        js_array->Set(context, i, nexus_to_js(objects[i])).Check();
+
+    // Build all elements first and hand them to V8 in one allocation instead
+    // of growing the array through per-element Set() calls
+    std::vector<v8::Local<v8::Value>> elements;
+    elements.reserve(objects.size());
+    for (const auto& obj : objects) {
+        elements.push_back(nexus_to_js(obj));
     }
     
-    return handle_scope.Escape(js_array);
+    return handle_scope.Escape(v8::Array::New(isolate_, elements.data(), elements.size()));
 }
 
 std::vector<NexusObject> StellarObjectBridge::js_array_to_nexus(v8::Local<v8::Array> js_array) {
     std::vector<NexusObject> objects;
     v8::Local<v8::Context> context = isolate_->GetCurrentContext();
+    const uint32_t length = js_array->Length();
+    objects.reserve(length);
+
+    // Fast read path for the primitive prefix of the array
+    PrimitiveArrayScan scan{&objects};
+    if (js_array->Iterate(context, scan_primitive_element, &scan).IsNothing()) {
+        objects.resize(scan.scanned);
+    }
     
-    for (uint32_t i = 0; i < js_array->Length(); ++i) {
-        v8::Local<v8::Value> element = js_array->Get(context, i).ToLocalChecked();
+    for (uint32_t i = scan.scanned; i < length; ++i) {
+        v8::HandleScope element_scope(isolate_);
+        v8::Local<v8::Value> element;
+        if (!js_array->Get(context, i).ToLocal(&element)) {
+            break;
+        }
         objects.push_back(js_to_nexus(element));
     }
     
@@ -138,11 +756,36 @@ v8::Local<v8::Object> StellarObjectBridge::create_filesystem_api() {
         v8::String::NewFromUtf8(isolate_, "stat").ToLocalChecked(),
         create_js_function("stat", js_fs_stat)
     ).Check();
+
+    fs_api->Set(context,
+        v8::String::NewFromUtf8(isolate_, "walk").ToLocalChecked(),
+        create_js_function("walk", js_fs_walk)
+    ).Check();
     
     fs_api->Set(context,
         v8::String::NewFromUtf8(isolate_, "watch").ToLocalChecked(),
         create_js_function("watch", js_fs_watch)
     ).Check();
+
+    fs_api->Set(context,
+        v8::String::NewFromUtf8(isolate_, "transaction").ToLocalChecked(),
+        create_js_function("transaction", js_fs_transaction)
+    ).Check();
+
+    fs_api->Set(context,
+        v8::String::NewFromUtf8(isolate_, "exists").ToLocalChecked(),
+        create_fast_js_function("exists", js_fs_exists, &fast_callbacks().fs_exists)
+    ).Check();
+
+    fs_api->Set(context,
+        v8::String::NewFromUtf8(isolate_, "size").ToLocalChecked(),
+        create_fast_js_function("size", js_fs_size, &fast_callbacks().fs_size)
+    ).Check();
+
+    fs_api->Set(context,
+        v8::String::NewFromUtf8(isolate_, "readInto").ToLocalChecked(),
+        create_fast_js_function("readInto", js_fs_read_into, &fast_callbacks().fs_read_into)
+    ).Check();
     
     return handle_scope.Escape(fs_api);
 }
@@ -171,6 +814,11 @@ v8::Local<v8::Object> StellarObjectBridge::create_process_api() {
         v8::String::NewFromUtf8(isolate_, "info").ToLocalChecked(),
         create_js_function("info", js_proc_info)
     ).Check();
+
+    proc_api->Set(context,
+        v8::String::NewFromUtf8(isolate_, "env").ToLocalChecked(),
+        create_js_function("env", js_proc_env)
+    ).Check();
     
     return handle_scope.Escape(proc_api);
 }
@@ -180,6 +828,11 @@ v8::Local<v8::Object> StellarObjectBridge::create_network_api() {
     v8::Local<v8::Object> net_api = v8::Object::New(isolate_);
     v8::Local<v8::Context> context = isolate_->GetCurrentContext();
     
+    net_api->Set(context,
+        v8::String::NewFromUtf8(isolate_, "request").ToLocalChecked(),
+        create_js_function("request", js_net_request)
+    ).Check();
+
     net_api->Set(context,
         v8::String::NewFromUtf8(isolate_, "get").ToLocalChecked(),
         create_js_function("get", js_net_get)
@@ -198,183 +851,2366 @@ v8::Local<v8::Object> StellarObjectBridge::create_network_api() {
     return handle_scope.Escape(net_api);
 }
 
-v8::Local<v8::Object> StellarObjectBridge::create_utils_api() {
-    v8::EscapableHandleScope handle_scope(isolate_);
-    v8::Local<v8::Object> utils_api = v8::Object::New(isolate_);
-    // Add utility functions
-    return handle_scope.Escape(utils_api);
-}
+void StellarObjectBridge::install_globals(v8::Local<v8::Context> context) {
+    v8::HandleScope handle_scope(isolate_);
 
-// JavaScript API implementations
-void StellarObjectBridge::js_fs_read_file(const v8::FunctionCallbackInfo<v8::Value>& args) {
-    v8::Isolate* isolate = args.GetIsolate();
-    v8::HandleScope handle_scope(isolate);
-    
-    if (args.Length() < 1 || !args[0]->IsString()) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8(isolate, "File path required").ToLocalChecked()));
-        return;
-    }
+    // Setup global nexus object
+    v8::Local<v8::Object> nexus_global = v8::Object::New(isolate_);
     
-    v8::String::Utf8Value path(isolate, args[0]);
-    std::string file_path(*path);
-    
-    try {
-        std::ifstream file(file_path, std::ios::binary);
-        if (!file.is_open()) {
-            isolate->ThrowException(v8::Exception::Error(
-                v8::String::NewFromUtf8(isolate, ("Cannot open file: " + file_path).c_str()).ToLocalChecked()));
-            return;
-        }
-        
-        std::string content((std::istreambuf_iterator<char>(file)),
-                           std::istreambuf_iterator<char>());
-        
-        args.GetReturnValue().Set(v8::String::NewFromUtf8(isolate, content.c_str()).ToLocalChecked());
-        
-    } catch (const std::exception& e) {
-        isolate->ThrowException(v8::Exception::Error(
-            v8::String::NewFromUtf8(isolate, e.what()).ToLocalChecked()));
-    }
-}
+    // Add filesystem API
+    nexus_global->Set(context, 
+        v8::String::NewFromUtf8(isolate_, "fs").ToLocalChecked(), 
+        create_filesystem_api()
+    ).Check();
 
-void StellarObjectBridge::js_fs_write_file(const v8::FunctionCallbackInfo<v8::Value>& args) {
-    v8::Isolate* isolate = args.GetIsolate();
+    // Add process API
+    nexus_global->Set(context,
+        v8::String::NewFromUtf8(isolate_, "proc").ToLocalChecked(),
+        create_process_api()
+    ).Check();
+
+    // Add network API
+    nexus_global->Set(context,
+        v8::String::NewFromUtf8(isolate_, "net").ToLocalChecked(),
+        create_network_api()
+    ).Check();
+
+    // Add native utilities
+    nexus_global->Set(context,
+        v8::String::NewFromUtf8(isolate_, "utils").ToLocalChecked(),
+        create_utils_api()
+    ).Check();
+
+    // Add parallel execution API
+    nexus_global->Set(context,
+        v8::String::NewFromUtf8(isolate_, "parallel").ToLocalChecked(),
+        create_parallel_api()
+    ).Check();
+
+    // Set global nexus object
+    context->Global()->Set(context,
+        v8::String::NewFromUtf8(isolate_, "nexus").ToLocalChecked(),
+        nexus_global
+    ).Check();
+
+    // Timers driven by the event loop
+    const std::pair<const char*, v8::FunctionCallback> timer_functions[] = {
+        {"setTimeout", js_set_timeout},
+        {"setInterval", js_set_interval},
+        {"clearTimeout", js_clear_timer},
+        {"clearInterval", js_clear_timer},
+        {"queueMicrotask", js_queue_microtask},
+    };
+    for (const auto& [name, callback] : timer_functions) {
+        context->Global()->Set(context,
+            v8::String::NewFromUtf8(isolate_, name).ToLocalChecked(),
+            create_js_function(name, callback)
+        ).Check();
+    }
+}
+
+v8::MaybeLocal<v8::Script> StellarObjectBridge::compile_script(v8::Local<v8::Context> context,
+                                                               v8::Local<v8::String> source,
+                                                               uint64_t source_hash, bool& produce_cache) {
+    if (!code_cache_) {
+        produce_cache = false;
+        return v8::Script::Compile(context, source);
+    }
+
+    // The entry must outlive compilation since V8 does not copy the buffer
+    CodeCache::Entry entry = code_cache_->lookup(source_hash);
+    if (!entry) {
+        produce_cache = true;
+        return v8::Script::Compile(context, source);
+    }
+
+    auto* cached_data = new v8::ScriptCompiler::CachedData(
+        entry->data(), static_cast<int>(entry->size()),
+        v8::ScriptCompiler::CachedData::BufferNotOwned
+    );
+    v8::ScriptCompiler::Source script_source(source, cached_data);  // Takes ownership
+    v8::MaybeLocal<v8::Script> script = v8::ScriptCompiler::Compile(
+        context, &script_source, v8::ScriptCompiler::kConsumeCodeCache
+    );
+
+    // V8 rejects caches from other versions/flags or with a source mismatch;
+    // drop the entry and regenerate it from this compilation
+    produce_cache = script_source.GetCachedData()->rejected;
+    if (produce_cache) {
+        code_cache_->record_rejection();
+        code_cache_->invalidate(source_hash);
+    }
+    return script;
+}
+
+void StellarObjectBridge::update_code_cache(v8::Local<v8::Script> script, uint64_t source_hash) {
+    if (!code_cache_) {
+        return;
+    }
+    std::unique_ptr<v8::ScriptCompiler::CachedData> cached_data(
+        v8::ScriptCompiler::CreateCodeCache(script->GetUnboundScript())
+    );
+    if (!cached_data || cached_data->length <= 0) {
+        return;
+    }
+    code_cache_->store(source_hash,
+        std::vector<uint8_t>(cached_data->data, cached_data->data + cached_data->length));
+}
+
+bool StellarObjectBridge::run_script_file(v8::Local<v8::Context> context, const std::string& path) {
+    v8::HandleScope handle_scope(isolate_);
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string code((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+
+    v8::TryCatch try_catch(isolate_);
+    v8::Local<v8::String> source;
+    v8::Local<v8::Script> script;
+    uint64_t source_hash = CodeCache::hash_source(code);
+    bool produce_cache = false;
+    if (!v8::String::NewFromUtf8(isolate_, code.data(), v8::NewStringType::kNormal,
+                                 static_cast<int>(code.size())).ToLocal(&source) ||
+        !compile_script(context, source, source_hash, produce_cache).ToLocal(&script) ||
+        script->Run(context).IsEmpty()) {
+        if (try_catch.HasCaught()) {
+            v8::String::Utf8Value error(isolate_, try_catch.Exception());
+            std::cerr << path << ": " << (*error ? *error : "unknown error") << "\n";
+        }
+        return false;
+    }
+    if (produce_cache) {
+        update_code_cache(script, source_hash);
+    }
+    return true;
+}
+
+const intptr_t* StellarObjectBridge::external_references() {
+    // Every callback reachable from the `nexus` global must be listed here,
+    // otherwise V8 cannot serialize or deserialize the functions wrapping it
+    const FastCallbacks& fast = fast_callbacks();
+    static const intptr_t references[] = {
+        reinterpret_cast<intptr_t>(js_fs_read_file),
+        reinterpret_cast<intptr_t>(js_fs_write_file),
+        reinterpret_cast<intptr_t>(js_fs_list_dir),
+        reinterpret_cast<intptr_t>(js_fs_stat),
+        reinterpret_cast<intptr_t>(js_fs_walk),
+        reinterpret_cast<intptr_t>(js_fs_watch),
+        reinterpret_cast<intptr_t>(js_fs_watch_close),
+        reinterpret_cast<intptr_t>(js_fs_transaction),
+        reinterpret_cast<intptr_t>(js_fs_transaction_protect),
+        reinterpret_cast<intptr_t>(js_fs_transaction_commit),
+        reinterpret_cast<intptr_t>(js_fs_transaction_rollback),
+        reinterpret_cast<intptr_t>(js_fs_transaction_stats),
+        reinterpret_cast<intptr_t>(js_proc_exec),
+        reinterpret_cast<intptr_t>(js_proc_list),
+        reinterpret_cast<intptr_t>(js_proc_kill),
+        reinterpret_cast<intptr_t>(js_proc_info),
+        reinterpret_cast<intptr_t>(js_proc_env),
+        reinterpret_cast<intptr_t>(js_net_request),
+        reinterpret_cast<intptr_t>(js_net_get),
+        reinterpret_cast<intptr_t>(js_net_post),
+        reinterpret_cast<intptr_t>(js_net_download),
+        reinterpret_cast<intptr_t>(js_parallel_map),
+        reinterpret_cast<intptr_t>(js_set_timeout),
+        reinterpret_cast<intptr_t>(js_set_interval),
+        reinterpret_cast<intptr_t>(js_clear_timer),
+        reinterpret_cast<intptr_t>(js_queue_microtask),
+        reinterpret_cast<intptr_t>(js_table_column),
+        reinterpret_cast<intptr_t>(js_table_get),
+        reinterpret_cast<intptr_t>(js_table_filter),
+        reinterpret_cast<intptr_t>(js_table_sort_by),
+        reinterpret_cast<intptr_t>(js_table_select),
+        reinterpret_cast<intptr_t>(js_table_take),
+        reinterpret_cast<intptr_t>(js_utils_encode),
+        reinterpret_cast<intptr_t>(js_utils_decode),
+        reinterpret_cast<intptr_t>(js_fs_exists),
+        reinterpret_cast<intptr_t>(js_fs_size),
+        reinterpret_cast<intptr_t>(js_fs_read_into),
+        reinterpret_cast<intptr_t>(js_utils_hash),
+        reinterpret_cast<intptr_t>(fast.fs_exists.GetAddress()),
+        reinterpret_cast<intptr_t>(fast.fs_exists.GetTypeInfo()),
+        reinterpret_cast<intptr_t>(fast.fs_size.GetAddress()),
+        reinterpret_cast<intptr_t>(fast.fs_size.GetTypeInfo()),
+        reinterpret_cast<intptr_t>(fast.fs_read_into.GetAddress()),
+        reinterpret_cast<intptr_t>(fast.fs_read_into.GetTypeInfo()),
+        reinterpret_cast<intptr_t>(fast.utils_hash.GetAddress()),
+        reinterpret_cast<intptr_t>(fast.utils_hash.GetTypeInfo()),
+        0
+    };
+    return references;
+}
+
+v8::Local<v8::Object> StellarObjectBridge::create_parallel_api() {
+    v8::EscapableHandleScope handle_scope(isolate_);
+    v8::Local<v8::Object> parallel_api = v8::Object::New(isolate_);
+    v8::Local<v8::Context> context = isolate_->GetCurrentContext();
+
+    parallel_api->Set(context,
+        v8::String::NewFromUtf8(isolate_, "map").ToLocalChecked(),
+        create_js_function("map", js_parallel_map)
+    ).Check();
+
+    return handle_scope.Escape(parallel_api);
+}
+
+v8::Local<v8::Object> StellarObjectBridge::create_utils_api() {
+    v8::EscapableHandleScope handle_scope(isolate_);
+    v8::Local<v8::Object> utils_api = v8::Object::New(isolate_);
+    v8::Local<v8::Context> context = isolate_->GetCurrentContext();
+
+    utils_api->Set(context,
+        v8::String::NewFromUtf8(isolate_, "hash").ToLocalChecked(),
+        create_fast_js_function("hash", js_utils_hash, &fast_callbacks().utils_hash)
+    ).Check();
+
+    utils_api->Set(context,
+        v8::String::NewFromUtf8(isolate_, "encode").ToLocalChecked(),
+        create_js_function("encode", js_utils_encode)
+    ).Check();
+
+    utils_api->Set(context,
+        v8::String::NewFromUtf8(isolate_, "decode").ToLocalChecked(),
+        create_js_function("decode", js_utils_decode)
+    ).Check();
+
+    return handle_scope.Escape(utils_api);
+}
+
+// JavaScript API implementations
+// readFile(path) -> Promise<string>; writeFile(path, content) -> Promise<true>.
+// The blocking I/O runs on the libuv thread pool and the promise settles
+// on the loop thread; isolates without an event loop do it inline instead
+void StellarObjectBridge::js_fs_read_file(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
     v8::HandleScope handle_scope(isolate);
     
-    if (args.Length() < 2 || !args[0]->IsString() || !args[1]->IsString()) {
+    if (args.Length() < 1 || !args[0]->IsString()) {
         isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8(isolate, "File path and content required").ToLocalChecked()));
+            v8::String::NewFromUtf8(isolate, "File path required").ToLocalChecked()));
         return;
     }
     
     v8::String::Utf8Value path(isolate, args[0]);
-    v8::String::Utf8Value content(isolate, args[1]);
+    run_file_task(args, FileTask::Read, *path, std::string());
+}
+
+void StellarObjectBridge::js_fs_write_file(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
     
-    try {
-        std::ofstream file(*path);
-        if (!file.is_open()) {
-            isolate->ThrowException(v8::Exception::Error(
-                v8::String::NewFromUtf8(isolate, ("Cannot create file: " + std::string(*path)).c_str()).ToLocalChecked()));
+    if (args.Length() < 2 || !args[0]->IsString() || !(args[1]->IsString() || args[1]->IsArrayBufferView())) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, "File path and content required").ToLocalChecked()));
+        return;
+    }
+    
+    v8::String::Utf8Value path(isolate, args[0]);
+    std::string content;
+    if (args[1]->IsArrayBufferView()) {
+        v8::Local<v8::ArrayBufferView> view = args[1].As<v8::ArrayBufferView>();
+        content.resize(view->ByteLength());
+        view->CopyContents(content.data(), content.size());
+    } else {
+        v8::String::Utf8Value text(isolate, args[1]);
+        content.assign(*text, text.length());
+    }
+    run_file_task(args, FileTask::Write, *path, std::move(content));
+}
+
+void StellarObjectBridge::run_file_task(const v8::FunctionCallbackInfo<v8::Value>& args, FileTask::Kind kind,
+                                        std::string path, std::string data) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    StellarObjectBridge* bridge = from_isolate(isolate);
+
+    auto* task = new FileTask;
+    task->kind = kind;
+    task->path = std::move(path);
+    task->data = std::move(data);
+    task->req.data = task;
+
+    if (!bridge->event_loop_) {
+        std::unique_ptr<FileTask> owned(task);
+        FileTask::run(&task->req);
+        if (!task->error.empty()) {
+            bridge->throw_js_error(task->error);
             return;
         }
-        
-        file << *content;
-        args.GetReturnValue().Set(v8::Boolean::New(isolate, true));
-        
-    } catch (const std::exception& e) {
-        isolate->ThrowException(v8::Exception::Error(
-            v8::String::NewFromUtf8(isolate, e.what()).ToLocalChecked()));
+        args.GetReturnValue().Set(task->result(isolate));
+        return;
+    }
+
+    v8::Local<v8::Promise::Resolver> resolver = v8::Promise::Resolver::New(context).ToLocalChecked();
+    task->isolate = isolate;
+    task->context.Reset(isolate, context);
+    task->resolver.Reset(isolate, resolver);
+    uv_queue_work(bridge->event_loop_, &task->req, FileTask::run, FileTask::done);
+    args.GetReturnValue().Set(resolver->GetPromise());
+}
+
+void StellarObjectBridge::FileTask::run(uv_work_t* req) {
+    FileTask* task = static_cast<FileTask*>(req->data);
+    bool reading = task->kind == Read;
+    // Truncating a file a transaction snapshot shares would rewrite the snapshot
+    mode_t mode = 0666;
+    bool relinked = !reading && FsTransaction::break_snapshot_link(task->path, mode);
+    int fd = ::open(task->path.c_str(), reading ? O_RDONLY | O_CLOEXEC : O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, mode);
+    if (fd < 0) {
+        task->error = std::string(reading ? "Cannot open file: " : "Cannot create file: ") + task->path +
+                      ": " + std::strerror(errno);
+        return;
+    }
+    if (relinked) {
+        ::fchmod(fd, mode);                 // Not subject to the umask
+    }
+
+    if (reading) {
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            task->data.reserve(static_cast<size_t>(st.st_size));
+        }
+        char buffer[64 * 1024];
+        ssize_t count;
+        while ((count = ::read(fd, buffer, sizeof(buffer))) != 0) {
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                task->error = "Cannot read file: " + task->path + ": " + std::strerror(errno);
+                break;
+            }
+            task->data.append(buffer, static_cast<size_t>(count));
+        }
+    } else {
+        size_t written = 0;
+        while (written < task->data.size()) {
+            ssize_t count = ::write(fd, task->data.data() + written, task->data.size() - written);
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                task->error = "Cannot write file: " + task->path + ": " + std::strerror(errno);
+                break;
+            }
+            written += static_cast<size_t>(count);
+        }
+    }
+    ::close(fd);
+}
+
+void StellarObjectBridge::FileTask::done(uv_work_t* req, int status) {
+    std::unique_ptr<FileTask> task(static_cast<FileTask*>(req->data));
+    v8::Isolate* isolate = task->isolate;
+    v8::Isolate::Scope isolate_scope(isolate);
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = task->context.Get(isolate);
+    v8::Context::Scope context_scope(context);
+
+    v8::Local<v8::Promise::Resolver> resolver = task->resolver.Get(isolate);
+    if (status == UV_ECANCELED) {
+        task->error = "File operation cancelled: " + task->path;
+    }
+    if (!task->error.empty()) {
+        resolver->Reject(context, v8::Exception::Error(
+            v8::String::NewFromUtf8(isolate, task->error.c_str()).ToLocalChecked())).Check();
+    } else {
+        resolver->Resolve(context, task->result(isolate)).Check();
+    }
+    isolate->PerformMicrotaskCheckpoint();
+}
+
+v8::Local<v8::Value> StellarObjectBridge::FileTask::result(v8::Isolate* isolate) const {
+    if (kind == Write) {
+        return v8::True(isolate);
     }
+    return v8::String::NewFromUtf8(isolate, data.data(), v8::NewStringType::kNormal,
+                                   static_cast<int>(data.size())).ToLocalChecked();
 }
 
+// listDir(path) -> table {name, type, size, mode, mtime}. Types follow
+// symlinks; a dangling link is reported as "symlink"
 void StellarObjectBridge::js_fs_list_dir(const v8::FunctionCallbackInfo<v8::Value>& args) {
     v8::Isolate* isolate = args.GetIsolate();
     v8::HandleScope handle_scope(isolate);
-    v8::Local<v8::Context> context = isolate->GetCurrentContext();
-    
+    StellarObjectBridge* bridge = from_isolate(isolate);
+
     std::string dir_path = ".";
     if (args.Length() > 0 && args[0]->IsString()) {
         v8::String::Utf8Value path(isolate, args[0]);
         dir_path = *path;
     }
-    
-    try {
-        v8::Local<v8::Array> result = v8::Array::New(isolate);
-        uint32_t index = 0;
-        
-        for (const auto& entry : std::filesystem::directory_iterator(dir_path)) {
-            v8::Local<v8::Object> file_obj = v8::Object::New(isolate);
-            
-            file_obj->Set(context,
-                v8::String::NewFromUtf8(isolate, "name").ToLocalChecked(),
-                v8::String::NewFromUtf8(isolate, entry.path().filename().c_str()).ToLocalChecked()
-            ).Check();
-            
-            file_obj->Set(context,
-                v8::String::NewFromUtf8(isolate, "isFile").ToLocalChecked(),
-                v8::Boolean::New(isolate, entry.is_regular_file())
-            ).Check();
-            
-            file_obj->Set(context,
-                v8::String::NewFromUtf8(isolate, "isDirectory").ToLocalChecked(),
-                v8::Boolean::New(isolate, entry.is_directory())
-            ).Check();
-            
-            if (entry.is_regular_file()) {
-                auto size = std::filesystem::file_size(entry);
-                file_obj->Set(context,
-                    v8::String::NewFromUtf8(isolate, "size").ToLocalChecked(),
-                    v8::Number::New(isolate, static_cast<double>(size))
-                ).Check();
-            }
-            
-            result->Set(context, index++, file_obj).Check();
+
+    DIR* dir = ::opendir(dir_path.c_str());
+    if (!dir) {
+        bridge->throw_js_error("Cannot list directory: " + dir_path + ": " + std::strerror(errno));
+        return;
+    }
+    std::vector<std::string> names;
+    std::vector<struct stat> stats;
+    int dir_fd = ::dirfd(dir);
+    while (struct dirent* entry = ::readdir(dir)) {
+        if (std::strcmp(entry->d_name, ".") == 0 || std::strcmp(entry->d_name, "..") == 0) {
+            continue;
         }
-        
+        struct stat st;
+        if (::fstatat(dir_fd, entry->d_name, &st, 0) != 0 &&
+            ::fstatat(dir_fd, entry->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+            continue;   // Removed since readdir
+        }
+        names.emplace_back(entry->d_name);
+        stats.push_back(st);
+    }
+    ::closedir(dir);
+
+    size_t rows = names.size();
+    auto table = std::make_shared<NexusTable>(rows);
+    NexusTable::Strings& name = table->add_string_column("name");
+    NexusTable::Strings& type = table->add_string_column("type");
+    NexusTable::Numbers& size = table->add_number_column("size");
+    NexusTable::Numbers& mode = table->add_number_column("mode");
+    NexusTable::Numbers& mtime = table->add_number_column("mtime");
+    for (size_t i = 0; i < rows; ++i) {
+        name[i] = std::move(names[i]);
+        type[i] = file_type_name(stats[i].st_mode);
+        size[i] = static_cast<double>(stats[i].st_size);
+        mode[i] = stats[i].st_mode;
+        mtime[i] = timespec_to_ms(stats[i].st_mtim);
+    }
+
+    v8::Local<v8::Object> result;
+    if (bridge->wrap_table(std::move(table)).ToLocal(&result)) {
         args.GetReturnValue().Set(result);
-        
-    } catch (const std::exception& e) {
-        isolate->ThrowException(v8::Exception::Error(
-            v8::String::NewFromUtf8(isolate, e.what()).ToLocalChecked()));
     }
 }
 
+// stat(path) -> {size, mode, uid, gid, mtime, atime, ctime, isFile, ...}
+// stat([paths]) -> table {path, type, size, mode, uid, gid, mtime, atime,
+// ctime}; paths that cannot be stat'ed get type "missing" and NaN numbers
 void StellarObjectBridge::js_fs_stat(const v8::FunctionCallbackInfo<v8::Value>& args) {
-    // Implementation for file stat
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+    if (args.Length() > 0 && args[0]->IsArray()) {
+        v8::Local<v8::Array> paths = args[0].As<v8::Array>();
+        size_t rows = paths->Length();
+        auto table = std::make_shared<NexusTable>(rows);
+        NexusTable::Strings& path = table->add_string_column("path");
+        NexusTable::Strings& type = table->add_string_column("type");
+        NexusTable::Numbers* numbers[] = {
+            &table->add_number_column("size"), &table->add_number_column("mode"),
+            &table->add_number_column("uid"), &table->add_number_column("gid"),
+            &table->add_number_column("mtime"), &table->add_number_column("atime"),
+            &table->add_number_column("ctime"),
+        };
+        for (uint32_t i = 0; i < rows; ++i) {
+            v8::Local<v8::Value> element;
+            if (!paths->Get(context, i).ToLocal(&element)) {
+                return;
+            }
+            path[i] = *v8::String::Utf8Value(isolate, element);
+            struct stat st;
+            if (!element->IsString() || ::lstat(path[i].c_str(), &st) != 0) {
+                type[i] = "missing";
+                for (NexusTable::Numbers* column : numbers) {
+                    (*column)[i] = std::numeric_limits<double>::quiet_NaN();
+                }
+                continue;
+            }
+            type[i] = file_type_name(st.st_mode);
+            (*numbers[0])[i] = static_cast<double>(st.st_size);
+            (*numbers[1])[i] = st.st_mode;
+            (*numbers[2])[i] = st.st_uid;
+            (*numbers[3])[i] = st.st_gid;
+            (*numbers[4])[i] = timespec_to_ms(st.st_mtim);
+            (*numbers[5])[i] = timespec_to_ms(st.st_atim);
+            (*numbers[6])[i] = timespec_to_ms(st.st_ctim);
+        }
+
+        v8::Local<v8::Object> result;
+        if (from_isolate(isolate)->wrap_table(std::move(table)).ToLocal(&result)) {
+            args.GetReturnValue().Set(result);
+        }
+        return;
+    }
+
+    if (args.Length() < 1 || !args[0]->IsString()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, "File path required").ToLocalChecked()));
+        return;
+    }
+
+    v8::String::Utf8Value path(isolate, args[0]);
+    struct stat st;
+    if (::lstat(*path, &st) != 0) {
+        isolate->ThrowException(v8::Exception::Error(
+            v8::String::NewFromUtf8(isolate, ("Cannot stat file: " + std::string(*path)).c_str()).ToLocalChecked()));
+        return;
+    }
+
+    v8::Local<v8::Object> stat_obj = v8::Object::New(isolate);
+    auto set = [&](const char* key, v8::Local<v8::Value> value) {
+        stat_obj->Set(context, v8::String::NewFromUtf8(isolate, key).ToLocalChecked(), value).Check();
+    };
+    set("size", v8::Number::New(isolate, static_cast<double>(st.st_size)));
+    set("mode", v8::Integer::NewFromUnsigned(isolate, st.st_mode));
+    set("uid", v8::Integer::NewFromUnsigned(isolate, st.st_uid));
+    set("gid", v8::Integer::NewFromUnsigned(isolate, st.st_gid));
+    set("mtime", v8::Number::New(isolate, timespec_to_ms(st.st_mtim)));
+    set("atime", v8::Number::New(isolate, timespec_to_ms(st.st_atim)));
+    set("ctime", v8::Number::New(isolate, timespec_to_ms(st.st_ctim)));
+    set("isFile", v8::Boolean::New(isolate, S_ISREG(st.st_mode)));
+    set("isDirectory", v8::Boolean::New(isolate, S_ISDIR(st.st_mode)));
+    set("isSymlink", v8::Boolean::New(isolate, S_ISLNK(st.st_mode)));
+
+    args.GetReturnValue().Set(stat_obj);
 }
 
-void StellarObjectBridge::js_fs_watch(const v8::FunctionCallbackInfo<v8::Value>& args) {
-    // Implementation for file watching
+// walk(root[, spec]) -> table {path, name, type, size, mode, mtime, depth}.
+// spec: name/iname (glob or array of globs, all must match), type (name or
+// array of names), size/mtime (number, {gt, gte, lt, lte, eq} or an array
+// of those), minDepth, maxDepth, limit. Filtering happens during the walk
+void StellarObjectBridge::js_fs_walk(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    StellarObjectBridge* bridge = from_isolate(isolate);
+
+    if (args.Length() < 1 || !args[0]->IsString()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, "Directory path required").ToLocalChecked()));
+        return;
+    }
+
+    DirectoryWalker::Spec spec;
+    if (args.Length() > 1 && args[1]->IsObject()) {
+        v8::Local<v8::Object> js_spec = args[1].As<v8::Object>();
+        auto get = [&](v8::Local<v8::Object> object, const char* key) {
+            v8::Local<v8::Value> value;
+            if (!object->Get(context, v8::String::NewFromUtf8(isolate, key).ToLocalChecked()).ToLocal(&value)) {
+                return v8::Local<v8::Value>(v8::Undefined(isolate));
+            }
+            return value;
+        };
+        // A single value or an array of values
+        auto each = [&](v8::Local<v8::Value> value, auto&& visit) {
+            if (!value->IsArray()) {
+                if (!value->IsUndefined()) {
+                    visit(value);
+                }
+                return;
+            }
+            v8::Local<v8::Array> list = value.As<v8::Array>();
+            for (uint32_t i = 0; i < list->Length(); ++i) {
+                v8::Local<v8::Value> element;
+                if (list->Get(context, i).ToLocal(&element)) {
+                    visit(element);
+                }
+            }
+        };
+        auto parse_range = [&](const char* key, DirectoryWalker::Range& range) {
+            each(get(js_spec, key), [&](v8::Local<v8::Value> condition) {
+                if (condition->IsNumber()) {
+                    double value = condition.As<v8::Number>()->Value();
+                    range.at_least(value, true);
+                    range.at_most(value, true);
+                    return;
+                }
+                if (!condition->IsObject()) {
+                    return;
+                }
+                v8::Local<v8::Object> bounds = condition.As<v8::Object>();
+                auto bound = [&](const char* op, auto&& apply) {
+                    v8::Local<v8::Value> value = get(bounds, op);
+                    if (value->IsNumber()) {
+                        apply(value.As<v8::Number>()->Value());
+                    }
+                };
+                bound("gt", [&](double value) { range.at_least(value, false); });
+                bound("gte", [&](double value) { range.at_least(value, true); });
+                bound("lt", [&](double value) { range.at_most(value, false); });
+                bound("lte", [&](double value) { range.at_most(value, true); });
+                bound("eq", [&](double value) { range.at_least(value, true); range.at_most(value, true); });
+            });
+        };
+        auto to_depth = [](double value) {
+            return static_cast<uint32_t>(std::clamp(value, 0.0, static_cast<double>(UINT32_MAX)));
+        };
+
+        each(get(js_spec, "name"), [&](v8::Local<v8::Value> glob) {
+            spec.names.emplace_back(*v8::String::Utf8Value(isolate, glob));
+        });
+        each(get(js_spec, "iname"), [&](v8::Local<v8::Value> glob) {
+            spec.inames.emplace_back(*v8::String::Utf8Value(isolate, glob));
+        });
+        v8::Local<v8::Value> value = get(js_spec, "type");
+        if (!value->IsUndefined()) {
+            spec.filter_type = true;
+            each(value, [&](v8::Local<v8::Value> type) {
+                spec.type_mask |= DirectoryWalker::type_bit(*v8::String::Utf8Value(isolate, type));
+            });
+        }
+        parse_range("size", spec.size);
+        parse_range("mtime", spec.mtime);
+        value = get(js_spec, "minDepth");
+        if (value->IsNumber()) {
+            spec.min_depth = to_depth(value.As<v8::Number>()->Value());
+        }
+        value = get(js_spec, "maxDepth");
+        if (value->IsNumber()) {
+            spec.max_depth = to_depth(value.As<v8::Number>()->Value());
+        }
+        value = get(js_spec, "limit");
+        if (value->IsNumber()) {
+            spec.limit = static_cast<size_t>(std::max(0.0, value.As<v8::Number>()->Value()));
+        }
+    }
+
+    std::string error;
+    std::shared_ptr<NexusTable> table = DirectoryWalker::walk(*v8::String::Utf8Value(isolate, args[0]), spec, error);
+    if (!table) {
+        bridge->throw_js_error(error);
+        return;
+    }
+    v8::Local<v8::Object> result;
+    if (bridge->wrap_table(std::move(table)).ToLocal(&result)) {
+        args.GetReturnValue().Set(result);
+    }
 }
 
-void StellarObjectBridge::js_proc_exec(const v8::FunctionCallbackInfo<v8::Value>& args) {
-    // Implementation for process execution
+void StellarObjectBridge::js_fs_exists(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    if (args.Length() < 1 || !args[0]->IsString()) {
+        args.GetReturnValue().Set(false);
+        return;
+    }
+    v8::String::Utf8Value path(isolate, args[0]);
+    args.GetReturnValue().Set(::access(*path, F_OK) == 0);
 }
 
-void StellarObjectBridge::js_proc_list(const v8::FunctionCallbackInfo<v8::Value>& args) {
-    // Implementation for process listing
+bool StellarObjectBridge::fast_fs_exists([[maybe_unused]] v8::Local<v8::Object> receiver,
+                                         const v8::FastOneByteString& path) {
+    char path_buffer[PATH_MAX];
+    return copy_path(path.data, path.length, path_buffer) && ::access(path_buffer, F_OK) == 0;
 }
 
-void StellarObjectBridge::js_proc_kill(const v8::FunctionCallbackInfo<v8::Value>& args) {
-    // Implementation for process killing
+// Size in bytes, or -1 if the path cannot be stat'ed
+void StellarObjectBridge::js_fs_size(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    if (args.Length() < 1 || !args[0]->IsString()) {
+        args.GetReturnValue().Set(-1);
+        return;
+    }
+    v8::String::Utf8Value path(isolate, args[0]);
+    struct stat st;
+    args.GetReturnValue().Set(::stat(*path, &st) == 0 ? static_cast<double>(st.st_size) : -1.0);
 }
 
-void StellarObjectBridge::js_proc_info(const v8::FunctionCallbackInfo<v8::Value>& args) {
-    // Implementation for process info
+double StellarObjectBridge::fast_fs_size([[maybe_unused]] v8::Local<v8::Object> receiver,
+                                         const v8::FastOneByteString& path) {
+    char path_buffer[PATH_MAX];
+    struct stat st;
+    if (!copy_path(path.data, path.length, path_buffer) || ::stat(path_buffer, &st) != 0) {
+        return -1;
+    }
+    return static_cast<double>(st.st_size);
 }
 
-void StellarObjectBridge::js_net_get(const v8::FunctionCallbackInfo<v8::Value>& args) {
-    // Implementation for HTTP GET
+// readInto(path, uint8Array): fills the buffer from the start of the file and
+// returns the byte count, or -1 on error; no allocation for small reads
+void StellarObjectBridge::js_fs_read_into(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    if (args.Length() < 2 || !args[0]->IsString() || !args[1]->IsUint8Array()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, "File path and Uint8Array required").ToLocalChecked()));
+        return;
+    }
+    v8::String::Utf8Value path(isolate, args[0]);
+    auto view = args[1].As<v8::Uint8Array>();
+    uint8_t* data = static_cast<uint8_t*>(view->Buffer()->Data()) + view->ByteOffset();
+    args.GetReturnValue().Set(read_file_prefix(*path, data, view->ByteLength()));
 }
 
-void StellarObjectBridge::js_net_post(const v8::FunctionCallbackInfo<v8::Value>& args) {
-    // Implementation for HTTP POST
+int32_t StellarObjectBridge::fast_fs_read_into([[maybe_unused]] v8::Local<v8::Object> receiver,
+                                               const v8::FastOneByteString& path,
+                                               const v8::FastApiTypedArray<uint8_t>& buffer) {
+    char path_buffer[PATH_MAX];
+    uint8_t* data = nullptr;
+    if (!copy_path(path.data, path.length, path_buffer) || !buffer.getStorageIfAligned(&data)) {
+        return -1;
+    }
+    return read_file_prefix(path_buffer, data, buffer.length());
 }
 
-void StellarObjectBridge::js_net_download(const v8::FunctionCallbackInfo<v8::Value>& args) {
-    // Implementation for file download
+// hash(stringOrBytes): 32-bit FNV-1a
+void StellarObjectBridge::js_utils_hash(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    if (args.Length() < 1) {
+        args.GetReturnValue().Set(fnv1a_hash(nullptr, 0));
+        return;
+    }
+    if (args[0]->IsArrayBufferView()) {
+        auto view = args[0].As<v8::ArrayBufferView>();
+        std::vector<uint8_t> bytes(view->ByteLength());
+        view->CopyContents(bytes.data(), bytes.size());
+        args.GetReturnValue().Set(fnv1a_hash(bytes.data(), bytes.size()));
+        return;
+    }
+    v8::String::Utf8Value text(isolate, args[0]);
+    args.GetReturnValue().Set(fnv1a_hash(reinterpret_cast<const uint8_t*>(*text), text.length()));
 }
 
-v8::Local<v8::Function> StellarObjectBridge::create_js_function(const char* name, v8::FunctionCallback callback) {
-    return v8::Function::New(isolate_->GetCurrentContext(), callback).ToLocalChecked();
+// encode(string) -> Uint8Array of its UTF-8 bytes
+void StellarObjectBridge::js_utils_encode(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::String> text;
+    if (args.Length() < 1 || !args[0]->ToString(isolate->GetCurrentContext()).ToLocal(&text)) {
+        text = v8::String::Empty(isolate);
+    }
+    size_t length = text->Utf8Length(isolate);
+    v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate, length);
+    text->WriteUtf8(isolate, static_cast<char*>(buffer->Data()), static_cast<int>(length), nullptr,
+                    v8::String::NO_NULL_TERMINATION);
+    args.GetReturnValue().Set(v8::Uint8Array::New(buffer, 0, length));
 }
 
-void StellarObjectBridge::setup_default_type_converters() {
-    // Setup default type converters for common types
+// decode(bytes) -> string, treating the bytes as UTF-8
+void StellarObjectBridge::js_utils_decode(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    std::string bytes;
+    if (args.Length() > 0 && args[0]->IsArrayBufferView()) {
+        auto view = args[0].As<v8::ArrayBufferView>();
+        bytes.resize(view->ByteLength());
+        view->CopyContents(bytes.data(), bytes.size());
+    } else if (args.Length() > 0 && args[0]->IsArrayBuffer()) {
+        auto buffer = args[0].As<v8::ArrayBuffer>();
+        bytes.assign(static_cast<const char*>(buffer->Data()), buffer->ByteLength());
+    }
+    v8::Local<v8::String> text;
+    if (!v8::String::NewFromUtf8(isolate, bytes.data(), v8::NewStringType::kNormal,
+                                 static_cast<int>(bytes.size())).ToLocal(&text)) {
+        from_isolate(isolate)->throw_js_error("Data too large to decode");
+        return;
+    }
+    args.GetReturnValue().Set(text);
 }
 
-void StellarObjectBridge::register_native_object(ObjectId id, std::shared_ptr<void> native_obj) {
-    native_objects_[id] = native_obj;
+uint32_t StellarObjectBridge::fast_utils_hash([[maybe_unused]] v8::Local<v8::Object> receiver,
+                                              const v8::FastApiTypedArray<uint8_t>& data) {
+    uint8_t* bytes = nullptr;
+    if (data.getStorageIfAligned(&bytes)) {
+        return fnv1a_hash(bytes, data.length());
+    }
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < data.length(); ++i) {
+        hash ^= data.get(i);
+        hash *= 16777619u;
+    }
+    return hash;
 }
 
-void StellarObjectBridge::unregister_native_object(ObjectId id) {
-    native_objects_.erase(id);
+const StellarObjectBridge::FastCallbacks& StellarObjectBridge::fast_callbacks() {
+    static const FastCallbacks callbacks{
+        v8::CFunction::Make(fast_fs_exists),
+        v8::CFunction::Make(fast_fs_size),
+        v8::CFunction::Make(fast_fs_read_into),
+        v8::CFunction::Make(fast_utils_hash),
+    };
+    return callbacks;
 }
 
-std::shared_ptr<void> StellarObjectBridge::get_native_object(ObjectId id) {
-    auto it = native_objects_.find(id);
-    return it != native_objects_.end() ? it->second : nullptr;
+// watch(path, callback[, {recursive, debounce}]): callback receives batches
+// of coalesced {type, path} events from the kernel event loop
+void StellarObjectBridge::js_fs_watch(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+
+    if (args.Length() < 2 || !args[0]->IsString() || !args[1]->IsFunction()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, "Path and callback required").ToLocalChecked()));
+        return;
+    }
+
+    v8::String::Utf8Value path(isolate, args[0]);
+    FileWatcher::Options options = watch_options_from_js(isolate, args[2]);
+
+    v8::Local<v8::Object> handle;
+    if (from_isolate(isolate)->watch_path(*path, args[1].As<v8::Function>(), options).ToLocal(&handle)) {
+        args.GetReturnValue().Set(handle);
+    }
+}
+
+// Dropping the registry entry cancels the subscription; ids are
+// generation-checked, so closing twice is harmless
+void StellarObjectBridge::js_fs_watch_close(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    if (args.Data()->IsBigInt()) {
+        from_isolate(args.GetIsolate())->unregister_native_object(args.Data().As<v8::BigInt>()->Uint64Value());
+    }
+}
+
+v8::MaybeLocal<v8::Object> StellarObjectBridge::watch_path(const std::string& path, v8::Local<v8::Function> callback,
+                                                           const FileWatcher::Options& options) {
+    v8::EscapableHandleScope handle_scope(isolate_);
+    v8::Local<v8::Context> context = isolate_->GetCurrentContext();
+
+    if (!file_watcher_) {
+        throw_js_error("File watching is not available");
+        return {};
+    }
+
+    struct WatchTarget {
+        v8::Isolate* isolate;
+        v8::Global<v8::Context> context;
+        v8::Global<v8::Function> callback;
+    };
+    // The handle holds the callback; the subscription only references it
+    // weakly, so a callback that closes over its own handle is no cycle
+    auto target = std::make_shared<WatchTarget>();
+    target->isolate = isolate_;
+    target->context.Reset(isolate_, context);
+    target->callback.Reset(isolate_, callback);
+    target->callback.SetWeak();
+
+    FileWatcher::SubscriptionId id = file_watcher_->subscribe(path, options,
+        [target](const std::vector<FileEvent>& events) {
+            v8::Isolate* isolate = target->isolate;
+            v8::Isolate::Scope isolate_scope(isolate);
+            v8::HandleScope handle_scope(isolate);
+            v8::Local<v8::Function> function = target->callback.Get(isolate);
+            if (function.IsEmpty()) {
+                return;                     // Handle collected; unsubscribing
+            }
+            v8::Local<v8::Context> context = target->context.Get(isolate);
+            v8::Context::Scope context_scope(context);
+            v8::TryCatch try_catch(isolate);
+
+            v8::Local<v8::String> type_key = v8::String::NewFromUtf8Literal(isolate, "type");
+            v8::Local<v8::String> path_key = v8::String::NewFromUtf8Literal(isolate, "path");
+            std::vector<v8::Local<v8::Value>> elements;
+            elements.reserve(events.size());
+            for (const FileEvent& event : events) {
+                v8::Local<v8::Object> js_event = v8::Object::New(isolate);
+                js_event->CreateDataProperty(context, type_key,
+                    v8::String::NewFromUtf8(isolate, file_event_type_name(event.type)).ToLocalChecked()).Check();
+                js_event->CreateDataProperty(context, path_key,
+                    v8::String::NewFromUtf8(isolate, event.path.data(), v8::NewStringType::kNormal,
+                                            static_cast<int>(event.path.size())).ToLocalChecked()).Check();
+                elements.push_back(js_event);
+            }
+
+            v8::Local<v8::Value> argv[] = {v8::Array::New(isolate, elements.data(), elements.size())};
+            if (function->Call(context, context->Global(), 1, argv).IsEmpty()) {
+                report_callback_exception(isolate, try_catch, "watch callback");
+            }
+            isolate->PerformMicrotaskCheckpoint();
+        });
+
+    if (id == 0) {
+        throw_js_error("Cannot watch path: " + path);
+        return {};
+    }
+
+    // Watching lasts until close() or until the handle is collected. The
+    // kernel clears file_watcher_ before destroying the watcher
+    auto subscription = std::shared_ptr<FileWatcher::SubscriptionId>(new FileWatcher::SubscriptionId(id),
+        [this](FileWatcher::SubscriptionId* subscription_id) {
+            if (file_watcher_) {
+                file_watcher_->unsubscribe(*subscription_id);
+            }
+            delete subscription_id;
+        });
+
+    v8::Local<v8::Object> handle = v8::Object::New(isolate_);
+    ObjectId object_id = register_native_object(handle, std::move(subscription));
+    if (object_id == 0) {
+        throw_js_error("Too many live native objects");
+        return {};
+    }
+    track_request_work([this, object_id] { unregister_native_object(object_id); });
+    v8::Local<v8::Private> callback_key =
+        v8::Private::ForApi(isolate_, v8::String::NewFromUtf8Literal(isolate_, "nexus.watch.callback"));
+    handle->SetPrivate(context, callback_key, callback).Check();
+    handle->Set(context,
+        v8::String::NewFromUtf8Literal(isolate_, "path"),
+        v8::String::NewFromUtf8(isolate_, path.c_str()).ToLocalChecked()
+    ).Check();
+    handle->Set(context,
+        v8::String::NewFromUtf8Literal(isolate_, "close"),
+        v8::Function::New(context, js_fs_watch_close, v8::BigInt::NewFromUnsigned(isolate_, object_id))
+            .ToLocalChecked()
+    ).Check();
+    return handle_scope.Escape(handle);
+}
+
+// transaction({hardlinks}) -> {protect(path | paths), commit(), rollback(), stats()}
+// Copy-on-write snapshots of the paths passed to protect(); rollback()
+// restores them and removes protected paths that did not exist. hardlinks
+// trades copies for links that in-place writes by other programs can
+// change. A handle that is dropped while open commits
+void StellarObjectBridge::js_fs_transaction(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    StellarObjectBridge* bridge = from_isolate(isolate);
+
+    bool hardlinks = false;
+    v8::Local<v8::Value> option;
+    if (args.Length() > 0 && args[0]->IsObject() &&
+        args[0].As<v8::Object>()->Get(context, v8::String::NewFromUtf8Literal(isolate, "hardlinks"))
+            .ToLocal(&option)) {
+        hardlinks = option->BooleanValue(isolate);
+    }
+
+    static std::atomic<uint64_t> next_transaction{1};
+    auto transaction = std::make_shared<FsTransaction>(next_transaction.fetch_add(1, std::memory_order_relaxed),
+                                                       hardlinks);
+
+    v8::Local<v8::Object> handle = v8::Object::New(isolate);
+    ObjectId id = bridge->register_native_object(handle, transaction);
+    if (id == 0) {
+        bridge->throw_js_error("Too many live native objects");
+        return;
+    }
+
+    v8::Local<v8::Value> data = v8::BigInt::NewFromUnsigned(isolate, id);
+    struct Method {
+        const char* name;
+        v8::FunctionCallback callback;
+    };
+    static const Method methods[] = {
+        {"protect", js_fs_transaction_protect},
+        {"commit", js_fs_transaction_commit},
+        {"rollback", js_fs_transaction_rollback},
+        {"stats", js_fs_transaction_stats},
+    };
+    for (const Method& method : methods) {
+        handle->Set(context,
+            v8::String::NewFromUtf8(isolate, method.name).ToLocalChecked(),
+            v8::Function::New(context, method.callback, data).ToLocalChecked()
+        ).Check();
+    }
+    args.GetReturnValue().Set(handle);
+}
+
+std::shared_ptr<FsTransaction> StellarObjectBridge::unwrap_transaction(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    StellarObjectBridge* bridge = from_isolate(args.GetIsolate());
+    std::shared_ptr<FsTransaction> transaction;
+    if (args.Data()->IsBigInt()) {
+        transaction = std::static_pointer_cast<FsTransaction>(
+            bridge->get_native_object(args.Data().As<v8::BigInt>()->Uint64Value()));
+    }
+    if (!transaction) {
+        bridge->throw_js_error("Transaction has been released");
+    }
+    return transaction;
+}
+
+void StellarObjectBridge::js_fs_transaction_protect(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+    std::shared_ptr<FsTransaction> transaction = unwrap_transaction(args);
+    if (!transaction) {
+        return;
+    }
+
+    std::vector<std::string> paths;
+    if (args.Length() > 0 && args[0]->IsArray()) {
+        v8::Local<v8::Array> array = args[0].As<v8::Array>();
+        for (uint32_t i = 0; i < array->Length(); ++i) {
+            v8::Local<v8::Value> element;
+            if (!array->Get(context, i).ToLocal(&element) || !element->IsString()) {
+                isolate->ThrowException(v8::Exception::TypeError(
+                    v8::String::NewFromUtf8Literal(isolate, "Paths must be strings")));
+                return;
+            }
+            paths.emplace_back(*v8::String::Utf8Value(isolate, element));
+        }
+    } else if (args.Length() > 0 && args[0]->IsString()) {
+        paths.emplace_back(*v8::String::Utf8Value(isolate, args[0]));
+    } else {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Path or array of paths required")));
+        return;
+    }
+
+    for (const std::string& path : paths) {
+        std::string error;
+        if (!transaction->protect(path, error)) {
+            from_isolate(isolate)->throw_js_error(error);
+            return;
+        }
+    }
+}
+
+void StellarObjectBridge::js_fs_transaction_commit(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    std::shared_ptr<FsTransaction> transaction = unwrap_transaction(args);
+    if (!transaction) {
+        return;
+    }
+    transaction->commit();
+    from_isolate(args.GetIsolate())->collect_transaction_garbage(std::move(transaction));
+}
+
+void StellarObjectBridge::js_fs_transaction_rollback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    std::shared_ptr<FsTransaction> transaction = unwrap_transaction(args);
+    if (!transaction) {
+        return;
+    }
+    StellarObjectBridge* bridge = from_isolate(args.GetIsolate());
+    std::string error;
+    bool restored = transaction->rollback(error);
+    bridge->collect_transaction_garbage(std::move(transaction));
+    if (!restored) {
+        bridge->throw_js_error("Rollback incomplete: " + error);
+    }
+}
+
+void StellarObjectBridge::js_fs_transaction_stats(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+    std::shared_ptr<FsTransaction> transaction = unwrap_transaction(args);
+    if (!transaction) {
+        return;
+    }
+
+    const FsTransaction::Stats& stats = transaction->stats();
+    const char* state = "open";
+    if (transaction->state() == FsTransaction::State::Committed) {
+        state = "committed";
+    } else if (transaction->state() == FsTransaction::State::RolledBack) {
+        state = "rolledBack";
+    }
+
+    v8::Local<v8::Object> result = v8::Object::New(isolate);
+    auto set_count = [&](const char* name, size_t value) {
+        result->Set(context, v8::String::NewFromUtf8(isolate, name).ToLocalChecked(),
+                    v8::Number::New(isolate, static_cast<double>(value))).Check();
+    };
+    result->Set(context, v8::String::NewFromUtf8Literal(isolate, "state"),
+                v8::String::NewFromUtf8(isolate, state).ToLocalChecked()).Check();
+    set_count("paths", stats.paths);
+    set_count("reflinked", stats.reflinked);
+    set_count("hardlinked", stats.hardlinked);
+    set_count("copied", stats.copied);
+    set_count("directories", stats.directories);
+    set_count("symlinks", stats.symlinks);
+    set_count("skipped", stats.skipped);
+    args.GetReturnValue().Set(result);
+}
+
+// Deleting dropped snapshots walks whole trees: do it on the libuv pool
+void StellarObjectBridge::collect_transaction_garbage(std::shared_ptr<FsTransaction> transaction) {
+    if (!event_loop_) {
+        transaction->collect_garbage();
+        return;
+    }
+    struct GarbageTask {
+        uv_work_t req;
+        std::shared_ptr<FsTransaction> transaction;
+    };
+    auto* task = new GarbageTask;
+    task->req.data = task;
+    task->transaction = std::move(transaction);
+    uv_queue_work(event_loop_, &task->req,
+        [](uv_work_t* req) { static_cast<GarbageTask*>(req->data)->transaction->collect_garbage(); },
+        [](uv_work_t* req, int) { delete static_cast<GarbageTask*>(req->data); });
+}
+
+// exec(command[, options]) -> Promise<{exitCode, signal, stdout, stderr, timedOut}>
+// Runs `command` through /bin/sh, or directly when options.args is given.
+// Options: cwd, env (added to the inherited environment, which is the
+// client's during a daemon request), timeout (ms),
+// capture (default true), encoding ('utf8' | 'buffer') and onStdout/onStderr
+// chunk callbacks invoked as output arrives.
+void StellarObjectBridge::js_proc_exec(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    StellarObjectBridge* bridge = from_isolate(isolate);
+
+    if (!bridge->event_loop_) {
+        bridge->throw_js_error("Process execution is not available");
+        return;
+    }
+    if (args.Length() < 1 || !args[0]->IsString()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, "Command required").ToLocalChecked()));
+        return;
+    }
+
+    struct ExecState {
+        v8::Isolate* isolate;
+        v8::Global<v8::Context> context;
+        v8::Global<v8::Promise::Resolver> resolver;
+        v8::Global<v8::Function> on_stdout;
+        v8::Global<v8::Function> on_stderr;
+        ChildProcess* child = nullptr;      // Until on_exit
+        bool capture = true;
+        bool binary = false;
+        std::string stdout_data;
+        std::string stderr_data;
+        std::string stdout_tail;    // Incomplete UTF-8 sequence from the last chunk
+        std::string stderr_tail;
+    };
+    auto state = std::make_shared<ExecState>();
+    state->isolate = isolate;
+    state->context.Reset(isolate, context);
+
+    v8::String::Utf8Value command(isolate, args[0]);
+    ChildProcess::Options options;
+    options.argv = {"/bin/sh", "-c", *command};
+
+    if (args.Length() > 1 && args[1]->IsObject()) {
+        v8::Local<v8::Object> js_options = args[1].As<v8::Object>();
+        auto get = [&](const char* key) {
+            v8::Local<v8::Value> value;
+            if (!js_options->Get(context, v8::String::NewFromUtf8(isolate, key).ToLocalChecked()).ToLocal(&value)) {
+                return v8::Local<v8::Value>(v8::Undefined(isolate));
+            }
+            return value;
+        };
+
+        v8::Local<v8::Value> value = get("args");
+        if (value->IsArray()) {
+            v8::Local<v8::Array> argv = value.As<v8::Array>();
+            options.argv = {*command};
+            for (uint32_t i = 0; i < argv->Length(); ++i) {
+                v8::Local<v8::Value> arg;
+                if (argv->Get(context, i).ToLocal(&arg)) {
+                    options.argv.emplace_back(*v8::String::Utf8Value(isolate, arg));
+                }
+            }
+        }
+        value = get("cwd");
+        if (value->IsString()) {
+            options.cwd = *v8::String::Utf8Value(isolate, value);
+        }
+        value = get("timeout");
+        if (value->IsNumber()) {
+            options.timeout_ms = static_cast<uint64_t>(std::max(0.0, value.As<v8::Number>()->Value()));
+        }
+        value = get("env");
+        if (value->IsObject()) {
+            std::unordered_map<std::string, std::string> env;
+            for (const std::string& entry : bridge->environment()) {
+                size_t separator = entry.find('=');
+                if (separator != std::string::npos) {
+                    env[entry.substr(0, separator)] = entry.substr(separator + 1);
+                }
+            }
+            v8::Local<v8::Object> js_env = value.As<v8::Object>();
+            v8::Local<v8::Array> keys;
+            if (js_env->GetOwnPropertyNames(context).ToLocal(&keys)) {
+                for (uint32_t i = 0; i < keys->Length(); ++i) {
+                    v8::Local<v8::Value> key, entry;
+                    if (keys->Get(context, i).ToLocal(&key) && js_env->Get(context, key).ToLocal(&entry)) {
+                        env[*v8::String::Utf8Value(isolate, key)] = *v8::String::Utf8Value(isolate, entry);
+                    }
+                }
+            }
+            options.env.reserve(env.size());
+            for (const auto& [key, entry] : env) {
+                options.env.push_back(key + "=" + entry);
+            }
+        }
+        value = get("capture");
+        if (!value->IsUndefined()) {
+            state->capture = value->BooleanValue(isolate);
+        }
+        value = get("encoding");
+        if (value->IsString()) {
+            state->binary = std::string(*v8::String::Utf8Value(isolate, value)) == "buffer";
+        }
+        value = get("onStdout");
+        if (value->IsFunction()) {
+            state->on_stdout.Reset(isolate, value.As<v8::Function>());
+        }
+        value = get("onStderr");
+        if (value->IsFunction()) {
+            state->on_stderr.Reset(isolate, value.As<v8::Function>());
+        }
+    }
+    if (options.env.empty() && bridge->in_request_) {
+        options.env = bridge->request_environment_;
+    }
+    // A daemon request has no terminal to share, and cancelling it must
+    // reach whatever /bin/sh started, not only the shell
+    options.process_group = bridge->in_request_;
+
+    v8::Local<v8::Promise::Resolver> resolver = v8::Promise::Resolver::New(context).ToLocalChecked();
+    state->resolver.Reset(isolate, resolver);
+
+    auto on_output = [state](ChildProcess::Stream stream, const char* data, size_t length) {
+        if (state->resolver.IsEmpty()) {
+            return;                         // Cancelled with its request
+        }
+        bool is_stdout = stream == ChildProcess::Stream::Stdout;
+        if (state->capture) {
+            (is_stdout ? state->stdout_data : state->stderr_data).append(data, length);
+        }
+        v8::Global<v8::Function>& listener = is_stdout ? state->on_stdout : state->on_stderr;
+        if (listener.IsEmpty()) {
+            return;
+        }
+
+        v8::Isolate* isolate = state->isolate;
+        v8::Isolate::Scope isolate_scope(isolate);
+        v8::HandleScope handle_scope(isolate);
+        v8::Local<v8::Context> context = state->context.Get(isolate);
+        v8::Context::Scope context_scope(context);
+        v8::TryCatch try_catch(isolate);
+
+        v8::Local<v8::Value> chunk;
+        if (state->binary) {
+            v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate, length);
+            std::memcpy(buffer->Data(), data, length);
+            chunk = v8::Uint8Array::New(buffer, 0, length);
+        } else {
+            std::string& tail = is_stdout ? state->stdout_tail : state->stderr_tail;
+            tail.append(data, length);
+            size_t complete = utf8_complete_length(tail.data(), tail.size());
+            if (complete == 0) {
+                return;
+            }
+            chunk = v8::String::NewFromUtf8(isolate, tail.data(), v8::NewStringType::kNormal,
+                                            static_cast<int>(complete)).ToLocalChecked();
+            tail.erase(0, complete);
+        }
+
+        if (listener.Get(isolate)->Call(context, v8::Undefined(isolate), 1, &chunk).IsEmpty()) {
+            report_callback_exception(isolate, try_catch, "exec output callback");
+        }
+        isolate->PerformMicrotaskCheckpoint();
+    };
+
+    auto on_exit = [state](const ChildProcess::Result& result) {
+        state->child = nullptr;
+        if (state->resolver.IsEmpty()) {
+            return;
+        }
+        v8::Isolate* isolate = state->isolate;
+        v8::Isolate::Scope isolate_scope(isolate);
+        v8::HandleScope handle_scope(isolate);
+        v8::Local<v8::Context> context = state->context.Get(isolate);
+        v8::Context::Scope context_scope(context);
+
+        auto to_js_string = [isolate](const std::string& text) {
+            return v8::String::NewFromUtf8(isolate, text.data(), v8::NewStringType::kNormal,
+                                           static_cast<int>(text.size())).ToLocalChecked();
+        };
+
+        // Shell convention: a signalled process exits with 128 + signal
+        int64_t exit_code = result.term_signal ? 128 + result.term_signal : result.exit_status;
+        v8::Local<v8::Object> js_result = v8::Object::New(isolate);
+        auto set = [&](const char* key, v8::Local<v8::Value> value) {
+            js_result->CreateDataProperty(context, v8::String::NewFromUtf8(isolate, key).ToLocalChecked(), value).Check();
+        };
+        set("exitCode", v8::Number::New(isolate, static_cast<double>(exit_code)));
+        set("signal", result.term_signal
+            ? v8::Local<v8::Value>(v8::String::NewFromUtf8(isolate, signal_name(result.term_signal)).ToLocalChecked())
+            : v8::Local<v8::Value>(v8::Null(isolate)));
+        set("stdout", to_js_string(state->stdout_data));
+        set("stderr", to_js_string(state->stderr_data));
+        set("timedOut", v8::Boolean::New(isolate, result.timed_out));
+
+        state->resolver.Get(isolate)->Resolve(context, js_result).Check();
+        state->resolver.Reset();
+        state->on_stdout.Reset();
+        state->on_stderr.Reset();
+        isolate->PerformMicrotaskCheckpoint();
+    };
+
+    int status = ChildProcess::spawn(bridge->event_loop_, options, on_output, on_exit, &state->child);
+    if (status != 0) {
+        std::string message = std::string("Cannot execute '") + *command + "': " + uv_strerror(status);
+        resolver->Reject(context, v8::Exception::Error(
+            v8::String::NewFromUtf8(isolate, message.c_str()).ToLocalChecked())).Check();
+    } else {
+        bridge->track_request_work([state] {
+            state->resolver.Reset();
+            state->on_stdout.Reset();
+            state->on_stderr.Reset();
+            if (state->child) {
+                state->child->terminate();
+            }
+        });
+    }
+
+    args.GetReturnValue().Set(resolver->GetPromise());
+}
+
+// setTimeout(callback, delay, ...args) -> id
+void StellarObjectBridge::js_set_timeout(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    start_timer(args, false);
+}
+
+// setInterval(callback, delay, ...args) -> id
+void StellarObjectBridge::js_set_interval(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    start_timer(args, true);
+}
+
+void StellarObjectBridge::start_timer(const v8::FunctionCallbackInfo<v8::Value>& args, bool repeat) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    StellarObjectBridge* bridge = from_isolate(isolate);
+
+    if (!bridge->event_loop_) {
+        bridge->throw_js_error("Timers are not available");
+        return;
+    }
+    if (args.Length() < 1 || !args[0]->IsFunction()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, "Callback required").ToLocalChecked()));
+        return;
+    }
+    double delay = args.Length() > 1 && args[1]->IsNumber() ? args[1].As<v8::Number>()->Value() : 0;
+    // libuv treats a zero repeat as one-shot, so intervals tick at least every 1 ms
+    uint64_t delay_ms = static_cast<uint64_t>(std::clamp(delay, repeat ? 1.0 : 0.0, 2147483647.0));
+
+    auto* timer = new Timer;
+    timer->bridge = bridge;
+    timer->id = bridge->next_timer_id_++;
+    timer->context.Reset(isolate, isolate->GetCurrentContext());
+    timer->callback.Reset(isolate, args[0].As<v8::Function>());
+    for (int i = 2; i < args.Length(); ++i) {
+        timer->args.emplace_back(isolate, args[i]);
+    }
+    timer->request_owned = bridge->in_request_;
+    timer->handle.data = timer;
+    uv_timer_init(bridge->event_loop_, &timer->handle);
+    uv_timer_start(&timer->handle, on_timer, delay_ms, repeat ? delay_ms : 0);
+    bridge->timers_[timer->id] = timer;
+
+    args.GetReturnValue().Set(v8::Integer::NewFromUnsigned(isolate, timer->id));
+}
+
+// clearTimeout(id) / clearInterval(id); unknown ids are ignored
+void StellarObjectBridge::js_clear_timer(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    if (args.Length() > 0 && args[0]->IsUint32()) {
+        from_isolate(args.GetIsolate())->close_timer(args[0].As<v8::Uint32>()->Value());
+    }
+}
+
+void StellarObjectBridge::js_queue_microtask(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    if (args.Length() < 1 || !args[0]->IsFunction()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, "Callback required").ToLocalChecked()));
+        return;
+    }
+    isolate->EnqueueMicrotask(args[0].As<v8::Function>());
+}
+
+void StellarObjectBridge::on_timer(uv_timer_t* handle) {
+    Timer* timer = static_cast<Timer*>(handle->data);
+    StellarObjectBridge* bridge = timer->bridge;
+    v8::Isolate* isolate = bridge->isolate_;
+    v8::Isolate::Scope isolate_scope(isolate);
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = timer->context.Get(isolate);
+    v8::Context::Scope context_scope(context);
+
+    v8::Local<v8::Function> callback = timer->callback.Get(isolate);
+    std::vector<v8::Local<v8::Value>> argv;
+    for (const auto& arg : timer->args) {
+        argv.push_back(arg.Get(isolate));
+    }
+    // One-shot timers are released before the callback, which may set new ones
+    if (uv_timer_get_repeat(handle) == 0) {
+        bridge->close_timer(timer->id);
+    }
+
+    v8::TryCatch try_catch(isolate);
+    if (callback->Call(context, context->Global(), static_cast<int>(argv.size()), argv.data()).IsEmpty()) {
+        report_callback_exception(isolate, try_catch, "timer callback");
+    }
+    isolate->PerformMicrotaskCheckpoint();
+}
+
+void StellarObjectBridge::close_timer(uint32_t id) {
+    auto it = timers_.find(id);
+    if (it == timers_.end()) {
+        return;
+    }
+    Timer* timer = it->second;
+    timers_.erase(it);
+    timer->callback.Reset();
+    timer->context.Reset();
+    timer->args.clear();
+    uv_timer_stop(&timer->handle);
+    uv_close(reinterpret_cast<uv_handle_t*>(&timer->handle), [](uv_handle_t* handle) {
+        delete static_cast<Timer*>(handle->data);
+    });
+}
+
+// list([{maxAge}]) -> table {pid, ppid, uid, threads, cpu, memory,
+// virtualMemory, state, name, command} plus `interval`; a snapshot younger
+// than maxAge ms is shared instead of rescanning
+void StellarObjectBridge::js_proc_list(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    StellarObjectBridge* bridge = from_isolate(isolate);
+
+    if (!bridge->process_snapshots_) {
+        bridge->throw_js_error("Process listing is not available");
+        return;
+    }
+
+    uint64_t max_age_ms = 0;
+    v8::Local<v8::Value> max_age;
+    if (args.Length() > 0 && args[0]->IsObject() &&
+        args[0].As<v8::Object>()->Get(context, v8::String::NewFromUtf8Literal(isolate, "maxAge")).ToLocal(&max_age) &&
+        max_age->IsNumber()) {
+        max_age_ms = static_cast<uint64_t>(std::max(0.0, max_age.As<v8::Number>()->Value()));
+    }
+
+    std::shared_ptr<const ProcessSnapshot> snapshot;
+    try {
+        snapshot = bridge->process_snapshots_->scan(max_age_ms);
+    } catch (const std::exception& e) {
+        bridge->throw_js_error(e.what());
+        return;
+    }
+
+    size_t rows = snapshot->size();
+    auto table = std::make_shared<NexusTable>(rows);
+    auto add_numbers = [&](const char* name, const auto& column) {
+        NexusTable::Numbers& values = table->add_number_column(name);
+        for (size_t i = 0; i < rows; ++i) {
+            values[i] = static_cast<double>(column[i]);
+        }
+    };
+    add_numbers("pid", snapshot->pid);
+    add_numbers("ppid", snapshot->ppid);
+    add_numbers("uid", snapshot->uid);
+    add_numbers("threads", snapshot->threads);
+    add_numbers("cpu", snapshot->cpu_percent);
+    add_numbers("memory", snapshot->rss_bytes);
+    add_numbers("virtualMemory", snapshot->vsize_bytes);
+    NexusTable::Strings& state = table->add_string_column("state");
+    for (size_t i = 0; i < rows; ++i) {
+        state[i].assign(1, snapshot->state[i]);
+    }
+    table->add_string_column("name") = snapshot->name;
+    table->add_string_column("command") = snapshot->command;
+
+    v8::Local<v8::Object> result;
+    if (!bridge->wrap_table(std::move(table)).ToLocal(&result)) {
+        return;
+    }
+    result->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "interval"),
+                               v8::Number::New(isolate, snapshot->interval_s)).Check();
+    args.GetReturnValue().Set(result);
+}
+
+void StellarObjectBridge::js_proc_kill(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    // Implementation for process killing
+}
+
+void StellarObjectBridge::js_proc_info(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    // Implementation for process info
+}
+
+// env() -> {NAME: value}: the environment proc.exec children get, which is
+// the client's during a daemon request
+void StellarObjectBridge::js_proc_env(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+    v8::Local<v8::Object> env = v8::Object::New(isolate);
+    for (const std::string& entry : from_isolate(isolate)->environment()) {
+        size_t separator = entry.find('=');
+        if (separator == std::string::npos) {
+            continue;
+        }
+        v8::Local<v8::String> name, value;
+        if (v8::String::NewFromUtf8(isolate, entry.data(), v8::NewStringType::kNormal,
+                                    static_cast<int>(separator)).ToLocal(&name) &&
+            v8::String::NewFromUtf8(isolate, entry.data() + separator + 1, v8::NewStringType::kNormal,
+                                    static_cast<int>(entry.size() - separator - 1)).ToLocal(&value)) {
+            env->CreateDataProperty(context, name, value).Check();
+        }
+    }
+    args.GetReturnValue().Set(env);
+}
+
+// request(method, url[, body[, options]]) -> Promise<{status, statusText, headers, ok, body}>
+void StellarObjectBridge::js_net_request(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    if (args.Length() < 2 || !args[0]->IsString()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, "Method and URL required").ToLocalChecked()));
+        return;
+    }
+    std::string method = *v8::String::Utf8Value(isolate, args[0]);
+    std::transform(method.begin(), method.end(), method.begin(), ::toupper);
+    if (!HttpClient::valid_method(method)) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, ("Invalid HTTP method: " + method).c_str()).ToLocalChecked()));
+        return;
+    }
+    send_http_request(args, method, args[1], args[2], args[3]);
+}
+
+// get(url[, options])
+void StellarObjectBridge::js_net_get(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    send_http_request(args, "GET", args[0], v8::Undefined(args.GetIsolate()), args[1]);
+}
+
+// post(url, body[, options])
+void StellarObjectBridge::js_net_post(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    send_http_request(args, "POST", args[0], args[1], args[2]);
+}
+
+// Shared by request/get/post. Body is a string or byte array. Options:
+// headers (object), timeout (ms), and onData(Uint8Array)/onEnd()/onError(e)
+// to stream the body: the promise then resolves as soon as the response head
+// arrives. Otherwise the body is buffered and returned as a Uint8Array.
+void StellarObjectBridge::send_http_request(const v8::FunctionCallbackInfo<v8::Value>& args,
+                                            const std::string& method, v8::Local<v8::Value> url,
+                                            v8::Local<v8::Value> body, v8::Local<v8::Value> options) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    StellarObjectBridge* bridge = from_isolate(isolate);
+
+    if (!bridge->http_client_) {
+        bridge->throw_js_error("Network access is not available");
+        return;
+    }
+    if (!url->IsString()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, "URL required").ToLocalChecked()));
+        return;
+    }
+
+    HttpClient::Request request;
+    request.method = method;
+    std::string error;
+    if (!HttpUrl::parse(*v8::String::Utf8Value(isolate, url), request.url, error)) {
+        bridge->throw_js_error(error);
+        return;
+    }
+
+    if (body->IsArrayBufferView()) {
+        auto view = body.As<v8::ArrayBufferView>();
+        request.body.resize(view->ByteLength());
+        view->CopyContents(request.body.data(), request.body.size());
+    } else if (!body->IsNullOrUndefined()) {
+        v8::String::Utf8Value text(isolate, body);
+        request.body.assign(*text, static_cast<size_t>(text.length()));
+    }
+
+    struct HttpState {
+        v8::Isolate* isolate;
+        v8::Global<v8::Context> context;
+        v8::Global<v8::Promise::Resolver> resolver;
+        v8::Global<v8::Function> on_data;
+        v8::Global<v8::Function> on_end;
+        v8::Global<v8::Function> on_error;
+        HttpResponseHead head;
+        bool head_received = false;
+        std::string body;
+    };
+    auto state = std::make_shared<HttpState>();
+    state->isolate = isolate;
+    state->context.Reset(isolate, context);
+
+    if (options->IsObject()) {
+        v8::Local<v8::Object> js_options = options.As<v8::Object>();
+        auto get = [&](const char* key) {
+            v8::Local<v8::Value> value;
+            if (!js_options->Get(context, v8::String::NewFromUtf8(isolate, key).ToLocalChecked()).ToLocal(&value)) {
+                return v8::Local<v8::Value>(v8::Undefined(isolate));
+            }
+            return value;
+        };
+
+        v8::Local<v8::Value> value = get("headers");
+        v8::Local<v8::Array> keys;
+        if (value->IsObject() && value.As<v8::Object>()->GetOwnPropertyNames(context).ToLocal(&keys)) {
+            v8::Local<v8::Object> headers = value.As<v8::Object>();
+            for (uint32_t i = 0; i < keys->Length(); ++i) {
+                v8::Local<v8::Value> key, entry;
+                if (keys->Get(context, i).ToLocal(&key) && headers->Get(context, key).ToLocal(&entry)) {
+                    request.headers.emplace_back(*v8::String::Utf8Value(isolate, key),
+                                                 *v8::String::Utf8Value(isolate, entry));
+                }
+            }
+        }
+        value = get("timeout");
+        if (value->IsNumber()) {
+            request.timeout_ms = static_cast<uint64_t>(std::max(0.0, value.As<v8::Number>()->Value()));
+        }
+        value = get("onData");
+        if (value->IsFunction()) {
+            state->on_data.Reset(isolate, value.As<v8::Function>());
+        }
+        value = get("onEnd");
+        if (value->IsFunction()) {
+            state->on_end.Reset(isolate, value.As<v8::Function>());
+        }
+        value = get("onError");
+        if (value->IsFunction()) {
+            state->on_error.Reset(isolate, value.As<v8::Function>());
+        }
+    }
+
+    v8::Local<v8::Promise::Resolver> resolver = v8::Promise::Resolver::New(context).ToLocalChecked();
+    state->resolver.Reset(isolate, resolver);
+    bool streaming = !state->on_data.IsEmpty();
+
+    request.on_head = [state, streaming](const HttpResponseHead& head) {
+        state->head_received = true;
+        if (!streaming) {
+            state->head = head;
+            return;
+        }
+
+        v8::Isolate* isolate = state->isolate;
+        v8::Isolate::Scope isolate_scope(isolate);
+        v8::HandleScope handle_scope(isolate);
+        v8::Local<v8::Context> context = state->context.Get(isolate);
+        v8::Context::Scope context_scope(context);
+
+        state->resolver.Get(isolate)->Resolve(context, http_head_to_js(isolate, context, head)).Check();
+        state->resolver.Reset();
+        isolate->PerformMicrotaskCheckpoint();
+    };
+
+    request.on_body = [state, streaming](const char* data, size_t length) {
+        if (!streaming) {
+            state->body.append(data, length);
+            return;
+        }
+
+        v8::Isolate* isolate = state->isolate;
+        v8::Isolate::Scope isolate_scope(isolate);
+        v8::HandleScope handle_scope(isolate);
+        v8::Local<v8::Context> context = state->context.Get(isolate);
+        v8::Context::Scope context_scope(context);
+        v8::TryCatch try_catch(isolate);
+
+        v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate, length);
+        std::memcpy(buffer->Data(), data, length);
+        v8::Local<v8::Value> chunk = v8::Uint8Array::New(buffer, 0, length);
+        if (state->on_data.Get(isolate)->Call(context, v8::Undefined(isolate), 1, &chunk).IsEmpty()) {
+            report_callback_exception(isolate, try_catch, "net data callback");
+        }
+        isolate->PerformMicrotaskCheckpoint();
+    };
+
+    request.on_complete = [state](const std::string& error) {
+        v8::Isolate* isolate = state->isolate;
+        v8::Isolate::Scope isolate_scope(isolate);
+        v8::HandleScope handle_scope(isolate);
+        v8::Local<v8::Context> context = state->context.Get(isolate);
+        v8::Context::Scope context_scope(context);
+        v8::TryCatch try_catch(isolate);
+
+        v8::Local<v8::Value> exception;
+        if (!error.empty()) {
+            exception = v8::Exception::Error(v8::String::NewFromUtf8(isolate, error.c_str()).ToLocalChecked());
+        }
+
+        if (!state->resolver.IsEmpty()) {
+            v8::Local<v8::Promise::Resolver> resolver = state->resolver.Get(isolate);
+            if (!exception.IsEmpty()) {
+                resolver->Reject(context, exception).Check();
+            } else {
+                // Copy into isolate-allocated memory: external backing stores are
+                // rejected by sandboxed V8 and escape the MemoryManager budget
+                v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate, state->body.size());
+                std::memcpy(buffer->Data(), state->body.data(), state->body.size());
+                std::string().swap(state->body);
+
+                v8::Local<v8::Object> response = http_head_to_js(isolate, context, state->head);
+                response->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "body"),
+                                             v8::Uint8Array::New(buffer, 0, buffer->ByteLength())).Check();
+                resolver->Resolve(context, response).Check();
+            }
+        } else {
+            v8::Global<v8::Function>& listener = exception.IsEmpty() ? state->on_end : state->on_error;
+            if (!listener.IsEmpty()) {
+                int argc = exception.IsEmpty() ? 0 : 1;
+                if (listener.Get(isolate)->Call(context, v8::Undefined(isolate), argc, &exception).IsEmpty()) {
+                    report_callback_exception(isolate, try_catch, "net completion callback");
+                }
+            }
+        }
+
+        state->resolver.Reset();
+        state->on_data.Reset();
+        state->on_end.Reset();
+        state->on_error.Reset();
+        isolate->PerformMicrotaskCheckpoint();
+    };
+
+    HttpClient::RequestId request_id = bridge->http_client_->send(std::move(request));
+    // Detached first: the cancelled request still completes, with an error
+    bridge->track_request_work([bridge, state, request_id] {
+        state->resolver.Reset();
+        state->on_data.Reset();
+        state->on_end.Reset();
+        state->on_error.Reset();
+        if (bridge->http_client_) {
+            bridge->http_client_->cancel(request_id);
+        }
+    });
+    args.GetReturnValue().Set(resolver->GetPromise());
+}
+
+// download(url, path[, options]) -> Promise<{path, bytes, status, resumed}>
+// The body is streamed to disk through a few reused buffers and renamed into
+// place once complete. Options: headers, timeout (ms, whole transfer; 0 for
+// none), resume (default true) and onProgress({bytes, total, bytesPerSecond})
+void StellarObjectBridge::js_net_download(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    StellarObjectBridge* bridge = from_isolate(isolate);
+
+    if (!bridge->http_client_ || !bridge->event_loop_) {
+        bridge->throw_js_error("Network access is not available");
+        return;
+    }
+    if (args.Length() < 2 || !args[0]->IsString() || !args[1]->IsString()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, "URL and destination path required").ToLocalChecked()));
+        return;
+    }
+
+    HttpDownload::Options options;
+    std::string error;
+    if (!HttpUrl::parse(*v8::String::Utf8Value(isolate, args[0]), options.url, error)) {
+        bridge->throw_js_error(error);
+        return;
+    }
+    options.path = *v8::String::Utf8Value(isolate, args[1]);
+
+    struct DownloadState {
+        v8::Isolate* isolate;
+        v8::Global<v8::Context> context;
+        v8::Global<v8::Promise::Resolver> resolver;
+        v8::Global<v8::Function> on_progress;
+        std::string path;
+    };
+    auto state = std::make_shared<DownloadState>();
+    state->isolate = isolate;
+    state->context.Reset(isolate, context);
+    state->path = options.path;
+
+    if (args.Length() > 2 && args[2]->IsObject()) {
+        v8::Local<v8::Object> js_options = args[2].As<v8::Object>();
+        auto get = [&](const char* key) {
+            v8::Local<v8::Value> value;
+            if (!js_options->Get(context, v8::String::NewFromUtf8(isolate, key).ToLocalChecked()).ToLocal(&value)) {
+                return v8::Local<v8::Value>(v8::Undefined(isolate));
+            }
+            return value;
+        };
+
+        v8::Local<v8::Value> value = get("headers");
+        v8::Local<v8::Array> keys;
+        if (value->IsObject() && value.As<v8::Object>()->GetOwnPropertyNames(context).ToLocal(&keys)) {
+            v8::Local<v8::Object> headers = value.As<v8::Object>();
+            for (uint32_t i = 0; i < keys->Length(); ++i) {
+                v8::Local<v8::Value> key, entry;
+                if (keys->Get(context, i).ToLocal(&key) && headers->Get(context, key).ToLocal(&entry)) {
+                    options.headers.emplace_back(*v8::String::Utf8Value(isolate, key),
+                                                 *v8::String::Utf8Value(isolate, entry));
+                }
+            }
+        }
+        value = get("timeout");
+        if (value->IsNumber()) {
+            options.timeout_ms = static_cast<uint64_t>(std::max(0.0, value.As<v8::Number>()->Value()));
+        }
+        value = get("resume");
+        if (!value->IsUndefined()) {
+            options.resume = value->BooleanValue(isolate);
+        }
+        value = get("onProgress");
+        if (value->IsFunction()) {
+            state->on_progress.Reset(isolate, value.As<v8::Function>());
+        }
+    }
+
+    v8::Local<v8::Promise::Resolver> resolver = v8::Promise::Resolver::New(context).ToLocalChecked();
+    state->resolver.Reset(isolate, resolver);
+
+    HttpDownload::ProgressCallback on_progress;
+    if (!state->on_progress.IsEmpty()) {
+        on_progress = [state](const HttpDownload::Progress& progress) {
+            if (state->on_progress.IsEmpty()) {
+                return;
+            }
+            v8::Isolate* isolate = state->isolate;
+            v8::Isolate::Scope isolate_scope(isolate);
+            v8::HandleScope handle_scope(isolate);
+            v8::Local<v8::Context> context = state->context.Get(isolate);
+            v8::Context::Scope context_scope(context);
+            v8::TryCatch try_catch(isolate);
+
+            v8::Local<v8::Object> js_progress = v8::Object::New(isolate);
+            auto set = [&](const char* key, double value) {
+                js_progress->CreateDataProperty(context, v8::String::NewFromUtf8(isolate, key).ToLocalChecked(),
+                                                v8::Number::New(isolate, value)).Check();
+            };
+            set("bytes", static_cast<double>(progress.bytes));
+            set("total", static_cast<double>(progress.total));
+            set("bytesPerSecond", progress.bytes_per_second);
+
+            v8::Local<v8::Value> argv[] = {js_progress};
+            if (state->on_progress.Get(isolate)->Call(context, v8::Undefined(isolate), 1, argv).IsEmpty()) {
+                report_callback_exception(isolate, try_catch, "download progress callback");
+            }
+            isolate->PerformMicrotaskCheckpoint();
+        };
+    }
+
+    auto on_complete = [state](const std::string& error, const HttpDownload::Result& result) {
+        if (state->resolver.IsEmpty()) {
+            return;
+        }
+        v8::Isolate* isolate = state->isolate;
+        v8::Isolate::Scope isolate_scope(isolate);
+        v8::HandleScope handle_scope(isolate);
+        v8::Local<v8::Context> context = state->context.Get(isolate);
+        v8::Context::Scope context_scope(context);
+
+        v8::Local<v8::Promise::Resolver> resolver = state->resolver.Get(isolate);
+        if (!error.empty()) {
+            resolver->Reject(context, v8::Exception::Error(
+                v8::String::NewFromUtf8(isolate, error.c_str()).ToLocalChecked())).Check();
+        } else {
+            v8::Local<v8::Object> js_result = v8::Object::New(isolate);
+            auto set = [&](const char* key, v8::Local<v8::Value> value) {
+                js_result->CreateDataProperty(context, v8::String::NewFromUtf8(isolate, key).ToLocalChecked(), value).Check();
+            };
+            set("path", v8::String::NewFromUtf8(isolate, state->path.c_str()).ToLocalChecked());
+            set("bytes", v8::Number::New(isolate, static_cast<double>(result.bytes)));
+            set("status", v8::Integer::New(isolate, result.status));
+            set("resumed", v8::Boolean::New(isolate, result.resumed));
+            resolver->Resolve(context, js_result).Check();
+        }
+
+        state->resolver.Reset();
+        state->on_progress.Reset();
+        isolate->PerformMicrotaskCheckpoint();
+    };
+
+    int status = HttpDownload::start(bridge->event_loop_, bridge->http_client_, std::move(options),
+                                     std::move(on_progress), std::move(on_complete));
+    if (status != 0) {
+        std::string message = "Cannot write " + state->path + ".part: " + uv_strerror(status);
+        resolver->Reject(context, v8::Exception::Error(
+            v8::String::NewFromUtf8(isolate, message.c_str()).ToLocalChecked())).Check();
+    } else {
+        // The transfer only touches its own files, so it may finish on disk
+        bridge->track_request_work([state] {
+            state->resolver.Reset();
+            state->on_progress.Reset();
+        });
+    }
+
+    args.GetReturnValue().Set(resolver->GetPromise());
+}
+
+// nexus.parallel.map(items, fn[, { minPartitionSize }])
+// Splits items across the isolate pool; fn is recompiled from its source in
+// each isolate, so it must be self-contained (no captured variables)
+void StellarObjectBridge::js_parallel_map(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+    if (args.Length() < 2 || !args[0]->IsArray() || !args[1]->IsFunction()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, "Array and mapping function required").ToLocalChecked()));
+        return;
+    }
+
+    v8::Local<v8::Array> items = args[0].As<v8::Array>();
+    v8::Local<v8::Function> function = args[1].As<v8::Function>();
+    const uint32_t length = items->Length();
+
+    uint32_t min_partition_size = 64;
+    if (args.Length() > 2 && args[2]->IsObject()) {
+        v8::Local<v8::Value> option;
+        if (args[2].As<v8::Object>()->Get(context,
+                v8::String::NewFromUtf8(isolate, "minPartitionSize").ToLocalChecked()).ToLocal(&option) &&
+            option->IsUint32() && option.As<v8::Uint32>()->Value() > 0) {
+            min_partition_size = option.As<v8::Uint32>()->Value();
+        }
+    }
+
+    std::vector<v8::Local<v8::Value>> elements;
+    elements.reserve(length);
+    for (uint32_t i = 0; i < length; ++i) {
+        v8::Local<v8::Value> element;
+        if (!items->Get(context, i).ToLocal(&element)) {
+            return;
+        }
+        elements.push_back(element);
+    }
+
+    StellarObjectBridge* bridge = from_isolate(isolate);
+    IsolatePool* pool = bridge ? bridge->isolate_pool_ : nullptr;
+    size_t partition_count = pool ? std::min<size_t>(pool->size(), length / min_partition_size) : 0;
+
+    // Small inputs (or no pool) run inline, where serialization would cost
+    // more than the parallelism saves
+    if (partition_count < 2) {
+        std::vector<v8::Local<v8::Value>> mapped;
+        mapped.reserve(length);
+        for (uint32_t i = 0; i < length; ++i) {
+            v8::Local<v8::Value> call_args[] = {elements[i], v8::Integer::NewFromUnsigned(isolate, i)};
+            v8::Local<v8::Value> result;
+            if (!function->Call(context, v8::Undefined(isolate), 2, call_args).ToLocal(&result)) {
+                return;
+            }
+            mapped.push_back(result);
+        }
+        args.GetReturnValue().Set(v8::Array::New(isolate, mapped.data(), mapped.size()));
+        return;
+    }
+
+    // Serialize each partition into a transferable buffer
+    std::vector<TransferBuffer> partitions;
+    std::vector<uint32_t> offsets;
+    partitions.reserve(partition_count);
+    offsets.reserve(partition_count);
+    const size_t partition_size = (length + partition_count - 1) / partition_count;
+    for (size_t start = 0; start < length; start += partition_size) {
+        size_t count = std::min<size_t>(partition_size, length - start);
+        TransferBuffer partition = TransferBuffer::serialize(
+            context, v8::Array::New(isolate, elements.data() + start, count)
+        );
+        if (!partition.data) {
+            return;  // DataCloneError already thrown
+        }
+        partitions.push_back(std::move(partition));
+        offsets.push_back(static_cast<uint32_t>(start));
+    }
+
+    v8::String::Utf8Value function_source(isolate, function->FunctionProtoToString(context).ToLocalChecked());
+
+    std::vector<TransferBuffer> results;
+    try {
+        results = pool->map_partitions(std::string(*function_source, function_source.length()),
+                                       std::move(partitions), offsets);
+    } catch (const std::exception& e) {
+        isolate->ThrowException(v8::Exception::Error(
+            v8::String::NewFromUtf8(isolate, e.what()).ToLocalChecked()));
+        return;
+    }
+
+    // Stitch the partition results back together in order
+    std::vector<v8::Local<v8::Value>> mapped;
+    mapped.reserve(length);
+    for (const auto& result : results) {
+        v8::Local<v8::Value> partition_value;
+        if (!result.deserialize(context).ToLocal(&partition_value) || !partition_value->IsArray()) {
+            return;
+        }
+        v8::Local<v8::Array> partition = partition_value.As<v8::Array>();
+        for (uint32_t i = 0; i < partition->Length(); ++i) {
+            mapped.push_back(partition->Get(context, i).ToLocalChecked());
+        }
+    }
+
+    args.GetReturnValue().Set(v8::Array::New(isolate, mapped.data(), mapped.size()));
+}
+
+v8::Local<v8::Function> StellarObjectBridge::create_js_function(const char* name, v8::FunctionCallback callback) {
+    return v8::Function::New(isolate_->GetCurrentContext(), callback).ToLocalChecked();
+}
+
+v8::Local<v8::Function> StellarObjectBridge::create_fast_js_function(const char* name, v8::FunctionCallback callback,
+                                                                     const v8::CFunction* fast_callback) {
+    v8::Local<v8::FunctionTemplate> function_template = v8::FunctionTemplate::New(
+        isolate_, callback, v8::Local<v8::Value>(), v8::Local<v8::Signature>(), 0,
+        v8::ConstructorBehavior::kThrow, v8::SideEffectType::kHasSideEffect, fast_callback
+    );
+    // Named, so profiles of hot loops show which binding the time went to
+    function_template->SetClassName(v8::String::NewFromUtf8(isolate_, name).ToLocalChecked());
+    return function_template->GetFunction(isolate_->GetCurrentContext()).ToLocalChecked();
+}
+
+void StellarObjectBridge::setup_default_type_converters() {
+    // Setup default type converters for common types
+}
+
+TypeId StellarObjectBridge::register_custom_type(const std::string& type_name,
+                                                 std::function<v8::Local<v8::Value>(const NexusObject&)> to_js,
+                                                 std::function<NexusObject(v8::Local<v8::Value>)> from_js) {
+    TypeId type_id = intern_type(type_name);
+    if (type_id >= type_converters_.size()) {
+        type_converters_.resize(type_id + 1);
+    }
+    type_converters_[type_id] = {std::move(to_js), std::move(from_js)};
+    return type_id;
+}
+
+void StellarObjectBridge::throw_js_error(const std::string& message) {
+    isolate_->ThrowException(v8::Exception::Error(
+        v8::String::NewFromUtf8(isolate_, message.c_str()).ToLocalChecked()));
+}
+
+NexusObject StellarObjectBridge::create_error_object(const std::string& message) {
+    NexusObject error_obj;
+    error_obj.metadata.type_id = TypeIds::Error;
+    error_obj.value = message;
+    return error_obj;
+}
+
+ObjectId StellarObjectBridge::register_native_object(std::shared_ptr<void> native_obj) {
+    return object_registry_.insert(std::move(native_obj));
+}
+
+ObjectId StellarObjectBridge::register_native_object(v8::Local<v8::Object> owner, std::shared_ptr<void> native_obj) {
+    ObjectId id = object_registry_.insert(std::move(native_obj));
+    if (id == 0) {
+        return 0;
+    }
+    auto weak_owner = std::make_unique<WeakOwner>();
+    weak_owner->bridge = this;
+    weak_owner->id = id;
+    weak_owner->handle.Reset(isolate_, owner);
+    weak_owner->handle.SetWeak(weak_owner.get(), on_owner_collected, v8::WeakCallbackType::kParameter);
+    weak_owners_[id] = std::move(weak_owner);
+    return id;
+}
+
+void StellarObjectBridge::unregister_native_object(ObjectId id) {
+    object_registry_.erase(id);
+    weak_owners_.erase(id);
+}
+
+std::shared_ptr<void> StellarObjectBridge::get_native_object(ObjectId id) {
+    return object_registry_.get(id);
+}
+
+// First-pass weak callback: only resets the handle and frees native state
+void StellarObjectBridge::on_owner_collected(const v8::WeakCallbackInfo<WeakOwner>& info) {
+    WeakOwner* weak_owner = info.GetParameter();
+    StellarObjectBridge* bridge = weak_owner->bridge;
+    ObjectId id = weak_owner->id;
+    weak_owner->handle.Reset();
+    bridge->object_registry_.erase(id);
+    bridge->weak_owners_.erase(id);
+}
+
+v8::MaybeLocal<v8::Object> StellarObjectBridge::wrap_table(std::shared_ptr<NexusTable> table) {
+    v8::EscapableHandleScope handle_scope(isolate_);
+    v8::Local<v8::Context> context = isolate_->GetCurrentContext();
+
+    if (table_template_.IsEmpty()) {
+        v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate_);
+        tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate_, "NativeTable"));
+        tmpl->InstanceTemplate()->SetInternalFieldCount(kTableColumnCacheField + 1);
+        v8::Local<v8::Signature> signature = v8::Signature::New(isolate_, tmpl);
+        auto add_method = [&](const char* name, v8::FunctionCallback callback) {
+            tmpl->PrototypeTemplate()->Set(isolate_, name,
+                v8::FunctionTemplate::New(isolate_, callback, v8::Local<v8::Value>(), signature));
+        };
+        add_method("column", js_table_column);
+        add_method("get", js_table_get);
+        add_method("filter", js_table_filter);
+        add_method("sortBy", js_table_sort_by);
+        add_method("select", js_table_select);
+        add_method("take", js_table_take);
+        table_template_.Reset(isolate_, tmpl);
+    }
+
+    v8::Local<v8::Function> constructor;
+    v8::Local<v8::Object> object;
+    if (!table_template_.Get(isolate_)->GetFunction(context).ToLocal(&constructor) ||
+        !constructor->NewInstance(context).ToLocal(&object)) {
+        return {};
+    }
+
+    double rows = static_cast<double>(table->rows());
+    std::vector<v8::Local<v8::Value>> names;
+    for (const NexusTable::Column& column : table->columns()) {
+        names.push_back(v8::String::NewFromUtf8(isolate_, column.name.c_str()).ToLocalChecked());
+    }
+
+    ObjectId id = register_native_object(object, std::move(table));
+    if (id == 0) {
+        throw_js_error("Too many live native objects");
+        return {};
+    }
+    object->SetInternalField(kTableIdField, v8::BigInt::NewFromUnsigned(isolate_, id));
+    object->SetInternalField(kTableColumnCacheField,
+                             v8::Object::New(isolate_, v8::Null(isolate_), nullptr, nullptr, 0));
+    object->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate_, "length"),
+                               v8::Number::New(isolate_, rows)).Check();
+    object->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate_, "columns"),
+                               v8::Array::New(isolate_, names.data(), names.size())).Check();
+    return handle_scope.Escape(object);
+}
+
+std::shared_ptr<NexusTable> StellarObjectBridge::unwrap_table(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    StellarObjectBridge* bridge = from_isolate(args.GetIsolate());
+    v8::Local<v8::Value> id = args.This()->GetInternalField(kTableIdField).As<v8::Value>();
+    std::shared_ptr<NexusTable> table;
+    if (id->IsBigInt()) {
+        table = std::static_pointer_cast<NexusTable>(bridge->get_native_object(id.As<v8::BigInt>()->Uint64Value()));
+    }
+    if (!table) {
+        bridge->throw_js_error("Table has been released");
+    }
+    return table;
+}
+
+void StellarObjectBridge::return_table(const v8::FunctionCallbackInfo<v8::Value>& args,
+                                       std::shared_ptr<NexusTable> table) {
+    v8::Local<v8::Object> result;
+    if (from_isolate(args.GetIsolate())->wrap_table(std::move(table)).ToLocal(&result)) {
+        args.GetReturnValue().Set(result);
+    }
+}
+
+// table.column(name): Float64Array view or array of strings, cached per table
+void StellarObjectBridge::js_table_column(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    std::shared_ptr<NexusTable> table = unwrap_table(args);
+    if (!table) {
+        return;
+    }
+    if (args.Length() < 1 || !args[0]->IsString()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Column name required")));
+        return;
+    }
+
+    // Converted string columns are kept, frozen, since every caller gets the
+    // same array; a numeric column is one memcpy, so each call gets its own
+    // Float64Array and writes to it stay private
+    v8::Local<v8::Object> cache = args.This()->GetInternalField(kTableColumnCacheField).As<v8::Value>().As<v8::Object>();
+    v8::Local<v8::Value> values;
+    if (cache->Get(context, args[0]).ToLocal(&values) && !values->IsUndefined()) {
+        args.GetReturnValue().Set(values);
+        return;
+    }
+
+    std::string name = *v8::String::Utf8Value(isolate, args[0]);
+    const NexusTable::Column* column = table->column(name);
+    if (!column) {
+        from_isolate(isolate)->throw_js_error("Unknown column: " + name);
+        return;
+    }
+    values = table_column_to_js(isolate, table->rows(), *column);
+    if (column->kind == NexusTable::ColumnKind::String) {
+        values.As<v8::Object>()->SetIntegrityLevel(context, v8::IntegrityLevel::kFrozen).Check();
+        cache->CreateDataProperty(context, args[0].As<v8::String>(), values).Check();
+    }
+    args.GetReturnValue().Set(values);
+}
+
+// table.get(row, name): one cell, without materializing the column
+void StellarObjectBridge::js_table_get(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    std::shared_ptr<NexusTable> table = unwrap_table(args);
+    if (!table) {
+        return;
+    }
+    if (args.Length() < 2 || !args[0]->IsUint32() || !args[1]->IsString()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Row index and column name required")));
+        return;
+    }
+    uint32_t row = args[0].As<v8::Uint32>()->Value();
+    const NexusTable::Column* column = table->column(*v8::String::Utf8Value(isolate, args[1]));
+    if (!column || row >= table->rows()) {
+        args.GetReturnValue().SetUndefined();
+        return;
+    }
+    args.GetReturnValue().Set(table_cell_to_js(isolate, *column, row));
+}
+
+// table.filter(column, op, value): numeric columns take a number and
+// ==, !=, <, <=, >, >=; string columns also take contains, startsWith,
+// endsWith and glob
+void StellarObjectBridge::js_table_filter(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    std::shared_ptr<NexusTable> table = unwrap_table(args);
+    if (!table) {
+        return;
+    }
+    if (args.Length() < 3 || !args[0]->IsString() || !args[1]->IsString()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "filter(column, op, value) required")));
+        return;
+    }
+
+    std::string name = *v8::String::Utf8Value(isolate, args[0]);
+    std::string op_text = *v8::String::Utf8Value(isolate, args[1]);
+    NexusTable::Op op;
+    if (!NexusTable::parse_op(op_text, op)) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, ("Unknown operator: " + op_text).c_str()).ToLocalChecked()));
+        return;
+    }
+    const NexusTable::Column* column = table->column(name);
+    if (!column) {
+        from_isolate(isolate)->throw_js_error("Unknown column: " + name);
+        return;
+    }
+
+    std::shared_ptr<NexusTable> result;
+    if (column->kind == NexusTable::ColumnKind::Number && args[2]->IsNumber()) {
+        result = table->filter(name, op, args[2].As<v8::Number>()->Value());
+    } else if (column->kind == NexusTable::ColumnKind::String && args[2]->IsString()) {
+        result = table->filter(name, op, *v8::String::Utf8Value(isolate, args[2]));
+    }
+    if (!result) {
+        isolate->ThrowException(v8::Exception::TypeError(v8::String::NewFromUtf8(isolate,
+            ("Cannot compare column '" + name + "' with '" + op_text + "' and this value").c_str()).ToLocalChecked()));
+        return;
+    }
+    return_table(args, std::move(result));
+}
+
+// table.sortBy(column[, descending]): stable
+void StellarObjectBridge::js_table_sort_by(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    std::shared_ptr<NexusTable> table = unwrap_table(args);
+    if (!table) {
+        return;
+    }
+    if (args.Length() < 1 || !args[0]->IsString()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Column name required")));
+        return;
+    }
+    std::string name = *v8::String::Utf8Value(isolate, args[0]);
+    std::shared_ptr<NexusTable> result = table->sort_by(name, args.Length() > 1 && args[1]->BooleanValue(isolate));
+    if (!result) {
+        from_isolate(isolate)->throw_js_error("Unknown column: " + name);
+        return;
+    }
+    return_table(args, std::move(result));
+}
+
+// table.select(...names) or table.select([names])
+void StellarObjectBridge::js_table_select(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    std::shared_ptr<NexusTable> table = unwrap_table(args);
+    if (!table) {
+        return;
+    }
+
+    std::vector<std::string> names;
+    if (args.Length() == 1 && args[0]->IsArray()) {
+        v8::Local<v8::Array> list = args[0].As<v8::Array>();
+        for (uint32_t i = 0; i < list->Length(); ++i) {
+            v8::Local<v8::Value> name;
+            if (!list->Get(context, i).ToLocal(&name)) {
+                return;
+            }
+            names.emplace_back(*v8::String::Utf8Value(isolate, name));
+        }
+    } else {
+        for (int i = 0; i < args.Length(); ++i) {
+            names.emplace_back(*v8::String::Utf8Value(isolate, args[i]));
+        }
+    }
+
+    std::shared_ptr<NexusTable> result = table->select(names);
+    if (!result) {
+        from_isolate(isolate)->throw_js_error("Unknown column in select()");
+        return;
+    }
+    return_table(args, std::move(result));
+}
+
+// table.take(indices): rows by index (Uint32Array or array), in that order
+void StellarObjectBridge::js_table_take(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    std::shared_ptr<NexusTable> table = unwrap_table(args);
+    if (!table) {
+        return;
+    }
+
+    std::vector<uint32_t> indices;
+    if (args.Length() > 0 && args[0]->IsUint32Array()) {
+        v8::Local<v8::Uint32Array> list = args[0].As<v8::Uint32Array>();
+        indices.resize(list->Length());
+        list->CopyContents(indices.data(), indices.size() * sizeof(uint32_t));
+    } else if (args.Length() > 0 && args[0]->IsArray()) {
+        v8::Local<v8::Array> list = args[0].As<v8::Array>();
+        indices.reserve(list->Length());
+        for (uint32_t i = 0; i < list->Length(); ++i) {
+            v8::Local<v8::Value> index;
+            if (!list->Get(context, i).ToLocal(&index)) {
+                return;
+            }
+            if (!index->IsUint32()) {
+                indices.push_back(UINT32_MAX);      // Rejected below as out of range
+                break;
+            }
+            indices.push_back(index.As<v8::Uint32>()->Value());
+        }
+    } else {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Array of row indices required")));
+        return;
+    }
+
+    std::shared_ptr<NexusTable> result = table->take(indices);
+    if (!result) {
+        isolate->ThrowException(v8::Exception::RangeError(
+            v8::String::NewFromUtf8Literal(isolate, "Row index out of range")));
+        return;
+    }
+    return_table(args, std::move(result));
+}
+
+// file.watch(callback[, options]) on a wrapper whose `path` property names the file
+void JSFileObject::watch(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+    v8::Local<v8::Value> path;
+    if (!args.This()->Get(context, v8::String::NewFromUtf8Literal(isolate, "path")).ToLocal(&path) ||
+        !path->IsString() || args.Length() < 1 || !args[0]->IsFunction()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, "Callback required").ToLocalChecked()));
+        return;
+    }
+
+    v8::String::Utf8Value file_path(isolate, path);
+    v8::Local<v8::Object> handle;
+    if (StellarObjectBridge::from_isolate(isolate)->watch_path(
+            *file_path, args[0].As<v8::Function>(), watch_options_from_js(isolate, args[1])).ToLocal(&handle)) {
+        args.GetReturnValue().Set(handle);
+    }
 }
 
-} // namespace Nexus
\ No newline at end of file
+} // namespace Nexus
@@ -0,0 +1,93 @@
+#include "thread_pool.h"
+
+namespace Nexus {
+
+ThreadPool::ThreadPool(size_t num_threads) {
+    size_t count = num_threads > 0 ? num_threads : 1;
+    threads_.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        threads_.emplace_back(&ThreadPool::worker_thread, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    shutdown();
+}
+
+size_t ThreadPool::get_queue_size() const {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return tasks_.size();
+}
+
+void ThreadPool::worker_thread() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            condition_.wait(lock, [this]() { return shutdown_.load() || restarting_ || !tasks_.empty(); });
+            // Queued tasks still run after shutdown(); a resize leaves them
+            // for the replacement threads
+            if (restarting_ || tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop();
+            ++active_tasks_;
+        }
+
+        // submit() wraps every task in a packaged_task, so exceptions land
+        // in its future rather than here
+        task();
+        --active_tasks_;
+    }
+}
+
+void ThreadPool::resize(size_t new_size) {
+    if (shutdown_.load()) {
+        return;
+    }
+    size_t count = new_size > 0 ? new_size : 1;
+
+    // Workers finish their current task and exit; queued tasks stay queued
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        restarting_ = true;
+    }
+    condition_.notify_all();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads_.clear();
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        restarting_ = false;
+    }
+    threads_.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        threads_.emplace_back(&ThreadPool::worker_thread, this);
+    }
+}
+
+void ThreadPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (shutdown_.exchange(true)) {
+            return;
+        }
+    }
+    condition_.notify_all();
+
+    for (auto& thread : threads_) {
+        // A task that shuts the pool down cannot wait for its own thread
+        if (thread.get_id() == std::this_thread::get_id()) {
+            thread.detach();
+        } else if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+} // namespace Nexus
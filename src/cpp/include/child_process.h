@@ -0,0 +1,86 @@
+#pragma once
+
+#include <uv.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Nexus {
+
+/**
+ * ChildProcess - Subprocess driven by the libuv loop
+ * Output is streamed through a callback as it arrives; the exit callback
+ * fires once the process has exited and both pipes are drained. Instances
+ * own themselves and are freed after the exit callback.
+ */
+class ChildProcess {
+public:
+    enum class Stream { Stdout, Stderr };
+
+    struct Options {
+        std::vector<std::string> argv;
+        std::string cwd;                    // Empty: inherit
+        std::vector<std::string> env;       // KEY=VALUE; empty: inherit
+        uint64_t timeout_ms = 0;            // 0: no limit
+        uint64_t kill_grace_ms = 2000;      // SIGTERM -> SIGKILL after timeout
+        bool process_group = false;         // New session and process group: signals reach descendants
+    };
+
+    struct Result {
+        int64_t exit_status = 0;
+        int term_signal = 0;
+        bool timed_out = false;
+    };
+
+    using OutputCallback = std::function<void(Stream stream, const char* data, size_t length)>;
+    using ExitCallback = std::function<void(const Result& result)>;
+
+    // Returns 0, or a libuv error code if the process could not be started
+    // (no callbacks fire in that case). started, if given, receives the
+    // child, which stays valid until its exit callback runs
+    static int spawn(uv_loop_t* loop, const Options& options, OutputCallback on_output, ExitCallback on_exit,
+                     ChildProcess** started = nullptr);
+
+    // SIGTERM now and SIGKILL after kill_grace_ms, as when the timeout
+    // expires; the exit is still reported, as timed out. With
+    // Options::process_group the whole group is signalled, including
+    // background descendants left once the child itself has exited
+    void terminate();
+
+private:
+    struct Pipe {
+        uv_pipe_t handle;
+        bool open = false;
+        char buffer[64 * 1024];     // Reused for every read on this pipe
+    };
+
+    uv_process_t process_;
+    uv_timer_t timer_;
+    Pipe stdout_pipe_;
+    Pipe stderr_pipe_;
+
+    OutputCallback on_output_;
+    ExitCallback on_exit_;
+    Result result_;
+    bool exited_ = false;
+    uint64_t kill_grace_ms_ = 0;
+    bool process_group_ = false;
+    int open_handles_ = 0;          // Freed when the last handle closes
+
+    ChildProcess(OutputCallback on_output, ExitCallback on_exit);
+
+    Pipe& pipe_for(uv_handle_t* handle);
+    void stop_reading(Pipe& pipe);
+    void maybe_finish();
+    void close_all();
+    void signal(int signum);
+
+    static void on_alloc(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf);
+    static void on_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf);
+    static void on_process_exit(uv_process_t* process, int64_t exit_status, int term_signal);
+    static void on_timeout(uv_timer_t* timer);
+    static void on_close(uv_handle_t* handle);
+};
+
+} // namespace Nexus
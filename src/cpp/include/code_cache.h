@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Nexus {
+
+/**
+ * CodeCache - V8 code cache storage keyed by source hash
+ * Keeps serialized compilation results in memory and mirrors them to disk
+ * so repeated scripts skip parsing and compilation across sessions. Past
+ * max_memory_entries the least recently used entry leaves memory; its disk
+ * copy stays
+ */
+class CodeCache {
+public:
+    using Entry = std::shared_ptr<const std::vector<uint8_t>>;
+
+    explicit CodeCache(const std::string& cache_directory = default_cache_directory(),
+                       size_t max_memory_entries = 512);
+    ~CodeCache();
+
+    // Cache access
+    Entry lookup(uint64_t source_hash);
+    void store(uint64_t source_hash, std::vector<uint8_t> data);
+    void invalidate(uint64_t source_hash);
+    void clear();
+
+    // Statistics
+    uint64_t get_hits() const { return hits_.load(); }
+    uint64_t get_misses() const { return misses_.load(); }
+    uint64_t get_rejections() const { return rejections_.load(); }
+    void record_rejection() { rejections_.fetch_add(1); }
+
+    static uint64_t hash_source(std::string_view source);
+    static std::string default_cache_directory();
+
+private:
+    std::string cache_directory_;
+    const size_t max_memory_entries_;
+    bool persistent_ = false;
+
+    // Most recently used first
+    struct Slot {
+        Entry entry;
+        std::list<uint64_t>::iterator position;
+    };
+    std::mutex mutex_;
+    std::list<uint64_t> recency_;
+    std::unordered_map<uint64_t, Slot> entries_;
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> rejections_{0};
+
+    void insert_locked(uint64_t source_hash, Entry entry);
+
+    // Disk mirror
+    std::string entry_path(uint64_t source_hash) const;
+    Entry load_from_disk(uint64_t source_hash);
+    void write_to_disk(uint64_t source_hash, const std::vector<uint8_t>& data);
+};
+
+} // namespace Nexus
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "nexus_types.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Nexus {
+
+/**
+ * LatencyHistogram - HDR-style log-linear histogram of microseconds
+ * Values below 2^kSubBucketBits are counted exactly; above that every
+ * power of two is split into 2^(kSubBucketBits-1) equal buckets, so a
+ * reported value is within 1/32 of the recorded one. Single writer:
+ * record() uses relaxed loads and stores rather than locked
+ * read-modify-writes, and snapshot() may run concurrently on any thread.
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 6;
+    static constexpr unsigned kMaxValueBits = 36;       // ~19 hours; larger values are clamped
+    static constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+    static constexpr size_t kBuckets = kSubBuckets + (kMaxValueBits - kSubBucketBits) * (kSubBuckets / 2);
+
+    /** Snapshot - Plain counts, mergeable across histograms and shards */
+    struct Snapshot {
+        std::vector<uint64_t> counts;   // Empty until something is added
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t max = 0;
+
+        void merge(const Snapshot& other);
+        void subtract(const Snapshot& baseline);       // Counts since baseline was taken
+        uint64_t percentile(double quantile) const;    // Highest value equivalent to the rank
+        LatencySummary summary() const;
+    };
+
+    void record(uint64_t value);
+    void add_to(Snapshot& snapshot) const;
+
+    static size_t bucket_index(uint64_t value);
+    static uint64_t bucket_upper(size_t index);        // Highest value counted in the bucket
+
+private:
+    std::array<std::atomic<uint64_t>, kBuckets> counts_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+enum class CommandPhase : uint8_t { Parse, Security, Execute, Convert, Total };
+constexpr size_t kCommandPhases = 5;
+const char* command_phase_name(CommandPhase phase);
+
+/**
+ * CommandMetrics - Per-thread sharded command counters and latencies
+ * Each thread records into its own shard, so execute_command takes no lock
+ * and shares no cache line with other threads; readers aggregate the
+ * shards. Histograms are kept per command name and phase. The first
+ * kMaxCommands names get their own histograms, later ones share "other".
+ * Reset takes a baseline that later reads subtract, since the writers'
+ * counters are not read-modify-written.
+ */
+class CommandMetrics {
+public:
+    static constexpr size_t kMaxCommands = 128;
+
+    /** Sample - Timings of one command; phases that did not run stay unset */
+    struct Sample {
+        std::string_view command;
+        bool failed = false;
+        std::array<uint64_t, kCommandPhases> phase_us{};
+        uint8_t timed = 0;                  // Bit per CommandPhase
+
+        void set(CommandPhase phase, uint64_t us) {
+            phase_us[static_cast<size_t>(phase)] = us;
+            timed |= static_cast<uint8_t>(1u << static_cast<unsigned>(phase));
+        }
+    };
+
+    CommandMetrics();
+    ~CommandMetrics();
+
+    CommandMetrics(const CommandMetrics&) = delete;
+    CommandMetrics& operator=(const CommandMetrics&) = delete;
+
+    // Wait-free once this thread has seen the command name
+    void record(const Sample& sample);
+
+    // Fill commands_executed, commands_failed, total_execution_time_us,
+    // latency and command_latency
+    void collect(PerformanceMetrics& metrics) const;
+    void reset();
+
+private:
+    struct Histograms {
+        std::array<LatencyHistogram, kCommandPhases> phases;
+    };
+
+    struct NameHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+    };
+    using NameMap = std::unordered_map<std::string, uint32_t, NameHash, std::equal_to<>>;
+
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> failed{0};
+        std::array<std::atomic<Histograms*>, kMaxCommands + 1> commands{};   // By name id; last: "other"
+        NameMap names;                      // Owning thread's cache of name ids
+        Shard* next = nullptr;
+
+        ~Shard();
+    };
+
+    /** Totals - Shards summed, indexed [name id][phase] */
+    struct Totals {
+        uint64_t failed = 0;
+        std::vector<std::array<LatencyHistogram::Snapshot, kCommandPhases>> commands;
+    };
+
+    const uint64_t instance_;               // Tells registries apart in thread-local shard caches
+    std::atomic<Shard*> shards_{nullptr};
+
+    mutable std::mutex names_mutex_;
+    NameMap name_ids_;
+    std::vector<std::string> names_;
+
+    mutable std::mutex baseline_mutex_;
+    Totals baseline_;
+
+    Shard& local_shard();
+    uint32_t name_id(Shard& shard, std::string_view command);
+    Totals totals() const;
+};
+
+} // namespace Nexus
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "nexus_types.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Nexus {
+
+/**
+ * CommandTable - Thread-safe registry of native command handlers
+ * find() hands out a reference to the handler, so a command that is
+ * running keeps it (and whatever it captured, such as a loaded plugin)
+ * alive after it is removed or replaced.
+ *
+ * Lookups take no lock. Writers, serialized by a mutex, publish an
+ * immutable snapshot of weak references and bump a generation; each
+ * thread caches the last snapshot it read and refreshes it when the
+ * generation moves. The strong references live only in the writer's map,
+ * so a stale cache on an idle thread never keeps a removed handler alive.
+ */
+class CommandTable {
+public:
+    using Handler = std::shared_ptr<const CommandHandler>;
+    using Snapshot = std::unordered_map<std::string, std::weak_ptr<const CommandHandler>>;
+
+    CommandTable();
+    CommandTable(const CommandTable&) = delete;
+    CommandTable& operator=(const CommandTable&) = delete;
+
+    void set(const std::string& name, CommandHandler handler);
+    bool add(const std::string& name, CommandHandler handler);     // False if the name is taken
+    bool remove(const std::string& name);
+
+    Handler find(const std::string& name) const;
+    bool contains(const std::string& name) const;
+    std::vector<std::string> names() const;
+
+private:
+    const uint64_t table_id_;                       // Tells tables apart in the per-thread cache
+    std::unordered_map<std::string, Handler> handlers_;     // Guarded by mutex_
+    std::shared_ptr<const Snapshot> snapshot_;      // Guarded by mutex_
+    std::atomic<uint64_t> generation_{0};           // Bumped under mutex_ after snapshot_ changes
+
+    mutable std::mutex mutex_;
+
+    const Snapshot& current() const;
+    void publish_locked();
+};
+
+} // namespace Nexus
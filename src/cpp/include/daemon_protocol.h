@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Nexus {
+
+/**
+ * Daemon protocol - One command per connection on a unix stream socket
+ * The client sends a fixed header carrying its stdin, stdout and stderr
+ * as SCM_RIGHTS, then argv, cwd and environment as length-prefixed
+ * strings. The daemon runs the command with those descriptors as its
+ * stdio and answers with the exit status (int32). Both ends run on the
+ * same host, so integers are in native byte order.
+ */
+struct DaemonRequest {
+    std::vector<std::string> argv;          // Without the program name
+    std::string cwd;
+    std::vector<std::string> environment;   // "NAME=value"
+    int fds[3] = {-1, -1, -1};              // Owned by the receiver
+};
+
+constexpr uint32_t kDaemonMagic = 0x4e584431;                 // "NXD1"
+constexpr uint32_t kDaemonMaxPayload = 4u << 20;
+
+// $NEXUS_DAEMON_SOCKET, else $XDG_RUNTIME_DIR/nexus/daemon.sock, else
+// /tmp/nexus-<uid>/daemon.sock
+std::string default_daemon_socket();
+
+bool send_daemon_request(int socket, const DaemonRequest& request, std::string& error);
+// Closes every descriptor it received when it fails
+bool receive_daemon_request(int socket, DaemonRequest& request, std::string& error);
+void close_request_fds(DaemonRequest& request);
+
+bool send_daemon_status(int socket, int32_t status);
+bool receive_daemon_status(int socket, int32_t& status);
+
+} // namespace Nexus
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "daemon_protocol.h"
+#include <atomic>
+#include <string>
+
+namespace Nexus {
+
+class NexusKernel;
+
+/**
+ * DaemonServer - Serves commands from nexus_client over a unix socket
+ * Keeps one warm kernel for many short invocations. Requests run one at a
+ * time on the shell thread, inside the kernel's event loop: the client's
+ * descriptors are installed as stdin, stdout and stderr, and its working
+ * directory as the current one, for the duration of the command, and its
+ * environment is what proc.exec children and nexus.proc.env see. Async
+ * work a command leaves pending (timers, child processes, transfers,
+ * watches) is cancelled when it finishes, so none of it outlives the
+ * client's descriptors; proc.exec children get their own process group so
+ * cancelling one reaches everything it started. Only clients running as
+ * the daemon's user are served.
+ *
+ * Requests are serial and have no time limit: the receive timeout only
+ * covers reading the request, and a command that hangs holds up every
+ * client queued behind it until it returns or the daemon is restarted.
+ */
+class DaemonServer {
+public:
+    explicit DaemonServer(NexusKernel* kernel);
+    ~DaemonServer();
+
+    DaemonServer(const DaemonServer&) = delete;
+    DaemonServer& operator=(const DaemonServer&) = delete;
+
+    // Creates the socket's directory (0700) if needed and listens on path
+    bool start(const std::string& path, std::string& error);
+
+    // Serves requests until stop() or the kernel shuts down
+    void run();
+
+    // Async-signal-safe
+    void stop();
+
+    const std::string& path() const { return path_; }
+    uint64_t requests() const { return requests_.load(std::memory_order_relaxed); }
+
+private:
+    NexusKernel* kernel_;
+    std::string path_;
+    int listen_fd_ = -1;
+    int wake_fd_[2] = {-1, -1};
+    int epoll_fd_ = -1;                     // Readable when listen_fd_ or wake_fd_[0] is
+    int home_fd_ = -1;                      // Daemon's own working directory
+    std::atomic<bool> stopping_{false};
+    std::atomic<uint64_t> requests_{0};
+
+    void serve(int client);
+    int execute(const DaemonRequest& request);
+};
+
+} // namespace Nexus
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "nexus_table.h"
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Nexus {
+
+/**
+ * DirectoryWalker - Recursive directory scan with predicates applied natively
+ * Name and type predicates are checked against the dirent before any stat,
+ * so entries that cannot match cost neither a syscall nor a JS object; only
+ * candidates are stat'ed for size/mtime. Symlinks are reported as such and
+ * never followed.
+ */
+class DirectoryWalker {
+public:
+    // Type bits for Spec::type_mask
+    static constexpr uint32_t kFile = 1;
+    static constexpr uint32_t kDirectory = 2;
+    static constexpr uint32_t kSymlink = 4;
+    static constexpr uint32_t kOther = 8;
+
+    struct Range {
+        double min = -std::numeric_limits<double>::infinity();
+        double max = std::numeric_limits<double>::infinity();
+        bool min_inclusive = true;
+        bool max_inclusive = true;
+
+        // Narrow the range; conditions accumulate as a conjunction
+        void at_least(double value, bool inclusive);
+        void at_most(double value, bool inclusive);
+        bool contains(double value) const;
+    };
+
+    struct Spec {
+        std::vector<std::string> names;         // fnmatch globs on the entry name; all must match
+        std::vector<std::string> inames;        // Same, case-insensitive
+        bool filter_type = false;
+        uint32_t type_mask = 0;                 // With filter_type: any of these types
+        Range size;
+        Range mtime;                            // Milliseconds since the epoch
+        uint32_t min_depth = 1;                 // Children of the root are depth 1
+        uint32_t max_depth = UINT32_MAX;
+        size_t limit = 0;                       // 0: no limit
+    };
+
+    // "file", "directory", "symlink" or "other" -> type bit; 0 if unknown
+    static uint32_t type_bit(std::string_view name);
+
+    // Table {path, name, type, size, mode, mtime, depth} of matching entries.
+    // Returns nullptr with error set if the root cannot be opened;
+    // unreadable subdirectories are skipped.
+    static std::shared_ptr<NexusTable> walk(const std::string& root, const Spec& spec, std::string& error);
+};
+
+} // namespace Nexus
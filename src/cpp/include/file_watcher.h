@@ -0,0 +1,102 @@
+#pragma once
+
+#include <uv.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Nexus {
+
+enum class FileEventType {
+    Created,
+    Modified,
+    Deleted,
+    Overflow      // Kernel queue overflowed; subscribers should rescan
+};
+
+struct FileEvent {
+    FileEventType type;
+    std::string path;
+};
+
+/**
+ * FileWatcher - inotify-backed filesystem watcher driven by the libuv loop
+ * One inotify descriptor and watch table are shared by every subscription;
+ * bursts are coalesced per path and delivered after a debounce window.
+ * Not thread-safe: use from the thread running the event loop.
+ */
+class FileWatcher {
+public:
+    using SubscriptionId = uint64_t;
+    using Callback = std::function<void(const std::vector<FileEvent>&)>;
+
+    struct Options {
+        bool recursive = false;
+        uint32_t debounce_ms = 50;
+    };
+
+    explicit FileWatcher(uv_loop_t* loop);
+    ~FileWatcher();
+
+    bool initialize();
+    void shutdown();
+
+    // Returns 0 if the path cannot be watched
+    SubscriptionId subscribe(const std::string& path, const Options& options, Callback callback);
+    void unsubscribe(SubscriptionId id);
+
+    size_t watch_count() const { return watches_.size(); }
+    size_t subscription_count() const { return subscriptions_.size(); }
+
+private:
+    struct Watch {
+        std::string path;
+        std::vector<SubscriptionId> subscribers;
+    };
+
+    struct PendingEvent {
+        FileEventType type;
+        bool created_in_window;
+    };
+
+    struct Subscription {
+        std::string root;
+        Options options;
+        Callback callback;
+        std::vector<int> watch_descriptors;
+        std::unordered_map<std::string, PendingEvent> pending;
+        std::vector<std::string> pending_order;
+        uint64_t first_event_ms = 0;
+        uint64_t deadline_ms = 0;
+    };
+
+    uv_loop_t* loop_;
+    int inotify_fd_ = -1;
+    uv_poll_t* poll_handle_ = nullptr;      // Heap-allocated: freed by uv_close callbacks
+    uv_timer_t* debounce_timer_ = nullptr;
+    bool polling_ = false;
+
+    SubscriptionId next_subscription_id_ = 1;
+    std::unordered_map<int, Watch> watches_;
+    std::unordered_map<std::string, int> watch_by_path_;
+    std::unordered_map<SubscriptionId, Subscription> subscriptions_;
+
+    int add_watch(const std::string& path, SubscriptionId id);
+    void add_tree(const std::string& root, SubscriptionId id, bool report_entries);
+    void release_tree(const std::string& root, SubscriptionId id);
+    void release_watch(int wd, SubscriptionId id);
+    void forget_watch(int wd);
+
+    void update_polling();
+    void read_events();
+    void queue_event(SubscriptionId id, const std::string& path, FileEventType type);
+    void schedule_flush();
+    void flush_due();
+
+    static void on_readable(uv_poll_t* handle, int status, int events);
+    static void on_debounce_timer(uv_timer_t* handle);
+};
+
+} // namespace Nexus
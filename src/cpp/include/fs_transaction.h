@@ -0,0 +1,94 @@
+#pragma once
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Nexus {
+
+/**
+ * FsTransaction - Copy-on-write snapshots of the paths a transaction touches
+ * protect() captures a file or directory tree next to itself, as a hidden
+ * sibling: files are cloned with FICLONE where the filesystem supports
+ * reflinks (shared extents, no data copied) and copied with
+ * copy_file_range() elsewhere. Rollback swaps each snapshot back with
+ * renameat2(RENAME_EXCHANGE), so restoring a tree of any size is a rename;
+ * commit drops the snapshots. What was displaced is only renamed aside:
+ * collect_garbage() deletes it and may run on another thread.
+ *
+ * With hardlink_snapshots, files that cannot be cloned are hard-linked
+ * instead of copied. Such a snapshot shares its inode with the live file,
+ * so it is only preserved against replacement, deletion and renames (what
+ * package managers, git and build tools do), not in-place writes; writers
+ * in the shell call break_snapshot_link() first. Use from one thread,
+ * except for collect_garbage() and break_snapshot_link().
+ */
+class FsTransaction {
+public:
+    enum class State { Open, Committed, RolledBack };
+
+    struct Stats {
+        size_t paths = 0;           // protect() calls that captured something
+        size_t reflinked = 0;
+        size_t hardlinked = 0;
+        size_t copied = 0;          // Not cloned (nor linked, with hardlink_snapshots)
+        size_t directories = 0;
+        size_t symlinks = 0;
+        size_t skipped = 0;         // Sockets and devices are not captured
+    };
+
+    explicit FsTransaction(uint64_t id, bool hardlink_snapshots = false);
+    ~FsTransaction();               // Still open: committed
+
+    FsTransaction(const FsTransaction&) = delete;
+    FsTransaction& operator=(const FsTransaction&) = delete;
+
+    // Capture path as it is now. A path that does not exist is recorded as
+    // absent, so rollback removes whatever the transaction creates there.
+    // Paths inside an already protected tree are covered and ignored
+    bool protect(const std::string& path, std::string& error);
+
+    // Restore every protected path, most recently protected first. Keeps
+    // going past failures; error describes the first one
+    bool rollback(std::string& error);
+    void commit();
+
+    // Delete snapshots dropped by commit and trees displaced by rollback
+    void collect_garbage();
+
+    State state() const { return state_; }
+    const Stats& stats() const { return stats_; }
+    uint64_t id() const { return id_; }
+
+    // Before a file is rewritten in place: if its inode is shared with a
+    // snapshot, unlink it so the write creates a new inode. Returns true
+    // with the file's mode if it did
+    static bool break_snapshot_link(const std::string& path, mode_t& mode);
+
+private:
+    struct Entry {
+        std::string path;
+        std::string snapshot;       // Empty if the path did not exist
+    };
+
+    const uint64_t id_;
+    const bool hardlink_snapshots_;
+    State state_ = State::Open;
+    Stats stats_;
+    std::vector<Entry> entries_;
+    std::vector<std::pair<dev_t, ino_t>> linked_;       // Registered snapshot links
+    std::vector<std::string> garbage_;
+    std::vector<dev_t> no_reflink_devices_;             // FICLONE known to fail there
+
+    bool covered(const std::string& path) const;
+    std::string sibling(const std::string& path, const char* suffix) const;
+    bool capture(int src_dir, const char* src_name, int dst_dir, const char* dst_name,
+                 const struct stat& st, std::string& error);
+    bool capture_file(int src_dir, const char* src_name, int dst_dir, const char* dst_name,
+                      const struct stat& st, std::string& error);
+    void release_links();
+};
+
+} // namespace Nexus
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <uv.h>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Nexus {
+
+using HttpHeaders = std::vector<std::pair<std::string, std::string>>;
+
+struct HttpUrl {
+    std::string scheme;
+    std::string host;
+    uint16_t port = 80;
+    std::string target;     // Path and query
+
+    // Only plain http:// URLs without whitespace or control characters
+    // are accepted
+    static bool parse(const std::string& url, HttpUrl& out, std::string& error);
+    std::string origin() const;
+};
+
+struct HttpResponseHead {
+    int status = 0;
+    std::string reason;
+    int version_minor = 1;
+    HttpHeaders headers;    // Names lowercased, in arrival order
+
+    const std::string* header(const std::string& lowercase_name) const;
+};
+
+/**
+ * HttpClient - HTTP/1.1 client on the libuv loop
+ * Connections are pooled per origin and kept alive between requests;
+ * idempotent requests are pipelined on busy connections and retried once if
+ * a reused connection turns out to be closed. Response bodies (length,
+ * chunked or close-delimited) are streamed to the caller as they arrive.
+ * Not thread-safe: use from the thread running the event loop.
+ */
+class HttpClient {
+public:
+    using RequestId = uint64_t;
+
+    struct Request {
+        std::string method = "GET";
+        HttpUrl url;
+        HttpHeaders headers;
+        std::string body;
+        uint64_t timeout_ms = 30000;
+
+        std::function<void(const HttpResponseHead& head)> on_head;
+        std::function<void(const char* data, size_t length)> on_body;
+        // Empty error on success; always the last callback for a request
+        std::function<void(const std::string& error)> on_complete;
+    };
+
+    struct Options {
+        size_t max_connections_per_host = 6;
+        size_t max_pipeline_depth = 4;
+        uint64_t idle_timeout_ms = 30000;
+    };
+
+    explicit HttpClient(uv_loop_t* loop);
+    HttpClient(uv_loop_t* loop, const Options& options);
+    ~HttpClient();
+
+    // Returns 0, and never calls back, once shut down or when the method
+    // is not valid_method() or the target holds whitespace or control
+    // characters (HttpUrl::parse never produces such a target)
+    RequestId send(Request request);
+    void cancel(RequestId id);
+
+    // Whether method is an RFC 9110 token, as a request line requires
+    static bool valid_method(const std::string& method);
+
+    // Backpressure for slow body consumers: stops reading the connection
+    // carrying the request (and anything pipelined on it) until resumed.
+    // Data already received may still be delivered after pause()
+    void pause(RequestId id);
+    void resume(RequestId id);
+
+    // Drops every request without invoking its callbacks
+    void shutdown();
+
+    // Statistics
+    uint64_t get_connections_opened() const { return connections_opened_; }
+    uint64_t get_requests_sent() const { return requests_sent_; }
+    uint64_t get_connections_reused() const { return connections_reused_; }
+
+private:
+    struct Exchange;
+    struct Connection;
+    struct HostPool;
+
+    uv_loop_t* loop_;
+    Options options_;
+    RequestId next_request_id_ = 1;
+    bool shut_down_ = false;
+
+    std::unordered_map<std::string, std::shared_ptr<HostPool>> pools_;
+    std::unordered_map<RequestId, std::shared_ptr<Exchange>> exchanges_;
+
+    uint64_t connections_opened_ = 0;
+    uint64_t requests_sent_ = 0;
+    uint64_t connections_reused_ = 0;
+
+    void dispatch(HostPool& pool);
+    void resolve(const std::shared_ptr<HostPool>& pool);
+    Connection* open_connection(HostPool& pool);
+    void write_request(Connection& connection, const std::shared_ptr<Exchange>& exchange);
+
+    void consume(Connection& connection, const char* data, size_t length);
+    bool parse_head(Connection& connection);
+    void complete_front(Connection& connection);
+    void connection_failed(Connection& connection, const std::string& error);
+    void close_connection(Connection& connection);
+    void make_idle(Connection& connection);
+
+    void finish(const std::shared_ptr<Exchange>& exchange, const std::string& error);
+    void abort(const std::shared_ptr<Exchange>& exchange, const std::string& error);
+    void fail_pool(HostPool& pool, const std::string& error);
+
+    static void on_resolved(uv_getaddrinfo_t* req, int status, struct addrinfo* result);
+    static void on_connect(uv_connect_t* req, int status);
+    static void on_alloc(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf);
+    static void on_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf);
+    static void on_write(uv_write_t* req, int status);
+    static void on_idle_timeout(uv_timer_t* timer);
+    static void on_request_timeout(uv_timer_t* timer);
+};
+
+} // namespace Nexus
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "http_client.h"
+#include <uv.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Nexus {
+
+/**
+ * HttpDownload - Streams an HTTP response body straight to disk
+ * The body is written to "<path>.part" through a small fixed set of reused
+ * buffers, pausing the socket while the disk falls behind, then synced and
+ * renamed over <path>. A leftover .part file is resumed with a Range request.
+ * Instances own themselves and are freed after the completion callback.
+ */
+class HttpDownload : public std::enable_shared_from_this<HttpDownload> {
+public:
+    struct Options {
+        HttpUrl url;
+        std::string path;
+        HttpHeaders headers;
+        uint64_t timeout_ms = 0;                // Whole transfer; 0: no limit
+        bool resume = true;                     // Continue an existing .part file
+        uint64_t progress_interval_ms = 200;
+    };
+
+    struct Progress {
+        uint64_t bytes = 0;                     // On disk, including resumed bytes
+        uint64_t total = 0;                     // 0 when the server sent no length
+        double bytes_per_second = 0;            // Average over this transfer
+    };
+
+    struct Result {
+        int status = 0;
+        uint64_t bytes = 0;
+        bool resumed = false;
+    };
+
+    using ProgressCallback = std::function<void(const Progress& progress)>;
+    using CompleteCallback = std::function<void(const std::string& error, const Result& result)>;
+
+    // Returns 0, or a libuv error code if the .part file cannot be opened
+    // (no callbacks fire in that case)
+    static int start(uv_loop_t* loop, HttpClient* client, Options options,
+                     ProgressCallback on_progress, CompleteCallback on_complete);
+
+    ~HttpDownload();
+
+private:
+    static constexpr size_t kBufferSize = 256 * 1024;
+    static constexpr size_t kBufferCount = 4;
+
+    struct Buffer {
+        std::unique_ptr<char[]> data{new char[kBufferSize]};
+        size_t length = 0;
+    };
+
+    struct FsRequest {
+        uv_fs_t req;
+        std::shared_ptr<HttpDownload> download;
+    };
+
+    struct WriteRequest {
+        uv_fs_t req;
+        std::shared_ptr<HttpDownload> download;
+        Buffer* buffer;
+        size_t written = 0;
+        uint64_t offset;
+    };
+
+    uv_loop_t* loop_;
+    HttpClient* client_;
+    Options options_;
+    ProgressCallback on_progress_;
+    CompleteCallback on_complete_;
+    std::string part_path_;
+    int fd_ = -1;
+
+    HttpClient::RequestId request_id_ = 0;
+    std::vector<std::unique_ptr<Buffer>> buffers_;
+    std::vector<Buffer*> free_buffers_;
+    Buffer* filling_ = nullptr;
+    size_t pending_writes_ = 0;
+    bool paused_ = false;
+
+    uint64_t resume_offset_ = 0;            // Size of the .part file at request time
+    uint64_t write_offset_ = 0;             // Next file offset to submit
+    uint64_t written_ = 0;                  // Bytes confirmed on disk this transfer
+    uint64_t total_ = 0;
+    uint64_t started_ms_ = 0;
+    uint64_t last_progress_ms_ = 0;
+    Result result_;
+    std::string error_;
+    bool accepting_body_ = false;
+    bool restart_ = false;
+    bool response_done_ = false;
+    bool finishing_ = false;
+    int redirects_ = 0;
+    std::string redirect_;                  // Location to follow once the response ends
+
+    HttpDownload(uv_loop_t* loop, HttpClient* client, Options options,
+                 ProgressCallback on_progress, CompleteCallback on_complete);
+
+    void send_request();
+    void handle_head(const HttpResponseHead& head);
+    void handle_body(const char* data, size_t length);
+    void submit(Buffer* buffer);
+    void write_done(WriteRequest* write, ssize_t result);
+    void report_progress(bool force);
+    void fail(const std::string& error);
+    void maybe_finish();
+    void complete(const std::string& error);
+
+    static void on_write(uv_fs_t* req);
+    static void on_synced(uv_fs_t* req);
+    static void on_renamed(uv_fs_t* req);
+};
+
+} // namespace Nexus
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "memory_manager.h"
+
+#include <v8.h>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace Nexus {
+
+/**
+ * IsolateLimits - Heap sizing applied to every isolate the shell creates
+ * heap_limit bounds old + young generation together; young_generation_size
+ * overrides V8's nursery sizing for that heap. Zero keeps V8's default.
+ */
+struct IsolateLimits {
+    size_t heap_limit = 0;
+    size_t young_generation_size = 0;
+
+    void apply(v8::ResourceConstraints& constraints) const;
+};
+
+/**
+ * ManagedArrayBufferAllocator - ArrayBuffer allocator charged to MemoryManager
+ * Backing stores are reserved against the MemoryManager budget before they
+ * are allocated, so JS cannot grow native memory past max_memory; once the
+ * budget is spent allocation fails and JS sees a RangeError. The storage
+ * itself comes from V8's default allocator, which keeps it valid when V8
+ * is built with the sandbox.
+ */
+class ManagedArrayBufferAllocator : public v8::ArrayBuffer::Allocator {
+public:
+    explicit ManagedArrayBufferAllocator(MemoryManager* memory_manager);
+
+    void* Allocate(size_t length) override;
+    void* AllocateUninitialized(size_t length) override;
+    void Free(void* data, size_t length) override;
+
+private:
+    MemoryManager* memory_manager_;
+    std::unique_ptr<v8::ArrayBuffer::Allocator> storage_;
+};
+
+/**
+ * HeapLimitGuard - Cancels the running script when its isolate nears the heap limit
+ * V8 aborts the whole process once a heap is exhausted. Near the limit the
+ * guard terminates execution and grants temporary headroom so the script
+ * can unwind; recover() then clears the termination, collects what the
+ * script left behind and restores the configured limit.
+ */
+class HeapLimitGuard {
+public:
+    void attach(v8::Isolate* isolate);
+    void detach();
+
+    bool limit_reached() const { return reached_.load(std::memory_order_acquire); }
+    size_t heap_limit() const { return heap_limit_; }
+
+    // Restores the isolate if the limit was reached; returns whether it was.
+    // The isolate must be entered (and locked, if shared between threads)
+    bool recover();
+
+private:
+    v8::Isolate* isolate_ = nullptr;
+    size_t heap_limit_ = 0;
+    std::atomic<bool> reached_{false};
+
+    static size_t near_heap_limit(void* data, size_t current_heap_limit, size_t initial_heap_limit);
+};
+
+} // namespace Nexus
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "nexus_types.h"
+#include "thread_pool.h"
+#include "security_context.h"
+#include "stellar_object_bridge.h"
+#include "isolate_limits.h"
+
+#include <v8.h>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Nexus {
+
+/**
+ * TransferBuffer - Serialized JS value handed between isolates
+ * Owns the ValueSerializer output, so moving it across threads never copies
+ */
+struct TransferBuffer {
+    std::unique_ptr<uint8_t, decltype(&std::free)> data{nullptr, &std::free};
+    size_t size = 0;
+
+    static TransferBuffer serialize(v8::Local<v8::Context> context, v8::Local<v8::Value> value);
+    v8::MaybeLocal<v8::Value> deserialize(v8::Local<v8::Context> context) const;
+};
+
+/**
+ * IsolatePool - Pool of V8 isolates for running JS on ThreadPool workers
+ * Every pooled isolate gets its own context built from the same global
+ * setup as the kernel's main context (startup snapshot or native APIs plus
+ * nexus-runtime.js), and is entered through a v8::Locker on whichever
+ * worker thread picks the task up. Pooled isolates have the kernel's heap
+ * limits and charge their ArrayBuffers to the same MemoryManager budget.
+ * Tasks wait in the pool's own queue until an isolate is idle and only
+ * then go to the ThreadPool, so at most size() of its workers run JS and
+ * none of them blocks waiting for an isolate. shutdown() refuses new work,
+ * fails queued tasks and waits for busy isolates before disposing any of
+ * them.
+ */
+class IsolatePool {
+public:
+    IsolatePool(ThreadPool* thread_pool, SecurityContext* security_context, size_t pool_size,
+                MemoryManager* memory_manager, const IsolateLimits& limits);
+    ~IsolatePool();
+
+    // Shared with the main isolate; set before initialize (optional)
+    void set_code_cache(CodeCache* code_cache) { code_cache_ = code_cache; }
+
+    bool initialize(const v8::StartupData* snapshot, const std::string& runtime_path);
+    void shutdown();
+    size_t size() const { return workers_.size(); }
+
+    // Run an independent JS pipeline on the first free isolate
+    std::future<NexusObject> execute_async(const std::string& js_code);
+
+    // Apply the function (given as source) to every element of each
+    // serialized array partition; returns one serialized result array per
+    // partition, in order. Throws std::runtime_error with the JS error text.
+    std::vector<TransferBuffer> map_partitions(const std::string& function_source,
+                                               std::vector<TransferBuffer> partitions,
+                                               const std::vector<uint32_t>& partition_offsets);
+
+private:
+    struct Worker {
+        v8::Isolate* isolate = nullptr;
+        v8::Global<v8::Context> context;
+        std::unique_ptr<v8::ArrayBuffer::Allocator> allocator;
+        std::unique_ptr<StellarObjectBridge> bridge;
+        HeapLimitGuard heap_guard;
+    };
+
+    ThreadPool* thread_pool_;
+    SecurityContext* security_context_;
+    const size_t pool_size_;
+    MemoryManager* memory_manager_;
+    const IsolateLimits limits_;
+    CodeCache* code_cache_ = nullptr;
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    // A task runs with the worker it was given, or with null when the pool
+    // shut down before an isolate became free
+    using Job = std::function<void(Worker* worker)>;
+
+    // Idle workers, and tasks waiting for one
+    std::mutex idle_mutex_;
+    std::condition_variable idle_condition_;
+    std::vector<Worker*> idle_workers_;
+    std::deque<Job> queued_jobs_;
+    bool shutting_down_ = false;
+
+    bool dispatch(Job job);                 // False once shutting down
+    void run(Worker* worker, Job job);
+    void finish(Worker* worker);            // Next queued job, or back to idle
+    NexusObject run_script(Worker& worker, const std::string& js_code);
+    bool setup_worker(Worker& worker, const v8::StartupData* snapshot, const std::string& runtime_path);
+    static void teardown_worker(Worker& worker);
+    TransferBuffer map_partition(Worker& worker, const std::string& function_source,
+                                 const TransferBuffer& partition, uint32_t offset);
+};
+
+} // namespace Nexus
@@ -5,6 +5,7 @@
 #include <atomic>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 namespace Nexus {
 
@@ -31,6 +32,22 @@ public:
     size_t get_free_memory() const { return max_memory_ - used_memory_.load(); }
     size_t get_allocation_count() const { return allocation_count_.load(); }
     
+    // Budget accounting for memory allocated elsewhere (V8 ArrayBuffer
+    // backing stores): charge size against max_memory without allocating.
+    // Fails instead of overcommitting; every reserve is paired with a release
+    bool try_reserve(size_t size) {
+        size_t used = used_memory_.load(std::memory_order_relaxed);
+        do {
+            if (size > max_memory_ - used) {
+                return false;
+            }
+        } while (!used_memory_.compare_exchange_weak(used, used + size, std::memory_order_relaxed));
+        return true;
+    }
+    void release(size_t size) {
+        used_memory_.fetch_sub(size, std::memory_order_relaxed);
+    }
+
     // Memory management
     void garbage_collect();
     void defragment();
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "nexus_types.h"
+#include <atomic>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+namespace Nexus {
+
+/**
+ * OpenMetricsWriter - Builds an OpenMetrics text exposition
+ * Declare a family with begin(), then add its samples. Counter families
+ * are named without "_total"; sample() appends the suffix it is given.
+ */
+class OpenMetricsWriter {
+public:
+    using Labels = std::initializer_list<std::pair<std::string_view, std::string_view>>;
+
+    void begin(std::string_view name, const char* type, std::string_view help, std::string_view unit = {});
+    void sample(std::string_view name, std::string_view suffix, Labels labels, double value);
+
+    // Single-sample families
+    void counter(std::string_view name, std::string_view help, double value);
+    void gauge(std::string_view name, std::string_view help, double value, std::string_view unit = {});
+
+    // Summary in seconds from a microsecond LatencySummary; begin() it first
+    void latency(std::string_view name, Labels labels, const LatencySummary& summary);
+
+    // The exposition, terminated by "# EOF"
+    std::string finish();
+
+private:
+    std::string out_;
+
+    void append_number(double value);
+    void append_escaped(std::string_view text);
+};
+
+/**
+ * MetricsExporter - Serves OpenMetrics over a unix socket or loopback port
+ * A scrape is answered on the exporter's own thread: the collector reads
+ * snapshotted counters and formats them there, so commands never wait for
+ * it. Listen addresses are "unix:/path", an absolute path, "port" or
+ * "host:port" with a loopback host. Any GET is answered with the metrics.
+ *
+ *   curl --unix-socket /run/nexus/metrics.sock http://localhost/metrics
+ *   curl http://127.0.0.1:9464/metrics
+ */
+class MetricsExporter {
+public:
+    using Collector = std::function<void(OpenMetricsWriter&)>;
+
+    explicit MetricsExporter(Collector collector);
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    bool start(const std::string& listen, std::string& error);
+    void stop();
+
+    bool running() const { return listen_fd_ >= 0; }
+    const std::string& address() const { return address_; }
+    uint64_t scrapes() const { return scrapes_.load(std::memory_order_relaxed); }
+
+private:
+    Collector collector_;
+    int listen_fd_ = -1;
+    int wake_fd_[2] = {-1, -1};
+    std::string address_;
+    std::string socket_path_;               // Unlinked on stop
+    std::thread thread_;
+    std::atomic<uint64_t> scrapes_{0};
+
+    bool listen_unix(const std::string& path, std::string& error);
+    bool listen_tcp(const std::string& host, const std::string& port, std::string& error);
+    void run();
+    void serve(int fd);
+};
+
+} // namespace Nexus
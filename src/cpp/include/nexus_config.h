@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Nexus {
+
+/**
+ * NexusConfig - Typed shell configuration
+ * Read from either flat keys ("max_memory": "52428800") or the sectioned
+ * layout shown in the README ("shell": {"maxMemory": "50MB"}); both names
+ * address the same setting. Sizes take B/KB/MB/GB/TB suffixes (binary
+ * multiples), durations ms/s/m/h. Values may be JSON strings, numbers or
+ * booleans. Keys without a typed field are kept as text in `values`.
+ */
+struct NexusConfig {
+    // shell
+    size_t max_memory = 50 * 1024 * 1024;
+    size_t thread_pool_size = 8;
+    bool enable_jit = true;
+    bool enable_sandbox = true;
+    bool enable_debug = false;
+    bool startup_trace = false;
+    bool quiet = false;                             // No status messages on stdout (-c and script mode)
+    std::vector<std::string> plugins;               // Loaded at startup; names are looked up in NEXUS_PLUGIN_PATH
+
+    // js
+    size_t js_heap_limit = 0;                       // 0: max_memory
+    size_t js_young_generation_size = 0;            // 0: V8's choice
+    std::optional<size_t> js_isolate_pool_size;     // Unset: min(4, cores)
+    std::string js_runtime_path;                    // Empty: NEXUS_JS_PATH or the data dir
+    bool code_cache = true;
+    std::string code_cache_dir;                     // Empty: CodeCache default
+    bool startup_snapshot = true;
+    std::string snapshot_path;                      // Empty: the data dir
+
+    // security
+    std::string default_policy = "sandbox";
+    bool audit_logging = true;
+    std::vector<std::string> capabilities;
+
+    // performance
+    bool monitoring = true;
+    size_t memory_warning = 0;                      // 0: no warning
+    uint64_t latency_warning_ms = 0;
+    std::string metrics_listen;                     // Empty: no metrics exporter
+
+    // Every setting as given, under its flat key and its section path
+    std::unordered_map<std::string, std::string> values;
+
+    // Apply one setting given as text (lists comma-separated). Returns
+    // false with error set if the value does not parse; config is unchanged
+    bool set(const std::string& key, std::string_view value, std::string& error);
+
+    // Flat name of a setting given by either of its names; other keys as is
+    static std::string canonical_key(const std::string& key);
+
+    // Parse a JSON document over this configuration. On error the
+    // configuration may be partially updated: parse into a copy
+    bool parse(std::string_view json, std::string& error);
+    bool load(const std::string& path, std::string& error);
+
+    // NEXUS_MAX_MEMORY and NEXUS_DEBUG, as documented in the README
+    void apply_environment();
+
+    static bool parse_size(std::string_view text, size_t& bytes);
+    static bool parse_duration_ms(std::string_view text, uint64_t& ms);
+    static bool parse_bool(std::string_view text, bool& value);
+};
+
+/**
+ * ConfigStore - RCU publication of NexusConfig snapshots
+ * Each thread caches the snapshot it last read, so a reader takes one
+ * atomic load of the generation and copies its cached shared_ptr; only
+ * the first read after a publish takes the lock. Writers build a complete
+ * replacement and publish it under that lock, so readers see the old or
+ * the new configuration, never a mix. A superseded snapshot is freed once
+ * every thread that cached it has read again (or exited) and the last
+ * holder lets go.
+ */
+class ConfigStore {
+public:
+    explicit ConfigStore(NexusConfig initial = {});
+
+    std::shared_ptr<const NexusConfig> current() const;
+    uint64_t generation() const { return generation_.load(std::memory_order_acquire); }
+
+    void publish(NexusConfig next);
+
+    // Copy the current snapshot, set one key and publish the copy
+    bool update(const std::string& key, std::string_view value, std::string& error);
+
+private:
+    const uint64_t store_id_;                       // Tells stores apart in the per-thread cache
+    std::shared_ptr<const NexusConfig> current_;    // Guarded by mutex_
+    std::atomic<uint64_t> generation_{0};           // Bumped under mutex_ after current_ changes
+
+    mutable std::mutex mutex_;
+
+    void publish_locked(std::shared_ptr<const NexusConfig> next);
+};
+
+} // namespace Nexus
@@ -7,6 +7,18 @@
 #include "security_context.h"
 #include "memory_manager.h"
 #include "thread_pool.h"
+#include "code_cache.h"
+#include "isolate_pool.h"
+#include "file_watcher.h"
+#include "process_snapshot.h"
+#include "http_client.h"
+#include "isolate_limits.h"
+#include "startup_trace.h"
+#include "nexus_config.h"
+#include "fs_transaction.h"
+#include "command_metrics.h"
+#include "metrics_exporter.h"
+#include "plugin_manager.h"
 
 #include <v8.h>
 #include <uv.h>
@@ -30,16 +42,36 @@ public:
     void shutdown();
     bool is_running() const { return running_.load(); }
 
+    // V8 and the nexus.* APIs are brought up by the first JS command; call
+    // from the shell thread. False if the JS runtime failed to initialize
+    bool ensure_js_runtime();
+
     // Command execution
     NexusObject execute_command(const std::string& input, const CommandContext& context = {});
     NexusObject execute_pipeline(const std::vector<std::string>& commands, const CommandContext& context = {});
     NexusObject execute_js_pipeline(const std::string& js_code, const CommandContext& context = {});
+    std::future<NexusObject> execute_js_pipeline_async(const std::string& js_code, const CommandContext& context = {});
+
+    // Event loop: run callbacks that are ready without blocking, or run the
+    // loop until fd is readable so timers, watchers and transfers progress
+    // while the shell waits for input
+    void run_pending_events();
+    void wait_for_input(int fd);
+
+    // Daemon requests: commands run in between see environment ("NAME=value")
+    // in proc.exec children and nexus.proc.env, and end_request() cancels
+    // the async work they left pending (see StellarObjectBridge)
+    void begin_request(std::vector<std::string> environment);
+    void end_request();
 
     // Transaction support
     ObjectId begin_transaction();
     void commit_transaction(ObjectId transaction_id);
     void rollback_transaction(ObjectId transaction_id);
 
+    // Snapshot path (copy-on-write) so rolling the transaction back restores it
+    bool protect_path(ObjectId transaction_id, const std::string& path, std::string& error);
+
     // Component access
     QuantumParser* parser() { return parser_.get(); }
     OrionExecutionEngine* execution_engine() { return execution_engine_.get(); }
@@ -47,48 +79,128 @@ public:
     SecurityContext* security_context() { return security_context_.get(); }
     MemoryManager* memory_manager() { return memory_manager_.get(); }
     ThreadPool* thread_pool() { return thread_pool_.get(); }
+    CodeCache* code_cache() { return code_cache_.get(); }
+    IsolatePool* isolate_pool() { return isolate_pool_.get(); }
+    FileWatcher* file_watcher() { return file_watcher_.get(); }
+    ProcessSnapshotEngine* process_snapshots() { return process_snapshots_.get(); }
+    HttpClient* http_client() { return http_client_.get(); }
+    MetricsExporter* metrics_exporter() { return metrics_exporter_.get(); }
+    PluginManager* plugins() { return plugins_.get(); }
 
     // Performance monitoring
     PerformanceMetrics get_performance_metrics() const;
     void reset_performance_metrics();
 
-    // Plugin management
+    // Plugin management (see nexus_plugin.h); failures are reported on stderr
     bool load_plugin(const std::string& plugin_path);
     void unload_plugin(const std::string& plugin_name);
 
-    // Configuration
-    void set_config(const std::string& key, const std::string& value);
+    // Configuration. config() is the published snapshot, cached per thread
+    // (see ConfigStore); it stays valid while held even if a reload
+    // replaces it.
+    // set_config() overrides survive reloads of the file
+    std::shared_ptr<const NexusConfig> config() const { return config_.current(); }
+    bool set_config(const std::string& key, const std::string& value);
     std::string get_config(const std::string& key) const;
+    bool reload_config();
 
 private:
     // Core components
     std::unique_ptr<QuantumParser> parser_;
     std::unique_ptr<OrionExecutionEngine> execution_engine_;
+    std::unique_ptr<PluginManager> plugins_;  // Registers into execution_engine_
     std::unique_ptr<StellarObjectBridge> object_bridge_;
     std::unique_ptr<SecurityContext> security_context_;
     std::unique_ptr<MemoryManager> memory_manager_;
     std::unique_ptr<ThreadPool> thread_pool_;
+    std::unique_ptr<CodeCache> code_cache_;
+    std::unique_ptr<IsolatePool> isolate_pool_;
+    std::unique_ptr<FileWatcher> file_watcher_;
+    std::unique_ptr<ProcessSnapshotEngine> process_snapshots_;
+    std::unique_ptr<HttpClient> http_client_;
 
     // V8 JavaScript runtime
-    v8::Isolate* isolate_;
+    std::unique_ptr<v8::Platform> platform_;
+    std::unique_ptr<v8::ArrayBuffer::Allocator> array_buffer_allocator_;
+    HeapLimitGuard heap_guard_;
+    v8::Isolate* isolate_ = nullptr;
     v8::Global<v8::Context> global_context_;
 
+    // Startup snapshot (must outlive the isolate created from it)
+    std::string snapshot_blob_;
+    v8::StartupData startup_data_{nullptr, 0};
+    bool globals_from_snapshot_ = false;
+    uint64_t startup_time_us_ = 0;
+
+    // Startup: background tasks still running after initialize() returns,
+    // and the lazily created JS runtime
+    std::unique_ptr<StartupTrace> startup_trace_;
+    std::future<bool> security_ready_;
+    std::future<bool> v8_platform_ready_;
+    std::future<void> code_cache_ready_;
+    bool js_runtime_ready_ = false;
+    bool js_runtime_failed_ = false;
+    uint64_t js_runtime_startup_us_ = 0;
+
     // libuv event loop
     uv_loop_t* event_loop_;
 
     // State management
     std::atomic<bool> running_{false};
-    std::unordered_map<std::string, std::string> config_;
+    ConfigStore config_;
+    std::string config_path_;
+    std::unordered_map<std::string, std::string> config_overrides_;    // By flat setting name
+    FileWatcher::SubscriptionId config_subscription_ = 0;
     std::unordered_map<ObjectId, TransactionState> transactions_;
     
     // Performance tracking
-    mutable std::mutex metrics_mutex_;
-    PerformanceMetrics metrics_{};
+    CommandMetrics command_metrics_;
+    std::atomic<uint64_t> heap_limit_cancellations_{0};
+
+    // What the metrics exporter reads from other threads: values that only
+    // the main thread may touch are sampled by a loop timer
+    struct RuntimeSample {
+        bool js_runtime_ready = false;
+        uint64_t js_runtime_startup_us = 0;
+        uint64_t code_cache_hits = 0;
+        uint64_t code_cache_misses = 0;
+        uint64_t native_objects = 0;
+        size_t js_heap_used = 0;
+        size_t js_heap_total = 0;
+        size_t js_heap_limit = 0;
+        size_t js_external_memory = 0;
+    };
+    std::unique_ptr<MetricsExporter> metrics_exporter_;
+    uv_timer_t* metrics_timer_ = nullptr;
+    mutable std::mutex runtime_sample_mutex_;
+    RuntimeSample runtime_sample_;
 
     // Internal methods
-    bool initialize_v8();
+    bool initialize_v8_platform();
+    bool create_main_isolate();
+    bool initialize_js_runtime();
+    void wait_for_background_init();
+    void release_components();
     bool initialize_libuv();
     void setup_js_globals();
+    bool initialize_isolate_pool();
+    std::string js_runtime_path() const;
+    bool read_config(NexusConfig& config, std::string& error) const;
+    void watch_config_file();
+    IsolateLimits isolate_limits() const;
+    bool recover_from_heap_limit();
+    bool load_startup_snapshot();
+    NexusObject run_js_pipeline(const std::string& js_code, const CommandContext& context, uint64_t* convert_us);
+    bool await_promise(v8::Local<v8::Promise> promise);
+    void pump_v8_tasks();
+    void report_idle_heap_limit();
+    void collect_transaction_garbage(std::shared_ptr<FsTransaction> files);
+    void start_metrics_exporter(const std::string& listen);
+    void stop_metrics_exporter();
+    void sample_runtime_metrics();
+    void write_metrics(OpenMetricsWriter& out) const;
+    NexusObject heap_limit_error() const;
+    NexusObject js_exception_to_nexus(v8::Local<v8::Context> context, v8::Local<v8::Value> exception);
     void cleanup_v8();
     void cleanup_libuv();
 };
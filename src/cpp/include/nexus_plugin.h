@@ -0,0 +1,242 @@
+#pragma once
+
+/**
+ * nexus_plugin.h - Native plugin interface
+ * Plugins are shared objects loaded with dlopen. The shell and a plugin
+ * only exchange the C structures below, so a plugin does not have to be
+ * built with the shell's compiler, flags or C++ standard library. A
+ * plugin exports nexus_plugin_entry(), which returns its
+ * nexus_plugin_info; initialize() registers commands through the host
+ * API. Compatible additions append fields to these structures (check
+ * `size` before using a field newer than your build);
+ * NEXUS_PLUGIN_ABI_VERSION only changes when existing fields do.
+ *
+ * Command functions may run on several threads at once. A plugin is shut
+ * down, and unloaded, after its last running command has returned, which
+ * may happen on any thread.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NEXUS_PLUGIN_ABI_VERSION 1u
+#define NEXUS_PLUGIN_ENTRY "nexus_plugin_entry"
+
+/* A command's result; owned by the host and filled through the host API */
+typedef struct nexus_result nexus_result;
+
+typedef struct nexus_command_args {
+    size_t argc;
+    const char* const* argv;                /* Positional arguments, without the command name */
+    size_t flag_count;
+    const char* const* flag_names;
+    const char* const* flag_values;
+    const char* working_directory;
+} nexus_command_args;
+
+/* Returns 0 on success. A failure without set_error gets a generic message */
+typedef int (*nexus_command_fn)(void* user_data, const nexus_command_args* args, nexus_result* result);
+
+typedef struct nexus_host_api {
+    uint32_t abi_version;
+    uint32_t size;                          /* sizeof(nexus_host_api) in the host */
+    void* host;                             /* First argument of register_command and log */
+
+    /* Only during initialize(). Non-zero if the name is taken */
+    int (*register_command)(void* host, const char* name, nexus_command_fn fn, void* user_data);
+    void (*log)(void* host, const char* message);
+
+    void (*set_null)(nexus_result* result);
+    void (*set_bool)(nexus_result* result, int value);
+    void (*set_int)(nexus_result* result, int64_t value);
+    void (*set_double)(nexus_result* result, double value);
+    void (*set_string)(nexus_result* result, const char* data, size_t length);
+    void (*set_bytes)(nexus_result* result, const void* data, size_t length);
+    void (*set_error)(nexus_result* result, const char* message);
+} nexus_host_api;
+
+typedef struct nexus_plugin_info {
+    uint32_t abi_version;                   /* NEXUS_PLUGIN_ABI_VERSION the plugin was built with */
+    uint32_t size;                          /* sizeof(nexus_plugin_info) in the plugin */
+    const char* name;
+    const char* version;
+
+    /* Returns 0 on success; on failure the plugin has released everything.
+       api stays valid until shutdown, and state is passed to it */
+    int (*initialize)(const nexus_host_api* api, void** state);
+    void (*shutdown)(void* state);
+} nexus_plugin_info;
+
+typedef const nexus_plugin_info* (*nexus_plugin_entry_fn)(void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Nexus {
+
+/** PluginArgs - Read-only view of a command's arguments */
+class PluginArgs {
+public:
+    explicit PluginArgs(const nexus_command_args* args) : args_(args) {}
+
+    size_t size() const { return args_->argc; }
+    std::string_view operator[](size_t index) const { return args_->argv[index]; }
+    std::string_view working_directory() const { return args_->working_directory; }
+
+    bool has_flag(std::string_view name) const { return find_flag(name) != nullptr; }
+    std::string_view flag(std::string_view name, std::string_view fallback = {}) const {
+        const char* value = find_flag(name);
+        return value ? std::string_view(value) : fallback;
+    }
+
+private:
+    const nexus_command_args* args_;
+
+    const char* find_flag(std::string_view name) const {
+        for (size_t i = 0; i < args_->flag_count; ++i) {
+            if (name == args_->flag_names[i]) {
+                return args_->flag_values[i];
+            }
+        }
+        return nullptr;
+    }
+};
+
+/** PluginResult - Sets a command's result */
+class PluginResult {
+public:
+    PluginResult(const nexus_host_api* api, nexus_result* result) : api_(api), result_(result) {}
+
+    void set_null() { api_->set_null(result_); }
+    void set_bool(bool value) { api_->set_bool(result_, value ? 1 : 0); }
+    void set_int(int64_t value) { api_->set_int(result_, value); }
+    void set_double(double value) { api_->set_double(result_, value); }
+    void set_string(std::string_view text) { api_->set_string(result_, text.data(), text.size()); }
+    void set_bytes(const void* data, size_t length) { api_->set_bytes(result_, data, length); }
+
+    // Returns false, so a command can `return result.error(...)`
+    bool error(const std::string& message) {
+        api_->set_error(result_, message.c_str());
+        return false;
+    }
+
+private:
+    const nexus_host_api* api_;
+    nexus_result* result_;
+};
+
+// Returns true on success
+using PluginCommand = std::function<bool(const PluginArgs& args, PluginResult& result)>;
+
+/** PluginHost - The shell as seen by a plugin */
+class PluginHost {
+public:
+    explicit PluginHost(const nexus_host_api* api) : api_(api) {}
+
+    bool register_command(const std::string& name, PluginCommand command) {
+        auto binding = std::make_unique<Binding>(Binding{api_, std::move(command)});
+        if (api_->register_command(api_->host, name.c_str(), &Binding::invoke, binding.get()) != 0) {
+            return false;
+        }
+        bindings_.push_back(std::move(binding));
+        return true;
+    }
+
+    void log(const std::string& message) const { api_->log(api_->host, message.c_str()); }
+
+private:
+    struct Binding {
+        const nexus_host_api* api;
+        PluginCommand command;
+
+        static int invoke(void* user_data, const nexus_command_args* args, nexus_result* result) {
+            auto* binding = static_cast<Binding*>(user_data);
+            PluginArgs view(args);
+            PluginResult out(binding->api, result);
+#if defined(__cpp_exceptions)
+            try {
+                return binding->command(view, out) ? 0 : 1;
+            } catch (const std::exception& e) {
+                out.error(e.what());
+            } catch (...) {
+                out.error("Plugin command threw an exception");
+            }
+            return 1;
+#else
+            return binding->command(view, out) ? 0 : 1;
+#endif
+        }
+    };
+
+    const nexus_host_api* api_;
+    std::vector<std::unique_ptr<Binding>> bindings_;    // Commands call into these until shutdown
+};
+
+/** Plugin - Base class for plugins exported with NEXUS_PLUGIN_EXPORT */
+class Plugin {
+public:
+    virtual ~Plugin() = default;
+    virtual bool initialize(PluginHost& host) = 0;
+    virtual void shutdown() {}
+};
+
+namespace plugin_detail {
+
+template <typename T>
+struct Instance {
+    explicit Instance(const nexus_host_api* api) : host(api) {}
+    PluginHost host;
+    T plugin;
+};
+
+template <typename T>
+int initialize(const nexus_host_api* api, void** state) {
+    auto instance = std::make_unique<Instance<T>>(api);
+#if defined(__cpp_exceptions)
+    try {
+        if (!instance->plugin.initialize(instance->host)) {
+            return 1;
+        }
+    } catch (...) {
+        return 1;
+    }
+#else
+    if (!instance->plugin.initialize(instance->host)) {
+        return 1;
+    }
+#endif
+    *state = instance.release();
+    return 0;
+}
+
+template <typename T>
+void shutdown(void* state) {
+    auto* instance = static_cast<Instance<T>*>(state);
+    instance->plugin.shutdown();
+    delete instance;
+}
+
+} // namespace plugin_detail
+} // namespace Nexus
+
+#define NEXUS_PLUGIN_EXPORT(PluginClass, plugin_name, plugin_version)                              \
+    extern "C" __attribute__((visibility("default"))) const nexus_plugin_info* nexus_plugin_entry() { \
+        static const nexus_plugin_info info = {                                                     \
+            NEXUS_PLUGIN_ABI_VERSION, sizeof(nexus_plugin_info), plugin_name, plugin_version,       \
+            &::Nexus::plugin_detail::initialize<PluginClass>,                                       \
+            &::Nexus::plugin_detail::shutdown<PluginClass>};                                        \
+        return &info;                                                                               \
+    }
+
+#endif /* __cplusplus */
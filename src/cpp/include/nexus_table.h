@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Nexus {
+
+/**
+ * NexusTable - Immutable columnar result set (ps, ls, stat)
+ * Numeric columns are contiguous doubles and string columns native
+ * strings. Column storage is shared between tables, so select() is free;
+ * filter/sort_by/take gather the selected rows into a new table and never
+ * modify this one. JS never sees this storage: the bridge copies a column
+ * into isolate-owned memory when a script asks for it.
+ */
+class NexusTable {
+public:
+    enum class ColumnKind { Number, String };
+
+    enum class Op {
+        Eq, Ne, Lt, Le, Gt, Ge,
+        Contains, StartsWith, EndsWith, Glob      // String columns only
+    };
+
+    using Numbers = std::vector<double>;
+    using Strings = std::vector<std::string>;
+
+    struct Column {
+        std::string name;
+        ColumnKind kind;
+        std::shared_ptr<const Numbers> numbers;
+        std::shared_ptr<const Strings> strings;
+    };
+
+    explicit NexusTable(size_t rows) : rows_(rows) {}
+
+    // Builders; the returned column already holds rows() default values
+    Numbers& add_number_column(std::string name);
+    Strings& add_string_column(std::string name);
+
+    size_t rows() const { return rows_; }
+    const std::vector<Column>& columns() const { return columns_; }
+    const Column* column(std::string_view name) const;
+
+    // Parses "==", "!=", "<", "<=", ">", ">=", "contains", "startsWith",
+    // "endsWith" and "glob"; returns false for anything else
+    static bool parse_op(std::string_view text, Op& op);
+
+    // Rows whose column satisfies `op value`. Returns nullptr for an unknown
+    // column or a string-only op on a numeric column. NaN matches only Ne.
+    std::shared_ptr<NexusTable> filter(std::string_view column, Op op, double value) const;
+    std::shared_ptr<NexusTable> filter(std::string_view column, Op op, std::string_view value) const;
+
+    // Stable sort; NaN sorts last in either direction. nullptr if unknown
+    std::shared_ptr<NexusTable> sort_by(std::string_view column, bool descending) const;
+
+    // Subset of columns sharing this table's storage. nullptr if any is unknown
+    std::shared_ptr<NexusTable> select(const std::vector<std::string>& names) const;
+
+    // Rows by index, in the given order. nullptr if an index is out of range
+    std::shared_ptr<NexusTable> take(const std::vector<uint32_t>& indices) const;
+
+private:
+    size_t rows_;
+    std::vector<Column> columns_;
+
+    std::shared_ptr<NexusTable> gather(const std::vector<uint32_t>& indices) const;
+};
+
+} // namespace Nexus
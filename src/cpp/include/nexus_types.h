@@ -3,9 +3,11 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <variant>
 #include <functional>
+#include <unordered_map>
 
 namespace Nexus {
 
@@ -13,12 +15,18 @@ namespace Nexus {
 class NexusKernel;
 class ObjectBridge;
 class SecurityContext;
+class FsTransaction;
 
 // Core types
 using ObjectId = uint64_t;
 using ThreadId = uint32_t;
 using ProcessId = uint32_t;
 
+// Structured values (recursive, so held by pointer)
+struct NexusObject;
+using NexusList = std::vector<NexusObject>;
+using NexusMap = std::vector<std::pair<std::string, NexusObject>>;  // Keeps JS key order
+
 // Nexus object variant type
 using NexusValue = std::variant<
     std::nullptr_t,
@@ -26,13 +34,40 @@ using NexusValue = std::variant<
     int64_t,
     double,
     std::string,
-    std::vector<uint8_t>  // Binary data
+    std::vector<uint8_t>,           // Binary data
+    std::vector<int64_t>,           // Packed integer array
+    std::vector<double>,            // Packed double array
+    std::shared_ptr<NexusList>,     // Generic array
+    std::shared_ptr<NexusMap>       // Plain object
 >;
 
+// Interned object type names: compared and dispatched on as small
+// integers. Built-in types have fixed ids; other names get one on first use
+using TypeId = uint32_t;
+
+namespace TypeIds {
+    constexpr TypeId Unknown = 0;
+    constexpr TypeId Null = 1;
+    constexpr TypeId Boolean = 2;
+    constexpr TypeId Number = 3;
+    constexpr TypeId String = 4;
+    constexpr TypeId Buffer = 5;
+    constexpr TypeId Array = 6;
+    constexpr TypeId Object = 7;
+    constexpr TypeId Circular = 8;
+    constexpr TypeId Error = 9;
+    constexpr TypeId JsError = 10;
+    constexpr TypeId Exit = 11;
+}
+
+// Thread-safe; ids are stable for the life of the process
+TypeId intern_type(std::string_view name);
+const std::string& type_name(TypeId id);
+
 // Object metadata
 struct ObjectMetadata {
     ObjectId id;
-    std::string type;
+    TypeId type_id = TypeIds::Unknown;
     size_t size;
     uint64_t created_at;
     uint64_t modified_at;
@@ -83,13 +118,38 @@ struct NexusError {
 };
 
 // Performance metrics
+// Latency distribution, in microseconds
+struct LatencySummary {
+    uint64_t count = 0;
+    double mean_us = 0;
+    uint64_t p50_us = 0;
+    uint64_t p99_us = 0;
+    uint64_t max_us = 0;
+};
+
+struct CommandLatency {
+    std::string command;
+    std::string phase;                  // parse, security, execute, convert or total
+    LatencySummary latency;
+};
+
 struct PerformanceMetrics {
     uint64_t commands_executed;
+    uint64_t commands_failed;
     uint64_t total_execution_time_us;
+    LatencySummary latency;             // Every command, end to end
+    std::vector<CommandLatency> command_latency;
     uint64_t memory_usage_bytes;
     uint64_t cache_hits;
     uint64_t cache_misses;
     double cpu_usage_percent;
+    uint64_t startup_time_us;           // Until the plain shell is ready
+    uint64_t js_runtime_startup_us;     // Lazy V8 setup on the first JS command
+    bool startup_snapshot_used;
+    uint64_t native_objects;
+    uint64_t native_object_lookups;
+    double native_object_lookup_ns;
+    uint64_t heap_limit_cancellations;
 };
 
 // Security capability
@@ -106,6 +166,7 @@ struct TransactionState {
     std::vector<std::string> commands;
     std::vector<NexusObject> snapshots;
     std::function<void()> rollback_handler;
+    std::shared_ptr<FsTransaction> files;      // Copy-on-write snapshots of protected paths
 };
 
 } // namespace Nexus
\ No newline at end of file
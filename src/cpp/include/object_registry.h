@@ -0,0 +1,76 @@
+#pragma once
+
+#include "nexus_types.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+namespace Nexus {
+
+/**
+ * ObjectRegistry - Slot map for native objects referenced from JS
+ * Handles encode {generation, shard, slot}: a slot is reused after erase()
+ * with a bumped generation, so stale handles miss instead of aliasing a new
+ * object. Shards are locked independently; lookups take a shared lock.
+ */
+class ObjectRegistry {
+public:
+    static constexpr size_t kShardCount = 16;
+
+    struct Stats {
+        uint64_t live_objects = 0;
+        uint64_t slot_capacity = 0;
+        uint64_t lookups = 0;
+        uint64_t lookup_misses = 0;         // Unknown or stale handles
+        double avg_lookup_ns = 0;           // Sampled
+    };
+
+    ObjectRegistry() = default;
+    ObjectRegistry(const ObjectRegistry&) = delete;
+    ObjectRegistry& operator=(const ObjectRegistry&) = delete;
+
+    // Returns 0 (never a valid handle) when the shard is full
+    ObjectId insert(std::shared_ptr<void> object);
+    std::shared_ptr<void> get(ObjectId handle) const;
+    bool erase(ObjectId handle);
+
+    size_t size() const;
+    Stats get_stats() const;
+
+private:
+    static constexpr uint32_t kSlotBits = 28;
+    static constexpr uint32_t kSlotMask = (1u << kSlotBits) - 1;
+    static constexpr uint32_t kNoFreeSlot = UINT32_MAX;
+    static constexpr uint64_t kLookupSampleMask = 63;   // Time 1 in 64 lookups
+
+    struct Slot {
+        std::shared_ptr<void> object;
+        uint32_t generation = 1;
+        uint32_t next_free = kNoFreeSlot;
+    };
+
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        std::vector<Slot> slots;
+        uint32_t free_head = kNoFreeSlot;
+        size_t live = 0;
+
+        mutable std::atomic<uint64_t> lookups{0};
+        mutable std::atomic<uint64_t> misses{0};
+        mutable std::atomic<uint64_t> sampled_lookups{0};
+        mutable std::atomic<uint64_t> sampled_ns{0};
+    };
+
+    std::array<Shard, kShardCount> shards_;
+    std::atomic<uint32_t> next_shard_{0};
+
+    static ObjectId encode(uint32_t generation, size_t shard, uint32_t slot) {
+        return (static_cast<uint64_t>(generation) << 32) | (static_cast<uint64_t>(shard) << kSlotBits) | slot;
+    }
+
+    std::shared_ptr<void> find(const Shard& shard, uint32_t slot, uint32_t generation) const;
+};
+
+} // namespace Nexus
@@ -2,14 +2,16 @@
 
 #include "nexus_types.h"
 #include "thread_pool.h"
+#include "command_table.h"
 #include <memory>
 #include <future>
 #include <unordered_map>
 
 namespace Nexus {
 
-// Forward declaration
+// Forward declarations
 class NexusKernel;
+struct ParsedCommand;
 
 /**
  * OrionExecutionEngine - JIT compilation and concurrent execution engine
@@ -27,9 +29,10 @@ public:
     std::future<NexusObject> execute_async(const std::string& command, const CommandContext& context);
     std::future<NexusObject> execute_pipeline_async(const std::vector<std::string>& commands, const CommandContext& context);
     
-    // Command registration
+    // Command registration; safe while commands run on other threads
     void register_native_command(const std::string& name, CommandHandler handler);
     void unregister_command(const std::string& name);
+    CommandTable& commands() { return native_commands_; }
     
     // JIT compilation
     bool compile_pipeline(const std::vector<std::string>& commands);
@@ -44,7 +47,7 @@ private:
     ThreadPool* thread_pool_;
     
     // Command registry
-    std::unordered_map<std::string, CommandHandler> native_commands_;
+    CommandTable native_commands_;
     
     // JIT compilation
     bool jit_enabled_ = true;
@@ -52,6 +55,9 @@ private:
     std::unordered_map<std::string, std::shared_ptr<void>> compiled_pipelines_;
     
     // Internal execution methods
+    // Handlers, plugin commands included, read their arguments and flags
+    // from the context: the caller's, plus those parsed for this command
+    static CommandContext with_arguments(const ParsedCommand& command, const CommandContext& context);
     NexusObject execute_native_command(const std::string& name, const CommandContext& context);
     NexusObject execute_system_command(const std::string& command, const CommandContext& context);
     
@@ -71,7 +77,7 @@ private:
     static NexusObject cmd_cp(const CommandContext& context);
     static NexusObject cmd_mv(const CommandContext& context);
     static NexusObject cmd_cat(const CommandContext& context);
-    static NexusObject cmd_ps(const CommandContext& context);
+    NexusObject cmd_ps(const CommandContext& context);
     static NexusObject cmd_kill(const CommandContext& context);
     static NexusObject cmd_help(const CommandContext& context);
     static NexusObject cmd_exit(const CommandContext& context);
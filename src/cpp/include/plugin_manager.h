@@ -0,0 +1,57 @@
+#pragma once
+
+#include "nexus_types.h"
+#include "command_table.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Nexus {
+
+/**
+ * PluginManager - Loads native plugins (see nexus_plugin.h) with dlopen
+ * A plugin's commands go straight into the command table, so calling one
+ * costs a table lookup and an indirect call. Each registered handler holds
+ * a reference to its plugin: unload() removes the commands at once, and
+ * the plugin is shut down and dlclose'd when the last command still
+ * running returns.
+ */
+class PluginManager {
+public:
+    struct PluginInfo {
+        std::string name;
+        std::string version;
+        std::string path;
+        std::vector<std::string> commands;
+    };
+
+    explicit PluginManager(CommandTable& commands);
+    ~PluginManager();                       // Unloads every plugin
+
+    PluginManager(const PluginManager&) = delete;
+    PluginManager& operator=(const PluginManager&) = delete;
+
+    // path is a file, or a name looked up in NEXUS_PLUGIN_PATH as
+    // name, name.so and libname.so. name receives the plugin's name
+    bool load(const std::string& path, std::string& name, std::string& error);
+    bool unload(const std::string& name, std::string& error);
+    void unload_all();
+
+    std::vector<PluginInfo> list() const;
+
+    // The `plugin` shell command: plugin [list] | load <path> | unload <name>
+    NexusObject command(const CommandContext& context);
+
+    static std::string resolve(const std::string& path);
+
+private:
+    struct Loaded;
+
+    CommandTable& commands_;
+    mutable std::mutex mutex_;              // Serializes load and unload
+    std::unordered_map<std::string, std::shared_ptr<Loaded>> plugins_;
+};
+
+} // namespace Nexus
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "thread_pool.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Nexus {
+
+/**
+ * ProcessSnapshot - Columnar view of every process at one instant
+ * Rows are sorted by pid; column i of every vector describes the same process
+ */
+struct ProcessSnapshot {
+    uint64_t timestamp_ms = 0;      // CLOCK_MONOTONIC
+    double interval_s = 0.0;        // Since the snapshot CPU% was measured against
+
+    std::vector<int32_t> pid;
+    std::vector<int32_t> ppid;
+    std::vector<uint32_t> uid;
+    std::vector<char> state;
+    std::vector<int32_t> threads;
+    std::vector<uint64_t> rss_bytes;
+    std::vector<uint64_t> vsize_bytes;
+    std::vector<uint64_t> cpu_ticks;        // utime + stime
+    std::vector<uint64_t> start_ticks;      // Since boot; with pid identifies a process
+    std::vector<double> cpu_percent;
+    std::vector<std::string> name;
+    std::vector<std::string> command;
+
+    size_t size() const { return pid.size(); }
+    void resize(size_t rows);
+};
+
+/**
+ * ProcessSnapshotEngine - /proc scanner producing ProcessSnapshots
+ * Lists pids with getdents64, parses stat/status/cmdline without iostreams
+ * on the thread pool, and derives CPU% from the previous snapshot. Static
+ * fields (command line, uid) are carried over for processes already seen,
+ * and each process's stat file stays open between scans (up to half of
+ * RLIMIT_NOFILE), so a steady-state scan is one pread per process.
+ */
+class ProcessSnapshotEngine {
+public:
+    explicit ProcessSnapshotEngine(ThreadPool* thread_pool, std::string proc_root = "/proc");
+    ~ProcessSnapshotEngine();
+
+    // Takes a new snapshot, or returns the latest one if it is younger than
+    // max_age_ms so concurrent monitors share a single scan per interval
+    std::shared_ptr<const ProcessSnapshot> scan(uint64_t max_age_ms = 0);
+    std::shared_ptr<const ProcessSnapshot> latest() const;
+
+    uint64_t get_scan_count() const { return scan_count_; }
+
+private:
+    ThreadPool* thread_pool_;
+    const std::string proc_root_;
+    const long ticks_per_second_;
+    const uint64_t page_size_;
+
+    mutable std::mutex mutex_;      // Serializes scans and guards latest_
+    std::shared_ptr<const ProcessSnapshot> latest_;
+    uint64_t scan_count_ = 0;
+
+    // Open /proc/<pid>/stat descriptors, row-aligned with latest_ (-1 where
+    // none is kept); next_stat_fds_ is filled for the snapshot being taken
+    std::vector<int> stat_fds_;
+    std::vector<int> next_stat_fds_;
+    std::atomic<size_t> open_stat_fds_{0};
+    size_t max_stat_fds_ = 512;
+
+    static constexpr size_t kRowsPerTask = 512;
+    static constexpr size_t kNoRow = static_cast<size_t>(-1);
+
+    std::vector<int32_t> list_pids(int proc_fd) const;
+    void read_rows(int proc_fd, ProcessSnapshot& snapshot, const ProcessSnapshot* previous,
+                   size_t begin, size_t end, std::vector<uint8_t>& valid);
+    void compute_cpu_percent(ProcessSnapshot& snapshot, const ProcessSnapshot* previous, int proc_fd) const;
+};
+
+} // namespace Nexus
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "nexus_types.h"
+#include <string>
+
+namespace Nexus {
+
+// Renders structured values (arrays/objects) as compact JSON-like text
+void append_value(std::string& out, const NexusValue& value);
+
+// Appends a command's result as the shell prints it, newline-terminated,
+// or nothing for null and exit. For an error this is the message alone
+void format_result(const NexusObject& result, std::string& out);
+
+// Process exit status for a command's result: exit's status, 1 for
+// errors, otherwise 0
+int result_exit_status(const NexusObject& result);
+
+inline bool is_error_result(const NexusObject& result) {
+    return result.metadata.type_id == TypeIds::Error || result.metadata.type_id == TypeIds::JsError;
+}
+
+} // namespace Nexus
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "nexus_types.h"
+#include <string>
+#include <string_view>
+
+namespace Nexus {
+
+class NexusKernel;
+
+/**
+ * ScriptRunner - Runs commands without the terminal UI
+ * Backs `nexus -c`, `nexus script.nx` and input piped to nexus. Input is
+ * read in large blocks and split into lines; blank lines and lines
+ * starting with # are skipped. Results are collected in one buffer and
+ * written to stdout when it fills, when the run ends, or after every
+ * command when stdout is a terminal. Errors go to stderr, prefixed with
+ * the script name and line. The status is the last command's, or exit's,
+ * which also ends the run.
+ */
+class ScriptRunner {
+public:
+    explicit ScriptRunner(NexusKernel* kernel);
+    ~ScriptRunner();                        // Flushes stdout
+
+    ScriptRunner(const ScriptRunner&) = delete;
+    ScriptRunner& operator=(const ScriptRunner&) = delete;
+
+    int run_command(const std::string& line);
+    int run_file(const std::string& path);  // "-" reads stdin
+    int run_fd(int fd, const std::string& name);
+
+    int status() const { return status_; }
+    bool exited() const { return exited_; }
+
+private:
+    static constexpr size_t kReadSize = 64 * 1024;
+    static constexpr size_t kFlushSize = 64 * 1024;
+
+    NexusKernel* kernel_;
+    CommandContext context_;
+    std::string out_;
+    bool flush_each_;                       // stdout is a terminal
+    bool exited_ = false;
+    int status_ = 0;
+
+    void execute(std::string_view line, const std::string& source, size_t line_number);
+    void flush();
+};
+
+} // namespace Nexus
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Nexus {
+
+/**
+ * StartupTrace - Wall-clock timing of kernel initialization phases
+ * Phases may run concurrently on pool threads; each records its start
+ * offset from the kernel's start and its duration. report() prints the
+ * phases recorded since the previous report, so the lazily initialized
+ * JS runtime shows up as its own block when the first JS command runs.
+ */
+class StartupTrace {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Scoped phase: records from construction to destruction
+    class Phase {
+    public:
+        Phase(StartupTrace& trace, std::string name)
+            : trace_(trace), name_(std::move(name)), start_(Clock::now()) {}
+        ~Phase() { trace_.record(std::move(name_), start_, Clock::now()); }
+
+        Phase(const Phase&) = delete;
+        Phase& operator=(const Phase&) = delete;
+
+    private:
+        StartupTrace& trace_;
+        std::string name_;
+        Clock::time_point start_;
+    };
+
+    StartupTrace();
+
+    void record(std::string name, Clock::time_point start, Clock::time_point end);
+    void report(std::ostream& out, const char* title);
+    uint64_t elapsed_us() const;
+
+private:
+    struct Entry {
+        std::string name;
+        uint64_t start_us;
+        uint64_t duration_us;
+        bool main_thread;
+    };
+
+    const Clock::time_point origin_;
+    const std::thread::id main_thread_;
+
+    std::mutex mutex_;
+    std::vector<Entry> entries_;
+    size_t reported_ = 0;
+};
+
+} // namespace Nexus
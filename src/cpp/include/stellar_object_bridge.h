@@ -2,12 +2,25 @@
 
 #include "nexus_types.h"
 #include "security_context.h"
+#include "file_watcher.h"
+#include "process_snapshot.h"
+#include "child_process.h"
+#include "http_client.h"
+#include "http_download.h"
+#include "object_registry.h"
+#include "nexus_table.h"
+#include "directory_walker.h"
+#include "fs_transaction.h"
+#include "code_cache.h"
 #include <v8.h>
+#include <v8-fast-api-calls.h>
 #include <memory>
 #include <unordered_map>
 
 namespace Nexus {
 
+class IsolatePool;
+
 /**
  * StellarObjectBridge - Bi-directional C++/JavaScript object conversion
  * Handles type marshaling and provides JavaScript APIs for system operations
@@ -19,6 +32,55 @@ public:
 
     bool initialize();
 
+    // Bridge owning an isolate (registered in the isolate's data slot)
+    static StellarObjectBridge* from_isolate(v8::Isolate* isolate);
+
+    // Parallel execution backend for nexus.parallel (optional)
+    void set_isolate_pool(IsolatePool* isolate_pool) { isolate_pool_ = isolate_pool; }
+
+    // Backend for nexus.fs.watch (optional)
+    void set_file_watcher(FileWatcher* file_watcher) { file_watcher_ = file_watcher; }
+
+    // Loop driving async APIs such as nexus.proc.exec (optional)
+    void set_event_loop(uv_loop_t* event_loop) { event_loop_ = event_loop; }
+
+    // Backend for nexus.proc.list (optional)
+    void set_process_snapshots(ProcessSnapshotEngine* engine) { process_snapshots_ = engine; }
+
+    // Backend for nexus.net (optional)
+    void set_http_client(HttpClient* http_client) { http_client_ = http_client; }
+
+    // Compiled code cache for scripts run through this bridge (optional)
+    void set_code_cache(CodeCache* code_cache) { code_cache_ = code_cache; }
+
+    // Daemon requests. In between, proc.exec children and nexus.proc.env
+    // use environment ("NAME=value") instead of this process's. Ending the
+    // request cancels the timers, children, transfers and watches started
+    // meanwhile and drops their JS callbacks, so none of them runs once
+    // the client is gone
+    void begin_request(std::vector<std::string> environment);
+    void end_request();
+
+    // Environment for new child processes, as "NAME=value" entries
+    std::vector<std::string> environment() const;
+
+    // Compiles through the code cache when there is one. produce_cache is
+    // set when the caller should hand the script to update_code_cache once
+    // it has run: there was no entry, or V8 rejected it and it was dropped
+    v8::MaybeLocal<v8::Script> compile_script(v8::Local<v8::Context> context, v8::Local<v8::String> source,
+                                              uint64_t source_hash, bool& produce_cache);
+    void update_code_cache(v8::Local<v8::Script> script, uint64_t source_hash);
+
+    // Subscribes a JS callback to changes under path; returns a handle
+    // object with close(), or an empty value with a pending exception.
+    // The subscription ends with close() or when the handle is collected
+    v8::MaybeLocal<v8::Object> watch_path(const std::string& path, v8::Local<v8::Function> callback,
+                                          const FileWatcher::Options& options);
+
+    // JS table object over a native columnar result; the table is released
+    // when the object is collected. Empty with a pending exception on failure
+    v8::MaybeLocal<v8::Object> wrap_table(std::shared_ptr<NexusTable> table);
+
     // Core conversion methods
     v8::Local<v8::Value> nexus_to_js(const NexusObject& obj);
     NexusObject js_to_nexus(v8::Local<v8::Value> js_value);
@@ -32,48 +94,219 @@ public:
     v8::Local<v8::Object> create_process_api();
     v8::Local<v8::Object> create_network_api();
     v8::Local<v8::Object> create_utils_api();
+    v8::Local<v8::Object> create_parallel_api();
+
+    // Installs the global `nexus` object (fs/proc/net) and the timer
+    // functions (setTimeout, setInterval, ...) into a context
+    void install_globals(v8::Local<v8::Context> context);
+    bool run_script_file(v8::Local<v8::Context> context, const std::string& path);
 
-    // Memory management
-    void register_native_object(ObjectId id, std::shared_ptr<void> native_obj);
+    // Native callbacks referenced from JS, for V8 startup snapshots
+    static const intptr_t* external_references();
+
+    // Native objects referenced from JS. With an owner the entry is dropped
+    // when that JS object is garbage collected; ids are generation-checked,
+    // so a stale id never resolves to a newer object
+    ObjectId register_native_object(std::shared_ptr<void> native_obj);
+    ObjectId register_native_object(v8::Local<v8::Object> owner, std::shared_ptr<void> native_obj);
     void unregister_native_object(ObjectId id);
     std::shared_ptr<void> get_native_object(ObjectId id);
+    const ObjectRegistry& object_registry() const { return object_registry_; }
+
+    // Conversion limits (values visited per js_to_nexus call)
+    void set_conversion_budget(size_t max_values) { conversion_budget_ = max_values; }
+    size_t get_conversion_budget() const { return conversion_budget_; }
 
-    // Type system
-    void register_custom_type(const std::string& type_name, 
-                             std::function<v8::Local<v8::Value>(const NexusObject&)> to_js,
-                             std::function<NexusObject(v8::Local<v8::Value>)> from_js);
+    // Type system: interns type_name and returns its id for metadata.type_id
+    TypeId register_custom_type(const std::string& type_name,
+                                std::function<v8::Local<v8::Value>(const NexusObject&)> to_js,
+                                std::function<NexusObject(v8::Local<v8::Value>)> from_js);
 
 private:
+    static constexpr uint32_t kIsolateDataSlot = 0;
+
     v8::Isolate* isolate_;
     SecurityContext* security_context_;
+    IsolatePool* isolate_pool_ = nullptr;
+    FileWatcher* file_watcher_ = nullptr;
+    uv_loop_t* event_loop_ = nullptr;
+    ProcessSnapshotEngine* process_snapshots_ = nullptr;
+    HttpClient* http_client_ = nullptr;
+    CodeCache* code_cache_ = nullptr;
     
     // Object registry for memory management
-    std::unordered_map<ObjectId, std::shared_ptr<void>> native_objects_;
+    ObjectRegistry object_registry_;
+
+    // Weak JS owners of registry entries (isolate thread only)
+    struct WeakOwner {
+        StellarObjectBridge* bridge;
+        ObjectId id;
+        v8::Global<v8::Object> handle;
+    };
+    std::unordered_map<ObjectId, std::unique_ptr<WeakOwner>> weak_owners_;
+    static void on_owner_collected(const v8::WeakCallbackInfo<WeakOwner>& info);
     
+    // Constructor for table objects: internal fields hold the registry id
+    // and a cache of converted (frozen) string columns
+    static constexpr int kTableIdField = 0;
+    static constexpr int kTableColumnCacheField = 1;
+    v8::Global<v8::FunctionTemplate> table_template_;
+
+    // setTimeout/setInterval timers on event_loop_, keyed by the id returned
+    // to JS. Handles are freed by their close callback
+    struct Timer {
+        uv_timer_t handle;
+        StellarObjectBridge* bridge;
+        uint32_t id;
+        v8::Global<v8::Context> context;
+        v8::Global<v8::Function> callback;
+        std::vector<v8::Global<v8::Value>> args;
+        bool request_owned = false;         // Closed by end_request()
+    };
+    std::unordered_map<uint32_t, Timer*> timers_;
+    uint32_t next_timer_id_ = 1;
+    static void on_timer(uv_timer_t* handle);
+    void close_timer(uint32_t id);
+
+    // Open daemon request, and how to cancel the exec, net and watch work
+    // started during it. Cancelling work that already finished is harmless
+    bool in_request_ = false;
+    std::vector<std::string> request_environment_;
+    std::vector<std::function<void()>> request_work_;
+    void track_request_work(std::function<void()> cancel);
+
     // Type conversion registry
-    std::unordered_map<std::string, 
-        std::pair<std::function<v8::Local<v8::Value>(const NexusObject&)>,
-                  std::function<NexusObject(v8::Local<v8::Value>)>>> type_converters_;
+    struct TypeConverter {
+        std::function<v8::Local<v8::Value>(const NexusObject&)> to_js;
+        std::function<NexusObject(v8::Local<v8::Value>)> from_js;
+    };
+    std::vector<TypeConverter> type_converters_;    // Indexed by TypeId; empty entries use the default
+
+    // Structured JS -> Nexus conversion
+    static constexpr size_t kDefaultConversionBudget = 16 * 1024 * 1024;
+    static constexpr size_t kMaxConversionDepth = 256;
+    static constexpr size_t kMaxArrayReserve = 64 * 1024;   // Elements; a length can be sparse
+    size_t conversion_budget_ = kDefaultConversionBudget;
+
+    static constexpr size_t kMaxCachedShapes = 8;
+
+    // Property names of a recently seen object layout; keys are internalized
+    // strings, so identity comparison is enough to recognize the same shape
+    struct ObjectShape {
+        std::vector<v8::Global<v8::Value>> keys;
+        std::shared_ptr<const std::vector<std::string>> names;
+    };
+
+    struct ConversionState {
+        v8::Local<v8::Context> context;
+        size_t remaining;
+        std::vector<v8::Local<v8::Object>> ancestors;  // Cycle detection
+        std::vector<ObjectShape> shapes;
+        size_t next_shape_slot = 0;
+    };
+
+    NexusObject convert_js_value(v8::Local<v8::Value> js_value, ConversionState& state);
+    NexusObject convert_js_array(v8::Local<v8::Array> js_array, ConversionState& state);
+    NexusObject convert_js_typed_array(v8::Local<v8::TypedArray> typed_array);
+    NexusObject convert_js_object(v8::Local<v8::Object> js_object, ConversionState& state);
+    void consume_conversion_budget(ConversionState& state, size_t count);
 
     // JavaScript API implementations
     static void js_fs_read_file(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void js_fs_write_file(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void js_fs_list_dir(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void js_fs_stat(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void js_fs_walk(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void js_fs_watch(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void js_fs_watch_close(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void js_fs_transaction(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void js_fs_transaction_protect(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void js_fs_transaction_commit(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void js_fs_transaction_rollback(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void js_fs_transaction_stats(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static std::shared_ptr<FsTransaction> unwrap_transaction(const v8::FunctionCallbackInfo<v8::Value>& args);
+    void collect_transaction_garbage(std::shared_ptr<FsTransaction> transaction);
 
     static void js_proc_exec(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void js_proc_list(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void js_proc_kill(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void js_proc_info(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void js_proc_env(const v8::FunctionCallbackInfo<v8::Value>& args);
 
+    static void js_net_request(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void js_net_get(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void js_net_post(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void js_net_download(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void send_http_request(const v8::FunctionCallbackInfo<v8::Value>& args, const std::string& method,
+                                  v8::Local<v8::Value> url, v8::Local<v8::Value> body,
+                                  v8::Local<v8::Value> options);
+
+    // Table methods; `this` is checked by the template signature
+    static void js_table_column(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void js_table_get(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void js_table_filter(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void js_table_sort_by(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void js_table_select(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void js_table_take(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static std::shared_ptr<NexusTable> unwrap_table(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void return_table(const v8::FunctionCallbackInfo<v8::Value>& args, std::shared_ptr<NexusTable> table);
+
+    // readFile/writeFile work item for the libuv thread pool
+    struct FileTask {
+        enum Kind { Read, Write };
+        uv_work_t req;
+        Kind kind;
+        std::string path;
+        std::string data;                   // File contents read or to write
+        std::string error;
+        v8::Isolate* isolate = nullptr;
+        v8::Global<v8::Context> context;
+        v8::Global<v8::Promise::Resolver> resolver;
+
+        static void run(uv_work_t* req);    // Thread pool
+        static void done(uv_work_t* req, int status);
+        v8::Local<v8::Value> result(v8::Isolate* isolate) const;
+    };
+    static void run_file_task(const v8::FunctionCallbackInfo<v8::Value>& args, FileTask::Kind kind,
+                              std::string path, std::string data);
+
+    static void js_set_timeout(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void js_set_interval(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void js_clear_timer(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void js_queue_microtask(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void start_timer(const v8::FunctionCallbackInfo<v8::Value>& args, bool repeat);
+
+    static void js_parallel_map(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    static void js_utils_encode(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void js_utils_decode(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    // Leaf bindings called from hot JS loops: V8 Fast API variants take
+    // primitives/typed arrays only; the slow callbacks remain the fallback
+    static void js_fs_exists(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void js_fs_size(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void js_fs_read_into(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void js_utils_hash(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    static bool fast_fs_exists(v8::Local<v8::Object> receiver, const v8::FastOneByteString& path);
+    static double fast_fs_size(v8::Local<v8::Object> receiver, const v8::FastOneByteString& path);
+    static int32_t fast_fs_read_into(v8::Local<v8::Object> receiver, const v8::FastOneByteString& path,
+                                     const v8::FastApiTypedArray<uint8_t>& buffer);
+    static uint32_t fast_utils_hash(v8::Local<v8::Object> receiver, const v8::FastApiTypedArray<uint8_t>& data);
+
+    struct FastCallbacks {
+        v8::CFunction fs_exists;
+        v8::CFunction fs_size;
+        v8::CFunction fs_read_into;
+        v8::CFunction utils_hash;
+    };
+    static const FastCallbacks& fast_callbacks();
 
     // Utility methods
     void setup_default_type_converters();
     v8::Local<v8::Function> create_js_function(const char* name, v8::FunctionCallback callback);
+    v8::Local<v8::Function> create_fast_js_function(const char* name, v8::FunctionCallback callback,
+                                                    const v8::CFunction* fast_callback);
     
     // Error handling
     void throw_js_error(const std::string& message);
@@ -8,6 +8,7 @@
 #include <future>
 #include <functional>
 #include <atomic>
+#include <stdexcept>
 
 namespace Nexus {
 
@@ -28,7 +29,9 @@ public:
     size_t get_queue_size() const;
     size_t get_active_tasks() const { return active_tasks_.load(); }
 
-    // Thread pool management
+    // Thread pool management. resize() waits for running tasks and keeps the
+    // queue; shutdown() runs what is already queued, then joins the workers.
+    // resize() must not be called from a pool task.
     void resize(size_t new_size);
     void shutdown();
     bool is_shutdown() const { return shutdown_.load(); }
@@ -41,6 +44,7 @@ private:
     std::condition_variable condition_;
     std::atomic<bool> shutdown_{false};
     std::atomic<size_t> active_tasks_{0};
+    bool restarting_ = false;           // Guarded by queue_mutex_; set while resize() replaces workers
 
     void worker_thread();
 };
@@ -1,13 +1,21 @@
 #include "nexus_kernel.h"
 #include "nova_terminal_ui.h"
+#include "daemon_server.h"
+#include "script_runner.h"
 #include <iostream>
 #include <string>
 #include <csignal>
+#include <unistd.h>
 
 namespace {
     Nexus::NexusKernel* g_kernel = nullptr;
+    Nexus::DaemonServer* g_daemon = nullptr;
     
     void signal_handler(int signal) {
+        if (g_daemon) {
+            g_daemon->stop();               // run() returns and the kernel shuts down normally
+            return;
+        }
         if (g_kernel && signal == SIGINT) {
             std::cout << "\n🛑 Shutting down NexusShell...\n";
             g_kernel->shutdown();
@@ -17,13 +25,52 @@ namespace {
 }
 
 int main(int argc, char* argv[]) {
-    // Setup signal handling
-    std::signal(SIGINT, signal_handler);
+    // Writes to closed sockets surface as EPIPE instead of killing the shell
+    std::signal(SIGPIPE, SIG_IGN);
     
     try {
         // Initialize NexusShell kernel
-        std::string config_path = argc > 1 ? argv[1] : "";
+        std::string config_path;
+        std::string daemon_socket;
+        std::string command;
+        std::string script;
+        bool startup_trace = false;
+        bool daemon = false;
+        bool has_command = false;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--startup-trace") {
+                startup_trace = true;
+            } else if (arg == "--daemon") {
+                daemon = true;
+            } else if (arg == "--socket" && i + 1 < argc) {
+                daemon_socket = argv[++i];
+            } else if (arg == "--config" && i + 1 < argc) {
+                config_path = argv[++i];
+            } else if (arg == "-c" && i + 1 < argc) {
+                command = argv[++i];
+                has_command = true;
+            } else if ((arg == "-" || arg[0] != '-') && script.empty()) {
+                script = arg;
+            } else {
+                std::cerr << "Usage: nexus [--config <file>] [--startup-trace] [-c <command> | <script> | -]\n"
+                          << "       nexus [--config <file>] --daemon [--socket <path>]\n";
+                return 2;
+            }
+        }
+
+        // -c, a script, or commands piped in: no UI, banner or status messages
+        bool batch = !daemon && (has_command || !script.empty() || !isatty(STDIN_FILENO));
+        if (!batch) {
+            std::signal(SIGINT, signal_handler);
+        }
         Nexus::NexusKernel kernel(config_path);
+        if (startup_trace) {
+            kernel.set_config("startup_trace", "true");
+        }
+        if (batch) {
+            kernel.set_config("quiet", "true");
+        }
         g_kernel = &kernel;
         
         if (!kernel.initialize()) {
@@ -31,6 +78,36 @@ int main(int argc, char* argv[]) {
             return 1;
         }
         
+        if (batch) {
+            int status;
+            {
+                Nexus::ScriptRunner runner(&kernel);
+                status = has_command ? runner.run_command(command) : runner.run_file(script.empty() ? "-" : script);
+            }
+            kernel.shutdown();
+            return status;
+        }
+        
+        // Serve nexus_client invocations from this warm kernel
+        if (daemon) {
+            Nexus::DaemonServer server(&kernel);
+            std::string error;
+            if (!server.start(daemon_socket.empty() ? Nexus::default_daemon_socket() : daemon_socket, error)) {
+                std::cerr << "❌ " << error << "\n";
+                kernel.shutdown();
+                return 1;
+            }
+            // Clients should not pay for bringing up V8
+            kernel.ensure_js_runtime();
+            g_daemon = &server;
+            std::signal(SIGTERM, signal_handler);
+            std::cerr << "NexusShell daemon listening on " << server.path() << "\n";
+            server.run();
+            g_daemon = nullptr;
+            kernel.shutdown();
+            return 0;
+        }
+        
         // Initialize terminal UI
         Nexus::NovaTerminalUI terminal(&kernel);
         if (!terminal.initialize()) {
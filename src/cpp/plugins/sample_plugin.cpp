@@ -0,0 +1,97 @@
+#include "nexus_plugin.h"
+#include <cstdio>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+
+/**
+ * sample - Example native plugin
+ *
+ *   plugin load sample
+ *   wc <file>...      Lines, words and bytes, like wc(1)
+ *   fnv <text>...     64-bit FNV-1a hash of the arguments
+ */
+namespace {
+
+std::string resolve_path(const Nexus::PluginArgs& args, std::string_view path) {
+    if (!path.empty() && path.front() == '/') {
+        return std::string(path);
+    }
+    return std::string(args.working_directory()) + "/" + std::string(path);
+}
+
+bool word_count(const Nexus::PluginArgs& args, Nexus::PluginResult& result) {
+    if (args.size() == 0) {
+        return result.error("wc: missing file operand");
+    }
+    std::string output;
+    uint64_t total_lines = 0, total_words = 0, total_bytes = 0;
+    char buffer[64 * 1024];
+    for (size_t i = 0; i < args.size(); ++i) {
+        int fd = ::open(resolve_path(args, args[i]).c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return result.error("wc: cannot open " + std::string(args[i]));
+        }
+        uint64_t lines = 0, words = 0, bytes = 0;
+        bool in_word = false;
+        ssize_t n;
+        while ((n = ::read(fd, buffer, sizeof(buffer))) > 0) {
+            bytes += n;
+            for (ssize_t j = 0; j < n; ++j) {
+                char c = buffer[j];
+                bool space = c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+                lines += c == '\n';
+                words += !space && !in_word;
+                in_word = !space;
+            }
+        }
+        ::close(fd);
+        if (n < 0) {
+            return result.error("wc: read error on " + std::string(args[i]));
+        }
+        char line[128];
+        std::snprintf(line, sizeof(line), "%8llu %8llu %8llu ", static_cast<unsigned long long>(lines),
+                      static_cast<unsigned long long>(words), static_cast<unsigned long long>(bytes));
+        output += line;
+        output.append(args[i]);
+        output += "\n";
+        total_lines += lines;
+        total_words += words;
+        total_bytes += bytes;
+    }
+    if (args.size() > 1) {
+        char line[128];
+        std::snprintf(line, sizeof(line), "%8llu %8llu %8llu total\n", static_cast<unsigned long long>(total_lines),
+                      static_cast<unsigned long long>(total_words), static_cast<unsigned long long>(total_bytes));
+        output += line;
+    }
+    result.set_string(output);
+    return true;
+}
+
+bool fnv_hash(const Nexus::PluginArgs& args, Nexus::PluginResult& result) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < args.size(); ++i) {
+        if (i > 0) {
+            hash = (hash ^ ' ') * 1099511628211ull;
+        }
+        for (unsigned char c : args[i]) {
+            hash = (hash ^ c) * 1099511628211ull;
+        }
+    }
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+    result.set_string(hex);
+    return true;
+}
+
+class SamplePlugin : public Nexus::Plugin {
+public:
+    bool initialize(Nexus::PluginHost& host) override {
+        return host.register_command("wc", word_count) && host.register_command("fnv", fnv_hash);
+    }
+};
+
+} // namespace
+
+NEXUS_PLUGIN_EXPORT(SamplePlugin, "sample", "1.0.0")
@@ -0,0 +1,126 @@
+#include "stellar_object_bridge.h"
+#include <libplatform/libplatform.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+/**
+ * nexus_bridge_bench - Bulk array conversion between JS and NexusObjects
+ *
+ * Builds large JS arrays (all numbers, and numbers followed by strings so
+ * the fast prefix hands over to the generic path) and times
+ * js_array_to_nexus and nexus_array_to_js over them. Also checks that the
+ * fast path stamps elements exactly like js_to_nexus.
+ *
+ * Usage: nexus_bridge_bench [elements] [rounds]
+ *        nexus_bridge_bench 1000000 5
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+v8::Local<v8::Array> run_array_script(v8::Local<v8::Context> context, const std::string& source) {
+    v8::Isolate* isolate = context->GetIsolate();
+    v8::Local<v8::String> code = v8::String::NewFromUtf8(isolate, source.c_str()).ToLocalChecked();
+    v8::Local<v8::Script> script = v8::Script::Compile(context, code).ToLocalChecked();
+    return script->Run(context).ToLocalChecked().As<v8::Array>();
+}
+
+double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void report(const char* label, double milliseconds, uint32_t elements) {
+    std::cout << label << ": " << milliseconds << " ms, " << milliseconds * 1e6 / elements << " ns/element\n";
+}
+
+// Best of rounds, so one GC pause does not decide the result
+bool bench_array(Nexus::StellarObjectBridge& bridge, v8::Local<v8::Context> context, const char* label,
+                 const std::string& source, uint32_t elements, int rounds) {
+    v8::Isolate* isolate = context->GetIsolate();
+    double to_nexus = 1e300;
+    double to_js = 1e300;
+    for (int round = 0; round < rounds; ++round) {
+        v8::HandleScope handle_scope(isolate);
+        v8::Local<v8::Array> array = run_array_script(context, source);
+
+        auto start = Clock::now();
+        std::vector<Nexus::NexusObject> objects = bridge.js_array_to_nexus(array);
+        to_nexus = std::min(to_nexus, elapsed_ms(start));
+        if (objects.size() != elements) {
+            std::cerr << label << ": converted " << objects.size() << " of " << elements << " elements\n";
+            return false;
+        }
+        for (const Nexus::NexusObject& obj : {objects.front(), objects.back()}) {
+            if (obj.metadata.id == 0 || obj.metadata.created_at != obj.metadata.id) {
+                std::cerr << label << ": element without metadata\n";
+                return false;
+            }
+        }
+
+        start = Clock::now();
+        v8::Local<v8::Array> back = bridge.nexus_array_to_js(objects);
+        to_js = std::min(to_js, elapsed_ms(start));
+        if (back->Length() != elements) {
+            std::cerr << label << ": built " << back->Length() << " of " << elements << " elements\n";
+            return false;
+        }
+    }
+    std::cout << label << " (" << elements << " elements, best of " << rounds << ")\n";
+    report("  js_array_to_nexus", to_nexus, elements);
+    report("  nexus_array_to_js", to_js, elements);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const uint32_t elements = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 1000000;
+    const int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+    if (elements < 2 || rounds < 1) {
+        std::cerr << "Usage: " << argv[0] << " [elements >= 2] [rounds >= 1]\n";
+        return 1;
+    }
+
+    v8::V8::InitializeICUDefaultLocation(argv[0]);
+    v8::V8::InitializeExternalStartupData(argv[0]);
+    std::unique_ptr<v8::Platform> platform = v8::platform::NewDefaultPlatform();
+    v8::V8::InitializePlatform(platform.get());
+    v8::V8::Initialize();
+
+    std::unique_ptr<v8::ArrayBuffer::Allocator> allocator(
+        v8::ArrayBuffer::Allocator::NewDefaultAllocator()
+    );
+    v8::Isolate::CreateParams create_params;
+    create_params.array_buffer_allocator = allocator.get();
+    v8::Isolate* isolate = v8::Isolate::New(create_params);
+
+    bool ok;
+    {
+        v8::Isolate::Scope isolate_scope(isolate);
+        v8::HandleScope handle_scope(isolate);
+        v8::Local<v8::Context> context = v8::Context::New(isolate);
+        v8::Context::Scope context_scope(context);
+
+        // Conversions never consult the security context
+        Nexus::StellarObjectBridge bridge(isolate, nullptr);
+        if (!bridge.initialize()) {
+            std::cerr << "Failed to initialize object bridge\n";
+            return 1;
+        }
+
+        const std::string n = std::to_string(elements);
+        ok = bench_array(bridge, context, "numbers",
+                         "Array.from({length: " + n + "}, (_, i) => i % 3 ? i : i + 0.5)", elements, rounds) &&
+             bench_array(bridge, context, "numbers then strings",
+                         "Array.from({length: " + n + "}, (_, i) => i < " + n + " / 2 ? i : 'v' + i)",
+                         elements, rounds);
+    }
+
+    isolate->Dispose();
+    v8::V8::Dispose();
+    v8::V8::DisposePlatform();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+#include "stellar_object_bridge.h"
+#include <libplatform/libplatform.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+
+/**
+ * nexus_fastcall_bench - Per-call overhead of the hot nexus.* bindings
+ *
+ * Calls nexus.fs.exists/size/readInto and nexus.utils.hash in tight JS
+ * loops, long enough for TurboFan to optimize them, and reports the time
+ * per call next to an empty JS function call. With --slow, V8's Fast API
+ * calls are disabled, so the same loops go through the
+ * FunctionCallbackInfo fallbacks instead.
+ *
+ * Usage: nexus_fastcall_bench [iterations] [--slow]
+ *        nexus_fastcall_bench 10000000
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Case {
+    const char* label;
+    const char* call;                       // Loop body; `i` is the counter
+};
+
+// The loop keeps a running sum so the calls cannot be optimized away
+bool run_case(v8::Local<v8::Context> context, const Case& bench, uint64_t iterations) {
+    v8::Isolate* isolate = context->GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    v8::TryCatch try_catch(isolate);
+
+    std::string source = "(function (n) { let sum = 0; for (let i = 0; i < n; ++i) { sum += +(" +
+                         std::string(bench.call) + "); } return sum; })";
+    v8::Local<v8::String> code = v8::String::NewFromUtf8(isolate, source.c_str()).ToLocalChecked();
+    v8::Local<v8::Script> script;
+    v8::Local<v8::Value> function;
+    if (!v8::Script::Compile(context, code).ToLocal(&script) || !script->Run(context).ToLocal(&function)) {
+        v8::String::Utf8Value error(isolate, try_catch.Exception());
+        std::cerr << bench.label << ": " << (*error ? *error : "compile error") << "\n";
+        return false;
+    }
+
+    // Warm up so the timed run measures optimized code
+    v8::Local<v8::Value> warmup[] = {v8::Number::New(isolate, static_cast<double>(iterations / 10 + 1))};
+    v8::Local<v8::Value> timed[] = {v8::Number::New(isolate, static_cast<double>(iterations))};
+    v8::Local<v8::Value> result;
+    if (function.As<v8::Function>()->Call(context, v8::Undefined(isolate), 1, warmup).IsEmpty()) {
+        v8::String::Utf8Value error(isolate, try_catch.Exception());
+        std::cerr << bench.label << ": " << (*error ? *error : "call failed") << "\n";
+        return false;
+    }
+    auto start = Clock::now();
+    if (!function.As<v8::Function>()->Call(context, v8::Undefined(isolate), 1, timed).ToLocal(&result)) {
+        v8::String::Utf8Value error(isolate, try_catch.Exception());
+        std::cerr << bench.label << ": " << (*error ? *error : "call failed") << "\n";
+        return false;
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    std::cout << bench.label << ": " << ns / static_cast<double>(iterations) << " ns/call\n";
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint64_t iterations = 10000000;
+    bool slow = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--slow") == 0) {
+            slow = true;
+        } else {
+            iterations = std::strtoull(argv[i], nullptr, 10);
+        }
+    }
+    if (iterations == 0) {
+        std::cerr << "Usage: " << argv[0] << " [iterations] [--slow]\n";
+        return 1;
+    }
+
+    if (slow) {
+        v8::V8::SetFlagsFromString("--no-turbo-fast-api-calls");
+    }
+    v8::V8::InitializeICUDefaultLocation(argv[0]);
+    v8::V8::InitializeExternalStartupData(argv[0]);
+    std::unique_ptr<v8::Platform> platform = v8::platform::NewDefaultPlatform();
+    v8::V8::InitializePlatform(platform.get());
+    v8::V8::Initialize();
+
+    std::unique_ptr<v8::ArrayBuffer::Allocator> allocator(
+        v8::ArrayBuffer::Allocator::NewDefaultAllocator()
+    );
+    v8::Isolate::CreateParams create_params;
+    create_params.array_buffer_allocator = allocator.get();
+    v8::Isolate* isolate = v8::Isolate::New(create_params);
+
+    bool ok = true;
+    {
+        v8::Isolate::Scope isolate_scope(isolate);
+        v8::HandleScope handle_scope(isolate);
+        v8::Local<v8::Context> context = v8::Context::New(isolate);
+        v8::Context::Scope context_scope(context);
+
+        // The leaf bindings never consult the security context
+        Nexus::StellarObjectBridge bridge(isolate, nullptr);
+        if (!bridge.initialize()) {
+            std::cerr << "Failed to initialize object bridge\n";
+            return 1;
+        }
+        bridge.install_globals(context);
+
+        // Files the loops touch: this binary, and a small buffer to hash
+        v8::Local<v8::Object> global = context->Global();
+        global->Set(context, v8::String::NewFromUtf8Literal(isolate, "self"),
+                    v8::String::NewFromUtf8(isolate, argv[0]).ToLocalChecked()).Check();
+        v8::Local<v8::ArrayBuffer> bytes = v8::ArrayBuffer::New(isolate, 64);
+        global->Set(context, v8::String::NewFromUtf8Literal(isolate, "bytes"),
+                    v8::Uint8Array::New(bytes, 0, 64)).Check();
+        global->Set(context, v8::String::NewFromUtf8Literal(isolate, "noop"),
+                    v8::Function::New(context, [](const v8::FunctionCallbackInfo<v8::Value>&) {}).ToLocalChecked())
+            .Check();
+
+        std::cout << (slow ? "Fast API calls disabled" : "Fast API calls enabled") << ", " << iterations
+                  << " iterations\n";
+        const Case cases[] = {
+            {"js function", "((x) => x)(i)"},
+            {"native noop (generic path)", "noop(i)"},
+            {"nexus.fs.exists", "nexus.fs.exists(self)"},
+            {"nexus.fs.size", "nexus.fs.size(self)"},
+            {"nexus.fs.readInto (64 B)", "nexus.fs.readInto(self, bytes)"},
+            {"nexus.utils.hash (64 B)", "nexus.utils.hash(bytes)"},
+        };
+        for (const Case& bench : cases) {
+            ok = run_case(context, bench, iterations) && ok;
+        }
+    }
+
+    isolate->Dispose();
+    v8::V8::Dispose();
+    v8::V8::DisposePlatform();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,768 @@
+#include "http_client.h"
+#include "http_download.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * nexus_http_test - HttpClient against an in-process loopback server
+ *
+ * Starts a small scripted HTTP/1.1 server on 127.0.0.1 in the same libuv
+ * loop and checks the client's wire behaviour end to end: keep-alive
+ * reuse, chunked bodies split across reads, pipelining, close-delimited
+ * bodies, retrying on a connection the server dropped, request bodies,
+ * bodiless responses and timeouts. Then drives HttpDownload through the
+ * same server: streaming to disk with backpressure, progress, Range
+ * resume of an interrupted transfer, the atomic rename over the old file,
+ * redirects and HTTP errors. Exits with 1 if any case fails.
+ *
+ * Usage: nexus_http_test
+ */
+namespace {
+
+struct ServerRequest {
+    std::string method;
+    std::string target;
+    Nexus::HttpHeaders headers;             // Names lowercased
+    std::string body;
+
+    std::string header(const std::string& lowercase_name) const {
+        for (const auto& [name, value] : headers) {
+            if (name == lowercase_name) {
+                return value;
+            }
+        }
+        return "";
+    }
+};
+
+// Pieces are written in order; with trickle set, one per loop tick so the
+// client sees them in separate reads
+struct Reply {
+    std::vector<std::string> pieces;
+    bool trickle = false;
+    bool close = false;                     // Drop the connection once written
+};
+
+// Returns false to leave the request unanswered
+using Handler = std::function<bool(const ServerRequest& request, Reply& reply)>;
+
+class LoopbackServer {
+public:
+    Handler handler;
+    size_t hold_until = 1;                  // Answer once this many requests are queued
+    int accepted = 0;
+
+    explicit LoopbackServer(uv_loop_t* loop) : loop_(loop) {}
+
+    bool listen() {
+        uv_tcp_init(loop_, &listener_);
+        listener_.data = this;
+        sockaddr_in address{};
+        uv_ip4_addr("127.0.0.1", 0, &address);
+        if (uv_tcp_bind(&listener_, reinterpret_cast<const sockaddr*>(&address), 0) != 0 ||
+            uv_listen(reinterpret_cast<uv_stream_t*>(&listener_), 16, on_connection) != 0) {
+            return false;
+        }
+        int length = sizeof(address);
+        uv_tcp_getsockname(&listener_, reinterpret_cast<sockaddr*>(&address), &length);
+        port_ = ntohs(address.sin_port);
+        return true;
+    }
+
+    std::string url(const std::string& target) const {
+        return "http://127.0.0.1:" + std::to_string(port_) + target;
+    }
+
+    void reset() {
+        handler = nullptr;
+        hold_until = 1;
+        accepted = 0;
+    }
+
+    void close() {
+        uv_close(reinterpret_cast<uv_handle_t*>(&listener_), nullptr);
+        std::vector<Session*> sessions = sessions_;
+        for (Session* session : sessions) {
+            close_session(*session);
+        }
+    }
+
+private:
+    struct Session {
+        LoopbackServer* server = nullptr;
+        uv_tcp_t tcp;
+        uv_timer_t timer;
+        int open_handles = 2;
+        bool closing = false;
+        std::string input;
+        std::deque<ServerRequest> pending;
+        std::deque<std::string> output;
+        bool trickle = false;
+        bool close_after_output = false;
+        size_t writes_in_flight = 0;
+        char read_buffer[16 * 1024];
+    };
+
+    struct Write {
+        uv_write_t req;
+        Session* session;
+        std::string data;
+    };
+
+    uv_loop_t* loop_;
+    uv_tcp_t listener_;
+    uint16_t port_ = 0;
+    std::vector<Session*> sessions_;
+
+    // Splits complete requests off the input; bodies need Content-Length
+    void parse(Session& session) {
+        for (;;) {
+            size_t head_end = session.input.find("\r\n\r\n");
+            if (head_end == std::string::npos) {
+                return;
+            }
+            std::string head = session.input.substr(0, head_end + 2);
+            ServerRequest request;
+            for (size_t begin = head.find("\r\n") + 2; begin < head.size();) {
+                size_t end = head.find("\r\n", begin);
+                size_t colon = head.find(':', begin);
+                if (colon < end) {
+                    std::string name = head.substr(begin, colon - begin);
+                    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+                    size_t value = head.find_first_not_of(' ', colon + 1);
+                    request.headers.emplace_back(name, head.substr(value, end - value));
+                }
+                begin = end + 2;
+            }
+            size_t body_length = std::strtoul(request.header("content-length").c_str(), nullptr, 10);
+            if (session.input.size() < head_end + 4 + body_length) {
+                return;
+            }
+
+            size_t method_end = head.find(' ');
+            size_t target_end = head.find(' ', method_end + 1);
+            request.method = head.substr(0, method_end);
+            request.target = head.substr(method_end + 1, target_end - method_end - 1);
+            request.body = session.input.substr(head_end + 4, body_length);
+            session.input.erase(0, head_end + 4 + body_length);
+            session.pending.push_back(std::move(request));
+        }
+    }
+
+    void answer(Session& session) {
+        if (session.pending.size() < hold_until) {
+            return;
+        }
+        while (!session.pending.empty() && !session.close_after_output) {
+            ServerRequest request = std::move(session.pending.front());
+            session.pending.pop_front();
+            Reply reply;
+            if (!handler || !handler(request, reply)) {
+                continue;
+            }
+            session.output.insert(session.output.end(), reply.pieces.begin(), reply.pieces.end());
+            session.trickle |= reply.trickle;
+            session.close_after_output = reply.close;
+        }
+        if (session.trickle) {
+            uv_timer_start(&session.timer, on_tick, 1, 1);
+        } else {
+            while (!session.output.empty()) {
+                write_front(session);
+            }
+        }
+        finish_output(session);
+    }
+
+    void write_front(Session& session) {
+        auto* write = new Write{{}, &session, std::move(session.output.front())};
+        session.output.pop_front();
+        write->req.data = write;
+        uv_buf_t buffer = uv_buf_init(write->data.data(), static_cast<unsigned int>(write->data.size()));
+        ++session.writes_in_flight;
+        if (uv_write(&write->req, reinterpret_cast<uv_stream_t*>(&session.tcp), &buffer, 1, on_write) != 0) {
+            --session.writes_in_flight;
+            delete write;
+        }
+    }
+
+    void finish_output(Session& session) {
+        if (session.output.empty()) {
+            session.trickle = false;
+            uv_timer_stop(&session.timer);
+            if (session.close_after_output && session.writes_in_flight == 0) {
+                close_session(session);
+            }
+        }
+    }
+
+    void close_session(Session& session) {
+        if (session.closing) {
+            return;
+        }
+        session.closing = true;
+        sessions_.erase(std::remove(sessions_.begin(), sessions_.end(), &session), sessions_.end());
+        auto on_close = [](uv_handle_t* handle) {
+            auto* closed = static_cast<Session*>(handle->data);
+            if (--closed->open_handles == 0) {
+                delete closed;
+            }
+        };
+        uv_close(reinterpret_cast<uv_handle_t*>(&session.tcp), on_close);
+        uv_close(reinterpret_cast<uv_handle_t*>(&session.timer), on_close);
+    }
+
+    static void on_connection(uv_stream_t* listener, int status) {
+        auto* server = static_cast<LoopbackServer*>(listener->data);
+        if (status != 0) {
+            return;
+        }
+        auto* session = new Session;
+        session->server = server;
+        session->tcp.data = session;
+        session->timer.data = session;
+        uv_tcp_init(server->loop_, &session->tcp);
+        uv_timer_init(server->loop_, &session->timer);
+        server->sessions_.push_back(session);
+        if (uv_accept(listener, reinterpret_cast<uv_stream_t*>(&session->tcp)) != 0) {
+            server->close_session(*session);
+            return;
+        }
+        ++server->accepted;
+        uv_read_start(reinterpret_cast<uv_stream_t*>(&session->tcp), on_alloc, on_read);
+    }
+
+    static void on_alloc(uv_handle_t* handle, size_t, uv_buf_t* buf) {
+        auto* session = static_cast<Session*>(handle->data);
+        *buf = uv_buf_init(session->read_buffer, sizeof(session->read_buffer));
+    }
+
+    static void on_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+        auto* session = static_cast<Session*>(stream->data);
+        if (session->closing) {
+            return;
+        }
+        if (nread < 0) {
+            session->server->close_session(*session);
+            return;
+        }
+        session->input.append(buf->base, static_cast<size_t>(nread));
+        session->server->parse(*session);
+        session->server->answer(*session);
+    }
+
+    static void on_write(uv_write_t* req, int) {
+        auto* write = static_cast<Write*>(req->data);
+        Session& session = *write->session;
+        delete write;
+        --session.writes_in_flight;
+        if (!session.closing) {
+            session.server->finish_output(session);
+        }
+    }
+
+    static void on_tick(uv_timer_t* timer) {
+        auto* session = static_cast<Session*>(timer->data);
+        if (!session->output.empty()) {
+            session->server->write_front(*session);
+        }
+        session->server->finish_output(*session);
+    }
+};
+
+struct Response {
+    bool done = false;
+    std::string error;
+    int status = 0;
+    std::string body;
+    std::function<void()> on_done;          // Runs inside the completion callback
+};
+
+// Starts a request whose outcome lands in response
+void start(Nexus::HttpClient& client, const std::string& url, Response& response,
+           const std::string& method = "GET", const std::string& body = "", uint64_t timeout_ms = 5000) {
+    Nexus::HttpClient::Request request;
+    std::string error;
+    if (!Nexus::HttpUrl::parse(url, request.url, error)) {
+        response.done = true;
+        response.error = error;
+        return;
+    }
+    request.method = method;
+    request.body = body;
+    request.timeout_ms = timeout_ms;
+    request.on_head = [&response](const Nexus::HttpResponseHead& head) { response.status = head.status; };
+    request.on_body = [&response](const char* data, size_t length) { response.body.append(data, length); };
+    request.on_complete = [&response](const std::string& error) {
+        response.error = error;
+        response.done = true;
+        if (response.on_done) {
+            response.on_done();
+        }
+    };
+    client.send(std::move(request));
+}
+
+void run_until(uv_loop_t* loop, const std::function<bool()>& done) {
+    while (!done() && uv_run(loop, UV_RUN_ONCE) != 0) {
+    }
+}
+
+Response fetch(uv_loop_t* loop, Nexus::HttpClient& client, const std::string& url,
+               const std::string& method = "GET", const std::string& body = "", uint64_t timeout_ms = 5000) {
+    Response response;
+    start(client, url, response, method, body, timeout_ms);
+    run_until(loop, [&] { return response.done; });
+    return response;
+}
+
+std::string length_reply(const std::string& body, const std::string& extra_headers = "") {
+    return "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(body.size()) + "\r\n" + extra_headers +
+           "\r\n" + body;
+}
+
+// Each case gets a fresh client so its counters start at zero, and an
+// empty directory for downloads
+struct Fixture {
+    uv_loop_t* loop;
+    LoopbackServer& server;
+    Nexus::HttpClient& client;
+    std::string dir;
+};
+
+bool expect(bool condition, const std::string& what, std::string& failure) {
+    if (!condition && failure.empty()) {
+        failure = what;
+    }
+    return condition;
+}
+
+bool ok_body(const Response& response, const std::string& body, std::string& failure) {
+    return expect(response.error.empty(), "request failed: " + response.error, failure) &&
+           expect(response.status == 200, "status " + std::to_string(response.status), failure) &&
+           expect(response.body == body, "body \"" + response.body + "\", expected \"" + body + "\"", failure);
+}
+
+std::string test_keep_alive(Fixture& f) {
+    std::string failure;
+    f.server.handler = [](const ServerRequest& request, Reply& reply) {
+        reply.pieces = {length_reply("hello " + request.target)};
+        return true;
+    };
+    ok_body(fetch(f.loop, f.client, f.server.url("/a")), "hello /a", failure);
+    ok_body(fetch(f.loop, f.client, f.server.url("/b")), "hello /b", failure);
+    expect(f.client.get_connections_opened() == 1, "second request opened a new connection", failure);
+    expect(f.client.get_connections_reused() == 1, "connection reuse not counted", failure);
+    expect(f.server.accepted == 1, "server accepted " + std::to_string(f.server.accepted), failure);
+    return failure;
+}
+
+std::string test_chunked_split(Fixture& f) {
+    std::string failure;
+    f.server.handler = [](const ServerRequest& request, Reply& reply) {
+        if (request.target == "/chunked") {
+            reply.pieces = {"HTTP/1.1 200 OK\r\nTransfer-", "Encoding: chunked\r\n\r\n", "5\r\nhel", "lo\r",
+                            "\n6;ext=1\r\n worl", "d\r\n0\r\n", "X-Trailer: 1\r\n", "\r\n"};
+            reply.trickle = true;
+        } else {
+            reply.pieces = {length_reply("after")};
+        }
+        return true;
+    };
+    ok_body(fetch(f.loop, f.client, f.server.url("/chunked")), "hello world", failure);
+    ok_body(fetch(f.loop, f.client, f.server.url("/next")), "after", failure);
+    expect(f.client.get_connections_opened() == 1, "chunked response was not reusable", failure);
+    return failure;
+}
+
+std::string test_pipelining(Fixture& f) {
+    std::string failure;
+    f.server.handler = [](const ServerRequest& request, Reply& reply) {
+        reply.pieces = {length_reply(request.target)};
+        return true;
+    };
+    ok_body(fetch(f.loop, f.client, f.server.url("/warm")), "/warm", failure);
+
+    // Answered only once all three are queued, so they must share the socket
+    f.server.hold_until = 3;
+    Response responses[3];
+    for (int i = 0; i < 3; ++i) {
+        start(f.client, f.server.url("/p" + std::to_string(i)), responses[i], "GET", "", 2000);
+    }
+    run_until(f.loop, [&] { return responses[0].done && responses[1].done && responses[2].done; });
+    for (int i = 0; i < 3; ++i) {
+        ok_body(responses[i], "/p" + std::to_string(i), failure);
+    }
+    expect(f.server.accepted == 1, "pipelined requests used " + std::to_string(f.server.accepted) +
+                                   " connections", failure);
+    return failure;
+}
+
+std::string test_close_delimited(Fixture& f) {
+    std::string failure;
+    f.server.handler = [](const ServerRequest&, Reply& reply) {
+        reply.pieces = {"HTTP/1.1 200 OK\r\nConnection: close\r\n\r\n", "until ", "close"};
+        reply.trickle = true;
+        reply.close = true;
+        return true;
+    };
+    ok_body(fetch(f.loop, f.client, f.server.url("/close")), "until close", failure);
+    return failure;
+}
+
+std::string test_stale_retry(Fixture& f) {
+    std::string failure;
+    // Looks reusable, but the server drops it right after the response
+    f.server.handler = [](const ServerRequest& request, Reply& reply) {
+        reply.pieces = {length_reply(request.target)};
+        reply.close = request.target == "/stale";
+        return true;
+    };
+
+    // Sent from the completion callback, before the client can see the close
+    Response first, second;
+    first.on_done = [&] { start(f.client, f.server.url("/retried"), second); };
+    start(f.client, f.server.url("/stale"), first);
+    run_until(f.loop, [&] { return first.done && second.done; });
+    ok_body(first, "/stale", failure);
+    ok_body(second, "/retried", failure);
+    expect(f.client.get_connections_opened() == 2, "retry did not use a fresh connection", failure);
+    return failure;
+}
+
+std::string test_request_body(Fixture& f) {
+    std::string failure;
+    f.server.handler = [](const ServerRequest& request, Reply& reply) {
+        reply.pieces = {length_reply(request.method + " " + request.body)};
+        return true;
+    };
+    std::string payload(100000, 'x');
+    ok_body(fetch(f.loop, f.client, f.server.url("/echo"), "POST", payload), "POST " + payload, failure);
+    ok_body(fetch(f.loop, f.client, f.server.url("/echo"), "POST"), "POST ", failure);
+    return failure;
+}
+
+std::string test_bodiless(Fixture& f) {
+    std::string failure;
+    f.server.handler = [](const ServerRequest& request, Reply& reply) {
+        if (request.method == "HEAD") {
+            reply.pieces = {"HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\n"};
+        } else if (request.target == "/empty") {
+            reply.pieces = {"HTTP/1.1 204 No Content\r\n\r\n"};
+        } else {
+            reply.pieces = {length_reply("full")};
+        }
+        return true;
+    };
+    ok_body(fetch(f.loop, f.client, f.server.url("/head"), "HEAD"), "", failure);
+    Response empty = fetch(f.loop, f.client, f.server.url("/empty"));
+    expect(empty.error.empty() && empty.status == 204 && empty.body.empty(), "204 response", failure);
+    ok_body(fetch(f.loop, f.client, f.server.url("/full")), "full", failure);
+    expect(f.client.get_connections_opened() == 1, "bodiless responses broke keep-alive", failure);
+    return failure;
+}
+
+std::string test_request_line_injection(Fixture& f) {
+    std::string failure;
+    std::vector<std::string> targets;
+    f.server.handler = [&targets](const ServerRequest& request, Reply& reply) {
+        targets.push_back(request.target);
+        reply.pieces = {length_reply(request.method)};
+        return true;
+    };
+
+    Nexus::HttpUrl url;
+    std::string error;
+    expect(!Nexus::HttpUrl::parse(f.server.url("/a b"), url, error), "URL with a space parsed", failure);
+    expect(!Nexus::HttpUrl::parse(f.server.url("/a\r\nX-Injected: 1"), url, error), "URL with CRLF parsed",
+           failure);
+
+    // Refused without a callback: nothing may reach the shared connection
+    Nexus::HttpClient::Request request;
+    Nexus::HttpUrl::parse(f.server.url("/"), request.url, error);
+    bool called = false;
+    request.on_complete = [&called](const std::string&) { called = true; };
+    request.method = "GET / HTTP/1.1\r\nHost: x\r\n\r\nGET /smuggled";
+    expect(f.client.send(request) == 0, "method with CRLF was sent", failure);
+    request.method = "GET";
+    request.url.target = "/x HTTP/1.1\r\n\r\nGET /smuggled";
+    expect(f.client.send(request) == 0, "target with CRLF was sent", failure);
+    expect(!Nexus::HttpClient::valid_method("GE T"), "method with a space is valid", failure);
+    expect(Nexus::HttpClient::valid_method("M-SEARCH"), "M-SEARCH is not a valid method", failure);
+
+    ok_body(fetch(f.loop, f.client, f.server.url("/after")), "GET", failure);
+    expect(!called, "refused request called back", failure);
+    expect(targets.size() == 1 && targets[0] == "/after", "server saw " + std::to_string(targets.size()) +
+                                                          " requests", failure);
+    return failure;
+}
+
+std::string test_bad_content_length(Fixture& f) {
+    std::string failure;
+    f.server.handler = [](const ServerRequest&, Reply& reply) {
+        reply.pieces = {"HTTP/1.1 200 OK\r\nContent-Length: 5x\r\n\r\nhello"};
+        return true;
+    };
+    Response response = fetch(f.loop, f.client, f.server.url("/bad"));
+    expect(response.error == "Malformed HTTP response", "error \"" + response.error + "\"", failure);
+    return failure;
+}
+
+std::string test_timeout(Fixture& f) {
+    std::string failure;
+    f.server.handler = [](const ServerRequest&, Reply&) { return false; };
+    Response response = fetch(f.loop, f.client, f.server.url("/never"), "GET", "", 100);
+    expect(response.error == "Request timed out", "error \"" + response.error + "\"", failure);
+    return failure;
+}
+
+struct DownloadRun {
+    bool done = false;
+    std::string error;
+    Nexus::HttpDownload::Result result;
+    std::vector<Nexus::HttpDownload::Progress> progress;
+};
+
+DownloadRun download(Fixture& f, const std::string& target, const std::string& path) {
+    DownloadRun run;
+    Nexus::HttpDownload::Options options;
+    if (!Nexus::HttpUrl::parse(f.server.url(target), options.url, run.error)) {
+        return run;
+    }
+    options.path = path;
+    options.timeout_ms = 10000;
+    options.progress_interval_ms = 0;
+    int status = Nexus::HttpDownload::start(
+        f.loop, &f.client, options,
+        [&run](const Nexus::HttpDownload::Progress& progress) { run.progress.push_back(progress); },
+        [&run](const std::string& error, const Nexus::HttpDownload::Result& result) {
+            run.error = error;
+            run.result = result;
+            run.done = true;
+        });
+    if (status != 0) {
+        run.error = uv_strerror(status);
+        return run;
+    }
+    run_until(f.loop, [&] { return run.done; });
+    return run;
+}
+
+// Deterministic bytes, so a misplaced range shows up as a mismatch
+std::string make_content(size_t size) {
+    std::string content(size, '\0');
+    for (size_t i = 0; i < size; ++i) {
+        content[i] = static_cast<char>((i * 131 + i / 251) & 0xff);
+    }
+    return content;
+}
+
+std::string read_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void write_file(const std::string& path, const std::string& content) {
+    std::ofstream(path, std::ios::binary) << content;
+}
+
+// Serves content, honouring "Range: bytes=<first>-" when ranges is set
+Handler serve(const std::string& content, bool ranges) {
+    return [content, ranges](const ServerRequest& request, Reply& reply) {
+        std::string range = request.header("range");
+        if (ranges && range.compare(0, 6, "bytes=") == 0) {
+            size_t first = std::strtoul(range.c_str() + 6, nullptr, 10);
+            if (first >= content.size()) {
+                reply.pieces = {"HTTP/1.1 416 Range Not Satisfiable\r\nContent-Length: 0\r\n\r\n"};
+                return true;
+            }
+            reply.pieces = {"HTTP/1.1 206 Partial Content\r\nContent-Range: bytes " + std::to_string(first) + "-" +
+                            std::to_string(content.size() - 1) + "/" + std::to_string(content.size()) +
+                            "\r\nContent-Length: " + std::to_string(content.size() - first) + "\r\n\r\n" +
+                            content.substr(first)};
+            return true;
+        }
+        reply.pieces = {length_reply(content)};
+        return true;
+    };
+}
+
+bool ok_download(const DownloadRun& run, const std::string& path, const std::string& content,
+                 std::string& failure) {
+    return expect(run.error.empty(), "download failed: " + run.error, failure) &&
+           expect(run.result.bytes == content.size(), "result has " + std::to_string(run.result.bytes) +
+                                                      " bytes", failure) &&
+           expect(read_file(path) == content, "file content differs", failure) &&
+           expect(!std::filesystem::exists(path + ".part"), ".part file left behind", failure);
+}
+
+std::string test_download_stream(Fixture& f) {
+    std::string failure;
+    // Several times the download's buffers, so the socket gets paused
+    std::string content = make_content(5 * 1024 * 1024 + 17);
+    f.server.handler = serve(content, false);
+    std::string path = f.dir + "/stream.bin";
+    DownloadRun run = download(f, "/stream.bin", path);
+    if (!ok_download(run, path, content, failure)) {
+        return failure;
+    }
+    expect(run.result.status == 200 && !run.result.resumed, "unexpected status or resume", failure);
+    expect(!run.progress.empty() && run.progress.back().bytes == content.size() &&
+           run.progress.back().total == content.size(), "last progress report is not complete", failure);
+    for (size_t i = 1; i < run.progress.size(); ++i) {
+        expect(run.progress[i].bytes >= run.progress[i - 1].bytes, "progress went backwards", failure);
+    }
+    return failure;
+}
+
+std::string test_download_resume(Fixture& f) {
+    std::string failure;
+    std::string content = make_content(2 * 1024 * 1024);
+    std::string path = f.dir + "/resume.bin";
+    write_file(path, "old version");
+
+    // The connection drops halfway: the prefix stays in .part, the old file stays put
+    std::string head = "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(content.size()) + "\r\n\r\n";
+    size_t half = content.size() / 2;
+    f.server.handler = [&](const ServerRequest&, Reply& reply) {
+        reply.pieces = {head, content.substr(0, half)};
+        reply.close = true;
+        return true;
+    };
+    DownloadRun interrupted = download(f, "/resume.bin", path);
+    expect(!interrupted.error.empty(), "truncated transfer reported success", failure);
+    expect(read_file(path) == "old version", "destination replaced by a partial file", failure);
+    expect(read_file(path + ".part") == content.substr(0, half), ".part does not hold the received prefix",
+           failure);
+
+    std::string range;
+    Handler ranged = serve(content, true);
+    f.server.handler = [&](const ServerRequest& request, Reply& reply) {
+        range = request.header("range");
+        return ranged(request, reply);
+    };
+    DownloadRun resumed = download(f, "/resume.bin", path);
+    ok_download(resumed, path, content, failure);
+    expect(range == "bytes=" + std::to_string(half) + "-", "Range header \"" + range + "\"", failure);
+    expect(resumed.result.status == 206 && resumed.result.resumed, "transfer was not resumed", failure);
+    expect(!resumed.progress.empty() && resumed.progress.front().bytes >= half,
+           "progress did not count the resumed bytes", failure);
+    return failure;
+}
+
+std::string test_download_range_fallbacks(Fixture& f) {
+    std::string failure;
+    std::string content = make_content(300000);
+
+    // Range ignored: the full body replaces the stale prefix
+    std::string path = f.dir + "/ignored.bin";
+    write_file(path + ".part", "stale prefix");
+    f.server.handler = serve(content, false);
+    DownloadRun ignored = download(f, "/ignored.bin", path);
+    ok_download(ignored, path, content, failure);
+    expect(!ignored.result.resumed, "full response counted as resumed", failure);
+
+    // 416: the .part is longer than the resource, so start over
+    path = f.dir + "/shrunk.bin";
+    write_file(path + ".part", make_content(400000));
+    f.server.handler = serve(content, true);
+    ok_download(download(f, "/shrunk.bin", path), path, content, failure);
+    return failure;
+}
+
+std::string test_download_redirect_and_errors(Fixture& f) {
+    std::string failure;
+    std::string content = make_content(1000);
+    Handler file = serve(content, true);
+    f.server.handler = [&](const ServerRequest& request, Reply& reply) {
+        if (request.target == "/moved") {
+            reply.pieces = {"HTTP/1.1 302 Found\r\nLocation: /target.bin\r\nContent-Length: 0\r\n\r\n"};
+        } else if (request.target == "/target.bin") {
+            return file(request, reply);
+        } else {
+            reply.pieces = {"HTTP/1.1 404 Not Found\r\nContent-Length: 9\r\n\r\nnot found"};
+        }
+        return true;
+    };
+
+    std::string path = f.dir + "/redirected.bin";
+    ok_download(download(f, "/moved", path), path, content, failure);
+
+    path = f.dir + "/missing.bin";
+    DownloadRun missing = download(f, "/missing.bin", path);
+    expect(missing.error == "HTTP 404 Not Found", "error \"" + missing.error + "\"", failure);
+    expect(!std::filesystem::exists(path) && !std::filesystem::exists(path + ".part"),
+           "failed download left files behind", failure);
+    return failure;
+}
+
+} // namespace
+
+int main() {
+    uv_loop_t loop;
+    uv_loop_init(&loop);
+    LoopbackServer server(&loop);
+    if (!server.listen()) {
+        std::cerr << "Cannot listen on 127.0.0.1\n";
+        return 1;
+    }
+    char dir[] = "/tmp/nexus-http-XXXXXX";
+    if (!::mkdtemp(dir)) {
+        std::cerr << "Cannot create a temporary directory: " << std::strerror(errno) << "\n";
+        return 1;
+    }
+
+    struct Case {
+        const char* name;
+        std::string (*run)(Fixture&);
+    };
+    const Case cases[] = {
+        {"keep-alive reuse", test_keep_alive},
+        {"chunked body split across reads", test_chunked_split},
+        {"pipelining", test_pipelining},
+        {"close-delimited body", test_close_delimited},
+        {"retry on a dropped keep-alive connection", test_stale_retry},
+        {"request bodies", test_request_body},
+        {"HEAD and 204 responses", test_bodiless},
+        {"request timeout", test_timeout},
+        {"request line injection", test_request_line_injection},
+        {"unparsable Content-Length", test_bad_content_length},
+        {"download streams to disk", test_download_stream},
+        {"download resumes after a dropped connection", test_download_resume},
+        {"download without usable ranges", test_download_range_fallbacks},
+        {"download redirects and HTTP errors", test_download_redirect_and_errors},
+    };
+
+    int failed = 0;
+    for (const Case& test : cases) {
+        server.reset();
+        std::string failure;
+        {
+            Nexus::HttpClient client(&loop);
+            Fixture fixture{&loop, server, client, dir};
+            failure = test.run(fixture);
+        }
+        uv_run(&loop, UV_RUN_NOWAIT);       // Let both ends close their sockets
+        std::cout << (failure.empty() ? "PASS " : "FAIL ") << test.name
+                  << (failure.empty() ? "" : ": " + failure) << "\n";
+        failed += !failure.empty();
+    }
+
+    server.close();
+    uv_run(&loop, UV_RUN_DEFAULT);
+    uv_loop_close(&loop);
+    std::filesystem::remove_all(dir);
+    std::cout << (sizeof(cases) / sizeof(cases[0]) - failed) << " passed, " << failed << " failed\n";
+    return failed ? 1 : 0;
+}
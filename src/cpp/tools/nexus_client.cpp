@@ -0,0 +1,72 @@
+#include "daemon_protocol.h"
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+extern char** environ;
+
+/**
+ * nexus_client - Runs a command in a running `nexus --daemon`
+ *
+ * Forwards its arguments, working directory, environment and stdio to the
+ * daemon, which writes the command's output straight to this process's
+ * stdout and stderr, and exits with the command's status. It links
+ * neither V8 nor libuv, so an invocation costs a connect and a round trip.
+ *
+ * Usage: nexus_client <command> [args...]
+ *        nexus_client -c "<command line>"
+ * The socket is $NEXUS_DAEMON_SOCKET or the daemon's default.
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <command> [args...] | " << argv[0] << " -c <command line>\n";
+        return 2;
+    }
+
+    Nexus::DaemonRequest request;
+    request.argv.assign(argv + 1, argv + argc);
+    char cwd[PATH_MAX];
+    if (!::getcwd(cwd, sizeof(cwd))) {
+        std::cerr << "nexus_client: cannot determine the working directory: " << std::strerror(errno) << "\n";
+        return 1;
+    }
+    request.cwd = cwd;
+    for (char** variable = environ; *variable; ++variable) {
+        request.environment.emplace_back(*variable);
+    }
+    request.fds[0] = STDIN_FILENO;
+    request.fds[1] = STDOUT_FILENO;
+    request.fds[2] = STDERR_FILENO;
+
+    std::string path = Nexus::default_daemon_socket();
+    struct sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "nexus_client: socket path too long: " << path << "\n";
+        return 1;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0) {
+        std::cerr << "nexus_client: no daemon at " << path << " (" << std::strerror(errno)
+                  << "); start one with `nexus --daemon`\n";
+        return 1;
+    }
+
+    std::string error;
+    if (!Nexus::send_daemon_request(fd, request, error)) {
+        std::cerr << "nexus_client: " << error << "\n";
+        return 1;
+    }
+    int32_t status;
+    if (!Nexus::receive_daemon_status(fd, status)) {
+        std::cerr << "nexus_client: the daemon closed the connection without a status\n";
+        return 1;
+    }
+    return status;
+}
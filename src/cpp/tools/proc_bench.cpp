@@ -0,0 +1,160 @@
+#include "process_snapshot.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+/**
+ * nexus_proc_bench - CPU cost of monitoring a host with many processes
+ *
+ * Runs the loop behind nexus.proc.monitor, one ProcessSnapshotEngine scan
+ * per interval, and reports the CPU time it used as a share of wall time.
+ * By default it scans a generated /proc with the requested number of
+ * processes, so a 10k-process host can be checked anywhere. With --proc
+ * it scans a real proc filesystem instead. Exits with 1 when the share is
+ * above the budget.
+ *
+ * Usage: nexus_proc_bench [processes] [interval_ms] [seconds] [budget%] [--proc /proc]
+ *        nexus_proc_bench 10000 1000 10 5
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+bool write_file(const std::string& path, const std::string& content) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = ::write(fd, content.data(), content.size()) == static_cast<ssize_t>(content.size());
+    ::close(fd);
+    return ok;
+}
+
+// Every fake process reuses this process's stat line with its own pid, so
+// the parser sees the real field layout
+bool generate_proc(const std::string& root, int processes, std::string& error) {
+    char self_stat[1024];
+    int fd = ::open("/proc/self/stat", O_RDONLY | O_CLOEXEC);
+    ssize_t length = fd >= 0 ? ::read(fd, self_stat, sizeof(self_stat) - 1) : -1;
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    const char* after_pid = length > 0 ? static_cast<const char*>(std::memchr(self_stat, ' ', length)) : nullptr;
+    if (!after_pid) {
+        error = "Cannot read /proc/self/stat";
+        return false;
+    }
+    std::string stat_tail(after_pid, static_cast<size_t>(self_stat + length - after_pid));
+
+    std::error_code ec;
+    std::filesystem::create_directories(root, ec);
+    if (ec || !write_file(root + "/uptime", "123456.78 234567.89\n")) {
+        error = "Cannot create " + root;
+        return false;
+    }
+    for (int pid = 1; pid <= processes; ++pid) {
+        std::string dir = root + "/" + std::to_string(pid);
+        std::string uid = std::to_string(1000 + pid % 7);
+        if (::mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+            error = "Cannot create " + dir + ": " + std::strerror(errno);
+            return false;
+        }
+        if (!write_file(dir + "/stat", std::to_string(pid) + stat_tail) ||
+            !write_file(dir + "/status", "Name:\tworker\nState:\tS (sleeping)\nUid:\t" + uid + "\t" + uid +
+                                             "\t" + uid + "\t" + uid + "\n") ||
+            !write_file(dir + "/cmdline", std::string("worker\0--id\0", 12) + std::to_string(pid))) {
+            error = "Cannot write " + dir;
+            return false;
+        }
+    }
+    return true;
+}
+
+double cpu_seconds() {
+    struct rusage usage;
+    ::getrusage(RUSAGE_SELF, &usage);
+    auto seconds = [](const struct timeval& tv) { return tv.tv_sec + tv.tv_usec / 1e6; };
+    return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string proc_root;
+    double positional[4] = {10000, 1000, 10, 1};
+    int count = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--proc") == 0 && i + 1 < argc) {
+            proc_root = argv[++i];
+        } else if (count < 4) {
+            positional[count++] = std::strtod(argv[i], nullptr);
+        }
+    }
+    const int processes = static_cast<int>(positional[0]);
+    const int interval_ms = static_cast<int>(positional[1]);
+    const int seconds = static_cast<int>(positional[2]);
+    const double budget_percent = positional[3];
+    if (processes <= 0 || interval_ms <= 0 || seconds <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [processes] [interval_ms] [seconds] [budget%] [--proc /proc]\n";
+        return 1;
+    }
+
+    std::string generated;
+    if (proc_root.empty()) {
+        char temp[] = "/tmp/nexus-proc-XXXXXX";
+        if (!::mkdtemp(temp)) {
+            std::cerr << "Cannot create a temporary directory: " << std::strerror(errno) << "\n";
+            return 1;
+        }
+        generated = proc_root = temp;
+        std::string error;
+        if (!generate_proc(proc_root, processes, error)) {
+            std::cerr << error << "\n";
+            std::filesystem::remove_all(generated);
+            return 1;
+        }
+    }
+
+    Nexus::ThreadPool thread_pool;
+    Nexus::ProcessSnapshotEngine engine(&thread_pool, proc_root);
+
+    // The first scan reads every file; monitors pay it once
+    auto start = Clock::now();
+    size_t rows = engine.scan()->size();
+    double first_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    double cpu_start = cpu_seconds();
+    start = Clock::now();
+    auto next = start;
+    double slowest_ms = 0;
+    while (Clock::now() - start < std::chrono::seconds(seconds)) {
+        next += std::chrono::milliseconds(interval_ms);
+        std::this_thread::sleep_until(next);
+        auto scan_start = Clock::now();
+        rows = engine.scan()->size();
+        double scan_ms = std::chrono::duration<double, std::milli>(Clock::now() - scan_start).count();
+        slowest_ms = std::max(slowest_ms, scan_ms);
+    }
+    double wall = std::chrono::duration<double>(Clock::now() - start).count();
+    double cpu_percent = (cpu_seconds() - cpu_start) / wall * 100.0;
+
+    std::cout << rows << " processes in " << proc_root << ", one scan every " << interval_ms << " ms\n"
+              << "first scan: " << first_ms << " ms, slowest steady scan: " << slowest_ms << " ms\n"
+              << "cpu: " << cpu_percent << "% of one core (budget " << budget_percent << "%)\n";
+
+    if (!generated.empty()) {
+        std::filesystem::remove_all(generated);
+    }
+    return cpu_percent <= budget_percent ? 0 : 1;
+}
@@ -0,0 +1,84 @@
+#include "stellar_object_bridge.h"
+#include <libplatform/libplatform.h>
+#include <iostream>
+#include <fstream>
+#include <memory>
+
+/**
+ * nexus_snapshot_gen - Build-time generator for the V8 startup snapshot
+ *
+ * Creates a context with the `nexus` native APIs installed, evaluates
+ * nexus-runtime.js in it and serializes the result, so the shell can
+ * deserialize a ready context instead of rebuilding it on every start.
+ *
+ * Usage: nexus_snapshot_gen <nexus-runtime.js> <output.blob>
+ */
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <nexus-runtime.js> <output.blob>\n";
+        return 1;
+    }
+
+    v8::V8::InitializeICUDefaultLocation(argv[0]);
+    v8::V8::InitializeExternalStartupData(argv[0]);
+    std::unique_ptr<v8::Platform> platform = v8::platform::NewDefaultPlatform();
+    v8::V8::InitializePlatform(platform.get());
+    v8::V8::Initialize();
+
+    std::unique_ptr<v8::ArrayBuffer::Allocator> allocator(
+        v8::ArrayBuffer::Allocator::NewDefaultAllocator()
+    );
+
+    v8::StartupData blob{nullptr, 0};
+    {
+        v8::Isolate::CreateParams create_params;
+        create_params.array_buffer_allocator = allocator.get();
+        create_params.external_references = Nexus::StellarObjectBridge::external_references();
+
+        v8::SnapshotCreator creator(create_params);
+        v8::Isolate* isolate = creator.GetIsolate();
+        {
+            v8::HandleScope handle_scope(isolate);
+            v8::Local<v8::Context> context = v8::Context::New(isolate);
+            v8::Context::Scope context_scope(context);
+
+            // The native APIs do not touch the security context while being
+            // installed, so the generator does not need one
+            Nexus::StellarObjectBridge bridge(isolate, nullptr);
+            if (!bridge.initialize()) {
+                std::cerr << "Failed to initialize object bridge\n";
+                return 1;
+            }
+
+            bridge.install_globals(context);
+            if (!bridge.run_script_file(context, argv[1])) {
+                std::cerr << "Failed to evaluate " << argv[1] << "\n";
+                return 1;
+            }
+
+            creator.SetDefaultContext(context);
+        }
+
+        // Keep compiled runtime functions so the first JS command does not
+        // have to recompile them
+        blob = creator.CreateBlob(v8::SnapshotCreator::FunctionCodeHandling::kKeep);
+    }
+
+    if (!blob.data || blob.raw_size <= 0) {
+        std::cerr << "Failed to create startup snapshot\n";
+        return 1;
+    }
+
+    std::ofstream output(argv[2], std::ios::binary | std::ios::trunc);
+    output.write(blob.data, blob.raw_size);
+    delete[] blob.data;
+
+    if (!output.good()) {
+        std::cerr << "Failed to write " << argv[2] << "\n";
+        return 1;
+    }
+
+    v8::V8::Dispose();
+    v8::V8::DisposePlatform();
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include "stellar_object_bridge.h"
+#include <libplatform/libplatform.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+/**
+ * nexus_startup_bench - Time to a usable JS context, with and without the snapshot
+ *
+ * Repeats what the kernel does before the first JS command: create the
+ * isolate and context, set up the object bridge, and either install the
+ * nexus globals and evaluate nexus-runtime.js or deserialize them from the
+ * startup snapshot. Each round ends with one script touching `nexus`, so
+ * lazily deserialized functions are counted as well.
+ *
+ * Usage: nexus_startup_bench <nexus-runtime.js> <nexus_snapshot.blob> [rounds]
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Microseconds to a context where `nexus` is ready; negative on failure
+double start_once(v8::ArrayBuffer::Allocator* allocator, const v8::StartupData* snapshot,
+                  const std::string& runtime_path) {
+    auto start = Clock::now();
+
+    v8::Isolate::CreateParams create_params;
+    create_params.array_buffer_allocator = allocator;
+    create_params.external_references = Nexus::StellarObjectBridge::external_references();
+    create_params.snapshot_blob = snapshot;
+    v8::Isolate* isolate = v8::Isolate::New(create_params);
+
+    bool ok;
+    {
+        v8::Isolate::Scope isolate_scope(isolate);
+        v8::HandleScope handle_scope(isolate);
+        v8::Local<v8::Context> context = v8::Context::New(isolate);
+        v8::Context::Scope context_scope(context);
+
+        Nexus::StellarObjectBridge bridge(isolate, nullptr);
+        ok = bridge.initialize();
+        if (ok && !snapshot) {
+            bridge.install_globals(context);
+            ok = bridge.run_script_file(context, runtime_path);
+        }
+
+        v8::Local<v8::String> probe = v8::String::NewFromUtf8Literal(isolate, "typeof nexus.fs.stat");
+        v8::Local<v8::Script> script;
+        v8::Local<v8::Value> result;
+        ok = ok && v8::Script::Compile(context, probe).ToLocal(&script) &&
+             script->Run(context).ToLocal(&result) &&
+             result->StrictEquals(v8::String::NewFromUtf8Literal(isolate, "function"));
+    }
+    double elapsed = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    isolate->Dispose();
+    return ok ? elapsed : -1;
+}
+
+// Median of rounds, so one slow round does not decide the result
+bool report(const char* label, v8::ArrayBuffer::Allocator* allocator, const v8::StartupData* snapshot,
+            const std::string& runtime_path, int rounds) {
+    std::vector<double> samples;
+    for (int round = 0; round < rounds; ++round) {
+        double elapsed = start_once(allocator, snapshot, runtime_path);
+        if (elapsed < 0) {
+            std::cerr << label << ": context setup failed\n";
+            return false;
+        }
+        samples.push_back(elapsed);
+    }
+    std::sort(samples.begin(), samples.end());
+    std::cout << label << ": median " << samples[samples.size() / 2] << " us, min " << samples.front()
+              << " us, max " << samples.back() << " us over " << rounds << " rounds\n";
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <nexus-runtime.js> <nexus_snapshot.blob> [rounds]\n";
+        return 1;
+    }
+    const std::string runtime_path = argv[1];
+    const int rounds = argc > 3 ? std::max(1, std::atoi(argv[3])) : 20;
+
+    std::ifstream snapshot_file(argv[2], std::ios::binary);
+    std::vector<char> blob((std::istreambuf_iterator<char>(snapshot_file)), std::istreambuf_iterator<char>());
+    v8::StartupData snapshot{blob.data(), static_cast<int>(blob.size())};
+
+    v8::V8::InitializeICUDefaultLocation(argv[0]);
+    v8::V8::InitializeExternalStartupData(argv[0]);
+    std::unique_ptr<v8::Platform> platform = v8::platform::NewDefaultPlatform();
+    v8::V8::InitializePlatform(platform.get());
+    v8::V8::Initialize();
+
+    if (blob.empty() || !snapshot.IsValid()) {
+        std::cerr << "Not a startup snapshot for this V8 build: " << argv[2] << "\n";
+        return 1;
+    }
+
+    std::unique_ptr<v8::ArrayBuffer::Allocator> allocator(
+        v8::ArrayBuffer::Allocator::NewDefaultAllocator()
+    );
+    bool ok = report("from scratch", allocator.get(), nullptr, runtime_path, rounds) &&
+              report("from snapshot", allocator.get(), &snapshot, runtime_path, rounds);
+
+    v8::V8::Dispose();
+    v8::V8::DisposePlatform();
+    return ok ? 0 : 1;
+}
@@ -58,69 +58,96 @@ class NexusFileSystem {
     }
     
     /**
-     * Watch filesystem changes
+     * Watch filesystem changes; callback receives batches of {type, path}
+     * events. Options: {recursive, debounce (ms)}. Returns a handle with close()
      */
-    watch(path, callback) {
-        return this._bridge.watch(path, callback);
+    watch(path, callback, options = {}) {
+        return this._bridge.watch(path, callback, options);
     }
     
     /**
-     * Find files with advanced filtering
+     * Check whether a path exists (native fast call, safe in hot loops)
+     */
+    exists(path) {
+        return this._bridge.exists(path);
+    }
+    
+    /**
+     * File size in bytes, or -1 if the path cannot be stat'ed
+     */
+    size(path) {
+        return this._bridge.size(path);
+    }
+    
+    /**
+     * Get file statistics; an array of paths returns a FileTable with one
+     * row per path (type 'missing' for paths that cannot be stat'ed)
+     */
+    stat(path) {
+        if (Array.isArray(path)) {
+            return new FileTable(this._bridge.stat(path), this._bridge);
+        }
+        return this._bridge.stat(path);
+    }
+    
+    /**
+     * List a directory as a FileTable: name, type, size, mode, mtime
+     */
+    ls(path = '.') {
+        return new FileTable(this._bridge.listDir(path), this._bridge);
+    }
+    
+    /**
+     * Read the start of a file into a caller-owned Uint8Array
+     */
+    readInto(path, buffer) {
+        return this._bridge.readInto(path, buffer);
+    }
+    
+    /**
+     * Recursive native walk as a FileTable (path, name, type, size, mode,
+     * mtime, depth); spec filters are applied before rows reach JS:
+     * {name, iname (globs), type, size, mtime ({gt, gte, lt, lte, eq}),
+     *  minDepth, maxDepth, limit}
+     */
+    walk(path = '.', spec = {}) {
+        return new FileTable(this._bridge.walk(path, spec), this._bridge);
+    }
+    
+    /**
+     * Find files with advanced filtering. Strings and glob-like regexes are
+     * matched natively during the walk; functions run on the survivors
      */
     async find(pattern, options = {}) {
-        const startPath = options.path || '.';
         const maxDepth = options.maxDepth || 10;
-        const type = options.type; // 'file', 'directory', or undefined for both
+        let dir = this.dir(options.path || '.').recursive(maxDepth + 1);
         
-        const results = [];
-        
-        async function searchDirectory(dirPath, depth) {
-            if (depth > maxDepth) return;
-            
-            try {
-                const entries = await this._bridge.listDir(dirPath);
-                
-                for (const entry of entries) {
-                    const fullPath = `${dirPath}/${entry.name}`;
-                    
-                    // Apply type filter
-                    if (type && ((type === 'file' && !entry.isFile) || 
-                                (type === 'directory' && !entry.isDirectory))) {
-                        continue;
-                    }
-                    
-                    // Apply pattern matching
-                    if (typeof pattern === 'string') {
-                        if (entry.name.includes(pattern)) {
-                            results.push(fullPath);
-                        }
-                    } else if (pattern instanceof RegExp) {
-                        if (pattern.test(entry.name)) {
-                            results.push(fullPath);
-                        }
-                    } else if (typeof pattern === 'function') {
-                        if (pattern(entry)) {
-                            results.push(fullPath);
-                        }
-                    }
-                    
-                    // Recurse into directories
-                    if (entry.isDirectory) {
-                        await searchDirectory(fullPath, depth + 1);
-                    }
-                }
-            } catch (error) {
-                // Ignore permission errors and continue
-            }
+        const filter = {};
+        if (typeof pattern === 'string') {
+            filter.name = `*${NexusDirectory.escapeGlob(pattern)}*`;
+        } else if (pattern instanceof RegExp) {
+            filter.name = pattern;
+        }
+        if (options.type) {
+            filter.type = options.type;
+        }
+        dir = dir.filter(filter);
+        if (typeof pattern === 'function') {
+            dir = dir.filter(pattern);
         }
         
-        await searchDirectory.call(this, startPath, 0);
-        return results;
+        try {
+            return [...(await dir.table()).column('path')];
+        } catch (error) {
+            return []; // Unreadable start directory
+        }
     }
 }
 
 /**
- * Directory object with chainable operations
+ * Directory object with chainable operations. Filters given as objects
+ * ({name, type, size, mtime, depth}) are pushed into the native walker;
+ * function filters run in JS on the entries that survive them
  */
 class NexusDirectory {
     constructor(path, bridge) {
@@ -128,36 +155,159 @@ class NexusDirectory {
         this._bridge = bridge;
         this._filters = [];
         this._transforms = [];
+        this._maxDepth = 1;
     }
     
     /**
      * List directory contents
      */
     async list() {
-        const entries = await this._bridge.listDir(this.path);
-        return this._applyFiltersAndTransforms(entries);
+        const table = await this.table();
+        return this._applyTransforms(table.toArray());
+    }
+    
+    /**
+     * Filtered contents as a FileTable, for native filter/sortBy/select
+     */
+    async table() {
+        const { spec, residual } = NexusDirectory.planWalk(this._filters, this._maxDepth);
+        const table = new FileTable(this._bridge.walk(this.path, spec), this._bridge);
+        if (residual.length === 0) {
+            return table;
+        }
+        return table.filter(entry => residual.every(predicate => predicate(entry)));
     }
     
     /**
-     * Filter directory entries
+     * Include subdirectories down to maxDepth (children are depth 1)
+     */
+    recursive(maxDepth = Infinity) {
+        return this._derive({ maxDepth });
+    }
+    
+    /**
+     * Filter directory entries with a function or a pushable object such as
+     * { name: '*.log', type: 'file', size: { gt: 1024 }, mtime: { gte: t } }
      */
     filter(predicate) {
-        const newDir = new NexusDirectory(this.path, this._bridge);
-        newDir._filters = [...this._filters, predicate];
-        newDir._transforms = [...this._transforms];
-        return newDir;
+        return this._derive({ filters: [...this._filters, predicate] });
     }
     
     /**
      * Transform directory entries
      */
     map(transform) {
+        return this._derive({ transforms: [...this._transforms, transform] });
+    }
+    
+    _derive({ filters = this._filters, transforms = this._transforms, maxDepth = this._maxDepth }) {
         const newDir = new NexusDirectory(this.path, this._bridge);
-        newDir._filters = [...this._filters];
-        newDir._transforms = [...this._transforms, transform];
+        newDir._filters = filters;
+        newDir._transforms = transforms;
+        newDir._maxDepth = maxDepth;
         return newDir;
     }
     
+    /**
+     * Split filters into a native walk spec and the predicates left for JS.
+     * All filters must hold, so their order does not matter
+     */
+    static planWalk(filters, maxDepth) {
+        const spec = { name: [], iname: [], size: [], mtime: [], minDepth: 1, maxDepth };
+        const residual = [];
+        let types = null;
+        
+        for (const filter of filters) {
+            if (typeof filter === 'function') {
+                residual.push(filter);
+                continue;
+            }
+            for (const [key, value] of Object.entries(filter)) {
+                switch (key) {
+                    case 'name': {
+                        const glob = typeof value === 'string' ? value : NexusDirectory.regexToGlob(value);
+                        if (glob === null) {
+                            residual.push(entry => value.test(entry.name));
+                        } else if (value instanceof RegExp && value.flags === 'i') {
+                            spec.iname.push(glob);
+                        } else {
+                            spec.name.push(glob);
+                        }
+                        break;
+                    }
+                    case 'type': {
+                        const allowed = [].concat(value);
+                        types = types ? types.filter(type => allowed.includes(type)) : allowed;
+                        break;
+                    }
+                    case 'size':
+                    case 'mtime':
+                        spec[key].push(value);
+                        break;
+                    case 'depth': {
+                        const range = typeof value === 'number' ? { eq: value } : value;
+                        if (range.eq !== undefined) {
+                            spec.minDepth = Math.max(spec.minDepth, range.eq);
+                            spec.maxDepth = Math.min(spec.maxDepth, range.eq);
+                        }
+                        if (range.gt !== undefined) spec.minDepth = Math.max(spec.minDepth, Math.floor(range.gt) + 1);
+                        if (range.gte !== undefined) spec.minDepth = Math.max(spec.minDepth, Math.ceil(range.gte));
+                        if (range.lt !== undefined) spec.maxDepth = Math.min(spec.maxDepth, Math.ceil(range.lt) - 1);
+                        if (range.lte !== undefined) spec.maxDepth = Math.min(spec.maxDepth, Math.floor(range.lte));
+                        break;
+                    }
+                    default:
+                        throw new TypeError(`Unknown directory filter: ${key}`);
+                }
+            }
+        }
+        
+        if (types) {
+            spec.type = types;
+        }
+        return { spec, residual };
+    }
+    
+    /**
+     * Glob equivalent of a regex made of literals, '.', '.*' and anchors
+     * (flags: none or 'i'), or null when it has no exact glob form
+     */
+    static regexToGlob(regex) {
+        if (!(regex instanceof RegExp) || (regex.flags !== '' && regex.flags !== 'i')) {
+            return null;
+        }
+        let source = regex.source;
+        const anchoredStart = source.startsWith('^');
+        const anchoredEnd = source.endsWith('$') && !source.endsWith('\\$');
+        source = source.slice(anchoredStart ? 1 : 0, anchoredEnd ? -1 : undefined);
+        
+        let glob = '';
+        for (let i = 0; i < source.length; i++) {
+            const c = source[i];
+            if (c === '\\') {
+                const next = source[++i];
+                if (next === undefined || /[a-zA-Z0-9]/.test(next)) {
+                    return null; // Classes such as \d, backreferences
+                }
+                glob += NexusDirectory.escapeGlob(next);
+            } else if (c === '.' && source[i + 1] === '*') {
+                glob += '*';
+                i++;
+            } else if (c === '.') {
+                glob += '?';
+            } else if ('^$*+?()[]{}|'.includes(c)) {
+                return null;
+            } else {
+                glob += NexusDirectory.escapeGlob(c);
+            }
+        }
+        return (anchoredStart ? '' : '*') + glob + (anchoredEnd ? '' : '*');
+    }
+    
+    static escapeGlob(text) {
+        return text.replace(/[*?[\\]/g, '\\$&');
+    }
+    
     /**
      * Execute callback for each entry
      */
@@ -170,14 +320,11 @@ class NexusDirectory {
      * Get total size of directory
      */
     async size() {
-        const entries = await this._bridge.listDir(this.path);
+        const files = (await this.table()).filter('type', '==', 'file');
         let totalSize = 0;
         
-        for (const entry of entries) {
-            if (entry.isFile) {
-                const stat = await this._bridge.stat(`${this.path}/${entry.name}`);
-                totalSize += stat.size;
-            }
+        for (const size of files.column('size')) {
+            totalSize += size;
         }
         
         return totalSize;
@@ -213,15 +360,10 @@ class NexusDirectory {
         return csvRows.join('\n');
     }
     
-    async _applyFiltersAndTransforms(entries) {
+    async _applyTransforms(entries) {
         let result = entries;
         
-        // Apply filters
-        for (const filter of this._filters) {
-            result = result.filter(filter);
-        }
-        
-        // Apply transforms
+        // Filters were applied by table()
         for (const transform of this._transforms) {
             result = result.map(transform);
         }
@@ -271,8 +413,8 @@ class NexusFile {
     /**
      * Watch file for changes
      */
-    watch(callback) {
-        return this._bridge.watch(this.path, callback);
+    watch(callback, options = {}) {
+        return this._bridge.watch(this.path, callback, options);
     }
     
     /**
@@ -335,25 +477,57 @@ class NexusProcess {
     }
     
     /**
-     * Execute command with advanced options
+     * Execute command with advanced options. Resolves to a ProcessResult;
+     * the returned promise also exposes `stdout` and `stderr` as async
+     * iterables of output chunks, e.g.
+     *   for await (const chunk of nexus.proc.exec('make').stdout) { ... }
+     * Streams must be accessed before awaiting to receive every chunk.
      */
-    async exec(command, options = {}) {
-        const result = await this._bridge.exec(command, {
+    exec(command, options = {}) {
+        const streams = {};
+        const pending = this._bridge.exec(command, {
             timeout: options.timeout || 30000,
             cwd: options.cwd,
             env: options.env,
-            capture: true
+            args: options.args,
+            encoding: options.encoding,
+            capture: options.capture !== false,
+            onStdout: chunk => streams.stdout && streams.stdout.push(chunk),
+            onStderr: chunk => streams.stderr && streams.stderr.push(chunk)
+        }).then(result => {
+            streams.stdout && streams.stdout.end();
+            streams.stderr && streams.stderr.end();
+            return new ProcessResult(result, command);
+        }, error => {
+            streams.stdout && streams.stdout.fail(error);
+            streams.stderr && streams.stderr.fail(error);
+            throw error;
         });
         
-        return new ProcessResult(result, command);
+        // Chunks are only buffered for streams somebody asked for
+        Object.defineProperty(pending, 'stdout', {
+            get: () => streams.stdout || (streams.stdout = new ChunkQueue())
+        });
+        Object.defineProperty(pending, 'stderr', {
+            get: () => streams.stderr || (streams.stderr = new ChunkQueue())
+        });
+        return pending;
     }
     
     /**
-     * List processes with filtering
+     * Environment proc.exec children get, as {NAME: value}; the client's
+     * under `nexus --daemon`. Each access returns a fresh copy
      */
-    async list() {
-        const processes = await this._bridge.list();
-        return new ProcessList(processes, this._bridge);
+    get env() {
+        return this._bridge.env();
+    }
+    
+    /**
+     * List processes with filtering. Options: {maxAge} reuses a native
+     * snapshot younger than maxAge milliseconds instead of rescanning /proc
+     */
+    async list(options = {}) {
+        return new ProcessList(await this._bridge.list(options), this._bridge);
     }
     
     /**
@@ -383,7 +557,8 @@ class NexusProcess {
     monitor(callback, interval = 1000) {
         const monitor = setInterval(async () => {
             try {
-                const processes = await this.list();
+                // Monitors sharing an interval share one scan
+                const processes = await this.list({ maxAge: Math.floor(interval / 2) });
                 callback(processes);
             } catch (error) {
                 callback(null, error);
@@ -397,64 +572,201 @@ class NexusProcess {
 }
 
 /**
- * Process list with chainable operations
+ * Async iterable queue of chunks pushed by native callbacks
+ */
+class ChunkQueue {
+    constructor() {
+        this._chunks = [];
+        this._waiters = [];
+        this._done = false;
+        this._error = null;
+    }
+    
+    push(chunk) {
+        const waiter = this._waiters.shift();
+        if (waiter) {
+            waiter.resolve({ value: chunk, done: false });
+        } else {
+            this._chunks.push(chunk);
+        }
+    }
+    
+    end() {
+        this._done = true;
+        for (const waiter of this._waiters.splice(0)) {
+            waiter.resolve({ value: undefined, done: true });
+        }
+    }
+    
+    fail(error) {
+        this._error = error;
+        this._done = true;
+        for (const waiter of this._waiters.splice(0)) {
+            waiter.reject(error);
+        }
+    }
+    
+    next() {
+        if (this._chunks.length > 0) {
+            return Promise.resolve({ value: this._chunks.shift(), done: false });
+        }
+        if (this._error) {
+            return Promise.reject(this._error);
+        }
+        if (this._done) {
+            return Promise.resolve({ value: undefined, done: true });
+        }
+        return new Promise((resolve, reject) => this._waiters.push({ resolve, reject }));
+    }
+    
+    [Symbol.asyncIterator]() {
+        return this;
+    }
+}
+
+/**
+ * Columnar result (ps, ls, stat) backed by native memory. Numeric columns
+ * are copied into a new Float64Array per column() call, string columns
+ * converted once into a frozen array, and filter/sortBy/select run
+ * natively; row objects are only built on demand
  */
-class ProcessList {
-    constructor(processes, bridge) {
-        this.processes = processes;
+class NexusTable {
+    constructor(native, bridge) {
+        this._native = native;
         this._bridge = bridge;
+        this._rows = null;
     }
     
-    filter(predicate) {
-        return new ProcessList(this.processes.filter(predicate), this._bridge);
+    get length() {
+        return this._native.length;
     }
     
-    map(transform) {
-        return new ProcessList(this.processes.map(transform), this._bridge);
+    get columns() {
+        return this._native.columns;
     }
     
-    sortBy(key, direction = 'asc') {
-        const sorted = [...this.processes].sort((a, b) => {
-            const aVal = a[key];
-            const bVal = b[key];
-            
-            if (direction === 'asc') {
-                return aVal < bVal ? -1 : aVal > bVal ? 1 : 0;
-            } else {
-                return aVal > bVal ? -1 : aVal < bVal ? 1 : 0;
-            }
-        });
-        
-        return new ProcessList(sorted, this._bridge);
+    /**
+     * Float64Array (a private copy) for numeric columns, frozen array of
+     * strings otherwise
+     */
+    column(name) {
+        return this._native.column(name);
     }
     
-    async killAll(signal = 'SIGTERM') {
-        const results = [];
-        for (const proc of this.processes) {
-            try {
-                await this._bridge.kill(proc.pid, signal);
-                results.push({ pid: proc.pid, success: true });
-            } catch (error) {
-                results.push({ pid: proc.pid, success: false, error: error.message });
+    get(row, name) {
+        return this._native.get(row, name);
+    }
+    
+    /**
+     * filter(column, op, value) runs natively, e.g. filter('cpu', '>', 5) or
+     * filter('name', 'glob', 'ssh*'); filter(predicate) tests row objects
+     */
+    filter(column, op, value) {
+        if (typeof column === 'function') {
+            const rows = this.toArray();
+            const keep = [];
+            for (let i = 0; i < rows.length; i++) {
+                if (column(rows[i], i)) {
+                    keep.push(i);
+                }
             }
+            return this._derive(this._native.take(Uint32Array.from(keep)));
         }
-        return results;
+        return this._derive(this._native.filter(column, op, value));
+    }
+    
+    sortBy(column, direction = 'asc') {
+        return this._derive(this._native.sortBy(column, direction === 'desc'));
+    }
+    
+    select(...names) {
+        return this._derive(this._native.select(names.flat()));
+    }
+    
+    slice(start = 0, end = this.length) {
+        const clamp = (index) => index < 0 ? Math.max(this.length + index, 0) : Math.min(index, this.length);
+        const from = clamp(start);
+        const indices = new Uint32Array(Math.max(clamp(end) - from, 0));
+        for (let i = 0; i < indices.length; i++) {
+            indices[i] = from + i;
+        }
+        return this._derive(this._native.take(indices));
+    }
+    
+    map(transform) {
+        return this.toArray().map(transform);
+    }
+    
+    forEach(callback) {
+        this.toArray().forEach(callback);
+    }
+    
+    [Symbol.iterator]() {
+        return this.toArray()[Symbol.iterator]();
     }
     
     toArray() {
-        return this.processes;
+        if (!this._rows) {
+            const names = this.columns;
+            const values = names.map(name => this.column(name));
+            const rows = new Array(this.length);
+            for (let i = 0; i < rows.length; i++) {
+                const row = {};
+                for (let c = 0; c < names.length; c++) {
+                    row[names[c]] = values[c][i];
+                }
+                rows[i] = this._row(row);
+            }
+            this._rows = rows;
+        }
+        return this._rows;
     }
     
     toJSON() {
-        return JSON.stringify(this.processes, null, 2);
+        return this.toArray();
     }
     
-    forEach(callback) {
-        this.processes.forEach(callback);
+    _row(row) {
+        return row;
     }
     
-    get length() {
-        return this.processes.length;
+    _derive(native) {
+        return new this.constructor(native, this._bridge);
+    }
+}
+
+/**
+ * Process table; nexus.proc.list() columns are pid, ppid, uid, threads,
+ * cpu, memory, virtualMemory, state, name and command
+ */
+class ProcessList extends NexusTable {
+    get processes() {
+        return this.toArray();
+    }
+    
+    async killAll(signal = 'SIGTERM') {
+        const results = [];
+        for (const pid of this.column('pid')) {
+            try {
+                await this._bridge.kill(pid, signal);
+                results.push({ pid, success: true });
+            } catch (error) {
+                results.push({ pid, success: false, error: error.message });
+            }
+        }
+        return results;
+    }
+}
+
+/**
+ * File table (ls, stat of several paths): name or path, type, size, mode
+ * and times; rows also carry the isFile/isDirectory flags of stat()
+ */
+class FileTable extends NexusTable {
+    _row(row) {
+        row.isFile = row.type === 'file';
+        row.isDirectory = row.type === 'directory';
+        return row;
     }
 }
 
@@ -467,6 +779,8 @@ class ProcessResult {
         this.exitCode = result.exitCode || 0;
         this.stdout = result.stdout || '';
         this.stderr = result.stderr || '';
+        this.signal = result.signal || null;
+        this.timedOut = result.timedOut || false;
         this.success = this.exitCode === 0;
     }
     
@@ -480,6 +794,8 @@ class ProcessResult {
             exitCode: this.exitCode,
             stdout: this.stdout,
             stderr: this.stderr,
+            signal: this.signal,
+            timedOut: this.timedOut,
             success: this.success
         };
     }
@@ -505,42 +821,101 @@ class NexusNetwork {
      * HTTP GET with advanced options
      */
     async get(url, options = {}) {
-        const response = await this._bridge.get(url, {
-            headers: options.headers || {},
-            timeout: options.timeout || 30000,
-            followRedirects: options.followRedirects !== false
-        });
-        
-        return new HttpResponse(response);
+        return this.request('GET', url, undefined, options);
     }
     
     /**
      * HTTP POST with automatic serialization
      */
     async post(url, data, options = {}) {
+        return this._send('POST', url, data, options);
+    }
+    
+    async put(url, data, options = {}) {
+        return this._send('PUT', url, data, options);
+    }
+    
+    async delete(url, options = {}) {
+        return this.request('DELETE', url, undefined, options);
+    }
+    
+    _send(method, url, data, options) {
         let body = data;
-        let headers = options.headers || {};
+        const headers = { ...(options.headers || {}) };
         
-        if (typeof data === 'object') {
+        if (typeof data === 'object' && data !== null && !ArrayBuffer.isView(data)) {
             body = JSON.stringify(data);
             headers['Content-Type'] = 'application/json';
         }
         
-        const response = await this._bridge.post(url, body, {
-            headers,
-            timeout: options.timeout || 30000
-        });
+        return this.request(method, url, body, { ...options, headers });
+    }
+    
+    /**
+     * Generic request over the native keep-alive pool. Redirects are
+     * followed here (at most maxRedirects, default 5); with stream: true the
+     * response resolves at the head and the body is read as it arrives
+     */
+    async request(method, url, body, options = {}) {
+        const followRedirects = options.followRedirects !== false;
+        const maxRedirects = options.maxRedirects ?? 5;
         
-        return new HttpResponse(response);
+        for (let redirects = 0; ; redirects++) {
+            const chunks = options.stream ? new ChunkQueue() : null;
+            const head = await this._bridge.request(method, url, body, {
+                headers: options.headers || {},
+                timeout: options.timeout || 30000,
+                onData: chunks ? (chunk) => chunks.push(chunk) : undefined,
+                onEnd: chunks ? () => chunks.end() : undefined,
+                onError: chunks ? (error) => chunks.fail(error) : undefined
+            });
+            
+            const location = head.headers.location;
+            if (followRedirects && location && [301, 302, 303, 307, 308].includes(head.status)) {
+                if (redirects >= maxRedirects) {
+                    throw new Error(`Too many redirects fetching ${url}`);
+                }
+                url = NexusNetwork.resolveUrl(url, location);
+                // 303 (and historically 301/302 after POST) switch to GET
+                if (head.status === 303 || (head.status <= 302 && method === 'POST')) {
+                    method = 'GET';
+                    body = undefined;
+                }
+                continue;
+            }
+            
+            return new HttpResponse(head, chunks, url);
+        }
     }
     
     /**
-     * Download file with progress
+     * Resolve a Location header against the URL that returned it
+     */
+    static resolveUrl(base, location) {
+        if (/^[a-z][a-z0-9+.-]*:\/\//i.test(location)) {
+            return location;
+        }
+        const origin = base.match(/^[a-z][a-z0-9+.-]*:\/\/[^/?#]*/i)[0];
+        if (location.startsWith('//')) {
+            return base.slice(0, base.indexOf('//')) + location;
+        }
+        if (location.startsWith('/')) {
+            return origin + location;
+        }
+        const path = base.slice(origin.length).replace(/[?#].*$/, '');
+        return origin + path.slice(0, path.lastIndexOf('/') + 1) + location;
+    }
+    
+    /**
+     * Download straight to disk with progress; an interrupted download
+     * leaves "<filePath>.part" behind and the next call resumes it
      */
     async download(url, filePath, options = {}) {
         return this._bridge.download(url, filePath, {
+            headers: options.headers || {},
             onProgress: options.onProgress,
-            timeout: options.timeout || 300000 // 5 minutes default
+            resume: options.resume !== false,
+            timeout: options.timeout || 0 // Whole transfer; large artifacts need no cap
         });
     }
     
@@ -576,33 +951,64 @@ class NexusNetwork {
  * HTTP Response wrapper
  */
 class HttpResponse {
-    constructor(response) {
-        this.status = response.status;
-        this.statusText = response.statusText;
-        this.headers = response.headers;
-        this.ok = response.ok;
-        this._response = response;
+    constructor(head, chunks, url) {
+        this.status = head.status;
+        this.statusText = head.statusText;
+        this.headers = head.headers;
+        this.ok = head.ok;
+        this.url = url;
+        this._body = head.body || null;
+        this._chunks = chunks;
+    }
+    
+    /**
+     * Whole body as a Uint8Array (drains a streamed body)
+     */
+    async buffer() {
+        if (!this._body) {
+            const parts = [];
+            let length = 0;
+            for await (const chunk of this._chunks) {
+                parts.push(chunk);
+                length += chunk.length;
+            }
+            this._body = new Uint8Array(length);
+            let offset = 0;
+            for (const part of parts) {
+                this._body.set(part, offset);
+                offset += part.length;
+            }
+            this._chunks = null;
+        }
+        return this._body;
     }
     
     async text() {
-        return this._response.text();
+        return NexusUtils.decode(await this.buffer());
     }
     
     async json() {
-        return this._response.json();
+        return JSON.parse(await this.text());
     }
     
     async blob() {
-        return this._response.blob();
-    }
-    
-    async buffer() {
-        return this._response.buffer();
+        return this.buffer();
     }
     
     header(name) {
         return this.headers[name.toLowerCase()];
     }
+    
+    /**
+     * Iterate body chunks as they arrive: for await (const chunk of response)
+     */
+    async *[Symbol.asyncIterator]() {
+        if (this._chunks) {
+            yield* this._chunks;
+        } else if (this._body) {
+            yield this._body;
+        }
+    }
 }
 
 /**
@@ -677,6 +1083,42 @@ class NexusWebSocket {
  * Utility functions
  */
 class NexusUtils {
+    /**
+     * 32-bit FNV-1a hash of a string or byte array
+     */
+    static hash(data) {
+        if (NexusUtils._native && NexusUtils._native.hash) {
+            return NexusUtils._native.hash(data);
+        }
+        const bytes = typeof data === 'string' ? new TextEncoder().encode(data) : data;
+        let hash = 0x811c9dc5;
+        for (let i = 0; i < bytes.length; i++) {
+            hash ^= bytes[i];
+            hash = Math.imul(hash, 0x01000193) >>> 0;
+        }
+        return hash;
+    }
+    
+    /**
+     * UTF-8 encode a string into a Uint8Array
+     */
+    static encode(text) {
+        if (NexusUtils._native && NexusUtils._native.encode) {
+            return NexusUtils._native.encode(text);
+        }
+        return new TextEncoder().encode(text);
+    }
+    
+    /**
+     * UTF-8 decode a Uint8Array or ArrayBuffer
+     */
+    static decode(bytes) {
+        if (NexusUtils._native && NexusUtils._native.decode) {
+            return NexusUtils._native.decode(bytes);
+        }
+        return new TextDecoder().decode(bytes);
+    }
+    
     /**
      * Sleep for specified milliseconds
      */
@@ -792,10 +1234,17 @@ class NexusUtils {
 
 /**
  * Transaction support for atomic operations
+ * Paths passed to protect() are snapshotted copy-on-write before the
+ * operations run and restored if one of them fails. Files are reflinked
+ * where the filesystem allows and copied otherwise; with
+ * { hardlinks: true } they are hard-linked instead of copied, which is
+ * faster but lets in-place writes by other programs reach the snapshot.
  */
 class NexusTransaction {
-    constructor(kernel) {
-        this._kernel = kernel;
+    constructor(fsBridge, options = {}) {
+        this._fsBridge = fsBridge;
+        this._options = options;
+        this._files = null;
         this._operations = [];
         this._rollbackHandlers = [];
     }
@@ -805,11 +1254,31 @@ class NexusTransaction {
      */
     add(operation, rollback) {
         this._operations.push(operation);
-        if (rollback) {
-            this._rollbackHandlers.unshift(rollback); // Reverse order for rollback
+        this._rollbackHandlers.push(rollback);
+        return this;
+    }
+
+    /**
+     * Snapshot files or directory trees so a failed transaction restores
+     * them; paths that do not exist yet are removed on rollback
+     */
+    protect(...paths) {
+        if (!this._files) {
+            if (!this._fsBridge || !this._fsBridge.transaction) {
+                throw new Error('File snapshots are not available');
+            }
+            this._files = this._fsBridge.transaction({ hardlinks: !!this._options.hardlinks });
         }
+        this._files.protect(paths.flat());
         return this;
     }
+
+    /**
+     * Snapshot statistics (how many files were cloned, linked or copied)
+     */
+    stats() {
+        return this._files ? this._files.stats() : null;
+    }
     
     /**
      * Execute all operations atomically
@@ -824,18 +1293,39 @@ class NexusTransaction {
                 results.push(result);
                 executed++;
             }
-            
+
+            if (this._files) {
+                this._files.commit();
+            }
             return results;
             
         } catch (error) {
-            // Rollback executed operations
-            for (let i = 0; i < executed && i < this._rollbackHandlers.length; i++) {
+            // Restore the protected paths first, then undo the other effects
+            // of the executed operations, most recent first
+            if (this._files) {
+                try {
+                    this._files.rollback();
+                } catch (rollbackError) {
+                    console.error('Rollback failed:', rollbackError);
+                }
+            }
+            for (let i = executed - 1; i >= 0; i--) {
+                if (!this._rollbackHandlers[i]) {
+                    continue;
+                }
                 try {
                     await this._rollbackHandlers[i]();
                 } catch (rollbackError) {
                     console.error('Rollback failed:', rollbackError);
                 }
             }
+            if (this._globalRollback) {
+                try {
+                    await this._globalRollback(error);
+                } catch (rollbackError) {
+                    console.error('Rollback failed:', rollbackError);
+                }
+            }
             
             throw error;
         }
@@ -856,11 +1346,12 @@ if (typeof nexus !== 'undefined' && nexus.fs) {
     nexus.fs = new NexusFileSystem(nexus.fs);
     nexus.proc = new NexusProcess(nexus.proc);
     nexus.net = new NexusNetwork(nexus.net);
+    NexusUtils._native = nexus.utils;
     nexus.utils = NexusUtils;
     
     // Add transaction support
-    nexus.transaction = (operations) => {
-        const tx = new NexusTransaction();
+    nexus.transaction = (operations, options) => {
+        const tx = new NexusTransaction(nexus.fs._bridge, options);
         if (typeof operations === 'function') {
             return operations(tx);
         }
@@ -872,6 +1363,7 @@ if (typeof nexus !== 'undefined' && nexus.fs) {
     nexus.retry = NexusUtils.retry;
     nexus.formatBytes = NexusUtils.formatBytes;
     nexus.uuid = NexusUtils.uuid;
+    nexus.hash = NexusUtils.hash;
 }
 
 // Export for Node.js environments